@@ -0,0 +1,83 @@
+// AlignedAllocator.hpp
+//
+// The purpose of the AlignedAllocator class template is to provide a standard-conforming allocator whose blocks always begin on
+// an Alignment-byte boundary (a full cache line by default). It is used by the columnar containers such as OptionBatch so that
+// every parameter column starts on its own cache line and can be streamed through with aligned vector loads.
+
+#ifndef AlignedAllocator_H
+#define AlignedAllocator_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator
+{
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef std::size_t size_type;
+	typedef std::ptrdiff_t difference_type;
+
+	template <typename U>
+	struct rebind
+	{
+		typedef AlignedAllocator<U, Alignment> other;
+	};
+
+	// Constructors
+	AlignedAllocator() {}																		// Default constructor
+	template <typename U>
+	AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}									// Converting constructor used by rebind
+
+	// Returns uninitialized storage for count objects of type T beginning on an Alignment-byte boundary
+	T* allocate(std::size_t count)
+	{
+		if (count == 0)
+			return 0;
+
+		void* block = 0;
+#if defined(_MSC_VER)
+		block = _aligned_malloc(count * sizeof(T), Alignment);
+#else
+		if (posix_memalign(&block, Alignment, count * sizeof(T)) != 0)
+			block = 0;
+#endif
+		if (block == 0)
+			throw std::bad_alloc();
+
+		return static_cast<T*>(block);
+	}
+
+	// Releases storage previously obtained from allocate
+	void deallocate(T* block, std::size_t)
+	{
+#if defined(_MSC_VER)
+		_aligned_free(block);
+#else
+		free(block);
+#endif
+	}
+};
+
+// All AlignedAllocator objects with equal alignment are interchangeable
+template <typename T, typename U, std::size_t Alignment>
+bool operator == (const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&)
+{
+	return true;
+}
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator != (const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&)
+{
+	return false;
+}
+
+
+#endif
@@ -0,0 +1,136 @@
+// Arena.cpp
+
+#include "Arena.hpp"
+#include "AlignedAllocator.hpp"
+
+#include <vector>
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Value constructor; blocks are obtained on demand, the first of initialBlockSize bytes
+Arena::Arena(size_t initialBlockSize) : current(0), offset(0), used(0), minBlockSize(initialBlockSize > 0 ? initialBlockSize : defaultBlockSize)
+{
+}
+
+// Destructor
+Arena::~Arena()
+{
+	Release();
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the bytes handed out since the last Reset, including the padding inserted to align them
+size_t Arena::BytesUsed() const
+{
+	return used;
+}
+
+// Returns the total size of the blocks held
+size_t Arena::Capacity() const
+{
+	size_t capacity = 0;
+	for (size_t i = 0; i < blocks.size(); i++)
+		capacity += blocks[i].size;
+	return capacity;
+}
+
+// Returns the number of blocks held
+size_t Arena::BlockCount() const
+{
+	return blocks.size();
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Makes sure the current block has room for bytes more bytes, moving on to a later block that does or adding one. Any room left in
+// the blocks passed over is not used again until Reset.
+void Arena::Reserve(size_t bytes)
+{
+	if (current < blocks.size() && blocks[current].size - offset >= bytes)
+		return;
+
+	NextBlock(bytes);
+}
+
+// Rewinds to the start of the first block. If the arena had grown to several blocks, they are replaced by one block of their
+// combined size, so that the next run of the same size is served from a single block without obtaining any more memory.
+void Arena::Reset()
+{
+	if (blocks.size() > 1)
+	{
+		size_t capacity = Capacity();
+		Release();
+		AddBlock(capacity);
+	}
+
+	current = 0;
+	offset = 0;
+	used = 0;
+}
+
+// Returns every block to the system; the arena can be used again afterwards
+void Arena::Release()
+{
+	AlignedAllocator<char, blockAlignment> allocator;
+	for (size_t i = 0; i < blocks.size(); i++)
+		allocator.deallocate(blocks[i].data, blocks[i].size);
+
+	blocks.clear();
+	current = 0;
+	offset = 0;
+	used = 0;
+}
+
+
+// -------------------------------------------------------------------------- Private Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Serves an allocation which does not fit in the rest of the current block from the first later block that can hold it, or from
+// a new block at least as large as the arena's current capacity, so that capacity doubles each time a block is added
+void* Arena::AllocateSlow(size_t bytes, size_t)
+{
+	NextBlock(bytes);
+
+	// A block begins on a cache line, so an allocation at its start is aligned for any alignment up to blockAlignment
+	used += bytes;
+	offset = bytes;
+	return blocks[current].data;
+}
+
+// Makes the first block after the current one with room for bytes bytes the current block, adding a block if there is none
+void Arena::NextBlock(size_t bytes)
+{
+	for (size_t j = (blocks.empty() ? 0 : current + 1); j < blocks.size(); j++)
+	{
+		if (blocks[j].size >= bytes)
+		{
+			current = j;
+			offset = 0;
+			return;
+		}
+	}
+
+	AddBlock(bytes);
+	current = blocks.size() - 1;
+	offset = 0;
+}
+
+// Adds a block of at least size bytes, and of at least the arena's current capacity and its minimum block size
+void Arena::AddBlock(size_t size)
+{
+	size_t capacity = Capacity();
+	if (size < capacity)
+		size = capacity;
+	if (size < minBlockSize)
+		size = minBlockSize;
+
+	Block block = { AlignedAllocator<char, blockAlignment>().allocate(size), size };
+	blocks.push_back(block);
+}
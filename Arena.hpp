@@ -0,0 +1,100 @@
+// Arena.hpp
+//
+// The purpose of the Arena class is to serve many small allocations that all die together -- the option objects of a ParamMatrix,
+// scratch result buffers of a pricing run -- out of a few large blocks, so that building a book of millions of rows costs a handful
+// of calls to the system allocator rather than one per row. Allocation only moves a pointer forward through the current block; when
+// the block is full a new one at least as large as everything allocated so far is added, so the number of blocks grows only with the
+// logarithm of the total size. Nothing is freed individually. Reset makes the whole arena available again while keeping its memory
+// (merged into a single block if it had grown to several), so a book rebuilt to the same size between runs allocates nothing at all,
+// and Release returns the memory to the system.
+//
+// The arena never runs destructors: objects made with Create whose destructors matter must be destroyed by their owner before Reset
+// or Release. An Arena is not thread safe; each thread building into an arena needs an arena of its own.
+
+#ifndef Arena_H
+#define Arena_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+using namespace std;
+
+class Arena
+{
+private:
+	struct Block
+	{
+		char* data;
+		size_t size;
+	};
+
+	vector<Block> blocks;								// Every block obtained from the system, in order of allocation
+	size_t current;										// Index in blocks of the block being allocated from
+	size_t offset;										// Bytes of the current block already handed out
+	size_t used;										// Bytes handed out since the last Reset, including alignment padding
+	size_t minBlockSize;								// Size of the first block, and the least size of any block
+
+	Arena(const Arena&);								// Not copyable
+	Arena& operator = (const Arena&);					// Not assignable
+
+	void* AllocateSlow(size_t bytes, size_t alignment);	// Moves on to the next block, adding one if there is none, and allocates from it
+	void NextBlock(size_t bytes);						// Moves on to the next block with room for bytes, adding one if there is none
+	void AddBlock(size_t size);							// Obtains a block of size bytes from the system
+
+public:
+	static const size_t defaultBlockSize = 64 * 1024;
+	static const size_t blockAlignment = 64;			// Every block begins on a cache line
+
+	// Constructors and Destructor
+	explicit Arena(size_t initialBlockSize = defaultBlockSize);	// Value constructor; no memory is obtained until the first allocation
+	virtual ~Arena();											// Destructor; returns every block to the system
+
+
+	// Accessor Functions
+	size_t BytesUsed() const;									// Returns the bytes handed out since the last Reset
+	size_t Capacity() const;									// Returns the total size of the blocks held
+	size_t BlockCount() const;									// Returns the number of blocks held
+
+
+	// Modifier Functions
+	void* Allocate(size_t bytes, size_t alignment = alignof(double));	// Returns bytes bytes of uninitialized storage aligned to alignment,
+																		// which must be a power of two not above blockAlignment
+	void Reserve(size_t bytes);									// Ensures that the current block has bytes bytes free, so that
+																// allocations totalling bytes, padding included, obtain no block
+	void Reset();												// Makes all of the memory available again; every pointer handed out
+																// before is invalidated
+	void Release();												// Returns every block to the system
+
+	template <typename T>
+	T* AllocateArray(size_t count)								// Returns uninitialized storage for count objects of type T
+	{
+		return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+	}
+
+	template <typename T, typename... Args>
+	T* Create(Args&&... args)									// Constructs a T from args in the arena; the caller runs its destructor
+	{
+		return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+	}
+};
+
+// Allocates by bumping the offset into the current block when the request fits there
+inline void* Arena::Allocate(size_t bytes, size_t alignment)
+{
+	if (current < blocks.size())
+	{
+		size_t start = (offset + (alignment - 1)) & ~(alignment - 1);
+		if (start + bytes <= blocks[current].size)
+		{
+			used += (start + bytes) - offset;
+			offset = start + bytes;
+			return blocks[current].data + start;
+		}
+	}
+
+	return AllocateSlow(bytes, alignment);
+}
+
+
+#endif
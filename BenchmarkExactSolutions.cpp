@@ -0,0 +1,487 @@
+// BenchmarkExactSolutions.cpp
+//
+// The purpose of this program is to measure the speed of every pricing and Greeks entry point of the Option class hierarchy and of
+// the batch containers built on top of it, so that a change to EuropeanOption, PerpetualAmericanOption, ParamMatrix, OptionBatch
+// or PartitionedBatch can be checked for throughput regressions. Each benchmark repeats its call until at least --min-time seconds
+// have elapsed and reports the time per call, the time per row and the rows processed per second. Batch benchmarks are run for
+// batch sizes 1, 10, 100, ... up to --max-rows (10^6 by default). Results are written as CSV (the default) or JSON, to standard
+// output or to --output, each as soon as it has been measured, so that successive runs can be kept as a performance history. The
+// books and engines a batch benchmark runs on are only built when a benchmark using them is selected by --filter.
+//
+// Usage: BenchmarkExactSolutions [--format=csv|json] [--output=file] [--max-rows=n] [--min-time=seconds] [--filter=substring]
+
+#include "EuropeanOption.hpp"
+#include "PerpetualAmericanOption.hpp"
+#include "PerpetualAmericanModel.hpp"
+#include "ParamMatrix.hpp"
+#include "OptionBatch.hpp"
+#include "PartitionedBatch.hpp"
+#include "PrecisionBatch.hpp"
+#include "Portfolio.hpp"
+#include "BsmKernel.hpp"
+#include "BumpEngine.hpp"
+#include "NormalDistribution.hpp"
+#include "ScenarioEngine.hpp"
+#include "ScenarioGrid.hpp"
+#include "SpotTickRepricer.hpp"
+#include "SurfaceGenerator.hpp"
+#include "TermStructureBatch.hpp"
+#include "ThreadPool.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct BenchmarkResult
+{
+	string name;										// Name of the function or method measured
+	size_t rows;										// Rows processed per call (1 for scalar functions)
+	size_t calls;										// Number of calls timed
+	double seconds;										// Total time of those calls
+};
+
+struct BenchmarkOutput
+{
+	ostream* os;										// Stream the results are written to
+	bool json;											// Whether the results are written as JSON rather than CSV
+	size_t written;										// Number of results written so far
+};
+
+struct BenchmarkSettings
+{
+	string format;
+	string output;
+	string filter;
+	size_t maxRows;
+	double minTime;
+};
+
+// Prevents the compiler from discarding the results of the functions being measured
+volatile double benchmarkSink = 0;
+
+// Number of distinct inputs cycled through by the scalar benchmarks; keeps the inputs from being constant-folded
+const size_t scalarInputs = 1024;
+
+// Repeats body() until minTime seconds have elapsed, doubling the number of calls per timing round, and returns the totals of
+// the final round
+template <typename Body>
+BenchmarkResult Measure(const string& name, size_t rows, double minTime, Body body)
+{
+	BenchmarkResult result = { name, rows, 0, 0 };
+	for (size_t calls = 1; ; calls *= 2)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (size_t i = 0; i < calls; i++)
+			body(i);
+		double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+		result.calls = calls;
+		result.seconds = elapsed;
+		if (elapsed >= minTime)
+			return result;
+	}
+}
+
+// Returns true if the benchmark named name should run under the given settings
+bool Selected(const BenchmarkSettings& settings, const string& name)
+{
+	return settings.filter.empty() || name.find(settings.filter) != string::npos;
+}
+
+// Writes the CSV header line, or the opening of the JSON document holding the instruction set used by the BSM kernel
+void BeginOutput(BenchmarkOutput& output)
+{
+	ostream& os = *output.os;
+	if (output.json)
+		os << "{" << endl << "  \"isa\": \"" << BsmKernel::IsaName(BsmKernel::GetIsa()) << "\"," << endl << "  \"benchmarks\": [";
+	else
+		os << "name,rows,calls,seconds,ns_per_call,ns_per_row,rows_per_sec" << endl;
+	os.flush();
+}
+
+// Writes one result as a CSV line or a JSON object, and flushes it so that a run cut short keeps every result measured so far
+void Report(BenchmarkOutput& output, const BenchmarkResult& r)
+{
+	ostream& os = *output.os;
+	double nsPerCall = 1e9 * r.seconds / r.calls;
+	if (output.json)
+	{
+		os << ((output.written > 0) ? "," : "") << endl << "    { \"name\": \"" << r.name << "\", \"rows\": " << r.rows << ", \"calls\": "
+		   << r.calls << ", \"seconds\": " << r.seconds << ", \"ns_per_call\": " << nsPerCall << ", \"ns_per_row\": " << nsPerCall / r.rows
+		   << ", \"rows_per_sec\": " << (r.calls * r.rows) / r.seconds << " }";
+	}
+	else
+	{
+		os << r.name << "," << r.rows << "," << r.calls << "," << r.seconds << "," << nsPerCall << "," << nsPerCall / r.rows << ","
+		   << (r.calls * r.rows) / r.seconds << endl;
+	}
+	os.flush();
+	output.written++;
+}
+
+// Closes the JSON document; CSV needs no closing
+void EndOutput(BenchmarkOutput& output)
+{
+	if (output.json)
+		*output.os << endl << "  ]" << endl << "}" << endl;
+}
+
+// Parses the command line; unrecognized arguments are reported and ignored
+BenchmarkSettings ParseArguments(int argc, char* argv[])
+{
+	BenchmarkSettings settings = { "csv", "", "", 1000000, 0.2 };
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg.compare(0, 9, "--format=") == 0)
+			settings.format = arg.substr(9);
+		else if (arg.compare(0, 9, "--output=") == 0)
+			settings.output = arg.substr(9);
+		else if (arg.compare(0, 9, "--filter=") == 0)
+			settings.filter = arg.substr(9);
+		else if (arg.compare(0, 11, "--max-rows=") == 0)
+			settings.maxRows = strtoul(arg.c_str() + 11, 0, 10);
+		else if (arg.compare(0, 11, "--min-time=") == 0)
+			settings.minTime = strtod(arg.c_str() + 11, 0);
+		else
+			cerr << "Ignoring unrecognized argument " << arg << endl;
+	}
+	return settings;
+}
+
+// Benchmarks every scalar member and static function of EuropeanOption and PerpetualAmericanOption
+void BenchmarkScalarFunctions(const BenchmarkSettings& settings, BenchmarkOutput& output)
+{
+	mt19937_64 generator(20201);
+	uniform_real_distribution<double> spot(80, 120), vol(0.1, 0.5), rate(0.0, 0.08), x(-4, 4);
+	vector<double> S(scalarInputs), sig(scalarInputs), r(scalarInputs), b(scalarInputs), z(scalarInputs);
+	for (size_t i = 0; i < scalarInputs; i++)
+	{
+		S[i] = spot(generator);
+		sig[i] = vol(generator);
+		r[i] = rate(generator);
+		b[i] = r[i] - 0.02;
+		z[i] = x(generator);
+	}
+
+	EuropeanOption euro('C', 100, 0.75);
+	PerpetualAmericanOption perpetual('P', 100);
+	PerpetualAmericanModel perpetualModel(perpetual, 0.3, 0.05, 0.03);
+	size_t m = scalarInputs - 1;
+
+#define SCALAR_BENCHMARK(label, expression)																	\
+	if (Selected(settings, label))																			\
+		Report(output, Measure(label, 1, settings.minTime, [&](size_t i) { benchmarkSink = benchmarkSink + (expression); }));
+
+	SCALAR_BENCHMARK("EuropeanOption::Price", euro.Price(S[i & m], sig[i & m], r[i & m], b[i & m]))
+	SCALAR_BENCHMARK("EuropeanOption::Delta", euro.Delta(S[i & m], sig[i & m], r[i & m], b[i & m]))
+	SCALAR_BENCHMARK("EuropeanOption::Gamma", euro.Gamma(S[i & m], sig[i & m], r[i & m], b[i & m]))
+	SCALAR_BENCHMARK("EuropeanOption::Theta", euro.Theta(S[i & m], sig[i & m], r[i & m], b[i & m]))
+	SCALAR_BENCHMARK("EuropeanOption::Vega", euro.Vega(S[i & m], sig[i & m], r[i & m], b[i & m]))
+	SCALAR_BENCHMARK("EuropeanOption::DivDiffDelta", euro.DivDiffDelta(S[i & m], sig[i & m], r[i & m], b[i & m], 0.01))
+	SCALAR_BENCHMARK("EuropeanOption::DivDiffGamma", euro.DivDiffGamma(S[i & m], sig[i & m], r[i & m], b[i & m], 0.01))
+	SCALAR_BENCHMARK("EuropeanOption::Evaluate", euro.Evaluate(S[i & m], sig[i & m], r[i & m], b[i & m]).price)
+	SCALAR_BENCHMARK("EuropeanOption::EvaluateHigherOrder", euro.EvaluateHigherOrder(S[i & m], sig[i & m], r[i & m], b[i & m]).color)
+	SCALAR_BENCHMARK("EuropeanOption::Gradient", euro.Gradient(S[i & m], sig[i & m], r[i & m], b[i & m]).dT)
+	SCALAR_BENCHMARK("EuropeanOption::d_1", euro.d_1(S[i & m], sig[i & m], b[i & m]))
+	SCALAR_BENCHMARK("EuropeanOption::N", EuropeanOption::N(z[i & m]))
+	SCALAR_BENCHMARK("EuropeanOption::n", EuropeanOption::n(z[i & m]))
+	SCALAR_BENCHMARK("NormalDistribution::FullCdf", NormalDistribution::FullCdf(z[i & m]))
+	SCALAR_BENCHMARK("NormalDistribution::FullPdf", NormalDistribution::FullPdf(z[i & m]))
+	SCALAR_BENCHMARK("NormalDistribution::ChebyshevCdf", NormalDistribution::ChebyshevCdf(z[i & m]))
+	SCALAR_BENCHMARK("NormalDistribution::ChebyshevPdf", NormalDistribution::ChebyshevPdf(z[i & m]))
+	SCALAR_BENCHMARK("NormalDistribution::TableCdf", NormalDistribution::TableCdf(z[i & m]))
+	SCALAR_BENCHMARK("NormalDistribution::TablePdf", NormalDistribution::TablePdf(z[i & m]))
+
+	// A full Greek set with each accuracy tier of the normal CDF/PDF
+	NormalDistribution::Tier defaultTier = NormalDistribution::GetTier();
+	const NormalDistribution::Tier tiers[3] = { NormalDistribution::FullTier, NormalDistribution::ChebyshevTier, NormalDistribution::TableTier };
+	for (NormalDistribution::Tier tier : tiers)
+	{
+		NormalDistribution::SetTier(tier);
+		string label = string("EuropeanOption::Evaluate(") + NormalDistribution::Name(tier) + " tier)";
+		SCALAR_BENCHMARK(label, euro.Evaluate(S[i & m], sig[i & m], r[i & m], b[i & m]).price)
+	}
+	NormalDistribution::SetTier(defaultTier);
+	SCALAR_BENCHMARK("PerpetualAmericanOption::Price", perpetual.Price(S[i & m], sig[i & m], r[i & m], b[i & m]))
+	SCALAR_BENCHMARK("PerpetualAmericanOption::Delta", perpetual.Delta(S[i & m], sig[i & m], r[i & m], b[i & m]))
+	SCALAR_BENCHMARK("PerpetualAmericanOption::Gamma", perpetual.Gamma(S[i & m], sig[i & m], r[i & m], b[i & m]))
+	SCALAR_BENCHMARK("PerpetualAmericanOption::DivDiffDelta", perpetual.DivDiffDelta(S[i & m], sig[i & m], r[i & m], b[i & m], 0.01))
+	SCALAR_BENCHMARK("PerpetualAmericanOption::DivDiffGamma", perpetual.DivDiffGamma(S[i & m], sig[i & m], r[i & m], b[i & m], 0.01))
+	SCALAR_BENCHMARK("PerpetualAmericanOption::Gradient", perpetual.Gradient(S[i & m], sig[i & m], r[i & m], b[i & m]).dSig)
+	SCALAR_BENCHMARK("PerpetualAmericanOption::y_1", PerpetualAmericanOption::y_1(sig[i & m], r[i & m], b[i & m]))
+	SCALAR_BENCHMARK("PerpetualAmericanOption::y_2", PerpetualAmericanOption::y_2(sig[i & m], r[i & m], b[i & m]))
+	SCALAR_BENCHMARK("PerpetualAmericanModel::Price", perpetualModel.Price(S[i & m]))
+	SCALAR_BENCHMARK("PerpetualAmericanModel::Evaluate", perpetualModel.Evaluate(S[i & m]).gamma)
+
+#undef SCALAR_BENCHMARK
+}
+
+// Holds a fixture of a batch benchmark, which is built by make on first use, so that only the fixtures of the selected benchmarks
+// take time and memory
+template <typename T>
+class LazyFixture
+{
+private:
+	function<T*()> make;								// Returns a new fixture
+	unique_ptr<T> fixture;								// The fixture, once built
+
+public:
+	explicit LazyFixture(const function<T*()>& maker) : make(maker)
+	{
+	}
+
+	T& operator () ()
+	{
+		if (!fixture)
+			fixture.reset(make());
+		return *fixture;
+	}
+};
+
+// Benchmarks the ParamMatrix, OptionBatch and BsmKernel batch functions, and the engines built on them, for batch sizes 1, 10, ...,
+// maxRows. The books hold a mix of Euro calls and puts with one PAMO row in every eight so that the virtual dispatch of ParamMatrix
+// is exercised. Every fixture is built on first use by a selected benchmark and released before the next batch size.
+void BenchmarkBatchFunctions(const BenchmarkSettings& settings, BenchmarkOutput& output)
+{
+	ThreadPool pool;
+
+	for (size_t rows = 1; rows <= settings.maxRows; rows *= 10)
+	{
+		ostringstream size;
+		size << "[" << rows << "]";
+		vector<double> out(rows);
+
+		// The mixed book, and the same rows with every PAMO row replaced by a Euro call
+		LazyFixture<OptionBatch> batch([&]()
+		{
+			mt19937_64 generator(rows);
+			uniform_real_distribution<double> spot(80, 120), vol(0.1, 0.5), rate(0.0, 0.08), strike(70, 130), maturity(0.05, 3);
+			OptionBatch* book = new OptionBatch();
+			book->Reserve(rows);
+			for (size_t i = 0; i < rows; i++)
+			{
+				double r = rate(generator);
+				vector<double> row{ spot(generator), vol(generator), r, r - 0.02, (i % 2 == 0) ? 1.0 : -1.0, strike(generator) };
+				if (i % 8 != 7)
+					row.push_back(maturity(generator));
+				book->PushRow(row);
+			}
+			return book;
+		});
+		LazyFixture<OptionBatch> euroBatch([&]()
+		{
+			OptionBatchView view = batch().View();
+			OptionBatch* book = new OptionBatch();
+			book->Reserve(rows);
+			for (size_t i = 0; i < rows; i++)
+			{
+				if (view.kind[i] == 'E')
+					book->PushEuropean(view.S[i], view.sig[i], view.r[i], view.b[i], (view.type[i] == 1) ? 'C' : 'P', view.K[i], view.T[i]);
+				else
+					book->PushEuropean(view.S[i], view.sig[i], view.r[i], view.b[i], 'C', view.K[i], 1);
+			}
+			return book;
+		});
+		LazyFixture<PrecisionBatch> euroSingle([&]() { return new PrecisionBatch(euroBatch().View(), PrecisionBatch::SinglePrecision); });
+		LazyFixture<ParamMatrix> matrix([&]()
+		{
+			OptionBatchView view = batch().View();
+			ParamMatrix* book = new ParamMatrix();
+			for (size_t i = 0; i < rows; i++)
+			{
+				vector<double> row{ view.S[i], view.sig[i], view.r[i], view.b[i], view.type[i], view.K[i] };
+				if (view.kind[i] == 'E')
+					row.push_back(view.T[i]);
+				book->PushRow(row);
+			}
+			return book;
+		});
+
+		// Result buffers wider than out
+		LazyFixture<vector<OptionResults> > outAll([&]() { return new vector<OptionResults>(rows); });
+		LazyFixture<vector<HigherOrderResults> > outHigher([&]() { return new vector<HigherOrderResults>(rows); });
+		LazyFixture<vector<PriceGradient> > outGradient([&]() { return new vector<PriceGradient>(rows); });
+
+		LazyFixture<PartitionedBatch> partitioned([&]() { return new PartitionedBatch(batch().View()); });
+		LazyFixture<PartitionedBatch> partitionedSimd([&]()
+		{
+			PartitionedBatch* book = new PartitionedBatch(batch().View());
+			book->SetVectorized(true);
+			return book;
+		});
+
+		// Bump engines for delta and gamma alone, comparable to DivDiffDelta followed by DivDiffGamma, with and without Richardson
+		// extrapolation, and for a wider set of sensitivities on the Euro book priced with BsmKernel
+		BumpEngine bumpSpot, bumpSpotPlain, bumpEuro(static_cast<void (*)(const OptionBatchView&, double*)>(BsmKernel::Price));
+		bumpSpot.AddFirst(BumpEngine::Spot);
+		bumpSpot.AddSecond(BumpEngine::Spot);
+		bumpSpotPlain = bumpSpot;
+		bumpSpotPlain.SetRichardson(false);
+		bumpEuro.AddFirst(BumpEngine::Spot);
+		bumpEuro.AddSecond(BumpEngine::Spot);
+		bumpEuro.AddFirst(BumpEngine::Vol);
+		bumpEuro.AddFirst(BumpEngine::Rate);
+		bumpEuro.AddCross(BumpEngine::Spot, BumpEngine::Vol);
+		LazyFixture<vector<double> > bumped([&]() { return new vector<double>(rows * bumpEuro.SpecCount()); });
+
+		// A tick-driven book holding the rows of euroBatch on a single underlying, so that every tick reprices every contract
+		size_t ticks = 0;
+		LazyFixture<SpotTickRepricer> repricer([&]()
+		{
+			OptionBatchView euroView = euroBatch().View();
+			SpotTickRepricer* book = new SpotTickRepricer();
+			size_t underlying = book->AddUnderlying(100);
+			for (size_t i = 0; i < rows; i++)
+				book->AddContract(EuropeanOption((euroView.type[i] == 1) ? 'C' : 'P', euroView.K[i], euroView.T[i]), underlying, euroView.sig[i],
+								  euroView.r[i], euroView.b[i]);
+			return book;
+		});
+
+		// The rows of batch as positions of alternating sign, spread over four underlyings and two books
+		LazyFixture<Portfolio> portfolio([&]()
+		{
+			OptionBatchView view = batch().View();
+			Portfolio* book = new Portfolio();
+			const char* underlyings[4] = { "U0", "U1", "U2", "U3" };
+			for (size_t i = 0; i < rows; i++)
+			{
+				double quantity = (i % 3 == 0) ? -100.0 : 100.0;
+				book->PushRows(OptionBatch::Slice(view, i, i + 1), &quantity, underlyings[i % 4], (i % 2 == 0) ? "B0" : "B1");
+			}
+			book->SetExpiryEdges(vector<double>{ 0.25, 0.5, 1, 2 });
+			book->SetStrikeEdges(vector<double>{ 0.9, 0.97, 1.03, 1.1 });
+			return book;
+		});
+		const int allKeys = Portfolio::ByUnderlying | Portfolio::ByExpiry | Portfolio::ByStrikeBand | Portfolio::ByBook;
+
+		// 20 scenarios on the portfolio: five spot shifts times two vol shifts times two rate shifts
+		LazyFixture<ScenarioEngine> stress([&]()
+		{
+			ScenarioEngine* engine = new ScenarioEngine(portfolio());
+			engine->AddScenarios(ScenarioEngine::Product(vector<double>{ -0.1, -0.05, 0, 0.05, 0.1 }, vector<double>{ -0.05, 0.05 },
+														 vector<double>{ -0.01, 0.01 }, vector<double>(), vector<double>()));
+			return engine;
+		});
+
+		// A spot x maturity grid with the same number of points as the books, evaluated as a ScenarioGrid and as a surface
+		size_t gridSpots = (rows < 100) ? rows : 100;
+		vector<double> gridSpotAxis(gridSpots), gridMaturityAxis(rows / gridSpots);
+		for (size_t i = 0; i < gridSpotAxis.size(); i++)
+			gridSpotAxis[i] = 80 + (40.0 * i) / gridSpots;
+		for (size_t i = 0; i < gridMaturityAxis.size(); i++)
+			gridMaturityAxis[i] = 0.05 + (3.0 * i) / gridMaturityAxis.size();
+		LazyFixture<ScenarioGrid> grid([&]()
+		{
+			return new ScenarioGrid(gridSpotAxis, vector<double>{ 0.3 }, vector<double>{ 0.04 }, vector<double>{ 0.02 }, 'C',
+									vector<double>{ 100 }, gridMaturityAxis);
+		});
+		LazyFixture<SurfaceGenerator> surface([&]() { return new SurfaceGenerator(gridSpotAxis, gridMaturityAxis, 'C', 100, 0.3, 0.04, 0.02); });
+		const int surfaceOutputs = Option::PriceOutput | Option::DeltaOutput | Option::GammaOutput;
+		GridTileSink gridSink = [&](size_t first, size_t count, const OptionResults* tile) { out[first] = tile[count - 1].price; };
+
+		// The book priced against upward sloping rate and carry curves and a skewed volatility surface
+		MarketCurves curves;
+		curves.rates = make_shared<const YieldCurve>(vector<double>{ 0.25, 0.5, 1, 2, 5 }, vector<double>{ 0.03, 0.032, 0.035, 0.04, 0.045 });
+		curves.carries = make_shared<const YieldCurve>(vector<double>{ 0.25, 1, 5 }, vector<double>{ 0.01, 0.015, 0.02 });
+		curves.vols = make_shared<const VolSurface>(vector<double>{ 80, 100, 120 }, vector<double>{ 0.25, 1, 5 },
+													vector<double>{ 0.35, 0.3, 0.28, 0.32, 0.28, 0.26, 0.3, 0.27, 0.25 });
+		LazyFixture<TermStructureBatch> termBook([&]()
+		{
+			TermStructureBatch* book = new TermStructureBatch(batch().View());
+			book->SetMarket(curves);
+			return book;
+		});
+
+		// Each benchmark runs setup, which fetches (and so builds) its fixtures, once before timing statement
+#define BATCH_BENCHMARK(label, setup, statement)															\
+	if (Selected(settings, label))																			\
+	{																										\
+		setup;																								\
+		Report(output, Measure(string(label) + size.str(), rows, settings.minTime, [&](size_t) { statement; benchmarkSink = benchmarkSink + out[0]; }));	\
+	}
+
+		BATCH_BENCHMARK("ParamMatrix::Price", ParamMatrix& m = matrix(), out = m.Price())
+		BATCH_BENCHMARK("ParamMatrix::Delta", ParamMatrix& m = matrix(), out = m.Delta())
+		BATCH_BENCHMARK("ParamMatrix::DivDiffDelta", ParamMatrix& m = matrix(), out = m.DivDiffDelta(0.01))
+		BATCH_BENCHMARK("ParamMatrix::Gamma", ParamMatrix& m = matrix(), out = m.Gamma())
+		BATCH_BENCHMARK("ParamMatrix::DivDiffGamma", ParamMatrix& m = matrix(), out = m.DivDiffGamma(0.01))
+		BATCH_BENCHMARK("ParamMatrix::Evaluate", ParamMatrix& m = matrix(); vector<OptionResults>& all = outAll(), all = m.Evaluate(); out[0] = all[0].price)
+		BATCH_BENCHMARK("ParamMatrix::Evaluate(higher order)", ParamMatrix& m = matrix(); vector<OptionResults>& all = outAll(); vector<HigherOrderResults>& higher = outHigher(),
+						m.Evaluate(Option::AllOutputs, Option::AllHigherOrderOutputs, all, higher); out[0] = higher[0].vanna)
+		BATCH_BENCHMARK("ParamMatrix::BookGradient", ParamMatrix& m = matrix(), out[0] = m.BookGradient().dSig)
+		BATCH_BENCHMARK("ParamMatrix::Price(parallel)", ParamMatrix& m = matrix(), m.Price(out, pool))
+		BATCH_BENCHMARK("ParamMatrix::DivDiffGamma(parallel)", ParamMatrix& m = matrix(), m.DivDiffGamma(0.01, out, pool))
+		BATCH_BENCHMARK("ParamMatrix::Rebuild", ParamMatrix& m = matrix(); ParamMatrix rebuilt, rebuilt = m; out[0] = rebuilt.RowData(0)[0])
+		BATCH_BENCHMARK("OptionBatch::Price", OptionBatchView view = batch().View(), OptionBatch::Price(view, out.data()))
+		BATCH_BENCHMARK("OptionBatch::Delta", OptionBatchView view = batch().View(), OptionBatch::Delta(view, out.data()))
+		BATCH_BENCHMARK("OptionBatch::Gamma", OptionBatchView view = batch().View(), OptionBatch::Gamma(view, out.data()))
+		BATCH_BENCHMARK("OptionBatch::Evaluate", OptionBatchView view = batch().View(); vector<OptionResults>& all = outAll(),
+						OptionBatch::Evaluate(view, Option::AllOutputs, all.data()); out[0] = all[0].price)
+		BATCH_BENCHMARK("OptionBatch::Gradient", OptionBatchView view = batch().View(); vector<PriceGradient>& gradient = outGradient(),
+						OptionBatch::Gradient(view, gradient.data()); out[0] = gradient[0].dK)
+		BATCH_BENCHMARK("PartitionedBatch::Price", PartitionedBatch& p = partitioned(), p.Price(out.data()))
+		BATCH_BENCHMARK("PartitionedBatch::Price(vectorized)", PartitionedBatch& p = partitionedSimd(), p.Price(out.data()))
+		BATCH_BENCHMARK("PartitionedBatch::Evaluate", PartitionedBatch& p = partitioned(); vector<OptionResults>& all = outAll(),
+						p.Evaluate(Option::AllOutputs, all.data()); out[0] = all[0].price)
+		BATCH_BENCHMARK("BsmKernel::Price", OptionBatchView euroView = euroBatch().View(), BsmKernel::Price(euroView, out.data()))
+		BATCH_BENCHMARK("BsmKernel::Delta", OptionBatchView euroView = euroBatch().View(), BsmKernel::Delta(euroView, out.data()))
+		BATCH_BENCHMARK("BsmKernel::Gamma", OptionBatchView euroView = euroBatch().View(), BsmKernel::Gamma(euroView, out.data()))
+		BATCH_BENCHMARK("BsmKernel::Theta", OptionBatchView euroView = euroBatch().View(), BsmKernel::Theta(euroView, out.data()))
+		BATCH_BENCHMARK("BsmKernel::Vega", OptionBatchView euroView = euroBatch().View(), BsmKernel::Vega(euroView, out.data()))
+		BATCH_BENCHMARK("BsmKernel::Price(float)", FloatBatchView floatView = euroSingle().FloatView(), BsmKernel::Price(floatView, out.data()))
+		BATCH_BENCHMARK("BsmKernel::Delta(float)", FloatBatchView floatView = euroSingle().FloatView(), BsmKernel::Delta(floatView, out.data()))
+		BATCH_BENCHMARK("BsmKernel::Gamma(float)", FloatBatchView floatView = euroSingle().FloatView(), BsmKernel::Gamma(floatView, out.data()))
+		BATCH_BENCHMARK("BumpEngine::Compute(delta, gamma)", OptionBatchView view = batch().View(); vector<double>& b = bumped(),
+						bumpSpot.Compute(view, b.data()); out[0] = b[0])
+		BATCH_BENCHMARK("BumpEngine::Compute(no extrapolation)", OptionBatchView view = batch().View(); vector<double>& b = bumped(),
+						bumpSpotPlain.Compute(view, b.data()); out[0] = b[0])
+		BATCH_BENCHMARK("BumpEngine::Compute(5 sensitivities, vectorized)", OptionBatchView euroView = euroBatch().View(); vector<double>& b = bumped(),
+						bumpEuro.Compute(euroView, b.data()); out[0] = b[0])
+		BATCH_BENCHMARK("ScenarioGrid::Evaluate(price)", ScenarioGrid& g = grid(), g.Evaluate(Option::PriceOutput, 4096, gridSink))
+		BATCH_BENCHMARK("ScenarioGrid::Evaluate", ScenarioGrid& g = grid(), g.Evaluate(Option::AllOutputs, 4096, gridSink))
+		BATCH_BENCHMARK("Portfolio::Total", Portfolio& p = portfolio(), out[0] = p.Total().totals.price)
+		BATCH_BENCHMARK("Portfolio::Aggregate(all keys)", Portfolio& p = portfolio(), out[0] = p.Aggregate(allKeys)[0].totals.price)
+		BATCH_BENCHMARK("Portfolio::Aggregate(all keys, parallel)", Portfolio& p = portfolio(),
+						out[0] = p.Aggregate(allKeys, Option::AllOutputs, pool)[0].totals.price)
+		BATCH_BENCHMARK("ScenarioEngine::ProfitAndLoss(20 scenarios)", ScenarioEngine& e = stress(), out[0] = e.ProfitAndLoss()[0])
+		BATCH_BENCHMARK("ScenarioEngine::ProfitAndLoss(20 scenarios, parallel)", ScenarioEngine& e = stress(), out[0] = e.ProfitAndLoss(pool)[0])
+		BATCH_BENCHMARK("SurfaceGenerator::Generate(price, delta, gamma)", SurfaceGenerator& g = surface(),
+						g.Generate(surfaceOutputs); out[0] = g.Surface(Option::PriceOutput)[0])
+		BATCH_BENCHMARK("SurfaceGenerator::Generate(price, delta, gamma, parallel)", SurfaceGenerator& g = surface(),
+						g.Generate(surfaceOutputs, pool); out[0] = g.Surface(Option::PriceOutput)[0])
+		BATCH_BENCHMARK("TermStructureBatch::SetMarket", TermStructureBatch& t = termBook(), t.SetMarket(curves); out[0] = t.Discount(0))
+		BATCH_BENCHMARK("TermStructureBatch::Price", TermStructureBatch& t = termBook(), t.Price(out.data()))
+		BATCH_BENCHMARK("TermStructureBatch::Price(parallel)", TermStructureBatch& t = termBook(), t.Price(out.data(), pool))
+		BATCH_BENCHMARK("SpotTickRepricer::Reprice", SpotTickRepricer& t = repricer(),
+						t.SetSpot(0, 100 + 0.01 * (++ticks & 1)); t.Reprice(); out[0] = t.GetResults(0).price)
+
+#undef BATCH_BENCHMARK
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	BenchmarkSettings settings = ParseArguments(argc, argv);
+
+	ofstream file;
+	if (!settings.output.empty())
+		file.open(settings.output.c_str());
+
+	BenchmarkOutput output = { settings.output.empty() ? &cout : &file, settings.format == "json", 0 };
+	BeginOutput(output);
+	BenchmarkScalarFunctions(settings, output);
+	BenchmarkBatchFunctions(settings, output);
+	EndOutput(output);
+
+	return 0;
+}
@@ -0,0 +1,73 @@
+// BoundedQueue.hpp
+//
+// The purpose of the BoundedQueue class template is to connect the stages of a pipeline running on separate threads. Push blocks
+// while the queue holds capacity items and Pop blocks while it is empty, so a fast producer is held back to the pace of its consumer
+// and the memory held between two stages never exceeds capacity items. Close marks the end of the stream: pushes are refused and
+// Pop returns false once the remaining items have been drained.
+
+#ifndef BoundedQueue_H
+#define BoundedQueue_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+template <typename T>
+class BoundedQueue
+{
+private:
+	std::mutex lock;
+	std::condition_variable notFull;											// Signalled when an item is popped or the queue is closed
+	std::condition_variable notEmpty;											// Signalled when an item is pushed or the queue is closed
+	std::deque<T> items;
+	std::size_t capacity;														// Maximum number of items held at once
+	bool closed;																// Set by Close
+
+	BoundedQueue(const BoundedQueue&);											// Not copyable
+	BoundedQueue& operator = (const BoundedQueue&);								// Not assignable
+
+public:
+	// Constructors and Destructor
+	explicit BoundedQueue(std::size_t maxItems) : capacity((maxItems > 0) ? maxItems : 1), closed(false) {}
+
+	// Waits for room and appends item; returns false, dropping item, if the queue has been closed
+	bool Push(T item)
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		notFull.wait(guard, [this] { return closed || items.size() < capacity; });
+		if (closed)
+			return false;
+
+		items.push_back(std::move(item));
+		notEmpty.notify_one();
+		return true;
+	}
+
+	// Waits for an item and moves it into item; returns false once the queue is closed and empty
+	bool Pop(T& item)
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		notEmpty.wait(guard, [this] { return closed || !items.empty(); });
+		if (items.empty())
+			return false;
+
+		item = std::move(items.front());
+		items.pop_front();
+		notFull.notify_one();
+		return true;
+	}
+
+	// Ends the stream; waiting producers and consumers are released
+	void Close()
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		closed = true;
+		notFull.notify_all();
+		notEmpty.notify_all();
+	}
+};
+
+
+#endif
@@ -0,0 +1,230 @@
+// BsmKernel.cpp
+
+#include "BsmKernel.hpp"
+#include "EuropeanOption.hpp"
+#include "OptionKernels.hpp"
+
+#if defined(_MSC_VER) && defined(BSM_KERNEL_X86)
+#include <intrin.h>
+#endif
+
+// Entry points of the instruction-set specific translation units; each namespace is defined by including BsmKernelImpl.hpp
+#if defined(BSM_KERNEL_X86)
+#define BSM_KERNEL_DECLARE(ns)																				\
+	namespace ns																							\
+	{																										\
+		void Price(const OptionBatchView& view, double* result);											\
+		void Delta(const OptionBatchView& view, double* result);											\
+		void Gamma(const OptionBatchView& view, double* result);											\
+		void Theta(const OptionBatchView& view, double* result);											\
+		void Vega(const OptionBatchView& view, double* result);												\
+		void Evaluate(const OptionBatchView& view, int outputs, OptionResults* result);						\
+		void Price(const FloatBatchView& view, double* result);												\
+		void Delta(const FloatBatchView& view, double* result);												\
+		void Gamma(const FloatBatchView& view, double* result);												\
+		void Theta(const FloatBatchView& view, double* result);												\
+		void Vega(const FloatBatchView& view, double* result);												\
+		void Evaluate(const FloatBatchView& view, int outputs, OptionResults* result);						\
+	}
+
+BSM_KERNEL_DECLARE(BsmKernelSse2)
+BSM_KERNEL_DECLARE(BsmKernelAvx2)
+BSM_KERNEL_DECLARE(BsmKernelAvx512)
+#endif
+
+namespace
+{
+	// Returns the instruction set currently selected; initialized to the widest supported one on first use
+	BsmKernel::Isa& CurrentIsa()
+	{
+		static BsmKernel::Isa isa = BsmKernel::DetectIsa();
+		return isa;
+	}
+
+	typedef double (EuropeanOption::*EuropeanMember)(double, double, double, double) const;
+
+	// Scalar fallback; evaluates every row through the given EuropeanOption member function
+	void ScalarLoop(const OptionBatchView& view, double* result, EuropeanMember member)
+	{
+		for (size_t i = 0; i < view.rows; i++)
+		{
+			EuropeanOption option((view.type[i] == 1) ? 'C' : 'P', view.K[i], view.T[i]);
+			result[i] = (option.*member)(view.S[i], view.sig[i], view.r[i], view.b[i]);
+		}
+	}
+
+	// Scalar fallback of Evaluate
+	void ScalarEvaluate(const OptionBatchView& view, int outputs, OptionResults* result)
+	{
+		for (size_t i = 0; i < view.rows; i++)
+		{
+			EuropeanOption option((view.type[i] == 1) ? 'C' : 'P', view.K[i], view.T[i]);
+			result[i] = option.Evaluate(view.S[i], view.sig[i], view.r[i], view.b[i], outputs);
+		}
+	}
+
+	// Scalar fallback of the single precision functions; evaluates every row through the float Euro kernel of its type
+	template <typename Result, typename Function>
+	void FloatScalarLoop(const FloatBatchView& view, Result* result, Function function)
+	{
+		for (size_t i = 0; i < view.rows; i++)
+			result[i] = (view.type[i] == 1) ? function(EuropeanKernel<CallOption, float>(), i) : function(EuropeanKernel<PutOption, float>(), i);
+	}
+}
+
+// Dispatches a call of one of the batch functions to the implementation for the currently selected instruction set, or to fallback
+#if defined(BSM_KERNEL_X86)
+#define BSM_KERNEL_DISPATCH(call, fallback)																	\
+	switch (CurrentIsa())																					\
+	{																										\
+	case Avx512:	BsmKernelAvx512::call;	break;															\
+	case Avx2:		BsmKernelAvx2::call;	break;															\
+	case Sse2:		BsmKernelSse2::call;	break;															\
+	default:		fallback;																				\
+	}
+#else
+#define BSM_KERNEL_DISPATCH(call, fallback)	fallback;
+#endif
+
+// Scalar fallback of a single precision function returning the given member of the float Euro kernel for every row
+#define BSM_KERNEL_FLOAT_FALLBACK(function)																	\
+	FloatScalarLoop(view, result, [&view](auto kernel, size_t i)											\
+	{																										\
+		return decltype(kernel)::function(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i]);	\
+	})
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the widest instruction set supported by both the CPU and the operating system
+BsmKernel::Isa BsmKernel::DetectIsa()
+{
+#if defined(BSM_KERNEL_X86) && (defined(__GNUC__) || defined(__clang__))
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		return Avx512;
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		return Avx2;
+	return Sse2;
+#elif defined(BSM_KERNEL_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool fma = (info[2] & (1 << 12)) != 0;
+	unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+	__cpuidex(info, 7, 0);
+	if ((xcr0 & 0xE6) == 0xE6 && (info[1] & (1 << 16)))
+		return Avx512;
+	if ((xcr0 & 0x6) == 0x6 && fma && (info[1] & (1 << 5)))
+		return Avx2;
+	return Sse2;
+#else
+	return Scalar;
+#endif
+}
+
+// Returns the instruction set used by the batch functions
+BsmKernel::Isa BsmKernel::GetIsa()
+{
+	return CurrentIsa();
+}
+
+// Returns a printable name for isa
+const char* BsmKernel::IsaName(Isa isa)
+{
+	switch (isa)
+	{
+	case Avx512:	return "avx512";
+	case Avx2:		return "avx2";
+	case Sse2:		return "sse2";
+	default:		return "scalar";
+	}
+}
+
+// Writes the Black-Scholes-Merton price of every row of view into result
+void BsmKernel::Price(const OptionBatchView& view, double* result)
+{
+	BSM_KERNEL_DISPATCH(Price(view, result), ScalarLoop(view, result, &EuropeanOption::Price))
+}
+
+// Writes the Black-Scholes-Merton delta of every row of view into result
+void BsmKernel::Delta(const OptionBatchView& view, double* result)
+{
+	BSM_KERNEL_DISPATCH(Delta(view, result), ScalarLoop(view, result, &EuropeanOption::Delta))
+}
+
+// Writes the Black-Scholes-Merton gamma of every row of view into result
+void BsmKernel::Gamma(const OptionBatchView& view, double* result)
+{
+	BSM_KERNEL_DISPATCH(Gamma(view, result), ScalarLoop(view, result, &EuropeanOption::Gamma))
+}
+
+// Writes the Black-Scholes-Merton theta of every row of view into result
+void BsmKernel::Theta(const OptionBatchView& view, double* result)
+{
+	BSM_KERNEL_DISPATCH(Theta(view, result), ScalarLoop(view, result, &EuropeanOption::Theta))
+}
+
+// Writes the Black-Scholes-Merton vega of every row of view into result
+void BsmKernel::Vega(const OptionBatchView& view, double* result)
+{
+	BSM_KERNEL_DISPATCH(Vega(view, result), ScalarLoop(view, result, &EuropeanOption::Vega))
+}
+
+// Writes the outputs selected by outputs of every row of view into result in one pass
+void BsmKernel::Evaluate(const OptionBatchView& view, int outputs, OptionResults* result)
+{
+	BSM_KERNEL_DISPATCH(Evaluate(view, outputs, result), ScalarEvaluate(view, outputs, result))
+}
+
+// Writes the single precision Black-Scholes-Merton price of every row of view into result
+void BsmKernel::Price(const FloatBatchView& view, double* result)
+{
+	BSM_KERNEL_DISPATCH(Price(view, result), BSM_KERNEL_FLOAT_FALLBACK(Price))
+}
+
+// Writes the single precision Black-Scholes-Merton delta of every row of view into result
+void BsmKernel::Delta(const FloatBatchView& view, double* result)
+{
+	BSM_KERNEL_DISPATCH(Delta(view, result), BSM_KERNEL_FLOAT_FALLBACK(Delta))
+}
+
+// Writes the single precision Black-Scholes-Merton gamma of every row of view into result
+void BsmKernel::Gamma(const FloatBatchView& view, double* result)
+{
+	BSM_KERNEL_DISPATCH(Gamma(view, result), BSM_KERNEL_FLOAT_FALLBACK(Gamma))
+}
+
+// Writes the single precision Black-Scholes-Merton theta of every row of view into result
+void BsmKernel::Theta(const FloatBatchView& view, double* result)
+{
+	BSM_KERNEL_DISPATCH(Theta(view, result), BSM_KERNEL_FLOAT_FALLBACK(Theta))
+}
+
+// Writes the single precision Black-Scholes-Merton vega of every row of view into result
+void BsmKernel::Vega(const FloatBatchView& view, double* result)
+{
+	BSM_KERNEL_DISPATCH(Vega(view, result), BSM_KERNEL_FLOAT_FALLBACK(Vega))
+}
+
+// Writes the single precision outputs selected by outputs of every row of view into result in one pass
+void BsmKernel::Evaluate(const FloatBatchView& view, int outputs, OptionResults* result)
+{
+	BSM_KERNEL_DISPATCH(Evaluate(view, outputs, result), FloatScalarLoop(view, result, [&view, outputs](auto kernel, size_t i)
+	{
+		return decltype(kernel)::Evaluate(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i], outputs);
+	}))
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Selects the instruction set used by the batch functions; a request for a wider set than the machine supports is lowered to the
+// widest supported one
+void BsmKernel::SetIsa(Isa isa)
+{
+	Isa widest = DetectIsa();
+	CurrentIsa() = (isa > widest) ? widest : isa;
+}
@@ -0,0 +1,80 @@
+// BsmKernel.hpp
+//
+// The purpose of the BsmKernel class is to evaluate the Black-Scholes-Merton price and Greeks of many Euro options at once. Its
+// static member functions take an OptionBatchView whose rows are all Euro options (the kind column is not consulted) and write one
+// result per row. Unlike the EuropeanOption member functions, which evaluate log, exp, sqrt and the normal CDF/PDF one contract at a
+// time, the kernel evaluates them for 2, 4 or 8 contracts per instruction using the vectorized approximations in SimdMath.hpp.
+//
+// The instruction set is chosen at run time: on first use the kernel picks the widest of AVX-512, AVX2 (with FMA) and SSE2 that the
+// CPU and operating system support, and SetIsa can be used to force a narrower one. The Scalar setting routes every row through
+// the EuropeanOption member functions, so it reproduces the existing scalar path exactly, and it is the only setting available
+// on non-x86 targets.
+//
+// Accuracy against the scalar path (EuropeanOption member functions), measured over 8 x 10^6 random contracts (eight seeds of 10^6)
+// with S, K in [1, 500], sig in [0.01, 2], r in [-0.05, 0.25], b in [-0.25, 0.25], T in [0.002, 30] and both option types, the same
+// on SSE2, AVX2 and AVX-512:
+//		Price		max |error| / max(1, |price|) < 9e-14
+//		Delta		max |error| / max(1, |delta|) < 4e-13
+//		Gamma		max relative error < 6e-13
+//		Theta		max |error| / max(1, |theta|) < 8e-14
+//		Vega		max relative error < 6e-13
+// The largest delta differences occur for deep in-the-money puts, where the scalar path's e^((b-r)T) * (N(d_1) - 1) cancels and the
+// kernel's -e^((b-r)T) * N(-d_1) does not. The gamma and vega relative errors grow with d_1^2 through the e^(-d_1^2 / 2) of n(d_1),
+// and the largest occur far from the money at low volatility (d_1 around 30, where gamma is near 1e-212).
+//
+// Throughput over 10^5 of the same random contracts, the minimum over 120 passes on an AVX-512 capable server core, was 19 ns per
+// price (AVX-512), 26 ns (AVX2) and 79 ns (SSE2), against 112 ns for the scalar path, EuropeanOption::Price. Over near-the-money
+// contracts the scalar path takes 65 to 70 ns per price (see NormalDistribution.hpp); with the boost normal distribution it used
+// before NormalDistribution, it took 670 ns.
+//
+// Each function also has an overload over a FloatBatchView, which evaluates in single precision with twice the lanes of the double
+// version (4, 8 or 16 contracts per instruction) and widens the results to double; see PrecisionBatch. Against the double kernel on
+// the same float inputs, over the ranges above, the price and theta errors are < 3e-5 * max(1, |value|) and the delta, gamma and vega
+// errors < 7e-6 * max(1, |value|) (gamma and vega < 7e-5 relative). Measured as above, the throughput was 10 ns per price in single
+// precision (AVX-512) against 19 ns in double.
+
+#ifndef BsmKernel_H
+#define BsmKernel_H
+
+#include "OptionBatch.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BSM_KERNEL_X86
+#endif
+
+class BsmKernel
+{
+public:
+	enum Isa { Scalar = 0, Sse2 = 1, Avx2 = 2, Avx512 = 3 };
+
+	// Accessor Functions
+	static Isa DetectIsa();														// Returns the widest instruction set the CPU and OS support
+	static Isa GetIsa();														// Returns the instruction set used by the functions below
+	static const char* IsaName(Isa isa);										// Returns a printable name for isa
+
+	// Batch Functions -- every row of view must represent a Euro option; result must hold view.rows doubles
+	static void Price(const OptionBatchView& view, double* result);				// Writes the Black-Scholes-Merton price of every row
+	static void Delta(const OptionBatchView& view, double* result);				// Writes the Black-Scholes-Merton delta of every row
+	static void Gamma(const OptionBatchView& view, double* result);				// Writes the Black-Scholes-Merton gamma of every row
+	static void Theta(const OptionBatchView& view, double* result);				// Writes the Black-Scholes-Merton theta of every row
+	static void Vega(const OptionBatchView& view, double* result);				// Writes the Black-Scholes-Merton vega of every row
+	static void Evaluate(const OptionBatchView& view, int outputs, OptionResults* result);
+																				// Writes the outputs selected by the Option::Outputs flags
+																				// of every row in one pass; the other fields are set to 0
+
+	// Single precision batch functions -- the same, over float columns and computed in float arithmetic with twice the lanes per
+	// instruction; results are widened to double
+	static void Price(const FloatBatchView& view, double* result);
+	static void Delta(const FloatBatchView& view, double* result);
+	static void Gamma(const FloatBatchView& view, double* result);
+	static void Theta(const FloatBatchView& view, double* result);
+	static void Vega(const FloatBatchView& view, double* result);
+	static void Evaluate(const FloatBatchView& view, int outputs, OptionResults* result);
+
+	// Modifier Functions
+	static void SetIsa(Isa isa);												// Selects the instruction set; requests wider than DetectIsa() are
+																				// lowered to DetectIsa(). Not thread safe with respect to running kernels
+};
+
+
+#endif
@@ -0,0 +1,31 @@
+// BsmKernelAvx2.cpp
+//
+// AVX2 and FMA instantiation of the BSM batch kernels defined in BsmKernelImpl.hpp. The target instructions are enabled for this file
+// only, through the pragmas below, so the rest of the program can be compiled for the baseline instruction set; BsmKernel.cpp only
+// calls into this file after checking at run time that the CPU supports AVX2 and FMA.
+
+#include "BsmKernel.hpp"
+
+#if defined(BSM_KERNEL_X86)
+
+#include <cstddef>
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+#define SIMD_MATH_AVX2
+#define BSM_KERNEL_NAMESPACE BsmKernelAvx2
+#include "BsmKernelImpl.hpp"
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
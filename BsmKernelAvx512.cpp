@@ -0,0 +1,45 @@
+// BsmKernelAvx512.cpp
+//
+// AVX-512F instantiation of the BSM batch kernels defined in BsmKernelImpl.hpp. The target instructions are enabled for this file
+// only, through the pragmas below, so the rest of the program can be compiled for the baseline instruction set; BsmKernel.cpp only
+// calls into this file after checking at run time that the CPU supports AVX-512F.
+//
+// GCC reports the masked and undefined-value intrinsics of avx512fintrin.h (_mm512_undefined_pd and the like) as uninitialized uses
+// once they are inlined into the kernels; those warnings are silenced for the intrinsics header and the kernel body only.
+
+#include "BsmKernel.hpp"
+
+#if defined(BSM_KERNEL_X86)
+
+#include <cstddef>
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx512f"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+
+#define SIMD_MATH_AVX512
+#define BSM_KERNEL_NAMESPACE BsmKernelAvx512
+#include "BsmKernelImpl.hpp"
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
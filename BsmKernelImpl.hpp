@@ -0,0 +1,217 @@
+// BsmKernelImpl.hpp
+//
+// Width-independent body of the BSM batch kernels. This file is included once by each instruction-set specific translation unit
+// after it has selected a SimdVec width and enabled the matching target instructions, and it places its functions in the namespace
+// named by BSM_KERNEL_NAMESPACE. It must not be included anywhere else.
+//
+// Every kernel computes, for W contracts at a time, the common subexpressions sqrt(T), sig * sqrt(T), d_1, d_2, exp((b - r) * T)
+// and exp(-r * T), and then combines them with the option type phi = +1 (call) or -1 (put) using the type-symmetric forms
+//		Price = phi * (S * e^((b-r)T) * N(phi * d_1) - K * e^(-rT) * N(phi * d_2))
+//		Delta = phi * e^((b-r)T) * N(phi * d_1)
+//		Theta = -S * sig * e^((b-r)T) * n(d_1) / (2 * sqrt(T)) - phi * (b - r) * S * e^((b-r)T) * N(phi * d_1) - phi * r * K * e^(-rT) * N(phi * d_2)
+// so that calls and puts share one branch-free instruction stream. A trailing partial block is copied into a padded local block so
+// that every row is evaluated by the same instructions regardless of its position in the batch.
+//
+// The same code is instantiated twice: over SimdVec for OptionBatchView, and over SimdVecF, with twice the lanes, for FloatBatchView.
+// Results are written as doubles in both cases; the float lanes are widened as they are stored.
+
+#include "SimdMath.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace BSM_KERNEL_NAMESPACE
+{
+	namespace
+	{
+		// Holds the subexpressions shared by the price and every Greek for one block of V::Width contracts
+		template <typename V>
+		struct Common
+		{
+			V S, sig, r, b, phi, K, T;
+			V sqrtT, sigSqrtT, d1, d2, carryFactor, discountFactor;
+		};
+
+		template <typename V, typename Real>
+		inline Common<V> LoadCommon(const Real* S, const Real* sig, const Real* r, const Real* b, const Real* type, const Real* K,
+									const Real* T)
+		{
+			Common<V> c;
+			c.S = Load(S);
+			c.sig = Load(sig);
+			c.r = Load(r);
+			c.b = Load(b);
+			c.phi = Load(type);
+			c.K = Load(K);
+			c.T = Load(T);
+
+			c.sqrtT = Sqrt(c.T);
+			c.sigSqrtT = c.sig * c.sqrtT;
+			c.d1 = (Log(c.S / c.K) + (c.b + V(0.5) * c.sig * c.sig) * c.T) / c.sigSqrtT;
+			c.d2 = c.d1 - c.sigSqrtT;
+			c.carryFactor = Exp((c.b - c.r) * c.T);
+			c.discountFactor = Exp(-c.r * c.T);
+			return c;
+		}
+
+		template <typename V>
+		inline V PriceBlock(const Common<V>& c)
+		{
+			return c.phi * (c.S * c.carryFactor * NormCdf(c.phi * c.d1) - c.K * c.discountFactor * NormCdf(c.phi * c.d2));
+		}
+
+		template <typename V>
+		inline V DeltaBlock(const Common<V>& c)
+		{
+			return c.phi * c.carryFactor * NormCdf(c.phi * c.d1);
+		}
+
+		template <typename V>
+		inline V GammaBlock(const Common<V>& c)
+		{
+			return NormPdf(c.d1) * c.carryFactor / (c.S * c.sigSqrtT);
+		}
+
+		template <typename V>
+		inline V ThetaBlock(const Common<V>& c)
+		{
+			V firstTerm = -(c.S * c.sig * c.carryFactor * NormPdf(c.d1)) / (V(2.0) * c.sqrtT);
+			V secondTerm = -(c.phi * (c.b - c.r) * c.S * c.carryFactor * NormCdf(c.phi * c.d1));
+			V thirdTerm = -(c.phi * c.r * c.K * c.discountFactor * NormCdf(c.phi * c.d2));
+			return firstTerm + secondTerm + thirdTerm;
+		}
+
+		template <typename V>
+		inline V VegaBlock(const Common<V>& c)
+		{
+			return c.S * c.sqrtT * c.carryFactor * NormPdf(c.d1);
+		}
+
+		// Writes the outputs selected by outputs of one block into out, one array per output in the order price, delta, gamma, theta,
+		// vega; N(phi * d_1), N(phi * d_2) and n(d_1) are each evaluated once, and only if a selected output needs them
+		template <typename V, typename Real>
+		inline void EvaluateBlock(const Common<V>& c, int outputs, Real (*out)[V::Width])
+		{
+			V cdf1(0.0), cdf2(0.0), pdf1(0.0);
+			if (outputs & (Option::PriceOutput | Option::DeltaOutput | Option::ThetaOutput))
+				cdf1 = NormCdf(c.phi * c.d1);
+			if (outputs & (Option::PriceOutput | Option::ThetaOutput))
+				cdf2 = NormCdf(c.phi * c.d2);
+			if (outputs & (Option::GammaOutput | Option::ThetaOutput | Option::VegaOutput))
+				pdf1 = NormPdf(c.d1);
+
+			V discountedSpot = c.S * c.carryFactor;
+			V discountedStrike = c.K * c.discountFactor;
+			if (outputs & Option::PriceOutput)
+				Store(out[0], c.phi * (discountedSpot * cdf1 - discountedStrike * cdf2));
+			if (outputs & Option::DeltaOutput)
+				Store(out[1], c.phi * c.carryFactor * cdf1);
+			if (outputs & Option::GammaOutput)
+				Store(out[2], pdf1 * c.carryFactor / (c.S * c.sigSqrtT));
+			if (outputs & Option::ThetaOutput)
+				Store(out[3], -(discountedSpot * c.sig * pdf1) / (V(2.0) * c.sqrtT) - c.phi * (c.b - c.r) * discountedSpot * cdf1
+							  - c.phi * c.r * discountedStrike * cdf2);
+			if (outputs & Option::VegaOutput)
+				Store(out[4], discountedSpot * c.sqrtT * pdf1);
+		}
+
+		// Stores one block of results; double lanes are stored directly, float lanes are widened
+		inline void StoreResult(double* result, SimdVec a)
+		{
+			Store(result, a);
+		}
+
+		inline void StoreResult(double* result, SimdVecF a)
+		{
+			float out[SimdVecF::Width];
+			Store(out, a);
+			for (int j = 0; j < SimdVecF::Width; j++)
+				result[j] = out[j];
+		}
+
+		// Copies rows [i, view.rows) of view into the local block columns, filling the lanes past the last row with a harmless
+		// at-the-money contract so that no lane produces a floating point exception
+		template <typename View, typename Real, size_t W>
+		inline void PadBlock(const View& view, size_t i, Real (&columns)[7][W])
+		{
+			for (size_t j = 0; j < W; j++)
+			{
+				bool live = (i + j < view.rows);
+				columns[0][j] = live ? view.S[i + j] : 1;
+				columns[1][j] = live ? view.sig[i + j] : 1;
+				columns[2][j] = live ? view.r[i + j] : 0;
+				columns[3][j] = live ? view.b[i + j] : 0;
+				columns[4][j] = live ? view.type[i + j] : 1;
+				columns[5][j] = live ? view.K[i + j] : 1;
+				columns[6][j] = live ? view.T[i + j] : 1;
+			}
+		}
+
+		// Applies block to every row of view, V::Width rows at a time, and handles the trailing partial block through padded copies
+		template <typename V, V (*block)(const Common<V>&), typename View>
+		void Run(const View& view, double* result)
+		{
+			typedef typename remove_const<typename remove_pointer<decltype(view.S)>::type>::type Real;
+			const size_t W = V::Width;
+			size_t i = 0;
+			for (; i + W <= view.rows; i += W)
+				StoreResult(result + i, block(LoadCommon<V>(view.S + i, view.sig + i, view.r + i, view.b + i, view.type + i, view.K + i, view.T + i)));
+
+			if (i < view.rows)
+			{
+				Real columns[7][W];
+				double out[W];
+				PadBlock(view, i, columns);
+				StoreResult(out, block(LoadCommon<V>(columns[0], columns[1], columns[2], columns[3], columns[4], columns[5], columns[6])));
+				for (size_t j = 0; i + j < view.rows; j++)
+					result[i + j] = out[j];
+			}
+		}
+
+		// Evaluates the outputs selected by outputs for every row of view, V::Width rows at a time; unselected fields are set to 0
+		template <typename V, typename View>
+		void RunEvaluate(const View& view, int outputs, OptionResults* result)
+		{
+			typedef typename remove_const<typename remove_pointer<decltype(view.S)>::type>::type Real;
+			const size_t W = V::Width;
+			Real out[5][W];
+			for (size_t k = 0; k < 5; k++)
+			{
+				for (size_t j = 0; j < W; j++)
+					out[k][j] = 0;
+			}
+
+			for (size_t i = 0; i < view.rows; i += W)
+			{
+				if (i + W <= view.rows)
+					EvaluateBlock(LoadCommon<V>(view.S + i, view.sig + i, view.r + i, view.b + i, view.type + i, view.K + i, view.T + i), outputs, out);
+				else
+				{
+					Real columns[7][W];
+					PadBlock(view, i, columns);
+					EvaluateBlock(LoadCommon<V>(columns[0], columns[1], columns[2], columns[3], columns[4], columns[5], columns[6]), outputs, out);
+				}
+
+				for (size_t j = 0; j < W && i + j < view.rows; j++)
+				{
+					OptionResults row = { out[0][j], out[1][j], out[2][j], out[3][j], out[4][j] };
+					result[i + j] = row;
+				}
+			}
+		}
+	}
+
+	void Price(const OptionBatchView& view, double* result) { Run<SimdVec, PriceBlock<SimdVec> >(view, result); }
+	void Delta(const OptionBatchView& view, double* result) { Run<SimdVec, DeltaBlock<SimdVec> >(view, result); }
+	void Gamma(const OptionBatchView& view, double* result) { Run<SimdVec, GammaBlock<SimdVec> >(view, result); }
+	void Theta(const OptionBatchView& view, double* result) { Run<SimdVec, ThetaBlock<SimdVec> >(view, result); }
+	void Vega(const OptionBatchView& view, double* result) { Run<SimdVec, VegaBlock<SimdVec> >(view, result); }
+	void Evaluate(const OptionBatchView& view, int outputs, OptionResults* result) { RunEvaluate<SimdVec>(view, outputs, result); }
+
+	void Price(const FloatBatchView& view, double* result) { Run<SimdVecF, PriceBlock<SimdVecF> >(view, result); }
+	void Delta(const FloatBatchView& view, double* result) { Run<SimdVecF, DeltaBlock<SimdVecF> >(view, result); }
+	void Gamma(const FloatBatchView& view, double* result) { Run<SimdVecF, GammaBlock<SimdVecF> >(view, result); }
+	void Theta(const FloatBatchView& view, double* result) { Run<SimdVecF, ThetaBlock<SimdVecF> >(view, result); }
+	void Vega(const FloatBatchView& view, double* result) { Run<SimdVecF, VegaBlock<SimdVecF> >(view, result); }
+	void Evaluate(const FloatBatchView& view, int outputs, OptionResults* result) { RunEvaluate<SimdVecF>(view, outputs, result); }
+}
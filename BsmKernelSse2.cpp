@@ -0,0 +1,31 @@
+// BsmKernelSse2.cpp
+//
+// SSE2 instantiation of the BSM batch kernels defined in BsmKernelImpl.hpp. The target instructions are enabled for this file
+// only, through the pragmas below, so the rest of the program can be compiled for the baseline instruction set; BsmKernel.cpp only
+// calls into this file after checking at run time that the CPU supports SSE2.
+
+#include "BsmKernel.hpp"
+
+#if defined(BSM_KERNEL_X86)
+
+#include <cstddef>
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#define SIMD_MATH_SSE2
+#define BSM_KERNEL_NAMESPACE BsmKernelSse2
+#include "BsmKernelImpl.hpp"
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
@@ -0,0 +1,379 @@
+// BumpEngine.cpp
+
+#include "BumpEngine.hpp"
+#include "Instrumentation.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+
+namespace
+{
+	const size_t defaultBlockRows = 256;
+
+	// OptionBatch::Price is overloaded, so the static version has to be named by its type
+	void DefaultPricer(const OptionBatchView& view, double* result)
+	{
+		OptionBatch::Price(view, result);
+	}
+
+	// Returns the central difference of order order from the prices v of a four-entry stencil, with steps h and k
+	double Difference(BumpEngine::Order order, const double* v, double h, double k)
+	{
+		switch (order)
+		{
+		case BumpEngine::FirstOrder:	return (v[0] - v[1]) / (2 * h);
+		case BumpEngine::SecondOrder:	return (v[0] - 2 * v[2] + v[1]) / (h * h);
+		default:						return (v[0] - v[1] - v[2] + v[3]) / (4 * h * k);
+		}
+	}
+}
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor
+BumpEngine::BumpEngine() : richardson(true), blockRows(defaultBlockRows), pricer(DefaultPricer)
+{
+	fill(steps, steps + parameterCount, 0.0);
+	BuildScenarios();
+}
+
+// Value constructor
+BumpEngine::BumpEngine(const BatchPricer& batchPricer) : richardson(true), blockRows(defaultBlockRows), pricer(batchPricer)
+{
+	fill(steps, steps + parameterCount, 0.0);
+	BuildScenarios();
+}
+
+// Copy constructor
+BumpEngine::BumpEngine(const BumpEngine& engine) : specs(engine.specs), scenarios(engine.scenarios), stencils(engine.stencils),
+												   richardson(engine.richardson), blockRows(engine.blockRows), pricer(engine.pricer)
+{
+	copy(engine.steps, engine.steps + parameterCount, steps);
+}
+
+// Destructor
+BumpEngine::~BumpEngine()
+{
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the number of sensitivities requested
+size_t BumpEngine::SpecCount() const
+{
+	return specs.size();
+}
+
+// Returns sensitivity index
+const BumpEngine::BumpSpec& BumpEngine::GetSpec(size_t index) const
+{
+	return specs[index];
+}
+
+// Returns the number of distinct scenarios, the unbumped one included, that are priced for every row
+size_t BumpEngine::ScenarioCount() const
+{
+	return scenarios.size();
+}
+
+// Returns the step set for parameter with SetStep; 0 means that the automatic step is used
+double BumpEngine::GetStep(Parameter parameter) const
+{
+	return steps[parameter];
+}
+
+// Returns whether Richardson extrapolation is used
+bool BumpEngine::IsRichardson() const
+{
+	return richardson;
+}
+
+// Returns the step used for parameter when it has value value: the step set with SetStep, or else the automatic one, limited to a
+// quarter of the value for sig and T and rounded so that value + step is exactly representable
+double BumpEngine::Step(Parameter parameter, double value) const
+{
+	double h = (steps[parameter] > 0) ? steps[parameter] : AutomaticStep(parameter, value, richardson);
+	if (parameter == Vol || parameter == Maturity)
+		h = min(h, max(value, 0.0) / 4);
+
+	return (value + h) - value;
+}
+
+// Writes SpecCount() sensitivities for every row of view into result, result[i * SpecCount() + j] holding sensitivity j of row i
+void BumpEngine::Compute(const OptionBatchView& view, double* result) const
+{
+	INSTRUMENT_SCOPE("BumpEngine::Compute");
+	ComputeRange(view, 0, view.rows, result);
+}
+
+// Returns SpecCount() sensitivities for every row of view, in the layout described above
+vector<double> BumpEngine::Compute(const OptionBatchView& view) const
+{
+	vector<double> resultVect(view.rows * specs.size());
+	Compute(view, resultVect.data());
+	return resultVect;
+}
+
+// Parallel version of Compute; the rows are divided into chunks, each of which is computed with buffers of its own
+void BumpEngine::Compute(const OptionBatchView& view, double* result, ThreadPool& pool) const
+{
+	INSTRUMENT_SCOPE("BumpEngine::Compute(pool)");
+	pool.ParallelFor(0, view.rows, 0, [&](size_t first, size_t last) { ComputeRange(view, first, last, result); });
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Requests dV/dx for x = parameter and returns the index of the sensitivity
+size_t BumpEngine::AddFirst(Parameter parameter)
+{
+	BumpSpec spec = { FirstOrder, parameter, parameter };
+	specs.push_back(spec);
+	BuildScenarios();
+	return specs.size() - 1;
+}
+
+// Requests d^2V/dx^2 for x = parameter and returns the index of the sensitivity
+size_t BumpEngine::AddSecond(Parameter parameter)
+{
+	BumpSpec spec = { SecondOrder, parameter, parameter };
+	specs.push_back(spec);
+	BuildScenarios();
+	return specs.size() - 1;
+}
+
+// Requests d^2V/dxdy for x = first and y = second and returns the index of the sensitivity. A cross derivative of a parameter with
+// itself is a second derivative, and is requested as one.
+size_t BumpEngine::AddCross(Parameter first, Parameter second)
+{
+	if (first == second)
+		return AddSecond(first);
+
+	BumpSpec spec = { CrossOrder, first, second };
+	specs.push_back(spec);
+	BuildScenarios();
+	return specs.size() - 1;
+}
+
+// Removes every sensitivity; the steps, extrapolation setting and pricer are kept
+void BumpEngine::Clear()
+{
+	specs.clear();
+	BuildScenarios();
+}
+
+// Uses the absolute step h for parameter, or the automatic step if h is not positive
+void BumpEngine::SetStep(Parameter parameter, double h)
+{
+	steps[parameter] = (h > 0) ? h : 0;
+}
+
+// Turns Richardson extrapolation on or off; the scenarios for the half steps are added or removed accordingly
+void BumpEngine::SetRichardson(bool extrapolate)
+{
+	richardson = extrapolate;
+	BuildScenarios();
+}
+
+// Prices the scenarios with batchPricer
+void BumpEngine::SetPricer(const BatchPricer& batchPricer)
+{
+	pricer = batchPricer;
+}
+
+// Sets how many rows' scenarios are laid out and priced by one call to the pricer
+void BumpEngine::SetBlockRows(size_t rows)
+{
+	blockRows = max(rows, size_t(1));
+}
+
+// Assignment operator
+BumpEngine& BumpEngine::operator = (const BumpEngine& engine)
+{
+	if (this != &engine)
+	{
+		specs = engine.specs;
+		scenarios = engine.scenarios;
+		stencils = engine.stencils;
+		copy(engine.steps, engine.steps + parameterCount, steps);
+		richardson = engine.richardson;
+		blockRows = engine.blockRows;
+		pricer = engine.pricer;
+	}
+
+	return *this;
+}
+
+
+// -------------------------------------------------------------------------- Static Functions ------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the name of parameter as used in reports
+const char* BumpEngine::Name(Parameter parameter)
+{
+	static const char* names[parameterCount] = { "S", "sig", "r", "b", "T" };
+	return names[parameter];
+}
+
+// Returns the automatic step for parameter at value. With a relative step u, a central difference has a truncation error of order
+// u^2 (u^4 once extrapolated) and a rounding error of order eps/u for first and eps/u^2 for second derivatives; u = eps^(1/4), or
+// eps^(1/6) with extrapolation, keeps both small for either order. S, sig and T are scaled by their own size, while r and b, which
+// are often near 0, are scaled by max(|value|, 0.01).
+double BumpEngine::AutomaticStep(Parameter parameter, double value, bool richardson)
+{
+	const double eps = numeric_limits<double>::epsilon();
+	double u = richardson ? pow(eps, 1.0 / 6.0) : pow(eps, 0.25);
+
+	double scale = fabs(value);
+	if (parameter == Rate || parameter == Carry)
+		scale = max(scale, 0.01);
+
+	return u * scale;
+}
+
+
+// -------------------------------------------------------------------------- Private Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Rebuilds the list of distinct scenarios and the stencil of every spec. Bumps are counted in half steps, so the step h is an offset
+// of 2 and the Richardson half step an offset of 1; the unbumped scenario is always scenarios[0].
+void BumpEngine::BuildScenarios()
+{
+	scenarios.clear();
+	Scenario unbumped = { { 0, 0, 0, 0, 0 } };
+	scenarios.push_back(unbumped);
+
+	stencils.assign(specs.size() * 8, 0);
+	for (size_t j = 0; j < specs.size(); j++)
+	{
+		const BumpSpec& spec = specs[j];
+		for (int level = 0; level < (richardson ? 2 : 1); level++)
+		{
+			signed char unit = (level == 0) ? 2 : 1;
+			size_t* stencil = &stencils[j * 8 + level * 4];
+
+			Scenario bumped = unbumped;
+			bumped.offset[spec.first] = unit;
+			if (spec.order == CrossOrder)
+			{
+				for (int corner = 0; corner < 4; corner++)					// (+, +), (+, -), (-, +), (-, -)
+				{
+					bumped.offset[spec.first] = (corner < 2) ? unit : -unit;
+					bumped.offset[spec.second] = (corner % 2 == 0) ? unit : -unit;
+					stencil[corner] = FindScenario(bumped);
+				}
+			}
+			else
+			{
+				stencil[0] = FindScenario(bumped);
+				bumped.offset[spec.first] = -unit;
+				stencil[1] = FindScenario(bumped);
+				stencil[2] = 0;
+			}
+		}
+	}
+}
+
+// Returns the index of scenario in scenarios, adding it at the end if it is not there yet
+size_t BumpEngine::FindScenario(const Scenario& scenario)
+{
+	for (size_t s = 0; s < scenarios.size(); s++)
+	{
+		if (equal(scenario.offset, scenario.offset + parameterCount, scenarios[s].offset))
+			return s;
+	}
+
+	scenarios.push_back(scenario);
+	return scenarios.size() - 1;
+}
+
+// Computes the sensitivities of rows [first, last) of view. The rows are taken blockRows at a time: every scenario of every row of
+// the block is written to one set of columns, row by row, the columns are priced by a single call to the pricer, and the prices are
+// combined into the sensitivities.
+void BumpEngine::ComputeRange(const OptionBatchView& view, size_t first, size_t last, double* result) const
+{
+	if (first >= last || specs.empty())
+		return;
+
+	size_t n = scenarios.size();
+	size_t m = specs.size();
+	size_t block = min(blockRows, last - first);
+
+	AlignedColumn S(block * n), sig(block * n), r(block * n), b(block * n), type(block * n), K(block * n), T(block * n);
+	AlignedTagColumn kind(block * n);
+	vector<double> prices(block * n);
+	vector<double> rowSteps(block * parameterCount);
+
+	for (size_t start = first; start < last; start += block)
+	{
+		size_t rows = min(block, last - start);
+		for (size_t i = 0; i < rows; i++)
+		{
+			size_t row = start + i;
+			double base[parameterCount] = { view.S[row], view.sig[row], view.r[row], view.b[row], view.T[row] };
+			double* h = &rowSteps[i * parameterCount];
+			for (size_t p = 0; p < parameterCount; p++)
+				h[p] = Step(Parameter(p), base[p]);
+
+			for (size_t s = 0; s < n; s++)
+			{
+				double value[parameterCount];
+				for (size_t p = 0; p < parameterCount; p++)
+					value[p] = (scenarios[s].offset[p] == 0) ? base[p] : base[p] + scenarios[s].offset[p] * (0.5 * h[p]);
+
+				size_t k = i * n + s;
+				S[k] = value[Spot];
+				sig[k] = value[Vol];
+				r[k] = value[Rate];
+				b[k] = value[Carry];
+				T[k] = value[Maturity];
+				type[k] = view.type[row];
+				K[k] = view.K[row];
+				kind[k] = view.kind[row];
+			}
+		}
+
+		OptionBatchView bumped = { S.data(), sig.data(), r.data(), b.data(), type.data(), K.data(), T.data(), kind.data(), rows * n };
+		pricer(bumped, prices.data());
+
+		for (size_t i = 0; i < rows; i++)
+		{
+			const double* v = &prices[i * n];
+			const double* h = &rowSteps[i * parameterCount];
+			double* out = result + (start + i) * m;
+			for (size_t j = 0; j < m; j++)
+			{
+				const BumpSpec& spec = specs[j];
+				double hx = h[spec.first];
+				double hy = h[spec.second];
+				if (hx == 0 || hy == 0)
+				{
+					out[j] = 0;
+					continue;
+				}
+
+				double stencil[8];
+				for (int e = 0; e < (richardson ? 8 : 4); e++)
+					stencil[e] = v[stencils[j * 8 + e]];
+
+				double coarse = Difference(spec.order, stencil, hx, hy);
+				if (richardson)
+				{
+					double fine = Difference(spec.order, stencil + 4, 0.5 * hx, 0.5 * hy);
+					out[j] = (4 * fine - coarse) / 3;
+				}
+				else
+					out[j] = coarse;
+			}
+		}
+	}
+}
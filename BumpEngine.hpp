@@ -0,0 +1,122 @@
+// BumpEngine.hpp
+//
+// The purpose of the BumpEngine class is to compute finite-difference sensitivities of a whole book at once, for any option kind that
+// can be priced by a batch pricer, with or without closed-form Greeks. OptionBatch::DivDiffDelta and DivDiffGamma each reprice every
+// row up to three times on their own, at a step chosen by the caller, so asking for delta and gamma prices the unbumped book and the
+// two spot-bumped books twice, and a step that is too small loses every digit to cancellation. The engine instead takes a list of
+// sensitivities -- first and second derivatives with respect to any of S, sig, r, b and T, and cross derivatives with respect to any
+// two of them -- and works out the set of distinct bumped scenarios that they need. A scenario shared by several sensitivities (the
+// unbumped row, S + h for both delta and gamma, ...) is priced once.
+//
+// Every sensitivity is a central difference: (V(x + h) - V(x - h)) / 2h, (V(x + h) - 2V(x) + V(x - h)) / h^2 and the four-corner
+// cross difference, whose errors are O(h^2). With Richardson extrapolation (the default), each is also formed with half the step
+// and the two are combined as (4 D(h/2) - D(h)) / 3, which cancels the h^2 term and leaves an O(h^4) error. Steps are chosen per
+// row and per parameter: a positive step set with SetStep is used as is, and otherwise the step is a relative step times the
+// parameter's scale (|S|, sig, T, and max(|r|, 0.01) or max(|b|, 0.01)). The relative step, eps^(1/6) with Richardson and
+// eps^(1/4) without, balances the truncation error against the rounding error of the prices for first and second derivatives
+// alike, so that a single step per parameter serves both and their scenarios can be shared. Steps in sig and T are limited to a
+// quarter of the parameter so that no scenario has a non-positive volatility or maturity, and sensitivities to a parameter whose
+// step is 0 for a row (T for a PAMO row) are 0.
+//
+// Compute lays the scenarios of a block of rows out as one OptionBatchView, row by row, and prices it with a single call to the batch
+// pricer, OptionBatch::Price by default. A book made only of Euro options can use the OptionBatchView overload of BsmKernel::Price
+// instead, which evaluates the bumped rows several at a time.
+
+#ifndef BumpEngine_H
+#define BumpEngine_H
+
+#include "OptionBatch.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+using namespace std;
+
+class ThreadPool;
+
+class BumpEngine
+{
+public:
+	enum Parameter { Spot = 0, Vol = 1, Rate = 2, Carry = 3, Maturity = 4 };
+	enum Order { FirstOrder = 1, SecondOrder = 2, CrossOrder = 3 };
+
+	static const size_t parameterCount = 5;
+
+	// A requested sensitivity: dV/dx (FirstOrder), d^2V/dx^2 (SecondOrder) or d^2V/dxdy (CrossOrder), with x = first and y = second
+	struct BumpSpec
+	{
+		Order order;
+		Parameter first;
+		Parameter second;								// Equal to first unless order is CrossOrder
+	};
+
+private:
+	// A bumped scenario; offset[p] is the bump of parameter p in units of half its step, between -2 and 2
+	struct Scenario
+	{
+		signed char offset[parameterCount];
+	};
+
+	vector<BumpSpec> specs;								// The sensitivities, in the order their results are written
+	vector<Scenario> scenarios;							// The distinct scenarios needed by specs; scenarios[0] is the unbumped row
+	vector<size_t> stencils;							// Four scenario indices per spec for the step h followed by four for h/2;
+														// unused entries are 0
+	double steps[parameterCount];						// Steps set with SetStep; 0 selects the automatic step
+	bool richardson;									// Whether each sensitivity is extrapolated from the steps h and h/2
+	size_t blockRows;									// Rows of the book whose scenarios are priced by one call to pricer
+	BatchPricer pricer;
+
+	void BuildScenarios();								// Rebuilds scenarios and stencils from specs
+	size_t FindScenario(const Scenario& scenario);		// Returns the index of scenario in scenarios, adding it if it is absent
+
+	void ComputeRange(const OptionBatchView& view, size_t first, size_t last, double* result) const;
+														// Computes the sensitivities of rows [first, last) of view
+
+public:
+	// Constructors and Destructor
+	BumpEngine();														// Default constructor; no sensitivities, automatic steps,
+																		// Richardson extrapolation and OptionBatch::Price
+	explicit BumpEngine(const BatchPricer& batchPricer);				// Value constructor; as above but pricing with batchPricer
+	BumpEngine(const BumpEngine& engine);								// Copy constructor
+	virtual ~BumpEngine();												// Destructor
+
+
+	// Accessor Functions
+	size_t SpecCount() const;											// Returns the number of sensitivities requested
+	const BumpSpec& GetSpec(size_t index) const;						// Returns sensitivity index
+	size_t ScenarioCount() const;										// Returns the number of distinct scenarios priced per row
+	double GetStep(Parameter parameter) const;							// Returns the step set for parameter; 0 means automatic
+	bool IsRichardson() const;											// Returns whether Richardson extrapolation is used
+	double Step(Parameter parameter, double value) const;				// Returns the step used for parameter when it has value value
+
+	void Compute(const OptionBatchView& view, double* result) const;	// Writes SpecCount() sensitivities per row of view into result,
+																		// result[i * SpecCount() + j] being sensitivity j of row i
+	vector<double> Compute(const OptionBatchView& view) const;			// Returns the sensitivities in the layout described above
+	void Compute(const OptionBatchView& view, double* result, ThreadPool& pool) const;
+																		// Parallel version; blocks of rows are computed concurrently,
+																		// so the pricer must be thread safe
+
+
+	// Modifier Functions
+	size_t AddFirst(Parameter parameter);								// Requests dV/dx for x = parameter; returns the spec's index
+	size_t AddSecond(Parameter parameter);								// Requests d^2V/dx^2 for x = parameter; returns the spec's index
+	size_t AddCross(Parameter first, Parameter second);					// Requests d^2V/dxdy for x = first and y = second, which must
+																		// differ; returns the spec's index
+	void Clear();														// Removes every sensitivity
+	void SetStep(Parameter parameter, double h);						// Uses the absolute step h for parameter; h <= 0 selects the
+																		// automatic step
+	void SetRichardson(bool extrapolate);								// Turns Richardson extrapolation on or off
+	void SetPricer(const BatchPricer& batchPricer);						// Prices the scenarios with batchPricer
+	void SetBlockRows(size_t rows);										// Sets how many rows' scenarios are priced per pricer call
+	BumpEngine& operator = (const BumpEngine& engine);					// Assignment operator
+
+
+	// Static Functions
+	static const char* Name(Parameter parameter);						// Returns "S", "sig", "r", "b" or "T"
+	static double AutomaticStep(Parameter parameter, double value, bool richardson);
+																		// Returns the automatic step for parameter at value
+
+};
+
+
+#endif
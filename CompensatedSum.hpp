@@ -0,0 +1,48 @@
+// CompensatedSum.hpp
+//
+// The purpose of the CompensatedSum struct is to add up long runs of doubles without the rounding error of a plain running sum, which
+// grows with the number of terms. It keeps the running sum together with a second double holding the rounding error of every addition
+// so far (Neumaier's variant of Kahan summation, which also handles terms larger than the sum), and only folds the two together when
+// the value is read. The error of the result is then about one rounding of the exact sum, plus n eps^2 times the sum of the absolute
+// values of the terms, independently of the order of the terms for any n below 1 / eps.
+//
+// Two compensated sums can be added together without losing either's error term, so partial sums formed over separate blocks of terms
+// can be combined, for example pairwise, into a total of the same accuracy.
+
+#ifndef CompensatedSum_H
+#define CompensatedSum_H
+
+#include <cmath>
+
+struct CompensatedSum
+{
+	double sum;											// Running sum
+	double compensation;								// Accumulated rounding error of sum
+
+	// Adds term to the sum
+	void Add(double term)
+	{
+		double total = sum + term;
+		if (std::fabs(sum) >= std::fabs(term))
+			compensation += (sum - total) + term;
+		else
+			compensation += (term - total) + sum;
+		sum = total;
+	}
+
+	// Adds the terms of other to the sum
+	void Add(const CompensatedSum& other)
+	{
+		Add(other.sum);
+		compensation += other.compensation;
+	}
+
+	// Returns the compensated value of the sum
+	double Value() const
+	{
+		return sum + compensation;
+	}
+};
+
+
+#endif
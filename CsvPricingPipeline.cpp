@@ -0,0 +1,453 @@
+// CsvPricingPipeline.cpp
+
+#include "CsvPricingPipeline.hpp"
+#include "BoundedQueue.hpp"
+#include "ExactPricingMethodsGlobalFunctions.hpp"
+#include "Instrumentation.hpp"
+#include "OptionBatch.hpp"
+#include "ThreadPool.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+
+// A batch of parsed rows together with their results; batches are recycled between runs of the stages
+struct CsvPricingPipeline::Batch
+{
+	OptionBatch rows;										// Parsed rows
+	vector<char> valid;										// 0 for rows whose line could not be parsed
+	vector<OptionResults> results;							// Results of the rows, filled in by the price stage
+};
+
+namespace
+{
+	typedef chrono::steady_clock Clock;
+
+	// Returns the number of seconds elapsed since start
+	double SecondsSince(Clock::time_point start)
+	{
+		return chrono::duration<double>(Clock::now() - start).count();
+	}
+
+	// Size of the blocks read from the input; lines longer than this are handled by growing the read buffer
+	const size_t readBlockBytes = 1 << 20;
+
+	// Returns [first, last) with surrounding spaces and tabs removed
+	void Trim(const char*& first, const char*& last)
+	{
+		while (first != last && (*first == ' ' || *first == '\t'))
+			first++;
+		while (last != first && (last[-1] == ' ' || last[-1] == '\t'))
+			last--;
+	}
+
+	// Parses the whole of the field [first, last) as a number
+	bool ParseField(const char* first, const char* last, double& value)
+	{
+		Trim(first, last);
+		return ParseDouble(first, last, value) && first == last;
+	}
+}
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor
+CsvPricingPipeline::CsvPricingPipeline() : outputs(Option::AllOutputs), batchRows(65536), queueDepth(4), digits(15), pool(0),
+										   malformedRows(0), firstMalformedLine(0), stats()
+{
+}
+
+// Value constructor
+CsvPricingPipeline::CsvPricingPipeline(int outputFlags, size_t rowsPerBatch, size_t batchesPerQueue, int significantDigits) :
+	outputs(outputFlags), batchRows((rowsPerBatch > 0) ? rowsPerBatch : 1), queueDepth((batchesPerQueue > 0) ? batchesPerQueue : 1),
+	digits(significantDigits), pool(0), malformedRows(0), firstMalformedLine(0), stats()
+{
+}
+
+// Copy constructor
+CsvPricingPipeline::CsvPricingPipeline(const CsvPricingPipeline& pipeline) : outputs(pipeline.outputs), batchRows(pipeline.batchRows),
+	queueDepth(pipeline.queueDepth), digits(pipeline.digits), pool(pipeline.pool), malformedRows(pipeline.malformedRows),
+	firstMalformedLine(pipeline.firstMalformedLine), stats(pipeline.stats)
+{
+}
+
+// Destructor
+CsvPricingPipeline::~CsvPricingPipeline()
+{
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the parse, price and write statistics of the last run, in that order
+const vector<PipelineStageStats>& CsvPricingPipeline::GetStats() const
+{
+	return stats;
+}
+
+// Returns the number of lines of the last run that could not be parsed
+size_t CsvPricingPipeline::GetMalformedRows() const
+{
+	return malformedRows;
+}
+
+// Returns the line number of the first malformed line of the last run, or 0 if every line was parsed
+size_t CsvPricingPipeline::GetFirstMalformedLine() const
+{
+	return firstMalformedLine;
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Runs the parse and price stages on two new threads and the write stage on the calling thread. If writing fails every queue is
+// closed, which stops the other two stages at their next push or pop.
+bool CsvPricingPipeline::Run(istream& input, ostream& output)
+{
+	malformedRows = 0;
+	firstMalformedLine = 0;
+	stats.assign(3, PipelineStageStats());
+	stats[0].name = "parse";
+	stats[1].name = "price";
+	stats[2].name = "write";
+
+	size_t batchCount = 2 * queueDepth + 3;
+	vector<unique_ptr<Batch> > batches;
+	BoundedQueue<Batch*> freeBatches(batchCount);
+	BoundedQueue<Batch*> parsed(queueDepth);
+	BoundedQueue<Batch*> priced(queueDepth);
+	for (size_t i = 0; i < batchCount; i++)
+	{
+		batches.push_back(unique_ptr<Batch>(new Batch));
+		batches.back()->rows.Reserve(batchRows);
+		freeBatches.Push(batches.back().get());
+	}
+
+	thread parser(&CsvPricingPipeline::ParseStage, this, ref(input), ref(freeBatches), ref(parsed));
+	thread pricer(&CsvPricingPipeline::PriceStage, this, ref(parsed), ref(priced));
+
+	bool written = WriteStage(output, priced, freeBatches);
+	if (!written)
+	{
+		freeBatches.Close();
+		parsed.Close();
+		priced.Close();
+	}
+
+	parser.join();
+	pricer.join();
+	return written;
+}
+
+// Sets the pool across which the price stage splits each batch
+void CsvPricingPipeline::SetThreadPool(ThreadPool* pricingPool)
+{
+	pool = pricingPool;
+}
+
+// Assignment operator
+CsvPricingPipeline& CsvPricingPipeline::operator = (const CsvPricingPipeline& pipeline)
+{
+	if (this != &pipeline)
+	{
+		outputs = pipeline.outputs;
+		batchRows = pipeline.batchRows;
+		queueDepth = pipeline.queueDepth;
+		digits = pipeline.digits;
+		pool = pipeline.pool;
+		malformedRows = pipeline.malformedRows;
+		firstMalformedLine = pipeline.firstMalformedLine;
+		stats = pipeline.stats;
+	}
+
+	return *this;
+}
+
+
+// -------------------------------------------------------------------------- Private Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Reads input in blocks of readBlockBytes and parses every complete line of each block. The incomplete line at the end of a block
+// is moved to the front of the buffer and completed by the next read, so no line is ever copied more than once.
+void CsvPricingPipeline::ParseStage(istream& input, BoundedQueue<Batch*>& freeBatches, BoundedQueue<Batch*>& parsed)
+{
+	PipelineStageStats& stage = stats[0];
+	Clock::time_point start = Clock::now();
+	double waiting = 0;
+
+	vector<char> buffer(2 * readBlockBytes);
+	size_t carried = 0;										// Bytes of an incomplete line at the front of buffer
+	size_t lineNumber = 0;
+	bool headerChecked = false;
+	Batch* batch = 0;
+	bool open = true;
+
+	while (open)
+	{
+		if (buffer.size() - carried < readBlockBytes)
+			buffer.resize(carried + readBlockBytes);
+
+		input.read(buffer.data() + carried, buffer.size() - carried);
+		size_t received = static_cast<size_t>(input.gcount());
+		bool atEnd = (received == 0);
+		stage.bytes += received;
+
+		const char* p = buffer.data();
+		const char* stop = buffer.data() + carried + received;
+		while (p != stop && open)
+		{
+			const char* newline = static_cast<const char*>(memchr(p, '\n', stop - p));
+			if (newline == 0 && !atEnd)
+				break;
+			const char* lineEnd = (newline != 0) ? newline : stop;
+			const char* next = (newline != 0) ? newline + 1 : stop;
+			lineNumber++;
+
+			const char* first = p;
+			const char* last = (lineEnd != p && lineEnd[-1] == '\r') ? lineEnd - 1 : lineEnd;
+			p = next;
+			Trim(first, last);
+			if (first == last)
+				continue;
+
+			if (!headerChecked)
+			{
+				headerChecked = true;
+				if (!((*first >= '0' && *first <= '9') || *first == '-' || *first == '+' || *first == '.'))
+					continue;
+			}
+
+			if (batch == 0)
+			{
+				Clock::time_point waitStart = Clock::now();
+				open = freeBatches.Pop(batch);
+				waiting += SecondsSince(waitStart);
+				if (!open)
+					break;
+				batch->rows.Clear();
+				batch->valid.clear();
+			}
+
+			if (!ParseLine(first, last, *batch))
+			{
+				malformedRows++;
+				if (firstMalformedLine == 0)
+					firstMalformedLine = lineNumber;
+			}
+			stage.rows++;
+
+			if (batch->rows.Size() == batchRows)
+			{
+				Clock::time_point waitStart = Clock::now();
+				open = parsed.Push(batch);
+				waiting += SecondsSince(waitStart);
+				batch = 0;
+			}
+		}
+
+		carried = stop - p;
+		memmove(buffer.data(), p, carried);
+		if (atEnd)
+			break;
+	}
+
+	if (batch != 0 && open)
+		parsed.Push(batch);
+	parsed.Close();
+
+	stage.wallSeconds = SecondsSince(start);
+	stage.busySeconds = stage.wallSeconds - waiting;
+}
+
+// Evaluates each parsed batch, splitting it across pool when one is set
+void CsvPricingPipeline::PriceStage(BoundedQueue<Batch*>& parsed, BoundedQueue<Batch*>& priced)
+{
+	PipelineStageStats& stage = stats[1];
+	Clock::time_point start = Clock::now();
+	double waiting = 0;
+
+	while (true)
+	{
+		Batch* batch = 0;
+		Clock::time_point waitStart = Clock::now();
+		bool received = parsed.Pop(batch);
+		waiting += SecondsSince(waitStart);
+		if (!received)
+			break;
+
+		OptionBatchView view = batch->rows.View();
+		batch->results.resize(view.rows);
+		{
+			INSTRUMENT_SCOPE("CsvPricingPipeline::price");
+			if (pool == 0)
+				OptionBatch::Evaluate(view, outputs, batch->results.data());
+			else
+			{
+				OptionResults* results = batch->results.data();
+				int selected = outputs;
+				pool->ParallelFor(0, view.rows, 0, [&](size_t first, size_t last)
+				{
+					OptionBatch::Evaluate(OptionBatch::Slice(view, first, last), selected, results + first);
+				});
+			}
+		}
+		stage.rows += view.rows;
+
+		waitStart = Clock::now();
+		bool sent = priced.Push(batch);
+		waiting += SecondsSince(waitStart);
+		if (!sent)
+			break;
+	}
+	priced.Close();
+
+	stage.wallSeconds = SecondsSince(start);
+	stage.busySeconds = stage.wallSeconds - waiting;
+}
+
+// Formats each priced batch into one text buffer, writes it and hands the batch back to the parser. Returns false as soon as a
+// write fails.
+bool CsvPricingPipeline::WriteStage(ostream& output, BoundedQueue<Batch*>& priced, BoundedQueue<Batch*>& freeBatches)
+{
+	PipelineStageStats& stage = stats[2];
+	Clock::time_point start = Clock::now();
+	double waiting = 0;
+
+	static const char* const names[5] = { "price", "delta", "gamma", "theta", "vega" };
+	static const int flags[5] = { Option::PriceOutput, Option::DeltaOutput, Option::GammaOutput, Option::ThetaOutput, Option::VegaOutput };
+	int columns = 0;
+	string header;
+	for (int c = 0; c < 5; c++)
+	{
+		if (outputs & flags[c])
+		{
+			header += (columns++ > 0) ? "," : "";
+			header += names[c];
+		}
+	}
+	header += "\n";
+	output.write(header.data(), header.size());
+	stage.bytes += header.size();
+
+	vector<char> text;
+	bool good = !output.fail();
+	while (good)
+	{
+		Batch* batch = 0;
+		Clock::time_point waitStart = Clock::now();
+		bool received = priced.Pop(batch);
+		waiting += SecondsSince(waitStart);
+		if (!received)
+			break;
+
+		size_t rows = batch->rows.Size();
+		text.resize(rows * (columns * (digits + 9) + 1));
+		char* out = text.data();
+		{
+			INSTRUMENT_SCOPE("CsvPricingPipeline::write");
+			for (size_t i = 0; i < rows; i++)
+			{
+				const OptionResults& result = batch->results[i];
+				const double values[5] = { result.price, result.delta, result.gamma, result.theta, result.vega };
+				int written = 0;
+				for (int c = 0; c < 5; c++)
+				{
+					if (outputs & flags[c])
+					{
+						if (written++ > 0)
+							*out++ = ',';
+						if (batch->valid[i])
+							out = FormatDouble(values[c], out, digits);
+					}
+				}
+				*out++ = '\n';
+			}
+
+			output.write(text.data(), out - text.data());
+			good = !output.fail();
+		}
+		stage.bytes += out - text.data();
+		stage.rows += rows;
+
+		waitStart = Clock::now();
+		freeBatches.Push(batch);
+		waiting += SecondsSince(waitStart);
+	}
+	output.flush();
+	good = good && !output.fail();
+
+	stage.wallSeconds = SecondsSince(start);
+	stage.busySeconds = stage.wallSeconds - waiting;
+	return good;
+}
+
+// Parses one line of the form S,sig,r,b,type,K[,T] into batch. A malformed line is recorded as invalid and replaced by a
+// placeholder row so that the row still occupies its place in the output.
+bool CsvPricingPipeline::ParseLine(const char* first, const char* last, Batch& batch) const
+{
+	INSTRUMENT_SCOPE("CsvPricingPipeline::ParseLine");
+	const char* fields[8];
+	const char* fieldEnds[8];
+	int fieldCount = 0;
+	for (const char* p = first; fieldCount < 8; )
+	{
+		const char* comma = static_cast<const char*>(memchr(p, ',', last - p));
+		fields[fieldCount] = p;
+		fieldEnds[fieldCount++] = (comma != 0) ? comma : last;
+		if (comma == 0)
+			break;
+		p = comma + 1;
+	}
+
+	double S, sig, r, b, K, T = 0;
+	char type = 0;
+	bool valid = (fieldCount == 6 || fieldCount == 7) && ParseField(fields[0], fieldEnds[0], S) && ParseField(fields[1], fieldEnds[1], sig)
+				 && ParseField(fields[2], fieldEnds[2], r) && ParseField(fields[3], fieldEnds[3], b) && ParseField(fields[5], fieldEnds[5], K);
+
+	// Option type, as C/P or +1/-1
+	if (valid)
+	{
+		const char* typeFirst = fields[4];
+		const char* typeLast = fieldEnds[4];
+		Trim(typeFirst, typeLast);
+		double typeValue = 0;
+		if (typeLast - typeFirst == 1 && (*typeFirst == 'C' || *typeFirst == 'c'))
+			type = 'C';
+		else if (typeLast - typeFirst == 1 && (*typeFirst == 'P' || *typeFirst == 'p'))
+			type = 'P';
+		else if (ParseField(typeFirst, typeLast, typeValue) && (typeValue == 1 || typeValue == -1))
+			type = (typeValue == 1) ? 'C' : 'P';
+		else
+			valid = false;
+	}
+
+	// Maturity; a missing or empty T field makes the row a PAMO
+	bool euro = false;
+	if (valid && fieldCount == 7)
+	{
+		const char* maturityFirst = fields[6];
+		const char* maturityLast = fieldEnds[6];
+		Trim(maturityFirst, maturityLast);
+		if (maturityFirst != maturityLast)
+		{
+			euro = true;
+			valid = ParseField(maturityFirst, maturityLast, T);
+		}
+	}
+
+	if (!valid)
+		batch.rows.PushEuropean(100, 0.2, 0, 0, 'C', 100, 1);
+	else if (euro)
+		batch.rows.PushEuropean(S, sig, r, b, type, K, T);
+	else
+		batch.rows.PushPerpetual(S, sig, r, b, type, K);
+	batch.valid.push_back(valid ? 1 : 0);
+
+	return valid;
+}
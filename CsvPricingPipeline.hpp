@@ -0,0 +1,88 @@
+// CsvPricingPipeline.hpp
+//
+// The purpose of the CsvPricingPipeline class is to price a CSV file of option parameters of any size with flat memory use. The work
+// is split into three stages, each on its own thread, connected by BoundedQueues of row batches:
+//		1. parse	reads the input in large blocks and parses each line into a batch of rows with ParseDouble,
+//		2. price	evaluates each batch with the OptionBatch evaluators (split across a ThreadPool when one is supplied), and
+//		3. write	formats each batch of results with FormatDouble into one buffer and writes it out with a single call.
+// While one batch is being priced, the next is being parsed and the previous one written, so for large files the run time is that
+// of the slowest stage rather than the sum of the three. A fixed set of batches is recycled from the writer back to the parser, so
+// the memory in use is bounded by (2 * queueDepth + 3) batches whatever the size of the file.
+//
+// Each input line holds S, sig, r, b, type, K and T separated by commas, i.e. the ParamMatrix::PushRow layout, except that type may
+// be given either as C/P or as +1/-1. A line whose T field is missing or empty is priced as a PAMO. A first line which does not begin
+// with a number is taken to be a header and skipped, as are blank lines. Every other line produces exactly one output line holding
+// the selected outputs, in the order price, delta, gamma, theta, vega; lines that cannot be parsed produce a line of empty fields so
+// that output lines can still be matched to input lines.
+
+#ifndef CsvPricingPipeline_H
+#define CsvPricingPipeline_H
+
+#include "Option.hpp"
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+class ThreadPool;
+
+template <typename T>
+class BoundedQueue;
+
+struct PipelineStageStats
+{
+	string name;										// "parse", "price" or "write"
+	size_t rows;										// Rows handled by the stage
+	size_t bytes;										// Bytes read (parse) or written (write); 0 for the price stage
+	double busySeconds;									// Time spent working, excluding time blocked on the queues
+	double wallSeconds;									// Time from the start of the run until the stage finished
+};
+
+class CsvPricingPipeline
+{
+private:
+	struct Batch;
+
+	int outputs;										// Option::Outputs flags of the values written
+	size_t batchRows;									// Rows per batch
+	size_t queueDepth;									// Batches held by each queue between two stages
+	int digits;											// Significant digits written per value
+	ThreadPool* pool;									// Pool used by the price stage; null to price on the stage's own thread
+	size_t malformedRows;								// Lines of the last run that could not be parsed
+	size_t firstMalformedLine;							// 1-based line number of the first of them, 0 if none
+	vector<PipelineStageStats> stats;					// Statistics of the last run, one entry per stage
+
+	void ParseStage(istream& input, BoundedQueue<Batch*>& freeBatches, BoundedQueue<Batch*>& parsed);	// Body of the parse thread
+	void PriceStage(BoundedQueue<Batch*>& parsed, BoundedQueue<Batch*>& priced);							// Body of the price thread
+	bool WriteStage(ostream& output, BoundedQueue<Batch*>& priced, BoundedQueue<Batch*>& freeBatches);	// Body of the write stage
+
+	bool ParseLine(const char* first, const char* last, Batch& batch) const;	// Appends the row on [first, last) to batch; returns false if
+																				// the line is malformed, in which case a placeholder row is added
+
+public:
+	// Constructors and Destructor
+	CsvPricingPipeline();																		// Default constructor; every output, 64k-row batches,
+																								// queues of 4 batches, 15 digits
+	CsvPricingPipeline(int outputFlags, size_t rowsPerBatch, size_t batchesPerQueue, int significantDigits);	// Value constructor
+	CsvPricingPipeline(const CsvPricingPipeline& pipeline);										// Copy constructor
+	virtual ~CsvPricingPipeline();																// Destructor
+
+
+	// Accessor Functions
+	const vector<PipelineStageStats>& GetStats() const;											// Returns the statistics of the last run
+	size_t GetMalformedRows() const;															// Returns the number of malformed lines of the last run
+	size_t GetFirstMalformedLine() const;														// Returns the line number of the first of them, 0 if none
+
+
+	// Modifier Functions
+	bool Run(istream& input, ostream& output);													// Prices every line of input and writes the results to
+																								// output; returns false if output could not be written
+	void SetThreadPool(ThreadPool* pricingPool);												// Sets the pool used by the price stage; null for none
+	CsvPricingPipeline& operator = (const CsvPricingPipeline& pipeline);						// Assignment operator
+
+};
+
+
+#endif
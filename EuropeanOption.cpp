@@ -1,204 +1,307 @@
-// EuropeanOption.cpp
-
-#include "EuropeanOption.hpp"
-
-#include <boost/math/distributions/normal.hpp>
-using namespace boost::math;
-
-#include <cmath>
-
-
-// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-
-// Default constructor
-EuropeanOption::EuropeanOption() : Option(), T(0)
-{
-}
-
-// Value constructor
-EuropeanOption::EuropeanOption(char optionType, double strike, double timeTillMat) : Option(optionType, strike), T(timeTillMat)
-{
-}
-
-// Copy constructor
-EuropeanOption::EuropeanOption(const EuropeanOption& EO) : Option(EO), T(EO.T)
-{
-}
-
-// Destructor
-EuropeanOption::~EuropeanOption()
-{
-}
-
-
-// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-
-// Returns the value of the private data member T
-double EuropeanOption::GetTTM() const
-{
-	return T;
-}
-
-// Returns a value that is fundamental to computation of the Euro option object's price and Greeks 
-double EuropeanOption::d_1(double S, double sig, double b) const
-{
-	return ((log(S / GetStrike()) + ((b + (pow(sig, 2) / 2)) * T)) / (sig * sqrt(T)));
-}
-
-// Like the above, returns a value that is fundamental to computation of the Euro option object's price and Greeks
-double EuropeanOption::d_2(double S, double sig, double b) const
-{
-	return (d_1(S, sig, b) - (sig * sqrt(T)));
-}
-
-
-// Returns the Black-Scholes-Merton price of the Euro option object
-double EuropeanOption::Price(double S, double sig, double r, double b) const
-{
-	if (GetType() == 'C')
-		return ((S * exp((b - r) * T) * N((d_1(S, sig, b)))) - (GetStrike() * exp((-r) * T) * N((d_2(S, sig, b)))));
-	else
-		return ((GetStrike() * exp((-r) * T) * N((-d_2(S, sig, b)))) - (S * exp((b - r) * T) * N((-d_1(S, sig, b)))));
-}
-
-// This returns the value of the Euro option object according to put-call parity. As such, optionPrice denotes the price 
-// of an option with identical strike and time till maturity but with opposite type i.e. if the current object is a call,
-// optionPrice should be the price of a put. S, r, and b are as usual; that is, S := spot price, r := interest rate, 
-// b := cost-of-carry
-double EuropeanOption::ParityPrice(double optionPrice, double S, double r, double b) const
-{
-	if (GetType() == 'C')
-		return (optionPrice + ((S * exp((b - r) * T)) - GetStrike() * exp(-r * T)));
-	else
-		return (optionPrice - ((S * exp((b - r) * T)) - GetStrike() * exp((-r) * T)));
-}
-
-
-// Returns the Black-Scholes-Merton delta of the Euro option object; delta is the first derivative of the Euro option's
-// price function with respect to the parameter S
-double EuropeanOption::Delta(double S, double sig, double r, double b) const
-{
-	if (GetType() == 'C')
-		return (exp((b - r) * T) * N(d_1(S, sig, b)));
-	else
-		return (exp((b - r) * T) * (N(d_1(S, sig, b)) - 1));
-}
-
-// Returns the Black-Scholes-Merton gamma of the Euro option object; gamma is the second derivative of the Euro option's
-// price function with respect to the parameter S
-double EuropeanOption::Gamma(double S, double sig, double r, double b) const
-{
-	// Euro calls and puts with identical strike price and time till maturity have identical gammas 
-	return (n(d_1(S, sig, b)) * exp((b - r) * T)) / (S * (sig * sqrt(T)));
-}
-
-// Returns the Black-Scholes-Merton theta of the Euro option object; theta is the first derivative of the Euro option's
-// price function with respect to time
-double EuropeanOption::Theta(double S, double sig, double r, double b) const
-{
-	if (GetType() == 'C')
-	{
-		double firstTerm  = -((S * (sig * (exp((b - r) * T) * n(d_1(S, sig, b))))) / (2 * sqrt(T)));
-		double secondTerm = -((b - r) * (S * (exp((b - r) * T) * N(d_1(S, sig, b)))));
-		double thirdTerm  = -(r * (GetStrike() * (exp(-r * T) * N(d_2(S, sig, b)))));
-
-		return firstTerm + secondTerm + thirdTerm;
-	}
-	else
-	{
-		double firstTerm  = -((S * (sig * (exp((b - r) * T) * n(d_1(S, sig, b))))) / (2 * sqrt(T)));
-		double secondTerm = ((b - r) * (S * (exp((b - r) * T) * N(d_1(S, sig, b)))));
-		double thirdTerm  = (r * (GetStrike() * (exp(-r * T) * N(-d_2(S, sig, b)))));
-
-		return firstTerm + secondTerm + thirdTerm;
-	}
-}
-
-// Returns the Black-Scholes-Merton vega of the Euro option object; vega is the first derivative of the Euro option's
-// price function with respect to the parameter sig
-double EuropeanOption::Vega(double S, double sig, double r, double b) const
-{
-	return (S * (sqrt(T) * (exp((b - r) * T) * n(d_1(S, sig, b)))));
-}
-
-// Returns an approximation of the delta of the Euro option through the method of centered divided differences for 1st 
-// derivatives
-double EuropeanOption::DivDiffDelta(double S, double sig, double r, double b, double h) const
-{
-	double numerator = Price((S + h), sig, r, b) - Price((S - h), sig, r, b);
-	return (numerator / (2 * h));
-}
-
-// Returns the absolute value of the difference between the values returned by delta and divDiffDelta with respect to 
-// a given value of h. 
-double EuropeanOption::DivDiffDeltaAccuracy(double S, double sig, double r, double b, double h) const
-{
-	return abs(Delta(S, sig, r, b) - DivDiffDelta(S, sig, r, b, h));
-}
-
-// Returns an approximation of the delta of the Euro option through the method of centered divided differences for 2nd 
-// derivatives
-double EuropeanOption::DivDiffGamma(double S, double sig, double r, double b, double h) const
-{
-	double numerator = ((Price((S + h), sig, r, b) - (2 * Price(S, sig, r, b))) + Price((S - h), sig, r, b));
-	return (numerator / pow(h, 2));
-}
-
-// Returns the absolute value of the difference between the values returned by gamma and divDiffGamma with respect to 
-// a given value of h.
-double EuropeanOption::DivDiffGammaAccuracy(double S, double sig, double r, double b, double h) const
-{
-	return abs(Gamma(S, sig, r, b) - DivDiffGamma(S, sig, r, b, h));
-}
-
-// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-
-// Allows the user to alter the Euro option's time till maturity
-void EuropeanOption::SetTTM(double timeTillMat)
-{
-	T = timeTillMat;
-}
-
-// Assignment operator
-EuropeanOption& EuropeanOption::operator = (const EuropeanOption& euroOp)
-{
-	if (this != &euroOp)
-	{
-		Option::operator = (euroOp);
-		T = euroOp.T;
-	}
-
-	return *this;
-}
-
-
-// -------------------------------------------------------------------------- Static Functions ------------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-
-// More compact way of calling the standard normal CDF at a value x
-double EuropeanOption::N(double x)
-{
-	normal_distribution<> myNormal;
-	return cdf(myNormal, x);
-}
-
-// More compact way of calling the standard normal PDF at a value x
-double EuropeanOption::n(double x)
-{
-	normal_distribution<> myNormal;
-	return pdf(myNormal, x);
-}
-
-// This function's purpose is to check if two Euro option prices, one corresponding to a call and the other a put with identical
-// strike price and time till maturity, satisfy put-call parity *up to a given additive constant which is stored by the input
-// variable tolerance*. In theory, when parity does not hold an arbitrage opportunity is present with respect to the 
-// underlying stock, a forward on that stock with strike the same as the two options, and the call and put option who's prices
-// served as input to the function.
-bool EuropeanOption::CheckParity(double callPrice, double putPrice, double K, double T, double S, double r, double b, double tolerance)
-{
-	bool condition = abs((callPrice - putPrice) - ((S * exp((b - r) * T)) - K * exp(-r * T))) < tolerance;
-	return condition;
+// EuropeanOption.cpp
+
+#include "EuropeanOption.hpp"
+#include "Instrumentation.hpp"
+#include "OptionKernels.hpp"
+
+#include <cmath>
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor
+EuropeanOption::EuropeanOption() : Option(), T(0)
+{
+}
+
+// Value constructor
+EuropeanOption::EuropeanOption(char optionType, double strike, double timeTillMat) : Option(optionType, strike), T(timeTillMat)
+{
+}
+
+// Copy constructor
+EuropeanOption::EuropeanOption(const EuropeanOption& EO) : Option(EO), T(EO.T)
+{
+}
+
+// Destructor
+EuropeanOption::~EuropeanOption()
+{
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the value of the private data member T
+double EuropeanOption::GetTTM() const
+{
+	return T;
+}
+
+// Returns a value that is fundamental to computation of the Euro option object's price and Greeks 
+double EuropeanOption::d_1(double S, double sig, double b) const
+{
+	return EuropeanKernel<CallOption>::d_1(S, sig, b, GetStrike(), T);
+}
+
+// Like the above, returns a value that is fundamental to computation of the Euro option object's price and Greeks
+double EuropeanOption::d_2(double S, double sig, double b) const
+{
+	return EuropeanKernel<CallOption>::d_2(S, sig, b, GetStrike(), T);
+}
+
+// The pricing and Greeks functions below select the call or put kernel of OptionKernels.hpp, where the formulas are implemented
+
+// Returns the Black-Scholes-Merton price of the Euro option object
+double EuropeanOption::Price(double S, double sig, double r, double b) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::Price");
+	if (GetType() == 'C')
+		return EuropeanKernel<CallOption>::Price(S, sig, r, b, GetStrike(), T);
+	else
+		return EuropeanKernel<PutOption>::Price(S, sig, r, b, GetStrike(), T);
+}
+
+// This returns the value of the Euro option object according to put-call parity. As such, optionPrice denotes the price 
+// of an option with identical strike and time till maturity but with opposite type i.e. if the current object is a call,
+// optionPrice should be the price of a put. S, r, and b are as usual; that is, S := spot price, r := interest rate, 
+// b := cost-of-carry
+double EuropeanOption::ParityPrice(double optionPrice, double S, double r, double b) const
+{
+	if (GetType() == 'C')
+		return (optionPrice + ((S * exp((b - r) * T)) - GetStrike() * exp(-r * T)));
+	else
+		return (optionPrice - ((S * exp((b - r) * T)) - GetStrike() * exp((-r) * T)));
+}
+
+
+// Returns the Black-Scholes-Merton delta of the Euro option object; delta is the first derivative of the Euro option's
+// price function with respect to the parameter S
+double EuropeanOption::Delta(double S, double sig, double r, double b) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::Delta");
+	if (GetType() == 'C')
+		return EuropeanKernel<CallOption>::Delta(S, sig, r, b, GetStrike(), T);
+	else
+		return EuropeanKernel<PutOption>::Delta(S, sig, r, b, GetStrike(), T);
+}
+
+// Returns the Black-Scholes-Merton gamma of the Euro option object; gamma is the second derivative of the Euro option's
+// price function with respect to the parameter S
+double EuropeanOption::Gamma(double S, double sig, double r, double b) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::Gamma");
+	// Euro calls and puts with identical strike price and time till maturity have identical gammas 
+	return EuropeanKernel<CallOption>::Gamma(S, sig, r, b, GetStrike(), T);
+}
+
+// Returns the Black-Scholes-Merton theta of the Euro option object; theta is the first derivative of the Euro option's
+// price function with respect to time
+double EuropeanOption::Theta(double S, double sig, double r, double b) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::Theta");
+	if (GetType() == 'C')
+		return EuropeanKernel<CallOption>::Theta(S, sig, r, b, GetStrike(), T);
+	else
+		return EuropeanKernel<PutOption>::Theta(S, sig, r, b, GetStrike(), T);
+}
+
+// Returns the Black-Scholes-Merton vega of the Euro option object; vega is the first derivative of the Euro option's
+// price function with respect to the parameter sig
+double EuropeanOption::Vega(double S, double sig, double r, double b) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::Vega");
+	// Like gamma, vega does not depend on the option type
+	return EuropeanKernel<CallOption>::Vega(S, sig, r, b, GetStrike(), T);
+}
+
+// Returns an approximation of the delta of the Euro option through the method of centered divided differences for 1st 
+// derivatives
+double EuropeanOption::DivDiffDelta(double S, double sig, double r, double b, double h) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::DivDiffDelta");
+	if (GetType() == 'C')
+		return EuropeanKernel<CallOption>::DivDiffDelta(S, sig, r, b, GetStrike(), T, h);
+	else
+		return EuropeanKernel<PutOption>::DivDiffDelta(S, sig, r, b, GetStrike(), T, h);
+}
+
+// Returns the absolute value of the difference between the values returned by delta and divDiffDelta with respect to 
+// a given value of h. 
+double EuropeanOption::DivDiffDeltaAccuracy(double S, double sig, double r, double b, double h) const
+{
+	return abs(Delta(S, sig, r, b) - DivDiffDelta(S, sig, r, b, h));
+}
+
+// Returns an approximation of the delta of the Euro option through the method of centered divided differences for 2nd 
+// derivatives
+double EuropeanOption::DivDiffGamma(double S, double sig, double r, double b, double h) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::DivDiffGamma");
+	if (GetType() == 'C')
+		return EuropeanKernel<CallOption>::DivDiffGamma(S, sig, r, b, GetStrike(), T, h);
+	else
+		return EuropeanKernel<PutOption>::DivDiffGamma(S, sig, r, b, GetStrike(), T, h);
+}
+
+// Returns the absolute value of the difference between the values returned by gamma and divDiffGamma with respect to 
+// a given value of h.
+double EuropeanOption::DivDiffGammaAccuracy(double S, double sig, double r, double b, double h) const
+{
+	return abs(Gamma(S, sig, r, b) - DivDiffGamma(S, sig, r, b, h));
+}
+
+// Computes the price and the Greeks selected by outputs in a single pass. Each subexpression shared by the individual member
+// functions -- sqrt(T), d_1, d_2, exp((b - r) * T), exp(-r * T), N(+/-d_1), N(+/-d_2) and n(d_1) -- is computed at most once, and
+// only if one of the selected outputs needs it. Fields that are not selected are set to 0. The values agree with those returned by
+// Price(), Delta(), Gamma(), Theta() and Vega() up to rounding; the put delta is computed as -e^((b-r)T) * N(-d_1), which avoids
+// the cancellation in e^((b-r)T) * (N(d_1) - 1) for deep in-the-money puts.
+OptionResults EuropeanOption::Evaluate(double S, double sig, double r, double b, int outputs) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::Evaluate");
+	if (GetType() == 'C')
+		return EuropeanKernel<CallOption>::Evaluate(S, sig, r, b, GetStrike(), T, outputs);
+	else
+		return EuropeanKernel<PutOption>::Evaluate(S, sig, r, b, GetStrike(), T, outputs);
+}
+
+// Returns the Black-Scholes-Merton vanna of the Euro option object; vanna is the derivative of the Euro option's delta with
+// respect to the parameter sig
+double EuropeanOption::Vanna(double S, double sig, double r, double b) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::Vanna");
+	// Vanna does not depend on the option type
+	return EuropeanKernel<CallOption>::Vanna(S, sig, r, b, GetStrike(), T);
+}
+
+// Returns the Black-Scholes-Merton volga of the Euro option object; volga, or vomma, is the derivative of the Euro option's
+// vega with respect to the parameter sig
+double EuropeanOption::Volga(double S, double sig, double r, double b) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::Volga");
+	// Like vega, volga does not depend on the option type
+	return EuropeanKernel<CallOption>::Volga(S, sig, r, b, GetStrike(), T);
+}
+
+// Returns the Black-Scholes-Merton charm of the Euro option object; charm is the rate at which the Euro option's delta changes
+// as time passes, i.e. minus its derivative with respect to T
+double EuropeanOption::Charm(double S, double sig, double r, double b) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::Charm");
+	if (GetType() == 'C')
+		return EuropeanKernel<CallOption>::Charm(S, sig, r, b, GetStrike(), T);
+	else
+		return EuropeanKernel<PutOption>::Charm(S, sig, r, b, GetStrike(), T);
+}
+
+// Returns the Black-Scholes-Merton speed of the Euro option object; speed is the derivative of the Euro option's gamma with
+// respect to the parameter S
+double EuropeanOption::Speed(double S, double sig, double r, double b) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::Speed");
+	// Like gamma, speed does not depend on the option type
+	return EuropeanKernel<CallOption>::Speed(S, sig, r, b, GetStrike(), T);
+}
+
+// Returns the Black-Scholes-Merton color of the Euro option object; color is the rate at which the Euro option's gamma changes
+// as time passes, i.e. minus its derivative with respect to T
+double EuropeanOption::Color(double S, double sig, double r, double b) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::Color");
+	// Like gamma, color does not depend on the option type
+	return EuropeanKernel<CallOption>::Color(S, sig, r, b, GetStrike(), T);
+}
+
+// Returns the Black-Scholes-Merton rho of the Euro option object; rho is the derivative of the Euro option's price with
+// respect to the parameter r, the cost-of-carry b held fixed
+double EuropeanOption::Rho(double S, double sig, double r, double b) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::Rho");
+	if (GetType() == 'C')
+		return EuropeanKernel<CallOption>::Rho(S, sig, r, b, GetStrike(), T);
+	else
+		return EuropeanKernel<PutOption>::Rho(S, sig, r, b, GetStrike(), T);
+}
+
+// Returns the Black-Scholes-Merton carry rho of the Euro option object; carry rho is the derivative of the Euro option's price
+// with respect to the parameter b, the interest rate r held fixed
+double EuropeanOption::CarryRho(double S, double sig, double r, double b) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::CarryRho");
+	if (GetType() == 'C')
+		return EuropeanKernel<CallOption>::CarryRho(S, sig, r, b, GetStrike(), T);
+	else
+		return EuropeanKernel<PutOption>::CarryRho(S, sig, r, b, GetStrike(), T);
+}
+
+// Computes the higher-order Greeks selected by higherOutputs in a single pass, sharing d_1, d_2, the discount factors and the
+// normal CDF/PDF values between them as Evaluate does. Fields that are not selected are set to 0.
+HigherOrderResults EuropeanOption::EvaluateHigherOrder(double S, double sig, double r, double b, int higherOutputs) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::EvaluateHigherOrder");
+	if (GetType() == 'C')
+		return EuropeanKernel<CallOption>::EvaluateHigherOrder(S, sig, r, b, GetStrike(), T, higherOutputs);
+	else
+		return EuropeanKernel<PutOption>::EvaluateHigherOrder(S, sig, r, b, GetStrike(), T, higherOutputs);
+}
+
+// Computes the outputs selected by outputs and the higher-order Greeks selected by higherOutputs in one pass, so that a risk run
+// needing both computes d_1, d_2, the discount factors and the normal CDF/PDF values only once per option
+void EuropeanOption::Evaluate(double S, double sig, double r, double b, int outputs, int higherOutputs, OptionResults& results,
+							  HigherOrderResults& higherResults) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::Evaluate(higher order)");
+	if (GetType() == 'C')
+		EuropeanKernel<CallOption>::Evaluate(S, sig, r, b, GetStrike(), T, outputs, higherOutputs, results, higherResults);
+	else
+		EuropeanKernel<PutOption>::Evaluate(S, sig, r, b, GetStrike(), T, outputs, higherOutputs, results, higherResults);
+}
+
+// Returns the price of the Euro option object together with its derivatives with respect to every input, S, sig, r, b, K and T,
+// computed by one reverse mode (adjoint) sweep through the pricing formula. dS, dSig and -dT are the delta, vega and theta.
+PriceGradient EuropeanOption::Gradient(double S, double sig, double r, double b) const
+{
+	INSTRUMENT_SCOPE("EuropeanOption::Gradient");
+	if (GetType() == 'C')
+		return EuropeanKernel<CallOption>::Gradient(S, sig, r, b, GetStrike(), T);
+	else
+		return EuropeanKernel<PutOption>::Gradient(S, sig, r, b, GetStrike(), T);
+}
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Allows the user to alter the Euro option's time till maturity
+void EuropeanOption::SetTTM(double timeTillMat)
+{
+	T = timeTillMat;
+}
+
+// Assignment operator
+EuropeanOption& EuropeanOption::operator = (const EuropeanOption& euroOp)
+{
+	if (this != &euroOp)
+	{
+		Option::operator = (euroOp);
+		T = euroOp.T;
+	}
+
+	return *this;
+}
+
+
+// -------------------------------------------------------------------------- Static Functions ------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// This function's purpose is to check if two Euro option prices, one corresponding to a call and the other a put with identical
+// strike price and time till maturity, satisfy put-call parity *up to a given additive constant which is stored by the input
+// variable tolerance*. In theory, when parity does not hold an arbitrage opportunity is present with respect to the 
+// underlying stock, a forward on that stock with strike the same as the two options, and the call and put option who's prices
+// served as input to the function.
+bool EuropeanOption::CheckParity(double callPrice, double putPrice, double K, double T, double S, double r, double b, double tolerance)
+{
+	bool condition = abs((callPrice - putPrice) - ((S * exp((b - r) * T)) - K * exp(-r * T))) < tolerance;
+	return condition;
 }
\ No newline at end of file
@@ -1,84 +1,125 @@
-// EuropeanOption.hpp
-//
-// The purpose of the EuropeanOption class is to extend the functionality of the base class Option to Option objects that are of
-// European type, i.e. having an expiry date which constitues the sole day the option holder can exercise. As such, the EuropeanOption
-// class is a derived class of Option, and we have an additional private data member to store the contract length (in years) of the 
-// European option object. The member functions are described at length below. Additionally there are 3 static member functions whose
-// primary purpose is to assist other non-static member functions.
-
-#ifndef EuropeanOption_H
-#define EuropeanOption_H
-
-#include "Option.hpp"
-
-class EuropeanOption : public Option
-{
-private:
-	double T;																	// Time till maturity
-
-public:
-	// Constructors and Destructor
-	EuropeanOption();															// Default constructor
-	EuropeanOption(char optionType, double strike, double timeTillMat);			// Value constructor
-	EuropeanOption(const EuropeanOption& EO);									// Copy constructor
-	virtual ~EuropeanOption();													// Destructor
-
-
-	// Accessor Functions
-	// Common Parameters -- S := current spot price | sig := volatility of spot price \\
-	//						r := interest rate		| b := cost-of-carry			  \\
-	
-	double GetTTM() const;																		// Getter for the private member T
-
-	double d_1(double S, double sig, double b) const;											// Both d_1 and d_2 are used in the price() member function as well as all of the Greek
-	double d_2(double S, double sig, double b) const;											// member functions declared below. We created these in order to streamline their usage
-																								// They are non-static member functions because their values depend on the private members
-																								// T and K
-								
-							   // Pricing Functions \\		
-
-	double Price(double S, double sig, double r, double b) const;								// Returns the Black-Scholes-Merton price of the Euro option
-	
-	double ParityPrice(double optionPrice, double S, double r, double b) const;					// Returns the price of the Euro option object according to the Put-Call parity formula;
-																								// optionPrice := price of an option of opposite type with identical strike and time till
-																								// maturity
-								// Greeks Functions \\
-
-	double Delta(double S, double sig, double r, double b) const;								// Returns the Black-Scholes-Merton delta of the Euro option
-	
-	double Gamma(double S, double sig, double r, double b) const;								// Returns the Black-Scholes-Merton gamma of the Euro option
-
-	double Theta(double S, double sig, double r, double b) const;								// Returns the Black-Scholes-Merton theta of the Euro option
-
-	double Vega(double S, double sig, double r, double b) const;								// Returns the Black-Scholes-Merton vega of the Euro option
-
-	double DivDiffDelta(double S, double sig, double r, double b, double h) const;				// Approximates the Euro option's delta via the centered divided differences method for
-																								// 1st derivatives; h specifies the radius of the interval about S we apply the approx. on
-
-	double DivDiffDeltaAccuracy(double S, double sig, double r, double b, double h) const;		// Returns the absolute value of the difference between the returned value of delta and
-																								// divDiffDelta for a given value of h used for the approximation in divDiffDelta
-	
-	double DivDiffGamma(double S, double sig, double r, double b, double h) const;				// Approximates the Euro option's delta via the centered divided differences method for
-																								// 2nd derivatives; h specifies the radius of the interval about S we apply the approx. 
-
-	double DivDiffGammaAccuracy(double S, double sig, double r, double b, double h) const;		// Returns the absolute value of the difference between the returned value of gamma and
-																								// divDiffGamma for a given value of h used for the approximation in divDiffGamma
-
-	
-	// Modifier Functions
-	void SetTTM(double timeTillMat);															// Setter for the private member T
-	EuropeanOption& operator = (const EuropeanOption& euroOp);									// Assignment operator
-
-
-	// Static Functions
-	static double N(double x);																	// Returns the CDF at x for a standard normal RV; used in many member functions above
-	static double n(double x);																	// Returns the PDF at x for a standard normal RV; used in many member functions above
-	static bool CheckParity(double callPrice, double putPrice, double K, double T, double S,
-							double r, double b, double tolerance);								// This returns 1 if the call and put price inputs satisfy parity *up to an additive
-																								// constant not exceeding the value of the input variable tolerance* and returns 0
-																								// otherwise
-
-};																										
-
-
-#endif
+// EuropeanOption.hpp
+//
+// The purpose of the EuropeanOption class is to extend the functionality of the base class Option to Option objects that are of
+// European type, i.e. having an expiry date which constitues the sole day the option holder can exercise. As such, the EuropeanOption
+// class is a derived class of Option, and we have an additional private data member to store the contract length (in years) of the 
+// European option object. The member functions are described at length below. Additionally there are 3 static member functions whose
+// primary purpose is to assist other non-static member functions.
+
+#ifndef EuropeanOption_H
+#define EuropeanOption_H
+
+#include "Option.hpp"
+#include "Instrumentation.hpp"
+#include "NormalDistribution.hpp"
+
+class EuropeanOption : public Option
+{
+private:
+	double T;																	// Time till maturity
+
+public:
+	// Constructors and Destructor
+	EuropeanOption();															// Default constructor
+	EuropeanOption(char optionType, double strike, double timeTillMat);			// Value constructor
+	EuropeanOption(const EuropeanOption& EO);									// Copy constructor
+	virtual ~EuropeanOption();													// Destructor
+
+
+	// Accessor Functions
+	// Common Parameters -- S := current spot price | sig := volatility of spot price \\
+	//						r := interest rate		| b := cost-of-carry			  \\
+	
+	double GetTTM() const;																		// Getter for the private member T
+
+	double d_1(double S, double sig, double b) const;											// Both d_1 and d_2 are used in the price() member function as well as all of the Greek
+	double d_2(double S, double sig, double b) const;											// member functions declared below. We created these in order to streamline their usage
+																								// They are non-static member functions because their values depend on the private members
+																								// T and K
+								
+							   // Pricing Functions \\		
+
+	double Price(double S, double sig, double r, double b) const;								// Returns the Black-Scholes-Merton price of the Euro option
+	
+	double ParityPrice(double optionPrice, double S, double r, double b) const;					// Returns the price of the Euro option object according to the Put-Call parity formula;
+																								// optionPrice := price of an option of opposite type with identical strike and time till
+																								// maturity
+								// Greeks Functions \\
+
+	double Delta(double S, double sig, double r, double b) const;								// Returns the Black-Scholes-Merton delta of the Euro option
+	
+	double Gamma(double S, double sig, double r, double b) const;								// Returns the Black-Scholes-Merton gamma of the Euro option
+
+	double Theta(double S, double sig, double r, double b) const;								// Returns the Black-Scholes-Merton theta of the Euro option
+
+	double Vega(double S, double sig, double r, double b) const;								// Returns the Black-Scholes-Merton vega of the Euro option
+
+	double DivDiffDelta(double S, double sig, double r, double b, double h) const;				// Approximates the Euro option's delta via the centered divided differences method for
+																								// 1st derivatives; h specifies the radius of the interval about S we apply the approx. on
+
+	double DivDiffDeltaAccuracy(double S, double sig, double r, double b, double h) const;		// Returns the absolute value of the difference between the returned value of delta and
+																								// divDiffDelta for a given value of h used for the approximation in divDiffDelta
+	
+	double DivDiffGamma(double S, double sig, double r, double b, double h) const;				// Approximates the Euro option's delta via the centered divided differences method for
+																								// 2nd derivatives; h specifies the radius of the interval about S we apply the approx. 
+
+	double DivDiffGammaAccuracy(double S, double sig, double r, double b, double h) const;		// Returns the absolute value of the difference between the returned value of gamma and
+																								// divDiffGamma for a given value of h used for the approximation in divDiffGamma
+
+	OptionResults Evaluate(double S, double sig, double r, double b, int outputs = AllOutputs) const;
+																								// Computes the outputs selected by the Option::Outputs flags in a single pass, sharing
+																								// d_1, d_2, sqrt(T), the discount factors and the normal CDF/PDF values between them
+
+							   // Higher-Order Greeks Functions
+
+	double Vanna(double S, double sig, double r, double b) const;								// Returns the vanna, the derivative of delta with respect to sig
+	double Volga(double S, double sig, double r, double b) const;								// Returns the volga (vomma), the derivative of vega with respect to sig
+	double Charm(double S, double sig, double r, double b) const;								// Returns the charm, the rate of change of delta as time passes
+	double Speed(double S, double sig, double r, double b) const;								// Returns the speed, the derivative of gamma with respect to S
+	double Color(double S, double sig, double r, double b) const;								// Returns the color, the rate of change of gamma as time passes
+	double Rho(double S, double sig, double r, double b) const;									// Returns the derivative of the price with respect to r, b held fixed
+	double CarryRho(double S, double sig, double r, double b) const;							// Returns the derivative of the price with respect to b, r held fixed;
+																								// for a stock option, where b = r - q, the usual rho is Rho + CarryRho
+
+	HigherOrderResults EvaluateHigherOrder(double S, double sig, double r, double b, int higherOutputs = AllHigherOrderOutputs) const;
+																								// Computes the higher-order Greeks selected by the Option::HigherOrderOutputs flags
+																								// in a single pass
+	void Evaluate(double S, double sig, double r, double b, int outputs, int higherOutputs, OptionResults& results,
+				  HigherOrderResults& higherResults) const;										// Computes both sets of outputs in a single pass
+
+	PriceGradient Gradient(double S, double sig, double r, double b) const;						// Returns the price and its derivatives with respect to S, sig, r, b, K and T,
+																								// computed by reverse mode differentiation at about twice the cost of a price
+
+	
+	// Modifier Functions
+	void SetTTM(double timeTillMat);															// Setter for the private member T
+	EuropeanOption& operator = (const EuropeanOption& euroOp);									// Assignment operator
+
+
+	// Static Functions
+	static double N(double x);																	// Returns the CDF at x for a standard normal RV; used in many member functions above
+	static double n(double x);																	// Returns the PDF at x for a standard normal RV; used in many member functions above
+	static bool CheckParity(double callPrice, double putPrice, double K, double T, double S,
+							double r, double b, double tolerance);								// This returns 1 if the call and put price inputs satisfy parity *up to an additive
+																								// constant not exceeding the value of the input variable tolerance* and returns 0
+																								// otherwise
+
+};																										
+
+// More compact way of calling the standard normal CDF at a value x; the accuracy tier is that selected in NormalDistribution. Defined
+// here, like the tier functions, so that every caller inlines it down to the tier dispatch
+inline double EuropeanOption::N(double x)
+{
+	INSTRUMENT_SCOPE("EuropeanOption::N");
+	return NormalDistribution::Cdf(x);
+}
+
+// More compact way of calling the standard normal PDF at a value x; the accuracy tier is that selected in NormalDistribution
+inline double EuropeanOption::n(double x)
+{
+	INSTRUMENT_SCOPE("EuropeanOption::n");
+	return NormalDistribution::Pdf(x);
+}
+
+
+#endif
@@ -1,40 +1,281 @@
-// ExactPricingMethodsGlobalFunctions.cpp
-
-#include "ExactPricingMethodsGlobalFunctions.hpp"
-
-#include <vector>
-#include <iostream>
-#include <cmath>
-
-using namespace std;
-
-// Overloaded << operator to print vector<double> objects directly.
-ostream& operator << (ostream& os, const vector<double> vec)
-{
-	os << "(";
-	for (vector<double>::const_iterator it = vec.begin(); it != vec.end(); ++it)
-	{
-		os << *it;
-		if (it != vec.end() - 1)
-			os << ", ";
-	}
-	os << ")" << endl;
-
-	return os;
-}
-
-// Create a vector starting with the value stored in start and increment each successive value by h. 
-// When i = (end - start) / h, the value we add to the vector is the value stored in end. We then 
-// return the meshed vector.
-vector<double> mesher(double start, double end, double h)
-{
-	double amtOfMeshPts = (end - start) / h;
-	vector<double> meshedVec;
-	for (int i = 0; i <= amtOfMeshPts; i++)
-		meshedVec.push_back(start + (i * h));
-
-	if (meshedVec.back() != end)
-		meshedVec.push_back(end);
-
-	return meshedVec;
-}
+// ExactPricingMethodsGlobalFunctions.cpp
+
+#include "ExactPricingMethodsGlobalFunctions.hpp"
+
+#include <vector>
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace std;
+
+// Overloaded << operator to print vector<double> objects directly.
+ostream& operator << (ostream& os, const vector<double> vec)
+{
+	os << "(";
+	for (vector<double>::const_iterator it = vec.begin(); it != vec.end(); ++it)
+	{
+		os << *it;
+		if (it != vec.end() - 1)
+			os << ", ";
+	}
+	os << ")" << endl;
+
+	return os;
+}
+
+// Create a vector starting with the value stored in start and increment each successive value by h. 
+// When i = (end - start) / h, the value we add to the vector is the value stored in end. We then 
+// return the meshed vector.
+vector<double> mesher(double start, double end, double h)
+{
+	double amtOfMeshPts = (end - start) / h;
+	vector<double> meshedVec;
+	for (int i = 0; i <= amtOfMeshPts; i++)
+		meshedVec.push_back(start + (i * h));
+
+	if (meshedVec.back() != end)
+		meshedVec.push_back(end);
+
+	return meshedVec;
+}
+
+
+// Parses a decimal number without going through the locale machinery of strtod or istream. Up to 19 significant digits are
+// accumulated in an integer; when that integer is at most 2^53 and the decimal exponent is at most 22 in magnitude, both the
+// mantissa and the power of ten are exact doubles, so one multiplication or division gives the correctly rounded result (Clinger's
+// fast path). This covers nearly every number found in market data files, and anything else is handed to strtod.
+bool ParseDouble(const char*& first, const char* last, double& value)
+{
+	static const double exactPowers[23] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+											1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+	const char* p = first;
+	bool negative = false;
+	if (p != last && (*p == '+' || *p == '-'))
+	{
+		negative = (*p == '-');
+		p++;
+	}
+
+	unsigned long long mantissa = 0;
+	int significantDigits = 0;
+	int exponent = 0;
+	bool anyDigits = false;
+	bool truncated = false;
+
+	// Integer part; digits beyond the 19th only scale the result
+	for (; p != last && *p >= '0' && *p <= '9'; p++)
+	{
+		anyDigits = true;
+		if (significantDigits < 19)
+		{
+			mantissa = mantissa * 10 + (*p - '0');
+			if (mantissa != 0)
+				significantDigits++;
+		}
+		else
+		{
+			exponent++;
+			truncated = truncated || (*p != '0');
+		}
+	}
+
+	// Fractional part
+	if (p != last && *p == '.')
+	{
+		for (p++; p != last && *p >= '0' && *p <= '9'; p++)
+		{
+			anyDigits = true;
+			if (significantDigits < 19)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				if (mantissa != 0)
+					significantDigits++;
+				exponent--;
+			}
+			else
+				truncated = truncated || (*p != '0');
+		}
+	}
+
+	if (!anyDigits)
+		return false;
+
+	// Exponent; an 'e' that is not followed by digits is not part of the number
+	if (p != last && (*p == 'e' || *p == 'E'))
+	{
+		const char* q = p + 1;
+		bool negativeExponent = false;
+		if (q != last && (*q == '+' || *q == '-'))
+		{
+			negativeExponent = (*q == '-');
+			q++;
+		}
+		if (q != last && *q >= '0' && *q <= '9')
+		{
+			int written = 0;
+			for (; q != last && *q >= '0' && *q <= '9'; q++)
+				if (written < 100000)
+					written = written * 10 + (*q - '0');
+			exponent += negativeExponent ? -written : written;
+			p = q;
+		}
+	}
+
+	if (!truncated && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22)
+	{
+		double result = static_cast<double>(mantissa);
+		result = (exponent < 0) ? result / exactPowers[-exponent] : result * exactPowers[exponent];
+		value = negative ? -result : result;
+	}
+	else
+	{
+		// strtod needs a terminated copy; numbers of ordinary length are copied to the stack
+		char text[64];
+		size_t length = p - first;
+		if (length < sizeof(text))
+		{
+			memcpy(text, first, length);
+			text[length] = 0;
+			value = strtod(text, 0);
+		}
+		else
+			value = strtod(string(first, p).c_str(), 0);
+	}
+
+	first = p;
+	return true;
+}
+
+// Formats value in the style of printf's %.<digits>g (fixed notation for decimal exponents from -5 up to digits - 1, scientific
+// notation otherwise, trailing zeros removed) without the cost of printf's format parsing and locale handling. The value is scaled
+// by a power of ten and rounded to a digits-digit integer, which is correct to within one unit in the last printed digit; with the
+// default 15 digits this is far below the accuracy of the pricing formulas themselves.
+char* FormatDouble(double value, char* out, int digits)
+{
+	static const unsigned long long integerPowers[19] = { 1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+														  100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL,
+														  1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+														  1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+														  1000000000000000000ULL };
+
+	if (digits < 1)
+		digits = 1;
+	if (digits > 17)
+		digits = 17;
+
+	if (value != value)
+	{
+		memcpy(out, "nan", 3);
+		return out + 3;
+	}
+	if (value < 0)
+	{
+		*out++ = '-';
+		value = -value;
+	}
+	if (value > 1.7976931348623157e308)
+	{
+		memcpy(out, "inf", 3);
+		return out + 3;
+	}
+	if (value == 0)
+	{
+		*out++ = '0';
+		return out;
+	}
+
+	// Scale value to a digits-digit integer; log10 can be off by one near powers of ten, which the checks below correct
+	int exponent10 = static_cast<int>(floor(log10(value)));
+	unsigned long long mantissa = 0;
+	for (int attempt = 0; attempt < 2; attempt++)
+	{
+		int scale = digits - 1 - exponent10;
+		double scaled = value;
+		while (scale > 300)
+		{
+			scaled *= 1e300;
+			scale -= 300;
+		}
+		while (scale < -300)
+		{
+			scaled /= 1e300;
+			scale += 300;
+		}
+		scaled = (scale >= 0) ? scaled * pow(10.0, scale) : scaled / pow(10.0, -scale);
+		mantissa = static_cast<unsigned long long>(scaled + 0.5);
+
+		if (mantissa >= integerPowers[digits])
+			exponent10++;
+		else if (mantissa < integerPowers[digits - 1])
+			exponent10--;
+		else
+			break;
+	}
+	if (mantissa >= integerPowers[digits])
+	{
+		mantissa = (mantissa + 5) / 10;
+		if (mantissa >= integerPowers[digits])
+		{
+			mantissa /= 10;
+			exponent10++;
+		}
+	}
+
+	// Significant digits, most significant first, without trailing zeros
+	char text[20];
+	for (int i = digits - 1; i >= 0; i--)
+	{
+		text[i] = static_cast<char>('0' + mantissa % 10);
+		mantissa /= 10;
+	}
+	int length = digits;
+	while (length > 1 && text[length - 1] == '0')
+		length--;
+
+	if (exponent10 >= -5 && exponent10 < digits)
+	{
+		if (exponent10 >= 0)
+		{
+			for (int i = 0; i <= exponent10; i++)
+				*out++ = (i < length) ? text[i] : '0';
+			if (length > exponent10 + 1)
+			{
+				*out++ = '.';
+				for (int i = exponent10 + 1; i < length; i++)
+					*out++ = text[i];
+			}
+		}
+		else
+		{
+			*out++ = '0';
+			*out++ = '.';
+			for (int i = -1; i > exponent10; i--)
+				*out++ = '0';
+			for (int i = 0; i < length; i++)
+				*out++ = text[i];
+		}
+	}
+	else
+	{
+		*out++ = text[0];
+		if (length > 1)
+		{
+			*out++ = '.';
+			for (int i = 1; i < length; i++)
+				*out++ = text[i];
+		}
+		*out++ = 'e';
+		*out++ = (exponent10 < 0) ? '-' : '+';
+		int magnitude = (exponent10 < 0) ? -exponent10 : exponent10;
+		if (magnitude >= 100)
+			*out++ = static_cast<char>('0' + magnitude / 100);
+		*out++ = static_cast<char>('0' + (magnitude / 10) % 10);
+		*out++ = static_cast<char>('0' + magnitude % 10);
+	}
+
+	return out;
+}
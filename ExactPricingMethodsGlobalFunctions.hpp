@@ -1,18 +1,26 @@
-// ExactPricingMethodsGlobalFunctions.hpp
-//
-// This header file contains the declaration of two functions which will be utilized in TestExactSolutions.cpp in order to enhance
-// the usability of our classes. 
-
-#ifndef EPMGlobalFunctions_H
-#define EPMGlobalFunctions
-
-#include <vector>
-#include <iostream>
-using namespace std;
-
-ostream& operator << (ostream& os, const vector<double> vec);		// This will allow the user to output vectors to the console directly
-
-vector<double> mesher(double start, double end, double h);			// Returns a vector of doubles whose 1st entry equals start, last entry equals
-																	// end, and whose j^th entry equals a+(j-1)*h. Requires (start - end)/h to be
-																	// an integer. 
+// ExactPricingMethodsGlobalFunctions.hpp
+//
+// This header file contains the declaration of two functions which will be utilized in TestExactSolutions.cpp in order to enhance
+// the usability of our classes, together with the number parsing and formatting functions used by the CSV pricing pipeline. 
+
+#ifndef EPMGlobalFunctions_H
+#define EPMGlobalFunctions_H
+
+#include <vector>
+#include <iostream>
+using namespace std;
+
+ostream& operator << (ostream& os, const vector<double> vec);		// This will allow the user to output vectors to the console directly
+
+vector<double> mesher(double start, double end, double h);			// Returns a vector of doubles whose 1st entry equals start, last entry equals
+																	// end, and whose j^th entry equals a+(j-1)*h. Requires (start - end)/h to be
+																	// an integer. 
+
+bool ParseDouble(const char*& first, const char* last, double& value);	// Parses a decimal number (optional sign, digits, optional fraction and
+																		// exponent) starting at first and not extending past last; on success
+																		// stores it in value, advances first past it and returns true
+
+char* FormatDouble(double value, char* out, int digits = 15);		// Writes value with the given number of significant digits (at most 17)
+																	// to out, without a terminating 0, and returns the end of the text; out
+																	// must have room for digits + 8 characters
 #endif
\ No newline at end of file
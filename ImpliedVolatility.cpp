@@ -0,0 +1,208 @@
+// ImpliedVolatility.cpp
+
+#include "ImpliedVolatility.hpp"
+#include "ThreadPool.hpp"
+
+#include <cmath>
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor
+ImpliedVolSolver::ImpliedVolSolver() : volTolerance(1e-10), priceTolerance(1e-12), maxIterations(50), maxVol(10)
+{
+}
+
+// Value constructor
+ImpliedVolSolver::ImpliedVolSolver(double volTol, double priceTol, int maxIter, double volCap) : volTolerance(volTol), priceTolerance(priceTol),
+																								 maxIterations(maxIter), maxVol(volCap)
+{
+}
+
+// Copy constructor
+ImpliedVolSolver::ImpliedVolSolver(const ImpliedVolSolver& solver) : volTolerance(solver.volTolerance), priceTolerance(solver.priceTolerance),
+																	 maxIterations(solver.maxIterations), maxVol(solver.maxVol)
+{
+}
+
+// Destructor
+ImpliedVolSolver::~ImpliedVolSolver()
+{
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the volatility at which option.Price(S, sig, r, b) equals quote. The option price is strictly increasing in sig, so once
+// the quote lies strictly between the no-arbitrage bounds there is exactly one root in (0, infinity). The bracket starts as
+// [0, maxVol] on the assumption that the root lies below maxVol; sigHigh is only known to price above the quote once an evaluation
+// has done so, and a bracket that collapses onto maxVol without one is settled by pricing maxVol itself. Only a price within
+// tolerance of the quote counts as converged.
+ImpliedVolResult ImpliedVolSolver::Solve(const EuropeanOption& option, double quote, double S, double r, double b, double previousVol) const
+{
+	ImpliedVolResult result = { 0, 0, ImpliedVolInvalidInput };
+
+	double K = option.GetStrike();
+	double T = option.GetTTM();
+	if (!(S > 0) || !(K > 0) || !(T > 0) || !std::isfinite(quote))
+		return result;
+
+	// No-arbitrage bounds: max(phi * (F - K) * e^(-rT), 0) < price < S * e^((b-r)T) for calls and K * e^(-rT) for puts
+	double discountedSpot = S * exp((b - r) * T);
+	double discountedStrike = K * exp(-r * T);
+	double lowerBound = (option.GetType() == 'C') ? (discountedSpot - discountedStrike) : (discountedStrike - discountedSpot);
+	double upperBound = (option.GetType() == 'C') ? discountedSpot : discountedStrike;
+	if (lowerBound < 0)
+		lowerBound = 0;
+
+	if (quote <= lowerBound)
+	{
+		result.status = ImpliedVolBelowIntrinsic;
+		return result;
+	}
+	if (quote >= upperBound)
+	{
+		result.vol = maxVol;
+		result.status = ImpliedVolAboveMaximum;
+		return result;
+	}
+
+	double sigLow = 0;
+	double sigHigh = maxVol;
+	double sig = (previousVol > 0 && previousVol < maxVol) ? previousVol : InitialGuess(option.GetType(), quote, S, K, T, r, b);
+	if (!(sig < maxVol))													// Start inside the bracket
+		sig = 0.5 * maxVol;
+	bool pricedAbove = false;												// Whether some evaluation priced above the quote
+	double sqrtT = sqrt(T);
+	double tolerance = priceTolerance * ((quote > 1) ? quote : 1);
+
+	result.status = ImpliedVolMaxIterations;
+	while (result.iterations < maxIterations)
+	{
+		OptionResults values = option.Evaluate(S, sig, r, b, Option::PriceOutput | Option::VegaOutput);
+		result.iterations++;
+
+		double error = values.price - quote;
+		if (error > 0)
+		{
+			sigHigh = sig;
+			pricedAbove = true;
+		}
+		else
+			sigLow = sig;
+
+		if (fabs(error) <= tolerance)
+		{
+			result.status = ImpliedVolConverged;
+			break;
+		}
+
+		// Halley step; volga = vega * d_1 * d_2 / sig
+		double next = -1;
+		if (values.vega > 1e-12 * ((quote > 1) ? quote : 1))
+		{
+			double d1 = option.d_1(S, sig, b);
+			double d2 = d1 - sig * sqrtT;
+			double newtonStep = error / values.vega;
+			double curvature = 0.5 * newtonStep * (d1 * d2 / sig);
+			double step = (fabs(curvature) < 0.5) ? newtonStep / (1 - curvature) : newtonStep;
+			next = sig - step;
+		}
+
+		// Fall back to bisection when the step leaves the bracket or could not be formed
+		if (!(next > sigLow && next < sigHigh))
+			next = 0.5 * (sigLow + sigHigh);
+
+		// A collapsed bracket that never priced above the quote ends at maxVol: once maxVol itself prices below the quote, the root
+		// lies above the search limit; any other collapse leaves the quote unmatched and the status at ImpliedVolMaxIterations
+		if ((sigHigh - sigLow) <= volTolerance)
+		{
+			if (pricedAbove)
+				break;
+			if (sig == maxVol)
+			{
+				result.status = ImpliedVolAboveMaximum;
+				break;
+			}
+			next = maxVol;
+		}
+		sig = next;
+	}
+
+	result.vol = sig;
+	return result;
+}
+
+// Solves every row of view against quotes[i]. The sig column of view is ignored; when previousVols is not null, previousVols[i] is
+// used as the starting point of row i, which typically brings a re-solve on the next tick down to one or two evaluations.
+void ImpliedVolSolver::Solve(const OptionBatchView& view, const double* quotes, const double* previousVols, ImpliedVolResult* results) const
+{
+	for (size_t i = 0; i < view.rows; i++)
+	{
+		EuropeanOption option((view.type[i] == 1) ? 'C' : 'P', view.K[i], view.T[i]);
+		results[i] = Solve(option, quotes[i], view.S[i], view.r[i], view.b[i], (previousVols != 0) ? previousVols[i] : 0);
+	}
+}
+
+// Parallel version of the batch solve; rows are split into chunks of grain rows which are solved on pool
+void ImpliedVolSolver::Solve(const OptionBatchView& view, const double* quotes, const double* previousVols, ImpliedVolResult* results,
+							 ThreadPool& pool, size_t grain) const
+{
+	pool.ParallelFor(0, view.rows, grain, [&](size_t first, size_t last)
+	{
+		OptionBatchView chunk = OptionBatch::Slice(view, first, last);
+		Solve(chunk, quotes + first, (previousVols != 0) ? previousVols + first : 0, results + first);
+	});
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Assignment operator
+ImpliedVolSolver& ImpliedVolSolver::operator = (const ImpliedVolSolver& solver)
+{
+	if (this != &solver)
+	{
+		volTolerance = solver.volTolerance;
+		priceTolerance = solver.priceTolerance;
+		maxIterations = solver.maxIterations;
+		maxVol = solver.maxVol;
+	}
+
+	return *this;
+}
+
+
+// -------------------------------------------------------------------------- Static Functions ------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the Corrado-Miller (1996) approximation of the implied volatility,
+//		sig ~ sqrt(2 pi / T) / (S' + K') * (C - (S' - K')/2 + sqrt((C - (S' - K')/2)^2 - (S' - K')^2 / pi)),
+// where S' = S e^((b-r)T), K' = K e^(-rT) and C is the call price (puts are converted through put-call parity). The square root
+// is clamped at zero for far from the money quotes, where the approximation is poor but still a usable starting point. The guess is
+// kept within [1e-4, 5]; Solve further moves it below the solver's maxVol.
+double ImpliedVolSolver::InitialGuess(char optionType, double quote, double S, double K, double T, double r, double b)
+{
+	const double pi = 3.14159265358979323846;
+
+	double discountedSpot = S * exp((b - r) * T);
+	double discountedStrike = K * exp(-r * T);
+	double callPrice = (optionType == 'C') ? quote : quote + discountedSpot - discountedStrike;
+
+	double moneyness = discountedSpot - discountedStrike;
+	double centered = callPrice - moneyness / 2;
+	double discriminant = centered * centered - (moneyness * moneyness) / pi;
+	if (discriminant < 0)
+		discriminant = 0;
+
+	double guess = (sqrt(2 * pi / T) / (discountedSpot + discountedStrike)) * (centered + sqrt(discriminant));
+	if (!(guess > 1e-4))
+		guess = 1e-4;
+	if (guess > 5)
+		guess = 5;
+
+	return guess;
+}
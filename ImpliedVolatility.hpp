@@ -0,0 +1,81 @@
+// ImpliedVolatility.hpp
+//
+// The purpose of the ImpliedVolSolver class is to invert the Black-Scholes-Merton pricing formula of the EuropeanOption class, i.e.
+// to recover the volatility sig at which EuropeanOption::Price reproduces a quoted option price. For each quote the solver
+//		1. checks the quote against the no-arbitrage bounds of the option (flagging quotes that cannot be inverted),
+//		2. starts from the previous solution of the same contract when one is supplied (warm start), and otherwise from the
+//		   Corrado-Miller rational approximation,
+//		3. takes Halley steps built from the price, vega and volga of EuropeanOption::Evaluate, and
+//		4. keeps a bracket [sigLow, sigHigh] around the root which is tightened after every evaluation; whenever a Halley step
+//		   would leave the bracket, or vega is too small to trust, it falls back to bisecting the bracket.
+// Each solve reports its status and the number of pricing evaluations it used so that solver cost can be monitored.
+
+#ifndef ImpliedVolatility_H
+#define ImpliedVolatility_H
+
+#include "EuropeanOption.hpp"
+#include "OptionBatch.hpp"
+
+#include <cstddef>
+
+class ThreadPool;
+
+// Possible outcomes of an implied volatility solve
+enum ImpliedVolStatus
+{
+	ImpliedVolConverged = 0,						// vol reproduces the quote to within the solver's price tolerance
+	ImpliedVolBelowIntrinsic = 1,					// The quote is at or below the option's lower no-arbitrage bound; vol is 0
+	ImpliedVolAboveMaximum = 2,						// The quote is at or above the option's upper no-arbitrage bound, or above the price at
+													// the upper search limit; vol is the upper search limit
+	ImpliedVolMaxIterations = 3,					// The iteration limit was reached, or the bracket narrowed to the vol tolerance without
+													// reproducing the quote; vol is the best estimate found
+	ImpliedVolInvalidInput = 4						// A non-positive spot, strike or maturity, or a non-finite quote; vol is 0
+};
+
+struct ImpliedVolResult
+{
+	double vol;										// Implied volatility
+	int iterations;									// Number of pricing evaluations used
+	ImpliedVolStatus status;						// Outcome of the solve
+};
+
+class ImpliedVolSolver
+{
+private:
+	double volTolerance;							// Absolute tolerance on sig
+	double priceTolerance;							// Tolerance on |price - quote|, relative to max(1, quote)
+	int maxIterations;								// Maximum number of pricing evaluations per quote
+	double maxVol;									// Upper end of the search interval
+
+public:
+	// Constructors and Destructor
+	ImpliedVolSolver();																	// Default constructor; tolerances of 1e-10 and 1e-12, 50 iterations
+	ImpliedVolSolver(double volTol, double priceTol, int maxIter, double volCap);		// Value constructor
+	ImpliedVolSolver(const ImpliedVolSolver& solver);									// Copy constructor
+	virtual ~ImpliedVolSolver();														// Destructor
+
+
+	// Accessor Functions
+	ImpliedVolResult Solve(const EuropeanOption& option, double quote, double S, double r, double b,
+						   double previousVol = 0) const;								// Solves for one contract; a positive previousVol is used as the
+																						// starting point instead of the rational approximation
+
+	void Solve(const OptionBatchView& view, const double* quotes, const double* previousVols,
+			   ImpliedVolResult* results) const;										// Solves every row of view (whose sig column is ignored) against the
+																						// matching entry of quotes; previousVols may be null
+	void Solve(const OptionBatchView& view, const double* quotes, const double* previousVols,
+			   ImpliedVolResult* results, ThreadPool& pool, size_t grain = 0) const;		// Parallel version of the above
+
+
+	// Modifier Functions
+	ImpliedVolSolver& operator = (const ImpliedVolSolver& solver);						// Assignment operator
+
+
+	// Static Functions
+	static double InitialGuess(char optionType, double quote, double S, double K, double T, double r, double b);
+																						// Corrado-Miller approximation of the implied volatility
+
+};
+
+
+#endif
@@ -0,0 +1,350 @@
+// Instrumentation.cpp
+
+#include "Instrumentation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+
+
+namespace
+{
+	// Histogram layout: values below subBuckets ticks have a bucket each; above that, each range [2^e, 2^(e+1)) is split into
+	// subBuckets buckets. Values of 2^(maxShift + subBucketBits + 1) ticks or more land in the last bucket.
+	const int subBucketBits = 5;
+	const unsigned long long subBuckets = 1ULL << subBucketBits;
+	const int maxShift = 40;
+	const size_t bucketCount = static_cast<size_t>((maxShift + 2) * subBuckets);
+
+	// One probe's histogram as recorded by one thread; only the owning thread writes, any thread may read
+	struct Histogram
+	{
+		atomic<unsigned long long> buckets[bucketCount];
+		atomic<unsigned long long> count;
+		atomic<unsigned long long> total;
+		atomic<unsigned long long> max;
+
+		Histogram() : count(0), total(0), max(0)
+		{
+			for (size_t i = 0; i < bucketCount; i++)
+				buckets[i].store(0, memory_order_relaxed);
+		}
+	};
+
+	// The histograms of one thread, created when the thread first records anything and kept after it exits
+	struct ThreadRecorder
+	{
+		atomic<Histogram*> probes[Instrumentation::maxProbes];
+
+		ThreadRecorder()
+		{
+			for (size_t i = 0; i < Instrumentation::maxProbes; i++)
+				probes[i].store(0, memory_order_relaxed);
+		}
+	};
+
+	// Probe names and every thread's recorder; the mutex is taken only to register probes and threads and to summarize
+	struct Registry
+	{
+		mutex lock;
+		vector<string> names;
+		vector<ThreadRecorder*> recorders;
+	};
+
+	Registry& GetRegistry()
+	{
+		static Registry* registry = new Registry();				// Never destroyed, so threads exiting after main may still record
+		return *registry;
+	}
+
+	thread_local ThreadRecorder* threadRecorder = 0;
+
+	// Returns the calling thread's recorder, registering it on first use
+	ThreadRecorder& GetThreadRecorder()
+	{
+		if (threadRecorder == 0)
+		{
+			threadRecorder = new ThreadRecorder();
+			Registry& registry = GetRegistry();
+			lock_guard<mutex> guard(registry.lock);
+			registry.recorders.push_back(threadRecorder);
+		}
+		return *threadRecorder;
+	}
+
+	// Returns the bucket of a value of ticks
+	size_t BucketOf(unsigned long long ticks)
+	{
+		if (ticks < subBuckets)
+			return static_cast<size_t>(ticks);
+
+		int exponent = 63;
+		while ((ticks >> exponent) == 0)
+			exponent--;
+		int shift = exponent - subBucketBits;
+		if (shift > maxShift)
+			return bucketCount - 1;
+
+		return static_cast<size_t>((shift + 1) * subBuckets + ((ticks >> shift) - subBuckets));
+	}
+
+	// Returns the midpoint of the range of values counted by bucket
+	double BucketValue(size_t bucket)
+	{
+		if (bucket < subBuckets)
+			return static_cast<double>(bucket);
+
+		int shift = static_cast<int>(bucket / subBuckets) - 1;
+		double lower = static_cast<double>((subBuckets + bucket % subBuckets) << shift);
+		return lower + 0.5 * static_cast<double>(1ULL << shift);
+	}
+
+	// Adds one to a counter owned by the calling thread; no read-modify-write is needed since no other thread writes it
+	void Bump(atomic<unsigned long long>& counter, unsigned long long amount)
+	{
+		counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed);
+	}
+
+	// Returns the smallest bucket value at or below which a fraction q of the count lies
+	double Quantile(const vector<unsigned long long>& buckets, unsigned long long count, double q)
+	{
+		unsigned long long rank = static_cast<unsigned long long>(q * count + 0.999999999);
+		rank = (rank == 0) ? 1 : rank;
+		unsigned long long seen = 0;
+		for (size_t i = 0; i < buckets.size(); i++)
+		{
+			seen += buckets[i];
+			if (seen >= rank)
+				return BucketValue(i);
+		}
+		return BucketValue(buckets.size() - 1);
+	}
+
+	// Escapes the characters of name that are special inside a quoted Prometheus label value or JSON string
+	string Escape(const string& name)
+	{
+		string escaped;
+		for (size_t i = 0; i < name.size(); i++)
+		{
+			if (name[i] == '\\' || name[i] == '"')
+				escaped += '\\';
+			escaped += name[i];
+		}
+		return escaped;
+	}
+}
+
+
+// -------------------------------------------------------------------------- Static Functions ------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns whether the probes were compiled in
+bool Instrumentation::IsEnabled()
+{
+#if defined(EXACT_PRICING_INSTRUMENT)
+	return true;
+#else
+	return false;
+#endif
+}
+
+// Returns the number of ticks per nanosecond, measured once by timing a 20 ms busy wait with both clocks
+double Instrumentation::TicksPerNanosecond()
+{
+	static const double ticksPerNanosecond = []
+	{
+		typedef chrono::steady_clock Clock;
+		Clock::time_point start = Clock::now();
+		unsigned long long startTicks = Ticks();
+		Clock::time_point now = start;
+		while (now - start < chrono::milliseconds(20))
+			now = Clock::now();
+		unsigned long long ticks = Ticks() - startTicks;
+		double nanoseconds = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(now - start).count());
+		return (ticks > 0) ? ticks / nanoseconds : 1.0;
+	}();
+	return ticksPerNanosecond;
+}
+
+// Returns the index of the probe called name, creating it if no probe of that name exists yet, so that probes at different sites
+// may share a name. Called once per site by INSTRUMENT_SCOPE.
+size_t Instrumentation::Register(const char* name)
+{
+	Registry& registry = GetRegistry();
+	lock_guard<mutex> guard(registry.lock);
+
+	for (size_t i = 0; i < registry.names.size(); i++)
+	{
+		if (registry.names[i] == name)
+			return i;
+	}
+
+	if (registry.names.size() == maxProbes)
+		return invalidProbe;
+
+	registry.names.push_back(name);
+	return registry.names.size() - 1;
+}
+
+// Adds a time of ticks to the calling thread's histogram of probe, creating the histogram on first use
+void Instrumentation::Record(size_t probe, unsigned long long ticks)
+{
+	if (probe >= maxProbes)
+		return;
+
+	ThreadRecorder& recorder = GetThreadRecorder();
+	Histogram* histogram = recorder.probes[probe].load(memory_order_relaxed);
+	if (histogram == 0)
+	{
+		histogram = new Histogram();
+		recorder.probes[probe].store(histogram, memory_order_release);
+	}
+
+	Bump(histogram->buckets[BucketOf(ticks)], 1);
+	Bump(histogram->count, 1);
+	Bump(histogram->total, ticks);
+	if (ticks > histogram->max.load(memory_order_relaxed))
+		histogram->max.store(ticks, memory_order_relaxed);
+}
+
+// Merges every thread's histograms probe by probe and converts the results to nanoseconds
+vector<ProbeSummary> Instrumentation::Summarize()
+{
+	vector<ProbeSummary> summaries;
+	double ticksPerNanosecond = TicksPerNanosecond();
+
+	Registry& registry = GetRegistry();
+	lock_guard<mutex> guard(registry.lock);
+
+	vector<unsigned long long> buckets(bucketCount);
+	for (size_t p = 0; p < registry.names.size(); p++)
+	{
+		fill(buckets.begin(), buckets.end(), 0);
+		unsigned long long count = 0, total = 0, max = 0;
+		for (size_t t = 0; t < registry.recorders.size(); t++)
+		{
+			const Histogram* histogram = registry.recorders[t]->probes[p].load(memory_order_acquire);
+			if (histogram == 0)
+				continue;
+
+			for (size_t i = 0; i < bucketCount; i++)
+				buckets[i] += histogram->buckets[i].load(memory_order_relaxed);
+			count += histogram->count.load(memory_order_relaxed);
+			total += histogram->total.load(memory_order_relaxed);
+			max = std::max(max, histogram->max.load(memory_order_relaxed));
+		}
+		if (count == 0)
+			continue;
+
+		// The buckets of a thread that is still recording may be a few counts ahead of or behind its count
+		unsigned long long bucketTotal = 0;
+		for (size_t i = 0; i < bucketCount; i++)
+			bucketTotal += buckets[i];
+
+		ProbeSummary summary;
+		summary.name = registry.names[p];
+		summary.count = count;
+		summary.totalNs = total / ticksPerNanosecond;
+		summary.meanNs = summary.totalNs / count;
+		summary.p50Ns = Quantile(buckets, bucketTotal, 0.5) / ticksPerNanosecond;
+		summary.p90Ns = Quantile(buckets, bucketTotal, 0.9) / ticksPerNanosecond;
+		summary.p99Ns = Quantile(buckets, bucketTotal, 0.99) / ticksPerNanosecond;
+		summary.p999Ns = Quantile(buckets, bucketTotal, 0.999) / ticksPerNanosecond;
+		summary.maxNs = max / ticksPerNanosecond;
+		summaries.push_back(summary);
+	}
+
+	return summaries;
+}
+
+// Clears every histogram of every thread
+void Instrumentation::Reset()
+{
+	Registry& registry = GetRegistry();
+	lock_guard<mutex> guard(registry.lock);
+
+	for (size_t t = 0; t < registry.recorders.size(); t++)
+	{
+		for (size_t p = 0; p < maxProbes; p++)
+		{
+			Histogram* histogram = registry.recorders[t]->probes[p].load(memory_order_acquire);
+			if (histogram == 0)
+				continue;
+
+			for (size_t i = 0; i < bucketCount; i++)
+				histogram->buckets[i].store(0, memory_order_relaxed);
+			histogram->count.store(0, memory_order_relaxed);
+			histogram->total.store(0, memory_order_relaxed);
+			histogram->max.store(0, memory_order_relaxed);
+		}
+	}
+}
+
+// Writes one Prometheus summary per probe, labelled with the probe name, plus a gauge holding the largest time recorded; times are
+// in seconds as Prometheus conventions require
+void Instrumentation::WritePrometheus(ostream& os)
+{
+	vector<ProbeSummary> summaries = Summarize();
+	const char* metric = "exact_pricing_probe_seconds";
+
+	os << "# HELP " << metric << " Time spent in instrumented blocks of the exact pricing library." << endl;
+	os << "# TYPE " << metric << " summary" << endl;
+	for (size_t i = 0; i < summaries.size(); i++)
+	{
+		const ProbeSummary& s = summaries[i];
+		string label = "probe=\"" + Escape(s.name) + "\"";
+		os << metric << "{" << label << ",quantile=\"0.5\"} " << s.p50Ns * 1e-9 << endl;
+		os << metric << "{" << label << ",quantile=\"0.9\"} " << s.p90Ns * 1e-9 << endl;
+		os << metric << "{" << label << ",quantile=\"0.99\"} " << s.p99Ns * 1e-9 << endl;
+		os << metric << "{" << label << ",quantile=\"0.999\"} " << s.p999Ns * 1e-9 << endl;
+		os << metric << "_sum{" << label << "} " << s.totalNs * 1e-9 << endl;
+		os << metric << "_count{" << label << "} " << s.count << endl;
+	}
+
+	os << "# HELP " << metric << "_max Largest time recorded by each probe." << endl;
+	os << "# TYPE " << metric << "_max gauge" << endl;
+	for (size_t i = 0; i < summaries.size(); i++)
+		os << metric << "_max{probe=\"" << Escape(summaries[i].name) << "\"} " << summaries[i].maxNs * 1e-9 << endl;
+}
+
+// Writes the summaries as a JSON document with times in nanoseconds
+void Instrumentation::WriteJson(ostream& os)
+{
+	vector<ProbeSummary> summaries = Summarize();
+
+	os << "{" << endl << "  \"ticks_per_ns\": " << TicksPerNanosecond() << "," << endl << "  \"probes\": [" << endl;
+	for (size_t i = 0; i < summaries.size(); i++)
+	{
+		const ProbeSummary& s = summaries[i];
+		os << "    { \"name\": \"" << Escape(s.name) << "\", \"count\": " << s.count << ", \"total_ns\": " << s.totalNs << ", \"mean_ns\": "
+		   << s.meanNs << ", \"p50_ns\": " << s.p50Ns << ", \"p90_ns\": " << s.p90Ns << ", \"p99_ns\": " << s.p99Ns << ", \"p999_ns\": "
+		   << s.p999Ns << ", \"max_ns\": " << s.maxNs << " }" << ((i + 1 < summaries.size()) ? "," : "") << endl;
+	}
+	os << "  ]" << endl << "}" << endl;
+}
+
+// Writes the summaries to path + ".tmp" and renames that file to path, replacing any previous dump
+bool Instrumentation::Dump(const string& path)
+{
+	string temporary = path + ".tmp";
+	{
+		ofstream file(temporary.c_str(), ios::trunc);
+		if (!file)
+			return false;
+
+		bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+		if (json)
+			WriteJson(file);
+		else
+			WritePrometheus(file);
+
+		file.close();
+		if (file.fail())
+			return false;
+	}
+
+	remove(path.c_str());								// rename does not replace an existing file on every platform
+	return rename(temporary.c_str(), path.c_str()) == 0;
+}
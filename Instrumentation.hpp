@@ -0,0 +1,121 @@
+// Instrumentation.hpp
+//
+// The purpose of the Instrumentation class is to show where time goes on the hot paths -- the pricing and Greeks entry points, the
+// normal CDF and PDF, the batch loops and the load, evaluate and write stages of the batch tools -- without attaching a profiler. A
+// probe is placed by writing INSTRUMENT_SCOPE("name"); at the top of a block; the time from there to the end of the block is read
+// from the CPU's time stamp counter (the steady clock on other processors) and added to a histogram for that probe.
+//
+// Each thread records into histograms of its own, so recording takes no locks and never contends: a bucket is bumped with a relaxed
+// load and store by the one thread that owns it, and other threads may read it concurrently. The histograms are log-linear in the
+// manner of HDR histograms: values below 32 ticks have a bucket each, and each power-of-two range above that is split into 32
+// buckets, so every recorded value is known to within about 3% up to 2^45 ticks. Summarize merges the histograms of every thread
+// that has ever recorded, including threads that have exited, into counts, means and percentiles converted to nanoseconds, and
+// WritePrometheus, WriteJson and Dump publish them in the Prometheus text exposition format or as JSON.
+//
+// All of this is compiled in only when EXACT_PRICING_INSTRUMENT is defined. Otherwise INSTRUMENT_SCOPE expands to nothing, the probes
+// cost nothing, and Summarize returns no probes. Each probe adds two time stamp counter reads and a few memory operations to its
+// block, i.e. some 10-20 ns, which is small next to a price but not next to a single N() call, so the N and n probes inflate the
+// times of the functions calling them.
+
+#ifndef Instrumentation_H
+#define Instrumentation_H
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define INSTRUMENT_RDTSC
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#define INSTRUMENT_RDTSC
+#include <x86intrin.h>
+#endif
+
+using namespace std;
+
+// Latency statistics of one probe, merged across threads; times are in nanoseconds
+struct ProbeSummary
+{
+	string name;
+	unsigned long long count;							// Times the probe was passed
+	double totalNs;										// Sum of the recorded times
+	double meanNs;
+	double p50Ns;
+	double p90Ns;
+	double p99Ns;
+	double p999Ns;
+	double maxNs;
+};
+
+class Instrumentation
+{
+private:
+	Instrumentation();									// Not constructible; every member is static
+
+public:
+	static const size_t maxProbes = 128;				// Probes beyond this number are registered as invalidProbe and ignored
+	static const size_t invalidProbe = maxProbes;
+
+	// Static Functions
+	static bool IsEnabled();																// Returns whether EXACT_PRICING_INSTRUMENT was defined
+	static unsigned long long Ticks();														// Returns the current time stamp counter value
+	static double TicksPerNanosecond();														// Returns the time stamp counter frequency in GHz,
+																							// calibrated against the steady clock on first use
+
+	static size_t Register(const char* name);												// Returns the index of the probe called name, creating
+																							// it on first use
+	static void Record(size_t probe, unsigned long long ticks);								// Adds ticks to the calling thread's histogram of probe
+
+	static vector<ProbeSummary> Summarize();												// Merges the histograms of every thread; probes never
+																							// passed are omitted
+	static void Reset();																	// Clears every histogram; counts recorded concurrently
+																							// with Reset may be lost
+
+	static void WritePrometheus(ostream& os);												// Writes Summarize() as Prometheus summaries
+	static void WriteJson(ostream& os);														// Writes Summarize() as a JSON document
+	static bool Dump(const string& path);													// Writes Prometheus text, or JSON if path ends in .json,
+																							// to a temporary file renamed to path once complete so
+																							// that readers of path never see a partial file
+};
+
+// Reads the time stamp counter, or the steady clock in nanoseconds where there is none
+inline unsigned long long Instrumentation::Ticks()
+{
+#if defined(INSTRUMENT_RDTSC)
+	return __rdtsc();
+#else
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Times the enclosing block and records it under a probe; created by INSTRUMENT_SCOPE
+class ScopedProbe
+{
+private:
+	size_t probe;
+	unsigned long long start;
+
+	ScopedProbe(const ScopedProbe&);					// Not copyable
+	ScopedProbe& operator = (const ScopedProbe&);		// Not assignable
+
+public:
+	explicit ScopedProbe(size_t probeIndex) : probe(probeIndex), start(Instrumentation::Ticks()) {}
+	~ScopedProbe() { Instrumentation::Record(probe, Instrumentation::Ticks() - start); }
+};
+
+#define INSTRUMENT_CONCATENATE_(a, b) a##b
+#define INSTRUMENT_CONCATENATE(a, b) INSTRUMENT_CONCATENATE_(a, b)
+
+#if defined(EXACT_PRICING_INSTRUMENT)
+#define INSTRUMENT_SCOPE(name)																				\
+	static const size_t INSTRUMENT_CONCATENATE(instrumentProbe, __LINE__) = Instrumentation::Register(name);	\
+	ScopedProbe INSTRUMENT_CONCATENATE(instrumentScope, __LINE__)(INSTRUMENT_CONCATENATE(instrumentProbe, __LINE__))
+#else
+#define INSTRUMENT_SCOPE(name) ((void)0)
+#endif
+
+
+#endif
@@ -0,0 +1,181 @@
+// NormalDistribution.cpp
+
+#include "NormalDistribution.hpp"
+
+
+namespace
+{
+	constexpr double pi = 3.14159265358979323846;
+
+	// Compile-time replacements for the <cmath> functions needed to build the tables, which are not constexpr before C++26. They
+	// are accurate to a few ulps over the ranges used below, which is far more than the ChebyshevTier and TableTier need.
+
+	// Returns e^x for |x| <= 40, reducing x to r = x - m ln 2 with |r| <= ln 2 / 2 and summing the Taylor series of e^r
+	constexpr double ConstExp(double x)
+	{
+		const double ln2Hi = 6.93147180369123816490e-01;		// ln 2 split in two, so that m * ln2Hi is exact
+		const double ln2Lo = 1.90821492927058770002e-10;
+		int m = int(x / (ln2Hi + ln2Lo) + ((x < 0) ? -0.5 : 0.5));
+		double r = (x - m * ln2Hi) - m * ln2Lo;
+
+		double sum = 1, term = 1;
+		for (int k = 1; k < 25; k++)
+		{
+			term *= r / k;
+			sum += term;
+		}
+
+		for (; m > 0; m--)
+			sum *= 2;
+		for (; m < 0; m++)
+			sum /= 2;
+		return sum;
+	}
+
+	// Returns cos(x) for x >= 0, reducing x to [0, pi] and summing the Taylor series of sin at x - pi / 2
+	constexpr double ConstCos(double x)
+	{
+		x -= 2 * pi * int(x / (2 * pi));
+		if (x > pi)
+			x = 2 * pi - x;
+
+		double y = x - pi / 2;
+		double sum = y, term = y;
+		for (int k = 1; k < 20; k++)
+		{
+			term *= -(y * y) / ((2 * k) * (2 * k + 1));
+			sum += term;
+		}
+		return -sum;
+	}
+
+	// Returns Q(z) = 1 - N(z) = erfc(z / sqrt(2)) / 2 for z >= 0. Below z = 3.5 erf is summed from the series
+	//		erf(w) = 2 / sqrt(pi) * e^(-w^2) * sum over k of w (2w^2)^k / (1 * 3 * ... * (2k + 1)),
+	// whose terms are all positive, and above it erfc is taken from its continued fraction
+	//		erfc(w) = e^(-w^2) / sqrt(pi) * 1 / (w + (1/2) / (w + 1 / (w + (3/2) / (w + 2 / (w + ...))))),
+	// evaluated from the bottom up, with w = z / sqrt(2).
+	constexpr double ConstQ(double z)
+	{
+		const double invSqrtPi = 0.56418958354775628695;
+		double w = z * 0.70710678118654752440;
+		double gauss = ConstExp(-(w * w));
+
+		if (z < 3.5)
+		{
+			double sum = w, term = w;
+			for (int k = 1; k < 200; k++)
+			{
+				term *= (2 * (w * w)) / (2 * k + 1);
+				sum += term;
+			}
+			return 0.5 * (1 - 2 * invSqrtPi * gauss * sum);
+		}
+
+		double fraction = w;
+		for (int k = 400; k > 0; k--)
+			fraction = w + (k / 2.0) / fraction;
+		return 0.5 * (invSqrtPi * gauss / fraction);
+	}
+
+	// Returns n(z)
+	constexpr double ConstPdf(double z)
+	{
+		return 0.39894228040143267794 * ConstExp(-0.5 * (z * z));
+	}
+
+	// Fits every ChebyshevTier piece: Q is interpolated at the M = degree + 1 Chebyshev nodes of the piece, t_j = cos(pi (j + 1/2) / M),
+	// giving the Chebyshev series sum over k of c_k T_k(t), which is then expanded into powers of t using T_(k+1) = 2t T_k - T_(k-1)
+	constexpr NormalDistribution::ChebyshevCoefficients BuildChebyshev()
+	{
+		const size_t M = NormalDistribution::chebyshevDegree + 1;
+		const double width = 1.0 / NormalDistribution::chebyshevPiecesPerUnit;
+		NormalDistribution::ChebyshevCoefficients result{};
+
+		for (size_t p = 0; p < NormalDistribution::chebyshevPieces; p++)
+		{
+			double values[M] = {};
+			for (size_t j = 0; j < M; j++)
+				values[j] = ConstQ((p + 0.5 + 0.5 * ConstCos(pi * (j + 0.5) / M)) * width);
+
+			double previous[M] = {};							// Power coefficients of T_(k-1) and T_k
+			double current[M] = {};
+			current[0] = 1;
+			for (size_t k = 0; k < M; k++)
+			{
+				double c = 0;
+				for (size_t j = 0; j < M; j++)
+					c += values[j] * ConstCos(pi * k * (j + 0.5) / M);
+				c *= ((k == 0) ? 1.0 : 2.0) / M;
+
+				for (size_t i = 0; i < M; i++)
+					result.coefficient[p][i] += c * current[i];
+
+				double next[M] = {};
+				for (size_t i = 0; i < M; i++)
+				{
+					next[i] = ((k == 0) ? 1.0 : 2.0) * ((i > 0) ? current[i - 1] : 0) - previous[i];
+					previous[i] = current[i];
+				}
+				for (size_t i = 0; i < M; i++)
+					current[i] = next[i];
+			}
+		}
+
+		return result;
+	}
+
+	// Fills the TableTier table with Q and n at the nodes
+	constexpr NormalDistribution::TableValues BuildTable()
+	{
+		NormalDistribution::TableValues result{};
+		for (size_t i = 0; i < NormalDistribution::tableSize; i++)
+		{
+			double z = double(i) / NormalDistribution::tableNodesPerUnit;
+			result.Q[i] = ConstQ(z);
+			result.pdf[i] = ConstPdf(z);
+		}
+		return result;
+	}
+
+	constexpr NormalDistribution::ChebyshevCoefficients builtChebyshev = BuildChebyshev();
+	constexpr NormalDistribution::TableValues builtTable = BuildTable();
+}
+
+NormalDistribution::Tier NormalDistribution::tier = NormalDistribution::FullTier;
+const NormalDistribution::ChebyshevCoefficients NormalDistribution::chebyshev = builtChebyshev;
+const NormalDistribution::TableValues NormalDistribution::table = builtTable;
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the tier used by Cdf and Pdf
+NormalDistribution::Tier NormalDistribution::GetTier()
+{
+#if defined(EXACT_PRICING_NORMAL_TIER)
+	return Tier(EXACT_PRICING_NORMAL_TIER);
+#else
+	return tier;
+#endif
+}
+
+// Returns the name of which as used in reports
+const char* NormalDistribution::Name(Tier which)
+{
+	switch (which)
+	{
+	case FullTier:		return "full";
+	case ChebyshevTier:	return "chebyshev";
+	default:			return "table";
+	}
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Selects the tier used by Cdf and Pdf
+void NormalDistribution::SetTier(Tier newTier)
+{
+	tier = newTier;
+}
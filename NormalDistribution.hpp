@@ -0,0 +1,212 @@
+// NormalDistribution.hpp
+//
+// The purpose of the NormalDistribution class is to evaluate the standard normal CDF and PDF for the single-contract pricing path,
+// where every Greek set calls them a dozen times and a vectorized batch does not help. It offers three accuracy tiers:
+//
+//		FullTier		CDF from std::erfc and PDF from std::exp; std::erfc is the Cody / fdlibm style rational approximation of the C
+//						library and agrees with the boost normal distribution to within a few ulps
+//		ChebyshevTier	CDF from piecewise polynomials fitted at Chebyshev nodes: 17 pieces of width 0.5 over [0, 8.5], degree 7,
+//						evaluated by Estrin's scheme; PDF as in FullTier
+//		TableTier		CDF and PDF by cubic Hermite interpolation in a table of the CDF and PDF at steps of 1/16 over [0, 8]
+//
+// Every tier works with Q(z) = 1 - N(z) for z = |x| and reflects, so that N(x) for x < 0 does not lose its digits to the cancellation
+// in 1 - N(|x|), and returns N = 0 or 1 and n = 0 beyond the range of its pieces or table. The polynomial coefficients and the table
+// are computed at compile time (constexpr) in NormalDistribution.cpp from a series / continued fraction evaluation of erfc, so no
+// tier has any start-up cost.
+//
+// Largest absolute errors against long double erfcl and expl, measured at 2 * 10^7 points over [-10, 10]:
+//		FullTier		CDF 1.2e-16		PDF 7.7e-17
+//		ChebyshevTier	CDF 3.6e-11		PDF 7.7e-17
+//		TableTier		CDF 2.2e-8		PDF 4.7e-8
+// Only FullTier is accurate relative to N(x) in the lower tail. The other two fit Q itself, so their absolute error is spread evenly
+// over the range and their relative error grows as N(x) shrinks; the largest relative errors of N(x) over x in [a, 0] are
+//		a =				-3				-5				-7.9
+//		FullTier		1.9e-15			3.6e-15			9.5e-15
+//		ChebyshevTier	4.3e-9			7.1e-7			8.6e-5
+//		TableTier		2.2e-6			2.2e-5			1.5e-4
+// and both return 0 from x = -8.5 (ChebyshevTier) or x = -8 (TableTier) downwards.
+//
+// Time per call, the minimum over 300 passes of 2048 calls on a single core of the development machine, with the calls independent
+// of one another:
+//		FullTier		CDF 20 ns		PDF 7 ns
+//		ChebyshevTier	CDF 11 ns		PDF 7 ns
+//		TableTier		CDF 8 ns		PDF 7 ns
+// Measured the same way, a full EuropeanOption::Evaluate takes about 80 ns (65 ns for the price alone) in all three tiers: within a
+// Greek set, which also takes a logarithm, two exponentials and a square root, the faster tiers show no measurable gain, and they
+// pay off only where Cdf is called on its own. EuropeanOption::N and n are inline, so that the run-time selection costs one well
+// predicted test of the tier per call, and ChebyshevCdf evaluates its pieces by Estrin's scheme, whose dependency chain is three
+// multiply-adds long rather than the seven of Horner's rule.
+//
+// The tier used by Cdf and Pdf, and through them by EuropeanOption::N and n and every double precision kernel, is chosen at run time
+// with SetTier (FullTier by default), or at compile time by defining EXACT_PRICING_NORMAL_TIER as 0, 1 or 2, in which case the tier
+// is fixed, SetTier has no effect and Cdf and Pdf carry no dispatch. The tier functions can also be called directly.
+
+#ifndef NormalDistribution_H
+#define NormalDistribution_H
+
+#include <cmath>
+#include <cstddef>
+
+class NormalDistribution
+{
+public:
+	enum Tier { FullTier = 0, ChebyshevTier = 1, TableTier = 2 };
+
+	static const size_t chebyshevPieces = 17;						// Pieces of the ChebyshevTier CDF
+	static const size_t chebyshevPiecesPerUnit = 2;					// i.e. pieces of width 0.5, covering [0, 8.5]
+	static const size_t chebyshevDegree = 7;						// Degree of every piece; ChebyshevCdf relies on it being 7
+	static const size_t tableNodesPerUnit = 16;						// Nodes of the TableTier table per unit of z
+	static const size_t tableSize = 8 * tableNodesPerUnit + 1;		// i.e. nodes 0, 1/16, ..., 8
+
+	// Coefficients of the ChebyshevTier pieces; piece p covers z in [p / 2, (p + 1) / 2] and is a polynomial in t = 4z - 2p - 1,
+	// which runs over [-1, 1], with coefficient[p][k] the coefficient of t^k
+	struct ChebyshevCoefficients
+	{
+		double coefficient[chebyshevPieces][chebyshevDegree + 1];
+	};
+
+	// Values of Q = 1 - N and of n at the TableTier nodes z = i / 16
+	struct TableValues
+	{
+		double Q[tableSize];
+		double pdf[tableSize];
+	};
+
+private:
+	static Tier tier;												// Tier used by Cdf and Pdf unless fixed at compile time
+	static const ChebyshevCoefficients chebyshev;
+	static const TableValues table;
+
+public:
+	// Accessor Functions
+	static Tier GetTier();											// Returns the tier used by Cdf and Pdf
+	static const char* Name(Tier which);							// Returns "full", "chebyshev" or "table"
+
+	static double Cdf(double x);									// Returns the standard normal CDF at x in the current tier
+	static double Pdf(double x);									// Returns the standard normal PDF at x in the current tier
+
+	static double FullCdf(double x);								// The tier functions; see above
+	static double FullPdf(double x);
+	static double ChebyshevCdf(double x);
+	static double ChebyshevPdf(double x);
+	static double TableCdf(double x);
+	static double TablePdf(double x);
+
+
+	// Modifier Functions
+	static void SetTier(Tier newTier);								// Selects the tier used by Cdf and Pdf; not thread safe with respect to
+																	// pricing running concurrently. Has no effect when the tier is fixed
+																	// at compile time
+};
+
+// Returns N(x) = erfc(-x / sqrt(2)) / 2
+inline double NormalDistribution::FullCdf(double x)
+{
+	return 0.5 * std::erfc(-x * 0.70710678118654752440);			// 1 / sqrt(2)
+}
+
+// Returns n(x) = exp(-x^2 / 2) / sqrt(2 pi)
+inline double NormalDistribution::FullPdf(double x)
+{
+	return 0.39894228040143267794 * std::exp(-0.5 * (x * x));		// 1 / sqrt(2 pi)
+}
+
+// Returns N(x) from the piece of Q covering |x|
+inline double NormalDistribution::ChebyshevCdf(double x)
+{
+	double z = std::fabs(x);
+	if (z != z)
+		return x;
+
+	double Q = 0;
+	if (z < double(chebyshevPieces) / chebyshevPiecesPerUnit)
+	{
+		double u = z * chebyshevPiecesPerUnit;
+		size_t piece = size_t(u);
+		double t = 2 * (u - piece) - 1;
+		const double* c = chebyshev.coefficient[piece];
+		double t2 = t * t;											// Estrin's scheme
+		double t4 = t2 * t2;
+		double low = (c[0] + c[1] * t) + (c[2] + c[3] * t) * t2;
+		double high = (c[4] + c[5] * t) + (c[6] + c[7] * t) * t2;
+		Q = low + high * t4;
+	}
+
+	return (x < 0) ? Q : 1 - Q;
+}
+
+// Returns n(x); the ChebyshevTier PDF is that of FullTier, std::exp being faster than any piecewise fit as accurate as the CDF
+inline double NormalDistribution::ChebyshevPdf(double x)
+{
+	return FullPdf(x);
+}
+
+// Returns N(x) by cubic Hermite interpolation of Q between the table nodes around |x|, using Q' = -n
+inline double NormalDistribution::TableCdf(double x)
+{
+	double z = std::fabs(x);
+	if (z != z)
+		return x;
+
+	double Q = 0;
+	if (z < double(tableSize - 1) / tableNodesPerUnit)
+	{
+		const double h = 1.0 / tableNodesPerUnit;
+		double u = z * tableNodesPerUnit;
+		size_t i = size_t(u);
+		double s = u - i;
+		double r = 1 - s;
+		Q = (r * r * (1 + 2 * s)) * table.Q[i] - (s * r * r * h) * table.pdf[i] + (s * s * (3 - 2 * s)) * table.Q[i + 1]
+			+ (s * s * r * h) * table.pdf[i + 1];
+	}
+
+	return (x < 0) ? Q : 1 - Q;
+}
+
+// Returns n(x) by cubic Hermite interpolation of n between the table nodes around |x|, using n'(z) = -z n(z)
+inline double NormalDistribution::TablePdf(double x)
+{
+	double z = std::fabs(x);
+	if (!(z < double(tableSize - 1) / tableNodesPerUnit))
+		return (z != z) ? x : 0;
+
+	const double h = 1.0 / tableNodesPerUnit;
+	double u = z * tableNodesPerUnit;
+	size_t i = size_t(u);
+	double s = u - i;
+	double r = 1 - s;
+	double z0 = i * h;
+	return (r * r * (1 + 2 * s)) * table.pdf[i] - (s * r * r * h) * (z0 * table.pdf[i]) + (s * s * (3 - 2 * s)) * table.pdf[i + 1]
+		   + (s * s * r * h) * ((z0 + h) * table.pdf[i + 1]);
+}
+
+// Returns N(x) in the current tier
+inline double NormalDistribution::Cdf(double x)
+{
+#if defined(EXACT_PRICING_NORMAL_TIER) && EXACT_PRICING_NORMAL_TIER == 2
+	return TableCdf(x);
+#elif defined(EXACT_PRICING_NORMAL_TIER) && EXACT_PRICING_NORMAL_TIER == 1
+	return ChebyshevCdf(x);
+#elif defined(EXACT_PRICING_NORMAL_TIER)
+	return FullCdf(x);
+#else
+	if (tier == FullTier)
+		return FullCdf(x);
+	return (tier == ChebyshevTier) ? ChebyshevCdf(x) : TableCdf(x);
+#endif
+}
+
+// Returns n(x) in the current tier
+inline double NormalDistribution::Pdf(double x)
+{
+#if defined(EXACT_PRICING_NORMAL_TIER) && EXACT_PRICING_NORMAL_TIER == 2
+	return TablePdf(x);
+#elif defined(EXACT_PRICING_NORMAL_TIER)
+	return FullPdf(x);
+#else
+	return (tier == TableTier) ? TablePdf(x) : FullPdf(x);
+#endif
+}
+
+
+#endif
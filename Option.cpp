@@ -1,72 +1,113 @@
-// Option.cpp
-
-#include "Option.hpp"
-
-// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-
-// Default constructor
-Option::Option() : type(1), K(0)
-{
-}
-
-// Value constructor
-Option::Option(char optionType, double strike) : K(strike)
-{
-	if (optionType == 'C' || optionType == 'P')
-		type = optionType;
-//  else 
-//		throw IllegalOptionTypeException(optionType)
-}
-
-// Copy constructor
-Option::Option(const Option& op) : type(op.type), K(op.K)
-{
-}
-
-// Destructor
-Option::~Option()
-{
-}
-
-// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-
-// Returns the value of the private data member type
-char Option::GetType() const
-{
-	return type;
-}
-
-// Returns the value of the private data member K
-double Option::GetStrike() const
-{
-	return K;
-}
-
-// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-
-// Allows the user to alter the option's type
-void Option::SetType(char optionType)
-{
-	type = optionType;
-}
-
-// Allows the user to alter the option's strike price
-void Option::SetStrike(double strike)
-{
-	K = strike;
-}
-
-// Assignment operator
-Option& Option::operator = (const Option& op)
-{
-	if (this != &op)
-	{
-		type = op.type;
-		K = op.K;
-	}
-
-	return *this;
+// Option.cpp
+
+#include "Option.hpp"
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor
+Option::Option() : type(1), K(0)
+{
+}
+
+// Value constructor
+Option::Option(char optionType, double strike) : K(strike)
+{
+	if (optionType == 'C' || optionType == 'P')
+		type = optionType;
+//  else 
+//		throw IllegalOptionTypeException(optionType)
+}
+
+// Copy constructor
+Option::Option(const Option& op) : type(op.type), K(op.K)
+{
+}
+
+// Destructor
+Option::~Option()
+{
+}
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the value of the private data member type
+char Option::GetType() const
+{
+	return type;
+}
+
+// Returns the value of the private data member K
+double Option::GetStrike() const
+{
+	return K;
+}
+
+// Computes every output selected by the bit flags in outputs and returns them together; fields that are not selected are set to 0.
+// This base class version simply calls Price(), Delta() and Gamma() as requested and leaves theta and vega at 0; derived classes
+// override it in order to share work between the outputs and to fill in the Greeks they support.
+OptionResults Option::Evaluate(double S, double sig, double r, double b, int outputs) const
+{
+	OptionResults result = { 0, 0, 0, 0, 0 };
+	if (outputs & PriceOutput)
+		result.price = Price(S, sig, r, b);
+	if (outputs & DeltaOutput)
+		result.delta = Delta(S, sig, r, b);
+	if (outputs & GammaOutput)
+		result.gamma = Gamma(S, sig, r, b);
+
+	return result;
+}
+
+// Computes the higher-order Greeks selected by the bit flags in higherOutputs. The base class supports none of them and returns
+// every field as 0; derived classes with closed forms for them override it.
+HigherOrderResults Option::EvaluateHigherOrder(double, double, double, double, int) const
+{
+	HigherOrderResults result = { 0, 0, 0, 0, 0, 0, 0 };
+	return result;
+}
+
+// Computes the outputs selected by outputs into results and the higher-order Greeks selected by higherOutputs into higherResults.
+// This base class version makes the two calls separately; derived classes override it in order to share work between them.
+void Option::Evaluate(double S, double sig, double r, double b, int outputs, int higherOutputs, OptionResults& results,
+					  HigherOrderResults& higherResults) const
+{
+	results = Evaluate(S, sig, r, b, outputs);
+	higherResults = EvaluateHigherOrder(S, sig, r, b, higherOutputs);
+}
+
+// Computes the price together with its derivatives with respect to S, sig, r, b, K and T. The base class supports none of the
+// derivatives and returns every one of them as 0; derived classes with differentiable pricing formulas override it.
+PriceGradient Option::Gradient(double S, double sig, double r, double b) const
+{
+	PriceGradient result = { Price(S, sig, r, b), 0, 0, 0, 0, 0, 0 };
+	return result;
+}
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Allows the user to alter the option's type
+void Option::SetType(char optionType)
+{
+	type = optionType;
+}
+
+// Allows the user to alter the option's strike price
+void Option::SetStrike(double strike)
+{
+	K = strike;
+}
+
+// Assignment operator
+Option& Option::operator = (const Option& op)
+{
+	if (this != &op)
+	{
+		type = op.type;
+		K = op.K;
+	}
+
+	return *this;
 }
\ No newline at end of file
@@ -1,43 +1,96 @@
-// Option.hpp
-//
-// The purpose of the Option class is to serve as a unifying abstract base class for our EuropeanOption and PerpetualAmericanOption derived
-// classes. There are two private members, one of character type that stores 'C' for call options and 'P' for put options, and the other a 
-// double which stores the strike price of the option. 
-
-#ifndef Option_H
-#define Option_H
-
-class Option
-{
-private:
-	char type;									// 'C' for calls and 'P' for puts
-	double K;									// Strike price
-
-
-public:
-	// Constructors and Destructor
-	Option();									// Default constructor
-	Option(char optionType, double strike);		// Value constructor
-	Option(const Option& op);					// Copy constructor	
-	virtual ~Option();							// Destructor
-
-
-	// Accessor Functions
-	char GetType() const;																			// Getter for the private member type
-	double GetStrike() const;																		// Getter for the private member K
-	virtual double Price(double S, double sig, double r, double b) const = 0;						// PVMF
-	virtual double Delta(double S, double sig, double r, double b) const = 0;						// PVMF 
-	virtual double DivDiffDelta(double S, double sig, double r, double b, double h) const = 0;		// PVMF 
-	virtual double Gamma(double S, double sig, double r, double b) const = 0;						// PVMF 
-	virtual double DivDiffGamma(double S, double sig, double r, double b, double h) const = 0;		// PVMF 
-
-
-	// Modifier Functions
-	void SetType(char optionType);																	// Setter for the private member type
-	void SetStrike(double strike);																	// Setter for the private member K
-	Option& operator = (const Option& op);															// Assignment operator
-
-};
-
-
-#endif
+// Option.hpp
+//
+// The purpose of the Option class is to serve as a unifying abstract base class for our EuropeanOption and PerpetualAmericanOption derived
+// classes. There are two private members, one of character type that stores 'C' for call options and 'P' for put options, and the other a 
+// double which stores the strike price of the option. 
+
+#ifndef Option_H
+#define Option_H
+
+// Holds the outputs of a single-pass evaluation of an option; see Option::Evaluate
+struct OptionResults
+{
+	double price;
+	double delta;
+	double gamma;
+	double theta;
+	double vega;
+};
+
+// Holds the higher-order Greeks of a single-pass evaluation of an option; see Option::EvaluateHigherOrder. Time derivatives are
+// taken with respect to the passage of time, as for theta, and rho and carry rho are the derivatives with respect to r and b
+// separately, each holding the other fixed.
+struct HigherOrderResults
+{
+	double vanna;										// d(delta)/d(sig)
+	double volga;										// d(vega)/d(sig)
+	double charm;										// d(delta)/dt
+	double speed;										// d(gamma)/dS
+	double color;										// d(gamma)/dt
+	double rho;											// d(price)/dr
+	double carryRho;									// d(price)/db
+};
+
+// Holds a price together with its derivatives with respect to every input of the pricing formula; see Option::Gradient. Unlike
+// theta, dT is the derivative with respect to the time till maturity itself, so that for a Euro option dT = -theta.
+struct PriceGradient
+{
+	double price;
+	double dS;											// d(price)/dS, i.e. delta
+	double dSig;										// d(price)/d(sig), i.e. vega
+	double dr;											// d(price)/dr, b held fixed
+	double db;											// d(price)/db, r held fixed
+	double dK;											// d(price)/dK
+	double dT;											// d(price)/dT
+};
+
+class Option
+{
+private:
+	char type;									// 'C' for calls and 'P' for puts
+	double K;									// Strike price
+
+
+public:
+	// Bit flags used to select the fields of OptionResults filled in by Evaluate; combine them with |
+	enum Outputs { PriceOutput = 1, DeltaOutput = 2, GammaOutput = 4, ThetaOutput = 8, VegaOutput = 16, AllOutputs = 31 };
+
+	// Bit flags used to select the fields of HigherOrderResults filled in by EvaluateHigherOrder; combine them with |
+	enum HigherOrderOutputs { VannaOutput = 1, VolgaOutput = 2, CharmOutput = 4, SpeedOutput = 8, ColorOutput = 16, RhoOutput = 32,
+							  CarryRhoOutput = 64, AllHigherOrderOutputs = 127 };
+
+
+	// Constructors and Destructor
+	Option();									// Default constructor
+	Option(char optionType, double strike);		// Value constructor
+	Option(const Option& op);					// Copy constructor	
+	virtual ~Option();							// Destructor
+
+
+	// Accessor Functions
+	char GetType() const;																			// Getter for the private member type
+	double GetStrike() const;																		// Getter for the private member K
+	virtual double Price(double S, double sig, double r, double b) const = 0;						// PVMF
+	virtual double Delta(double S, double sig, double r, double b) const = 0;						// PVMF 
+	virtual double DivDiffDelta(double S, double sig, double r, double b, double h) const = 0;		// PVMF 
+	virtual double Gamma(double S, double sig, double r, double b) const = 0;						// PVMF 
+	virtual double DivDiffGamma(double S, double sig, double r, double b, double h) const = 0;		// PVMF 
+	virtual OptionResults Evaluate(double S, double sig, double r, double b,
+								   int outputs = AllOutputs) const;									// Computes the selected outputs in a single call
+	virtual HigherOrderResults EvaluateHigherOrder(double S, double sig, double r, double b,
+												   int higherOutputs = AllHigherOrderOutputs) const;	// Computes the selected higher-order Greeks
+	virtual void Evaluate(double S, double sig, double r, double b, int outputs, int higherOutputs,
+						  OptionResults& results, HigherOrderResults& higherResults) const;		// Computes both sets of outputs in a single call
+	virtual PriceGradient Gradient(double S, double sig, double r, double b) const;				// Computes the price and its derivatives with respect
+																									// to every input in a single call
+
+
+	// Modifier Functions
+	void SetType(char optionType);																	// Setter for the private member type
+	void SetStrike(double strike);																	// Setter for the private member K
+	Option& operator = (const Option& op);															// Assignment operator
+
+};
+
+
+#endif
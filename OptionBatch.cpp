@@ -0,0 +1,413 @@
+// OptionBatch.cpp
+
+#include "OptionBatch.hpp"
+#include "EuropeanOption.hpp"
+#include "PerpetualAmericanOption.hpp"
+#include "Instrumentation.hpp"
+#include "OptionKernels.hpp"
+
+#include <vector>
+
+
+namespace
+{
+	// Calls function(kernel, i) for every row i of view, where kernel is a value of the OptionKernel type matching the row's kind
+	// and option type, and stores the returned value in result[i]
+	template <typename Result, typename Function>
+	void ForEachRow(const OptionBatchView& view, Result* result, Function function)
+	{
+		for (size_t i = 0; i < view.rows; i++)
+		{
+			bool call = (view.type[i] == 1);
+			if (view.kind[i] == 'E')
+				result[i] = call ? function(EuropeanKernel<CallOption>(), i) : function(EuropeanKernel<PutOption>(), i);
+			else
+				result[i] = call ? function(PerpetualAmericanKernel<CallOption>(), i) : function(PerpetualAmericanKernel<PutOption>(), i);
+		}
+	}
+}
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor
+OptionBatch::OptionBatch()
+{
+}
+
+// Copy constructor
+OptionBatch::OptionBatch(const OptionBatch& batch) : S(batch.S), sig(batch.sig), r(batch.r), b(batch.b), type(batch.type), K(batch.K),
+													 T(batch.T), kind(batch.kind)
+{
+}
+
+// Converts an existing ParamMatrix into columnar form. Row i of the batch represents the same option, with the same parameters,
+// as row i of paramMat.
+OptionBatch::OptionBatch(const ParamMatrix& paramMat)
+{
+	Reserve(paramMat.Size());
+	for (size_t i = 0; i < paramMat.Size(); i++)
+	{
+		const double* row = paramMat.RowData(i);
+		char optionType = (row[4] == 1) ? 'C' : 'P';
+		if (paramMat.RowWidth(i) == 7)
+			PushEuropean(row[0], row[1], row[2], row[3], optionType, row[5], row[6]);
+		else
+			PushPerpetual(row[0], row[1], row[2], row[3], optionType, row[5]);
+	}
+}
+
+// Destructor
+OptionBatch::~OptionBatch()
+{
+}
+
+// Each of the single-axis constructors below fills the batch with one row per entry of its vector argument while holding every
+// other parameter fixed, exactly as the ParamMatrix constructor with the same signature does. The axisIndex passed to PushLadder
+// selects the varying parameter: 0 -> spot, 1 -> vol, 2 -> rate, 3 -> carry, 4 -> strike, 5 -> timeTillMat.
+
+OptionBatch::OptionBatch(const vector<double>& spot, double vol, double rate, double carry, char optionType, double strike)
+{
+	PushLadder(spot, 0, 0, vol, rate, carry, optionType, strike, 0, 'A');
+}
+
+OptionBatch::OptionBatch(double spot, const vector<double>& vol, double rate, double carry, char optionType, double strike)
+{
+	PushLadder(vol, 1, spot, 0, rate, carry, optionType, strike, 0, 'A');
+}
+
+OptionBatch::OptionBatch(double spot, double vol, const vector<double>& rate, double carry, char optionType, double strike)
+{
+	PushLadder(rate, 2, spot, vol, 0, carry, optionType, strike, 0, 'A');
+}
+
+OptionBatch::OptionBatch(double spot, double vol, double rate, const vector<double>& carry, char optionType, double strike)
+{
+	PushLadder(carry, 3, spot, vol, rate, 0, optionType, strike, 0, 'A');
+}
+
+OptionBatch::OptionBatch(double spot, double vol, double rate, double carry, char optionType, const vector<double>& strike)
+{
+	PushLadder(strike, 4, spot, vol, rate, carry, optionType, 0, 0, 'A');
+}
+
+OptionBatch::OptionBatch(const vector<double>& spot, double vol, double rate, double carry, char optionType, double strike, double timeTillMat)
+{
+	PushLadder(spot, 0, 0, vol, rate, carry, optionType, strike, timeTillMat, 'E');
+}
+
+OptionBatch::OptionBatch(double spot, const vector<double>& vol, double rate, double carry, char optionType, double strike, double timeTillMat)
+{
+	PushLadder(vol, 1, spot, 0, rate, carry, optionType, strike, timeTillMat, 'E');
+}
+
+OptionBatch::OptionBatch(double spot, double vol, const vector<double>& rate, double carry, char optionType, double strike, double timeTillMat)
+{
+	PushLadder(rate, 2, spot, vol, 0, carry, optionType, strike, timeTillMat, 'E');
+}
+
+OptionBatch::OptionBatch(double spot, double vol, double rate, const vector<double>& carry, char optionType, double strike, double timeTillMat)
+{
+	PushLadder(carry, 3, spot, vol, rate, 0, optionType, strike, timeTillMat, 'E');
+}
+
+OptionBatch::OptionBatch(double spot, double vol, double rate, double carry, char optionType, const vector<double>& strike, double timeTillMat)
+{
+	PushLadder(strike, 4, spot, vol, rate, carry, optionType, 0, timeTillMat, 'E');
+}
+
+OptionBatch::OptionBatch(double spot, double vol, double rate, double carry, char optionType, double strike, const vector<double>& timeTillMat)
+{
+	PushLadder(timeTillMat, 5, spot, vol, rate, carry, optionType, strike, 0, 'E');
+}
+
+// Appends one row per entry of axis, substituting that entry for the parameter selected by axisIndex. Rows with an option type
+// other than 'C' or 'P' are skipped, matching the ParamMatrix constructors.
+void OptionBatch::PushLadder(const vector<double>& axis, int axisIndex, double spot, double vol, double rate, double carry,
+							 char optionType, double strike, double timeTillMat, char optionKind)
+{
+	if (optionType != 'C' && optionType != 'P')
+		return;
+	//	throw IllegalOptionTypeException(optionType)
+
+	Reserve(Size() + axis.size());
+	for (vector<double>::const_iterator it = axis.begin(); it != axis.end(); ++it)
+	{
+		double params[6] = { spot, vol, rate, carry, strike, timeTillMat };
+		params[axisIndex] = *it;
+
+		if (optionKind == 'E')
+			PushEuropean(params[0], params[1], params[2], params[3], optionType, params[4], params[5]);
+		else
+			PushPerpetual(params[0], params[1], params[2], params[3], optionType, params[4]);
+	}
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the number of rows in the batch
+size_t OptionBatch::Size() const
+{
+	return S.size();
+}
+
+// Returns a non-owning view of the columns; the view is invalidated by any subsequent modification of the batch
+OptionBatchView OptionBatch::View() const
+{
+	OptionBatchView view = { S.data(), sig.data(), r.data(), b.data(), type.data(), K.data(), T.data(), kind.data(), S.size() };
+	return view;
+}
+
+// Returns a vector of prices corresponding to the rows of the batch
+vector<double> OptionBatch::Price() const
+{
+	vector<double> resultVect(Size());
+	Price(View(), resultVect.data());
+	return resultVect;
+}
+
+// Returns a vector of deltas corresponding to the rows of the batch
+vector<double> OptionBatch::Delta() const
+{
+	vector<double> resultVect(Size());
+	Delta(View(), resultVect.data());
+	return resultVect;
+}
+
+// Returns a vector of approximated deltas corresponding to the rows of the batch
+vector<double> OptionBatch::DivDiffDelta(double h) const
+{
+	vector<double> resultVect(Size());
+	DivDiffDelta(View(), h, resultVect.data());
+	return resultVect;
+}
+
+// Returns a vector of gammas corresponding to the rows of the batch
+vector<double> OptionBatch::Gamma() const
+{
+	vector<double> resultVect(Size());
+	Gamma(View(), resultVect.data());
+	return resultVect;
+}
+
+// Returns a vector of approximated gammas corresponding to the rows of the batch
+vector<double> OptionBatch::DivDiffGamma(double h) const
+{
+	vector<double> resultVect(Size());
+	DivDiffGamma(View(), h, resultVect.data());
+	return resultVect;
+}
+
+
+// Returns a vector of single-pass evaluations corresponding to the rows of the batch
+vector<OptionResults> OptionBatch::Evaluate(int outputs) const
+{
+	vector<OptionResults> resultVect(Size());
+	Evaluate(View(), outputs, resultVect.data());
+	return resultVect;
+}
+
+// Returns a vector of the higher-order Greeks selected by higherOutputs corresponding to the rows of the batch
+vector<HigherOrderResults> OptionBatch::EvaluateHigherOrder(int higherOutputs) const
+{
+	vector<HigherOrderResults> resultVect(Size());
+	EvaluateHigherOrder(View(), higherOutputs, resultVect.data());
+	return resultVect;
+}
+
+// Returns a vector of the price gradients corresponding to the rows of the batch
+vector<PriceGradient> OptionBatch::Gradient() const
+{
+	vector<PriceGradient> resultVect(Size());
+	Gradient(View(), resultVect.data());
+	return resultVect;
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Reserves capacity for at least rows many rows in every column so that a known-size book is built without reallocation
+void OptionBatch::Reserve(size_t rows)
+{
+	S.reserve(rows);
+	sig.reserve(rows);
+	r.reserve(rows);
+	b.reserve(rows);
+	type.reserve(rows);
+	K.reserve(rows);
+	T.reserve(rows);
+	kind.reserve(rows);
+}
+
+// Removes every row from the batch; the columns keep their capacity so the batch can be refilled without allocating
+void OptionBatch::Clear()
+{
+	S.clear();
+	sig.clear();
+	r.clear();
+	b.clear();
+	type.clear();
+	K.clear();
+	T.clear();
+	kind.clear();
+}
+
+// Adds a row laid out as in ParamMatrix::PushRow, i.e. (S, sig, r, b, +/-1, K) for PAMOs and (S, sig, r, b, +/-1, K, T) for
+// Euro options. As in ParamMatrix, an entry of 1 in position 4 denotes a call and any other value a put.
+void OptionBatch::PushRow(const vector<double>& newRow)
+{
+	if (newRow.size() == 6)
+		PushPerpetual(newRow[0], newRow[1], newRow[2], newRow[3], (newRow[4] == 1) ? 'C' : 'P', newRow[5]);
+	else if (newRow.size() == 7)
+		PushEuropean(newRow[0], newRow[1], newRow[2], newRow[3], (newRow[4] == 1) ? 'C' : 'P', newRow[5], newRow[6]);
+	/*
+	else
+		//throw IllegalRowException()
+	*/
+}
+
+// Adds a Euro option row without requiring the caller to build a temporary parameter vector
+void OptionBatch::PushEuropean(double spot, double vol, double rate, double carry, char optionType, double strike, double timeTillMat)
+{
+	S.push_back(spot);
+	sig.push_back(vol);
+	r.push_back(rate);
+	b.push_back(carry);
+	type.push_back((optionType == 'C') ? 1 : -1);
+	K.push_back(strike);
+	T.push_back(timeTillMat);
+	kind.push_back('E');
+}
+
+// Adds a PAMO row without requiring the caller to build a temporary parameter vector
+void OptionBatch::PushPerpetual(double spot, double vol, double rate, double carry, char optionType, double strike)
+{
+	S.push_back(spot);
+	sig.push_back(vol);
+	r.push_back(rate);
+	b.push_back(carry);
+	type.push_back((optionType == 'C') ? 1 : -1);
+	K.push_back(strike);
+	T.push_back(0);
+	kind.push_back('A');
+}
+
+// Assignment operator
+OptionBatch& OptionBatch::operator = (const OptionBatch& batch)
+{
+	if (this != &batch)
+	{
+		S = batch.S;
+		sig = batch.sig;
+		r = batch.r;
+		b = batch.b;
+		type = batch.type;
+		K = batch.K;
+		T = batch.T;
+		kind = batch.kind;
+	}
+
+	return *this;
+}
+
+
+// -------------------------------------------------------------------------- Static Functions ------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns a view of rows [first, last) of view; used to hand contiguous blocks of a batch to different threads or stages
+OptionBatchView OptionBatch::Slice(const OptionBatchView& view, size_t first, size_t last)
+{
+	OptionBatchView slice = { view.S + first, view.sig + first, view.r + first, view.b + first, view.type + first, view.K + first,
+							  view.T + first, view.kind + first, last - first };
+	return slice;
+}
+
+// Each evaluator hands a generic lambda to ForEachRow, which calls it with the kernel of OptionKernels.hpp matching the row's kind
+// and type. The kernels are the functions behind the EuropeanOption and PerpetualAmericanOption member functions, so the results
+// coincide with those of the virtual calls made by the equivalent ParamMatrix loops, but no Option object is built and no virtual
+// call is made per row.
+
+// Writes the price of every row of view into result
+void OptionBatch::Price(const OptionBatchView& view, double* result)
+{
+	INSTRUMENT_SCOPE("OptionBatch::Price(view)");
+	ForEachRow(view, result, [&](auto kernel, size_t i)
+	{
+		return decltype(kernel)::Price(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i]);
+	});
+}
+
+// Writes the delta of every row of view into result
+void OptionBatch::Delta(const OptionBatchView& view, double* result)
+{
+	INSTRUMENT_SCOPE("OptionBatch::Delta(view)");
+	ForEachRow(view, result, [&](auto kernel, size_t i)
+	{
+		return decltype(kernel)::Delta(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i]);
+	});
+}
+
+// Writes the centered divided differences approximation of the delta of every row of view into result
+void OptionBatch::DivDiffDelta(const OptionBatchView& view, double h, double* result)
+{
+	INSTRUMENT_SCOPE("OptionBatch::DivDiffDelta(view)");
+	ForEachRow(view, result, [&](auto kernel, size_t i)
+	{
+		return decltype(kernel)::DivDiffDelta(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i], h);
+	});
+}
+
+// Writes the gamma of every row of view into result
+void OptionBatch::Gamma(const OptionBatchView& view, double* result)
+{
+	INSTRUMENT_SCOPE("OptionBatch::Gamma(view)");
+	ForEachRow(view, result, [&](auto kernel, size_t i)
+	{
+		return decltype(kernel)::Gamma(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i]);
+	});
+}
+
+// Writes the centered divided differences approximation of the gamma of every row of view into result
+void OptionBatch::DivDiffGamma(const OptionBatchView& view, double h, double* result)
+{
+	INSTRUMENT_SCOPE("OptionBatch::DivDiffGamma(view)");
+	ForEachRow(view, result, [&](auto kernel, size_t i)
+	{
+		return decltype(kernel)::DivDiffGamma(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i], h);
+	});
+}
+
+// Writes the single-pass evaluation of the outputs selected by outputs for every row of view into result
+void OptionBatch::Evaluate(const OptionBatchView& view, int outputs, OptionResults* result)
+{
+	INSTRUMENT_SCOPE("OptionBatch::Evaluate(view)");
+	ForEachRow(view, result, [&](auto kernel, size_t i)
+	{
+		return decltype(kernel)::Evaluate(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i], outputs);
+	});
+}
+
+// Writes the single-pass evaluation of the higher-order Greeks selected by higherOutputs for every row of view into result
+void OptionBatch::EvaluateHigherOrder(const OptionBatchView& view, int higherOutputs, HigherOrderResults* result)
+{
+	INSTRUMENT_SCOPE("OptionBatch::EvaluateHigherOrder(view)");
+	ForEachRow(view, result, [&](auto kernel, size_t i)
+	{
+		return decltype(kernel)::EvaluateHigherOrder(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i], higherOutputs);
+	});
+}
+
+// Writes the price and its derivatives with respect to every input, computed by reverse mode differentiation, for every row of view
+// into result
+void OptionBatch::Gradient(const OptionBatchView& view, PriceGradient* result)
+{
+	INSTRUMENT_SCOPE("OptionBatch::Gradient(view)");
+	ForEachRow(view, result, [&](auto kernel, size_t i)
+	{
+		return decltype(kernel)::Gradient(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i]);
+	});
+}
@@ -0,0 +1,143 @@
+// OptionBatch.hpp
+//
+// The purpose of the OptionBatch class is to offer a columnar (struct-of-arrays) alternative to ParamMatrix for large books. Rather
+// than storing each option as its own heap-allocated parameter row together with a separately heap-allocated Option object, an
+// OptionBatch stores one contiguous, cache-line aligned column per parameter (S, sig, r, b, type, K, T) plus a kind tag column which
+// records whether a row represents a Euro option ('E') or a PAMO ('A'). The type column follows the ParamMatrix convention of +1 for
+// calls and -1 for puts, and the T column of a PAMO row is unused and set to 0. A book of n rows therefore costs a handful of
+// allocations in total, and the batch evaluators walk the columns sequentially instead of chasing one pointer per row.
+//
+// An OptionBatchView is a non-owning set of column pointers; every batch evaluator is written against a view so that columns which
+// live elsewhere (for example in a memory-mapped file) can be priced without first being copied into an OptionBatch.
+
+#ifndef OptionBatch_H
+#define OptionBatch_H
+
+#include "AlignedAllocator.hpp"
+#include "ParamMatrix.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+using namespace std;
+
+typedef vector<double, AlignedAllocator<double> > AlignedColumn;
+typedef vector<char, AlignedAllocator<char> > AlignedTagColumn;
+
+struct OptionBatchView
+{
+	const double* S;									// Spot prices
+	const double* sig;									// Volatilities
+	const double* r;									// Interest rates
+	const double* b;									// Costs-of-carry
+	const double* type;									// +1 for calls, -1 for puts
+	const double* K;									// Strike prices
+	const double* T;									// Times till maturity (unused for PAMO rows)
+	const char* kind;									// 'E' for Euro option rows, 'A' for PAMO rows
+	size_t rows;										// Number of rows addressed by each of the pointers above
+};
+
+// The single precision counterpart of OptionBatchView; see PrecisionBatch and BsmKernel
+struct FloatBatchView
+{
+	const float* S;										// Spot prices
+	const float* sig;									// Volatilities
+	const float* r;										// Interest rates
+	const float* b;										// Costs-of-carry
+	const float* type;									// +1 for calls, -1 for puts
+	const float* K;										// Strike prices
+	const float* T;										// Times till maturity (unused for PAMO rows)
+	const char* kind;									// 'E' for Euro option rows, 'A' for PAMO rows
+	size_t rows;										// Number of rows addressed by each of the pointers above
+};
+
+// Writes the price of every row of view into result, which holds view.rows doubles; see BumpEngine and ScenarioEngine
+typedef function<void(const OptionBatchView& view, double* result)> BatchPricer;
+
+class OptionBatch
+{
+private:
+	AlignedColumn S;									// Spot price column
+	AlignedColumn sig;									// Volatility column
+	AlignedColumn r;									// Interest rate column
+	AlignedColumn b;									// Cost-of-carry column
+	AlignedColumn type;									// Option type column; +1 for calls and -1 for puts
+	AlignedColumn K;									// Strike price column
+	AlignedColumn T;									// Time till maturity column; 0 for PAMO rows
+	AlignedTagColumn kind;								// Kind tag column; 'E' for Euro options and 'A' for PAMOs
+
+	void PushLadder(const vector<double>& axis, int axisIndex, double spot, double vol, double rate, double carry,
+					char optionType, double strike, double timeTillMat, char optionKind);	// Helper for the single-axis constructors
+
+public:
+	// Constructors and Destructor
+	OptionBatch();										// Default constructor
+	OptionBatch(const OptionBatch& batch);				// Copy constructor
+	explicit OptionBatch(const ParamMatrix& paramMat);	// Converts every row of an existing ParamMatrix into columnar form
+	virtual ~OptionBatch();								// Destructor
+
+				// Constructors for Perpetual American batches; these mirror the corresponding ParamMatrix constructors //
+
+	OptionBatch(const vector<double>& spot, double vol, double rate, double carry, char optionType, double strike);
+	OptionBatch(double spot, const vector<double>& vol, double rate, double carry, char optionType, double strike);
+	OptionBatch(double spot, double vol, const vector<double>& rate, double carry, char optionType, double strike);
+	OptionBatch(double spot, double vol, double rate, const vector<double>& carry, char optionType, double strike);
+	OptionBatch(double spot, double vol, double rate, double carry, char optionType, const vector<double>& strike);
+
+				// Constructors for European batches; these mirror the corresponding ParamMatrix constructors //
+
+	OptionBatch(const vector<double>& spot, double vol, double rate, double carry, char optionType, double strike, double timeTillMat);
+	OptionBatch(double spot, const vector<double>& vol, double rate, double carry, char optionType, double strike, double timeTillMat);
+	OptionBatch(double spot, double vol, const vector<double>& rate, double carry, char optionType, double strike, double timeTillMat);
+	OptionBatch(double spot, double vol, double rate, const vector<double>& carry, char optionType, double strike, double timeTillMat);
+	OptionBatch(double spot, double vol, double rate, double carry, char optionType, const vector<double>& strike, double timeTillMat);
+	OptionBatch(double spot, double vol, double rate, double carry, char optionType, double strike, const vector<double>& timeTillMat);
+
+
+	// Accessor Functions
+	size_t Size() const;										// Returns the number of rows in the batch
+	OptionBatchView View() const;								// Returns a non-owning view of the batch's columns
+
+	vector<double> Price() const;								// Returns a vector of prices, one per row, in row order
+	vector<double> Delta() const;								// Returns a vector of deltas, one per row, in row order
+	vector<double> DivDiffDelta(double h) const;				// Returns a vector of approximate deltas using centered divided differences with step h
+	vector<double> Gamma() const;								// Returns a vector of gammas, one per row, in row order
+	vector<double> DivDiffGamma(double h) const;				// Returns a vector of approximate gammas using centered divided differences with step h
+	vector<OptionResults> Evaluate(int outputs = Option::AllOutputs) const;
+																// Returns the outputs selected by the Option::Outputs flags for every row, computed in
+																// a single pass per row
+	vector<HigherOrderResults> EvaluateHigherOrder(int higherOutputs = Option::AllHigherOrderOutputs) const;
+																// Returns the higher-order Greeks selected by the Option::HigherOrderOutputs
+																// flags for every row; they are 0 for PAMO rows
+	vector<PriceGradient> Gradient() const;						// Returns the price and its derivatives with respect to S, sig, r, b, K and T for every
+																// row, computed by reverse mode differentiation
+
+
+	// Modifier Functions
+	void Reserve(size_t rows);									// Reserves capacity in every column for at least rows many rows
+	void Clear();												// Removes every row while keeping the columns' capacity
+	void PushRow(const vector<double>& newRow);					// Adds a row given in the ParamMatrix::PushRow layout; newRow.size() must be 6 (PAMO)
+																// or 7 (Euro option), any other row is ignored
+	void PushEuropean(double spot, double vol, double rate, double carry, char optionType, double strike, double timeTillMat);
+	void PushPerpetual(double spot, double vol, double rate, double carry, char optionType, double strike);
+	OptionBatch& operator = (const OptionBatch& batch);			// Assignment operator
+
+
+	// Static Functions
+	// Each evaluator below writes view.rows results into the caller-supplied array result, in row order, and produces exactly
+	// the values the corresponding ParamMatrix member function returns for the same rows.
+	static void Price(const OptionBatchView& view, double* result);
+	static void Delta(const OptionBatchView& view, double* result);
+	static void DivDiffDelta(const OptionBatchView& view, double h, double* result);
+	static void Gamma(const OptionBatchView& view, double* result);
+	static void DivDiffGamma(const OptionBatchView& view, double h, double* result);
+	static void Evaluate(const OptionBatchView& view, int outputs, OptionResults* result);
+	static void EvaluateHigherOrder(const OptionBatchView& view, int higherOutputs, HigherOrderResults* result);
+	static void Gradient(const OptionBatchView& view, PriceGradient* result);
+
+	static OptionBatchView Slice(const OptionBatchView& view, size_t first, size_t last);	// Returns the view of rows [first, last) of view
+
+};
+
+
+#endif
@@ -0,0 +1,570 @@
+// OptionKernels.hpp
+//
+// The purpose of the OptionKernel class templates is to provide the pricing and Greeks formulas of the EuropeanOption and
+// PerpetualAmericanOption classes with the option type (call or put) and the exercise style (European or perpetual American) fixed
+// at compile time. Every function is static and inline, takes the strike and maturity as arguments instead of reading them from an
+// object, and tests the option type only through the compile-time constant Type::isCall, so the compiler removes the untaken
+// formula altogether. A loop over a book in which every row has the same type and style therefore contains no virtual calls and no
+// branches on the option type, and the formulas can be inlined into it.
+//
+// OptionKernelBase uses the curiously recurring template pattern to supply, once for both styles, the centered divided difference
+// Greeks and the batch loops over an OptionBatchView-like object whose rows all share the kernel's type and style. The EuropeanOption
+// and PerpetualAmericanOption member functions are thin adapters which pick the kernel matching GetType() and call it, so the
+// kernels compute exactly the values those member functions have always returned. A PAMO kernel ignores its T argument.
+//
+// Every kernel is also templated on its scalar type Real, double by default. The double kernels are the ones described above; the
+// float kernels evaluate the same formulas entirely in single precision, with the normal CDF and PDF and the PAMO exponents taken from
+// KernelMath<float> instead of the double precision functions of EuropeanOption and PerpetualAmericanOption. The batch loops accept views
+// and result arrays of either scalar type, so a double kernel run over a view of float columns computes in double from float inputs.
+
+#ifndef OptionKernels_H
+#define OptionKernels_H
+
+#include "Option.hpp"
+#include "EuropeanOption.hpp"
+#include "PerpetualAmericanOption.hpp"
+
+#include <cmath>
+#include <cstddef>
+
+// Option type tags
+struct CallOption
+{
+	static const bool isCall = true;
+	static const char type = 'C';
+};
+
+struct PutOption
+{
+	static const bool isCall = false;
+	static const char type = 'P';
+};
+
+// Exercise style tags
+struct EuropeanExercise
+{
+	static const char kind = 'E';
+};
+
+struct PerpetualAmericanExercise
+{
+	static const char kind = 'A';
+};
+
+// Normal distribution and PAMO exponent functions used by the kernels of scalar type Real
+template <typename Real>
+struct KernelMath;
+
+template <>
+struct KernelMath<double>
+{
+	static double N(double x) { return EuropeanOption::N(x); }
+	static double n(double x) { return EuropeanOption::n(x); }
+	static double y_1(double sig, double r, double b) { return PerpetualAmericanOption::y_1(sig, r, b); }
+	static double y_2(double sig, double r, double b) { return PerpetualAmericanOption::y_2(sig, r, b); }
+};
+
+template <>
+struct KernelMath<float>
+{
+	static float N(float x) { return 0.5f * std::erfc(-x * 0.70710678f); }			// 0.70710678 = 1 / sqrt(2)
+	static float n(float x) { return 0.39894228f * std::exp(-0.5f * (x * x)); }		// 0.39894228 = 1 / sqrt(2 * pi)
+
+	static float y_1(float sig, float r, float b)
+	{
+		float variance = sig * sig;
+		return ((0.5f - b / variance) + std::sqrt(((b / variance - 0.5f) * (b / variance - 0.5f)) + (2 * r) / variance));
+	}
+
+	static float y_2(float sig, float r, float b)
+	{
+		float variance = sig * sig;
+		return ((0.5f - b / variance) - std::sqrt(((b / variance - 0.5f) * (b / variance - 0.5f)) + (2 * r) / variance));
+	}
+};
+
+// The terms of the Black-Scholes-Merton formulas of a Euro option that do not depend on the spot. Callers which price the same
+// contract at many spots, or points of a grid along whose axes most terms repeat, compute them once and pass them to
+// EuropeanFormulas::Evaluate with the spot and the moneyness x = log(S / K) + (b + sig^2 / 2) * T.
+template <typename Real>
+struct EuropeanTerms
+{
+	Real sig;											// Volatility
+	Real r;												// Interest rate
+	Real b;												// Cost-of-carry
+	Real sqrtT;											// sqrt(T)
+	Real sigSqrtT;										// sig * sqrt(T)
+	Real carryFactor;									// exp((b - r) * T)
+	Real discountedStrike;								// K * exp(-r * T)
+};
+
+// d_1, d_2 and the normal distribution values of a Euro option; cdf1, cdf2 and pdf1 are 0 unless requested
+template <typename Real>
+struct EuropeanValues
+{
+	Real d1;
+	Real d2;
+	Real cdf1;											// N(d_1) for calls, N(-d_1) for puts
+	Real cdf2;											// N(d_2) for calls, N(-d_2) for puts
+	Real pdf1;											// n(d_1)
+};
+
+// The Black-Scholes-Merton price and first-order Greeks of a Euro option from its EuropeanTerms, with the option type phi (1 for
+// calls, -1 for puts) given at run time; these are the formulas of EuropeanOption::Evaluate, shared by the Euro kernels below,
+// SpotTickRepricer, ScenarioGrid and SurfaceGenerator
+template <typename Real>
+struct EuropeanFormulas
+{
+	static EuropeanValues<Real> Values(Real phi, Real x, Real sigSqrtT, bool needCdf1, bool needCdf2, bool needPdf1)
+	{
+		EuropeanValues<Real> values;
+		values.d1 = x / sigSqrtT;
+		values.d2 = values.d1 - sigSqrtT;
+		values.cdf1 = needCdf1 ? KernelMath<Real>::N(phi * values.d1) : 0;
+		values.cdf2 = needCdf2 ? KernelMath<Real>::N(phi * values.d2) : 0;
+		values.pdf1 = needPdf1 ? KernelMath<Real>::n(values.d1) : 0;
+		return values;
+	}
+
+	// Writes the outputs selected by outputs into result and sets the other fields to 0
+	static void FirstOrder(Real phi, Real S, const EuropeanTerms<Real>& terms, const EuropeanValues<Real>& values, int outputs,
+						   OptionResults& result)
+	{
+		Real discountedSpot = S * terms.carryFactor;
+		Real spotTerm = discountedSpot * values.cdf1;
+		Real strikeTerm = terms.discountedStrike * values.cdf2;
+
+		result.price = (outputs & Option::PriceOutput) ? phi * (spotTerm - strikeTerm) : 0;
+		result.delta = (outputs & Option::DeltaOutput) ? phi * (terms.carryFactor * values.cdf1) : 0;
+		result.gamma = (outputs & Option::GammaOutput) ? (values.pdf1 * terms.carryFactor) / (S * terms.sigSqrtT) : 0;
+		result.theta = (outputs & Option::ThetaOutput) ? -((discountedSpot * (terms.sig * values.pdf1)) / (2 * terms.sqrtT))
+															- phi * ((terms.b - terms.r) * spotTerm) - phi * (terms.r * strikeTerm) : 0;
+		result.vega = (outputs & Option::VegaOutput) ? discountedSpot * (terms.sqrtT * values.pdf1) : 0;
+	}
+
+	// Returns the outputs selected by outputs, computing only the normal distribution values they need
+	static OptionResults Evaluate(Real phi, Real S, Real x, const EuropeanTerms<Real>& terms, int outputs)
+	{
+		bool needCdf1 = (outputs & (Option::PriceOutput | Option::DeltaOutput | Option::ThetaOutput)) != 0;
+		bool needCdf2 = (outputs & (Option::PriceOutput | Option::ThetaOutput)) != 0;
+		bool needPdf1 = (outputs & (Option::GammaOutput | Option::ThetaOutput | Option::VegaOutput)) != 0;
+
+		OptionResults result;
+		FirstOrder(phi, S, terms, Values(phi, x, terms.sigSqrtT, needCdf1, needCdf2, needPdf1), outputs, result);
+		return result;
+	}
+};
+
+// Divided difference Greeks and homogeneous batch loops shared by every kernel; Kernel must provide static Price, Delta, Gamma,
+// Evaluate and Gradient functions with the argument lists used below
+template <typename Kernel, typename Real>
+struct OptionKernelBase
+{
+	// Approximates delta via centered divided differences for 1st derivatives with radius h
+	static Real DivDiffDelta(Real S, Real sig, Real r, Real b, Real K, Real T, Real h)
+	{
+		Real numerator = Kernel::Price((S + h), sig, r, b, K, T) - Kernel::Price((S - h), sig, r, b, K, T);
+		return (numerator / (2 * h));
+	}
+
+	// Approximates gamma via centered divided differences for 2nd derivatives with radius h
+	static Real DivDiffGamma(Real S, Real sig, Real r, Real b, Real K, Real T, Real h)
+	{
+		Real numerator = ((Kernel::Price((S + h), sig, r, b, K, T) - (2 * Kernel::Price(S, sig, r, b, K, T))) + Kernel::Price((S - h), sig, r, b, K, T));
+		return (numerator / std::pow(h, Real(2)));
+	}
+
+				// Batch loops; every row of view must have the kernel's option type and exercise style //
+
+	template <typename View, typename Result>
+	static void PriceBatch(const View& view, Result* result)
+	{
+		for (size_t i = 0; i < view.rows; i++)
+			result[i] = Kernel::Price(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i]);
+	}
+
+	template <typename View, typename Result>
+	static void DeltaBatch(const View& view, Result* result)
+	{
+		for (size_t i = 0; i < view.rows; i++)
+			result[i] = Kernel::Delta(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i]);
+	}
+
+	template <typename View, typename Result>
+	static void DivDiffDeltaBatch(const View& view, Real h, Result* result)
+	{
+		for (size_t i = 0; i < view.rows; i++)
+			result[i] = DivDiffDelta(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i], h);
+	}
+
+	template <typename View, typename Result>
+	static void GammaBatch(const View& view, Result* result)
+	{
+		for (size_t i = 0; i < view.rows; i++)
+			result[i] = Kernel::Gamma(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i]);
+	}
+
+	template <typename View, typename Result>
+	static void DivDiffGammaBatch(const View& view, Real h, Result* result)
+	{
+		for (size_t i = 0; i < view.rows; i++)
+			result[i] = DivDiffGamma(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i], h);
+	}
+
+	template <typename View>
+	static void EvaluateBatch(const View& view, int outputs, OptionResults* result)
+	{
+		for (size_t i = 0; i < view.rows; i++)
+			result[i] = Kernel::Evaluate(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i], outputs);
+	}
+
+	template <typename View>
+	static void GradientBatch(const View& view, PriceGradient* result)
+	{
+		for (size_t i = 0; i < view.rows; i++)
+			result[i] = Kernel::Gradient(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i]);
+	}
+};
+
+template <typename Style, typename Type, typename Real = double>
+struct OptionKernel;
+
+// Black-Scholes-Merton formulas for Euro options
+template <typename Type, typename Real>
+struct OptionKernel<EuropeanExercise, Type, Real> : public OptionKernelBase<OptionKernel<EuropeanExercise, Type, Real>, Real>
+{
+	static Real d_1(Real S, Real sig, Real b, Real K, Real T)
+	{
+		return ((std::log(S / K) + ((b + (std::pow(sig, Real(2)) / 2)) * T)) / (sig * std::sqrt(T)));
+	}
+
+	static Real d_2(Real S, Real sig, Real b, Real K, Real T)
+	{
+		return (d_1(S, sig, b, K, T) - (sig * std::sqrt(T)));
+	}
+
+	static Real Price(Real S, Real sig, Real r, Real b, Real K, Real T)
+	{
+		if (Type::isCall)
+			return ((S * std::exp((b - r) * T) * KernelMath<Real>::N((d_1(S, sig, b, K, T)))) - (K * std::exp((-r) * T) * KernelMath<Real>::N((d_2(S, sig, b, K, T)))));
+		else
+			return ((K * std::exp((-r) * T) * KernelMath<Real>::N((-d_2(S, sig, b, K, T)))) - (S * std::exp((b - r) * T) * KernelMath<Real>::N((-d_1(S, sig, b, K, T)))));
+	}
+
+	static Real Delta(Real S, Real sig, Real r, Real b, Real K, Real T)
+	{
+		if (Type::isCall)
+			return (std::exp((b - r) * T) * KernelMath<Real>::N(d_1(S, sig, b, K, T)));
+		else
+			return (std::exp((b - r) * T) * (KernelMath<Real>::N(d_1(S, sig, b, K, T)) - 1));
+	}
+
+	static Real Gamma(Real S, Real sig, Real r, Real b, Real K, Real T)
+	{
+		return (KernelMath<Real>::n(d_1(S, sig, b, K, T)) * std::exp((b - r) * T)) / (S * (sig * std::sqrt(T)));
+	}
+
+	static Real Theta(Real S, Real sig, Real r, Real b, Real K, Real T)
+	{
+		Real firstTerm = -((S * (sig * (std::exp((b - r) * T) * KernelMath<Real>::n(d_1(S, sig, b, K, T))))) / (2 * std::sqrt(T)));
+		if (Type::isCall)
+		{
+			Real secondTerm = -((b - r) * (S * (std::exp((b - r) * T) * KernelMath<Real>::N(d_1(S, sig, b, K, T)))));
+			Real thirdTerm = -(r * (K * (std::exp(-r * T) * KernelMath<Real>::N(d_2(S, sig, b, K, T)))));
+			return firstTerm + secondTerm + thirdTerm;
+		}
+		else
+		{
+			Real secondTerm = ((b - r) * (S * (std::exp((b - r) * T) * KernelMath<Real>::N(-d_1(S, sig, b, K, T)))));
+			Real thirdTerm = (r * (K * (std::exp(-r * T) * KernelMath<Real>::N(-d_2(S, sig, b, K, T)))));
+			return firstTerm + secondTerm + thirdTerm;
+		}
+	}
+
+	static Real Vega(Real S, Real sig, Real r, Real b, Real K, Real T)
+	{
+		return (S * (std::sqrt(T) * (std::exp((b - r) * T) * KernelMath<Real>::n(d_1(S, sig, b, K, T)))));
+	}
+
+	static Real Vanna(Real S, Real sig, Real r, Real b, Real K, Real T)
+	{
+		return -(std::exp((b - r) * T) * KernelMath<Real>::n(d_1(S, sig, b, K, T)) * d_2(S, sig, b, K, T)) / sig;
+	}
+
+	static Real Volga(Real S, Real sig, Real r, Real b, Real K, Real T)
+	{
+		return Vega(S, sig, r, b, K, T) * ((d_1(S, sig, b, K, T) * d_2(S, sig, b, K, T)) / sig);
+	}
+
+	static Real Charm(Real S, Real sig, Real r, Real b, Real K, Real T)
+	{
+		return EvaluateHigherOrder(S, sig, r, b, K, T, Option::CharmOutput).charm;
+	}
+
+	static Real Speed(Real S, Real sig, Real r, Real b, Real K, Real T)
+	{
+		return -(Gamma(S, sig, r, b, K, T) / S) * (1 + d_1(S, sig, b, K, T) / (sig * std::sqrt(T)));
+	}
+
+	static Real Color(Real S, Real sig, Real r, Real b, Real K, Real T)
+	{
+		return EvaluateHigherOrder(S, sig, r, b, K, T, Option::ColorOutput).color;
+	}
+
+	static Real Rho(Real S, Real sig, Real r, Real b, Real K, Real T)
+	{
+		return -(T * Price(S, sig, r, b, K, T));
+	}
+
+	static Real CarryRho(Real S, Real sig, Real r, Real b, Real K, Real T)
+	{
+		return EvaluateHigherOrder(S, sig, r, b, K, T, Option::CarryRhoOutput).carryRho;
+	}
+
+	// Single-pass evaluation; see EuropeanOption::Evaluate
+	static OptionResults Evaluate(Real S, Real sig, Real r, Real b, Real K, Real T, int outputs)
+	{
+		OptionResults result;
+		HigherOrderResults unused;
+		Evaluate(S, sig, r, b, K, T, outputs, 0, result, unused);
+		return result;
+	}
+
+	static HigherOrderResults EvaluateHigherOrder(Real S, Real sig, Real r, Real b, Real K, Real T, int higherOutputs)
+	{
+		OptionResults unused;
+		HigherOrderResults result;
+		Evaluate(S, sig, r, b, K, T, 0, higherOutputs, unused, result);
+		return result;
+	}
+
+	// Single-pass evaluation of the outputs selected by outputs and the higher-order Greeks selected by higherOutputs, each shared
+	// subexpression being computed at most once and only if a selected output needs it; see EuropeanOption::Evaluate
+	static void Evaluate(Real S, Real sig, Real r, Real b, Real K, Real T, int outputs, int higherOutputs, OptionResults& result,
+						 HigherOrderResults& higherResult)
+	{
+		HigherOrderResults emptyHigherResult = { 0, 0, 0, 0, 0, 0, 0 };
+		higherResult = emptyHigherResult;
+
+		EuropeanTerms<Real> terms;
+		terms.sig = sig;
+		terms.r = r;
+		terms.b = b;
+		terms.sqrtT = std::sqrt(T);
+		terms.sigSqrtT = sig * terms.sqrtT;
+		terms.carryFactor = std::exp((b - r) * T);
+		Real phi = Type::isCall ? 1 : -1;
+
+		bool needCdf1 = ((outputs & (Option::PriceOutput | Option::DeltaOutput | Option::ThetaOutput)) != 0)
+						|| ((higherOutputs & (Option::CharmOutput | Option::RhoOutput | Option::CarryRhoOutput)) != 0);
+		bool needCdf2 = ((outputs & (Option::PriceOutput | Option::ThetaOutput)) != 0) || ((higherOutputs & Option::RhoOutput) != 0);
+		bool needPdf1 = ((outputs & (Option::GammaOutput | Option::ThetaOutput | Option::VegaOutput)) != 0)
+						|| ((higherOutputs & ~(Option::RhoOutput | Option::CarryRhoOutput)) != 0);
+
+		terms.discountedStrike = needCdf2 ? K * std::exp((-r) * T) : 0;
+		Real x = std::log(S / K) + ((b + (std::pow(sig, Real(2)) / 2)) * T);
+		EuropeanValues<Real> values = EuropeanFormulas<Real>::Values(phi, x, terms.sigSqrtT, needCdf1, needCdf2, needPdf1);
+		EuropeanFormulas<Real>::FirstOrder(phi, S, terms, values, outputs, result);
+
+		if (higherOutputs == 0)
+			return;
+
+		Real d1 = values.d1, d2 = values.d2, cdf1 = values.cdf1, cdf2 = values.cdf2, pdf1 = values.pdf1;
+		Real sqrtT = terms.sqrtT, sigSqrtT = terms.sigSqrtT, carryFactor = terms.carryFactor, discountedStrike = terms.discountedStrike;
+		Real discountedSpot = S * carryFactor;
+		Real gamma = (pdf1 * carryFactor) / (S * sigSqrtT);
+		if (higherOutputs & Option::VannaOutput)
+			higherResult.vanna = -(carryFactor * pdf1 * d2) / sig;
+		if (higherOutputs & Option::VolgaOutput)
+			higherResult.volga = (discountedSpot * (sqrtT * pdf1)) * ((d1 * d2) / sig);
+		if (higherOutputs & Option::CharmOutput)
+			higherResult.charm = -carryFactor * ((pdf1 * ((b / sigSqrtT) - (d2 / (2 * T)))) + (phi * ((b - r) * cdf1)));
+		if (higherOutputs & Option::SpeedOutput)
+			higherResult.speed = -(gamma / S) * (1 + (d1 / sigSqrtT));
+		if (higherOutputs & Option::ColorOutput)
+			higherResult.color = gamma * ((r - b) + ((b * d1) / sigSqrtT) + ((1 - (d1 * d2)) / (2 * T)));
+		if (higherOutputs & Option::RhoOutput)
+			higherResult.rho = -T * (phi * ((discountedSpot * cdf1) - (discountedStrike * cdf2)));
+		if (higherOutputs & Option::CarryRhoOutput)
+			higherResult.carryRho = phi * (T * (discountedSpot * cdf1));
+	}
+
+	// Returns the price and its derivatives with respect to S, sig, r, b, K and T by reverse mode (adjoint) differentiation of Price.
+	// The forward sweep computes the price exactly as Price does, keeping its intermediate values; the reverse sweep then visits those
+	// values in the opposite order, accumulating into xBar the derivative of the price with respect to each value x. The cost is about
+	// twice that of a price, however many inputs there are.
+	static PriceGradient Gradient(Real S, Real sig, Real r, Real b, Real K, Real T)
+	{
+		// Forward sweep
+		Real sqrtT = std::sqrt(T);
+		Real sigSqrtT = sig * sqrtT;
+		Real drift = (b + (std::pow(sig, Real(2)) / 2)) * T;
+		Real d1 = (std::log(S / K) + drift) / sigSqrtT;
+		Real d2 = d1 - sigSqrtT;
+		Real carryFactor = std::exp((b - r) * T);
+		Real discountFactor = std::exp((-r) * T);
+		Real phi = Type::isCall ? 1 : -1;
+		Real cdf1 = KernelMath<Real>::N(phi * d1);										// N(d_1) for calls, N(-d_1) for puts
+		Real cdf2 = KernelMath<Real>::N(phi * d2);										// N(d_2) for calls, N(-d_2) for puts
+		Real price = phi * ((S * carryFactor * cdf1) - (K * discountFactor * cdf2));
+
+		// Reverse sweep through price = phi * (S * carryFactor * cdf1 - K * discountFactor * cdf2); since N'(phi * d) * phi = phi * n(d)
+		// and phi * phi = 1, the derivatives with respect to d1 and d2 carry no phi
+		Real SBar = phi * (carryFactor * cdf1);
+		Real KBar = -phi * (discountFactor * cdf2);
+		Real carryFactorBar = phi * (S * cdf1);
+		Real discountFactorBar = -phi * (K * cdf2);
+		Real d1Bar = S * carryFactor * KernelMath<Real>::n(d1);
+		Real d2Bar = -K * discountFactor * KernelMath<Real>::n(d2);
+
+		// d2 = d1 - sigSqrtT
+		d1Bar += d2Bar;
+		Real sigSqrtTBar = -d2Bar;
+
+		// d1 = (log(S / K) + drift) / sigSqrtT
+		Real numeratorBar = d1Bar / sigSqrtT;
+		sigSqrtTBar -= (d1Bar * d1) / sigSqrtT;
+		SBar += numeratorBar / S;
+		KBar -= numeratorBar / K;
+
+		// drift = (b + sig^2 / 2) * T
+		Real bBar = numeratorBar * T;
+		Real sigBar = numeratorBar * (sig * T);
+		Real TBar = numeratorBar * (b + (std::pow(sig, Real(2)) / 2));
+
+		// sigSqrtT = sig * sqrt(T)
+		sigBar += sigSqrtTBar * sqrtT;
+		TBar += (sigSqrtTBar * sig) / (2 * sqrtT);
+
+		// carryFactor = exp((b - r) * T) and discountFactor = exp(-r * T)
+		Real carryExponentBar = carryFactorBar * carryFactor;
+		Real discountExponentBar = discountFactorBar * discountFactor;
+		bBar += carryExponentBar * T;
+		Real rBar = -(carryExponentBar + discountExponentBar) * T;
+		TBar += (carryExponentBar * (b - r)) - (discountExponentBar * r);
+
+		PriceGradient result = { price, SBar, sigBar, rBar, bBar, KBar, TBar };
+		return result;
+	}
+};
+
+// Optimal early exercise formulas for PAMOs; the exponent is y_1 for calls and y_2 for puts, and T is ignored
+template <typename Type, typename Real>
+struct OptionKernel<PerpetualAmericanExercise, Type, Real> : public OptionKernelBase<OptionKernel<PerpetualAmericanExercise, Type, Real>, Real>
+{
+	static Real Exponent(Real sig, Real r, Real b)
+	{
+		return Type::isCall ? KernelMath<Real>::y_1(sig, r, b) : KernelMath<Real>::y_2(sig, r, b);
+	}
+
+	static Real Price(Real S, Real sig, Real r, Real b, Real K, Real /*T*/)
+	{
+		Real y = Exponent(sig, r, b);
+		if (Type::isCall)
+		{
+			Real factor = (K / (y - 1));
+			return (factor * std::pow(((((y - 1)) / y) * (S / K)), y));
+		}
+		else
+		{
+			Real factor = (K / (1 - y));
+			return (factor * std::pow(((((y - 1) * S) / (y * K))), y));
+		}
+	}
+
+	static Real Delta(Real S, Real sig, Real r, Real b, Real K, Real /*T*/)
+	{
+		Real y = Exponent(sig, r, b);
+		if (Type::isCall)
+		{
+			Real factor = (K / (y - 1));
+			return ((factor * std::pow((1 / (y * factor)), y)) * (y * std::pow(S, y - 1)));
+		}
+		else
+		{
+			Real factor = (K / (1 - y));
+			return ((factor * std::pow((1 / (y * (-factor))), y)) * (y * std::pow(S, y - 1)));
+		}
+	}
+
+	static Real Gamma(Real S, Real sig, Real r, Real b, Real K, Real /*T*/)
+	{
+		Real y = Exponent(sig, r, b);
+		if (Type::isCall)
+		{
+			Real factor = (K / (y - 1));
+			return ((K * std::pow((1 / (y * factor)), y)) * (y * std::pow(S, y - 2)));
+		}
+		else
+		{
+			Real factor = (K / (1 - y));
+			return -((K * std::pow((1 / (y * (-factor))), y)) * (y * std::pow(S, y - 2)));
+		}
+	}
+
+	// Fills in the price, delta and gamma as selected by outputs; PAMOs have no theta and their vega is not implemented, so both
+	// are left at 0 as in Option::Evaluate
+	static OptionResults Evaluate(Real S, Real sig, Real r, Real b, Real K, Real T, int outputs)
+	{
+		OptionResults result = { 0, 0, 0, 0, 0 };
+		if (outputs & Option::PriceOutput)
+			result.price = Price(S, sig, r, b, K, T);
+		if (outputs & Option::DeltaOutput)
+			result.delta = Delta(S, sig, r, b, K, T);
+		if (outputs & Option::GammaOutput)
+			result.gamma = Gamma(S, sig, r, b, K, T);
+
+		return result;
+	}
+
+	// The higher-order Greeks of PAMOs are not implemented; every field is left at 0 as in Option::EvaluateHigherOrder
+	static HigherOrderResults EvaluateHigherOrder(Real, Real, Real, Real, Real, Real, int)
+	{
+		HigherOrderResults result = { 0, 0, 0, 0, 0, 0, 0 };
+		return result;
+	}
+
+	// Returns the price and its derivatives with respect to S, sig, r, b and K by reverse mode differentiation of Price; see the
+	// Euro kernel. Writing the price of either type as K / |y - 1| * X^y with X = ((y - 1) * S) / (y * K), the derivatives with
+	// respect to S, K and the exponent y are y * price / S, (1 - y) * price / K and price * log(X), and the derivative with respect
+	// to y is carried back through y = 1/2 - b/sig^2 +/- sqrt((b/sig^2 - 1/2)^2 + 2r/sig^2). The derivative with respect to T is 0.
+	static PriceGradient Gradient(Real S, Real sig, Real r, Real b, Real K, Real T)
+	{
+		// Forward sweep
+		Real variance = sig * sig;
+		Real a = (b / variance) - Real(0.5);
+		Real root = std::sqrt((a * a) + ((2 * r) / variance));
+		Real y = Exponent(sig, r, b);
+		Real price = Price(S, sig, r, b, K, T);
+
+		// Reverse sweep through price = K / |y - 1| * X^y
+		Real SBar = (y * price) / S;
+		Real KBar = ((1 - y) * price) / K;
+		Real yBar = price * std::log(((y - 1) * S) / (y * K));
+
+		// y = -a + sign * root, where root = sqrt(a^2 + 2r / variance)
+		Real sign = Type::isCall ? 1 : -1;
+		Real aBar = yBar * (-1 + ((sign * a) / root));
+		Real rootBar = yBar * sign;
+		Real rBar = rootBar / (variance * root);
+		Real varianceBar = -(rootBar * r) / ((variance * variance) * root);
+
+		// a = b / variance - 1/2 and variance = sig^2
+		Real bBar = aBar / variance;
+		varianceBar -= (aBar * b) / (variance * variance);
+		Real sigBar = varianceBar * (2 * sig);
+
+		PriceGradient result = { price, SBar, sigBar, rBar, bBar, KBar, 0 };
+		return result;
+	}
+};
+
+// Shorthands for the two exercise styles
+template <typename Type, typename Real = double>
+using EuropeanKernel = OptionKernel<EuropeanExercise, Type, Real>;
+
+template <typename Type, typename Real = double>
+using PerpetualAmericanKernel = OptionKernel<PerpetualAmericanExercise, Type, Real>;
+
+
+#endif
@@ -1,420 +1,631 @@
-// ParamMatrix.cpp
-
-#include "ParamMatrix.hpp"
-#include "EuropeanOption.hpp"
-#include "PerpetualAmericanOption.hpp"
-
-#include <vector>
-
-
-// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-
-// Default constructor
-ParamMatrix::ParamMatrix()
-{
-}
-
-										// ------------------ Constructors for Perpetual American Option Matrices ------------------ \\
-			  // Each of the following constructors in this subsection are intended to initialize the matrix private member paramMat by holding all parameter's \\
-			  // constant except for one, which will vary according to the entries of the input vector. All matrices constructed in this subsection will have 6 \\
-              // columns, 1 for each of the input parameters to the constructor, and as such each of the rows represents a PAMO. In each constructor we	also    \\
-			  // populate the vector private member optVect, 1 entry for each row in the matrix paramMat, where the PAMO is constructed according to the last	\\
-			  // 2 entries in each row of the matrix paramMat.																								    \\ 
-
-// Constructs a matrix of PAMO parameters with spot.size() many rows. The i^th row of the resulting matrix paramMat will be 
-// (spot[i], vol, rate, carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike). That is, this constructor
-// is used when the user wishes to only vary the underlying spot price but wishes to keep all other parameters fixed.
-ParamMatrix::ParamMatrix(const vector<double>& spot, double vol, double rate, double carry, char optionType, double strike)
-{
-	for (vector<double>::const_iterator it = spot.begin(); it != spot.end(); ++it)
-	{
-		if (optionType == 'C')
-		{
-			vector<double> row{ *it, vol, rate, carry, 1, strike };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new PerpetualAmericanOption(optionType, strike)));
-		}
-		else if (optionType == 'P')
-		{
-			vector<double> row{ *it, vol, rate, carry, -1, strike };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new PerpetualAmericanOption(optionType, strike)));
-		}
-	//  else 
-	//		throw illegalOptionTypeException(optionType)
-	}
-}
-
-// Constructs a matrix of PAMO parameters with vol.size() many rows. The i^th row of the resulting matrix paramMat will be 
-// (spot, vol[i], rate, carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike). That is, this constructor
-// is used when the user wishes to only vary the volatility parameter but wishes to keep all other parameters fixed.
-ParamMatrix::ParamMatrix(double spot, const vector<double>& vol, double rate, double carry, char optionType, double strike)
-{
-	for (vector<double>::const_iterator it = vol.begin(); it != vol.end(); ++it)
-	{
-		if (optionType == 'C')
-		{
-			vector<double> row{ spot, *it, rate, carry, 1, strike };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new PerpetualAmericanOption(optionType, strike)));
-		}
-		else if (optionType == 'P')
-		{
-			vector<double> row{ spot, *it, rate, carry, -1, strike };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new PerpetualAmericanOption(optionType, strike)));
-		}
-	//  else 
-	//		throw illegalOtionTypeException(optionType)
-	}
-}
-
-// Constructs a matrix of PAMO parameters with rate.size() many rows. The i^th row of the resulting matrix paramMat will be 
-// (spot, vol, rate[i], carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike). That is, this constructor
-// is used when the user wishes to only vary the money market interest rate but wishes to keep all other parameters fixed.
-ParamMatrix::ParamMatrix(double spot, double vol, const vector<double>& rate, double carry, char optionType, double strike)
-{
-	for (vector<double>::const_iterator it = rate.begin(); it != rate.end(); ++it)
-	{
-		if (optionType == 'C')
-		{
-			vector<double> row{ spot, vol, *it, carry, 1, strike };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new PerpetualAmericanOption(optionType, strike)));
-		}
-		else if (optionType == 'P')
-		{
-			vector<double> row{ spot, vol, *it, carry, -1, strike };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new PerpetualAmericanOption(optionType, strike)));
-		}
-	//  else 
-	//		throw illegalOtionTypeException(optionType)
-	}
-}
-
-// Constructs a matrix of PAMO parameters with carry.size() many rows. The i^th row of the resulting matrix paramMat will be 
-// (spot, vol, rate, carry[i], +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike). That is, this constructor
-// is used when the user wishes to only vary the cost-of-carry of the underlying but wishes to keep all other parameters fixed.
-ParamMatrix::ParamMatrix(double spot, double vol, double rate, const vector<double>& carry, char optionType, double strike)
-{
-	for (vector<double>::const_iterator it = carry.begin(); it != carry.end(); ++it)
-	{
-		if (optionType == 'C')
-		{
-			vector<double> row{ spot, vol, rate, *it, 1, strike };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new PerpetualAmericanOption(optionType, strike)));
-		}
-		else if (optionType == 'P')
-		{
-			vector<double> row{ spot, vol, rate, *it, -1, strike };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new PerpetualAmericanOption(optionType, strike)));
-		}
-	//  else 
-	//		throw illegalOtionTypeException(optionType)
-	}
-}
-
-// Constructs a matrix of PAMO parameters with strike.size() many rows. The i^th row of the resulting matrix paramMat will be 
-// (spot, vol, rate, carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike[i]). That is, this constructor
-// is used when the user wishes to only vary the strike price of the option but wishes to keep all other parameters fixed.
-ParamMatrix::ParamMatrix(double spot, double vol, double rate, double carry, char optionType, const vector<double>& strike)
-{
-	for (vector<double>::const_iterator it = strike.begin(); it != strike.end(); ++it)
-	{
-		if (optionType == 'C')
-		{
-			vector<double> row{ spot, vol, rate, carry, 1, *it };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new PerpetualAmericanOption(optionType, *it)));
-		}
-		else if (optionType == 'P')
-		{
-			vector<double> row{ spot, vol, rate, carry, -1, *it };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new PerpetualAmericanOption(optionType, *it)));
-		}
-	//  else 
-	//		throw IllegalOptionTypeException(optionType)
-	}
-}
-
-
-										// ------------------ Constructors for European Option Matrices ------------------ \\
-			  // Each of the following constructors in this subsection are intended to initialize the matrix private member paramMat by holding all parameter's \\
-			  // constant except for one, which varies according to the entries of the input vector. All matrices constructed in this subsection will have 7    \\
-              // columns, 1 for each of the input parameters to the constructor, and as such each of the rows represents a Euro option.	In each constructor we	\\
-			  // also populate the vector private member optVect, 1 entry for each row in the matrix paramMat, where the Euro option is constructed according   \\
-			  // to the last 3 entries in each row of the matrix paramMat.																						\\ 
-
-// Constructs a matrix of Euro option parameters with spot.size() many rows. The i^th row of the resulting matrix paramMat
-// will be (spot[i], vol, rate, carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike, timeTillMat). That 
-// is, this constructor is used when the user wishes to only vary the strike price of the option but wishes to keep all other 
-// parameters fixed.
-ParamMatrix::ParamMatrix(const vector<double>& spot, double vol, double rate, double carry, char optionType, double strike, double timeTillMat)
-{
-	for (vector<double>::const_iterator it = spot.begin(); it != spot.end(); ++it)
-	{
-		if (optionType == 'C')
-		{
-			vector<double> row{ *it, vol, rate, carry, 1, strike, timeTillMat };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new EuropeanOption(optionType, strike, timeTillMat)));
-		}
-		else if (optionType == 'P')
-		{
-			vector<double> row{ *it, vol, rate, carry, -1, strike, timeTillMat };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new EuropeanOption(optionType, strike, timeTillMat)));
-		}
-		//  else 
-		//		throw IllegalOptionTypeException(optionType)
-	}
-}
-
-// Constructs a matrix of Euro option parameters with vol.size() many rows. The i^th row of the resulting matrix paramMat
-// will be (spot, vol[i], rate, carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike, timeTillMat). That 
-// is, this constructor is used when the user wishes to only vary the volatility parameter of the option but wishes to keep
-// all other parameters fixed.
-ParamMatrix::ParamMatrix(double spot, const vector<double>& vol, double rate, double carry, char optionType, double strike, double timeTillMat)
-{
-	for (vector<double>::const_iterator it = vol.begin(); it != vol.end(); ++it)
-	{
-		if (optionType == 'C')
-		{
-			vector<double> row{ spot, *it, rate, carry, 1, strike, timeTillMat };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new EuropeanOption(optionType, strike, timeTillMat)));
-		}
-		else if (optionType == 'P')
-		{
-			vector<double> row{ spot, *it, rate, carry, -1, strike };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new EuropeanOption(optionType, strike, timeTillMat)));
-		}
-		//  else 
-		//		throw IllegalOptionTypeException(optionType)
-	}
-}
-
-// Constructs a matrix of Euro option parameters with rate.size() many rows. The i^th row of the resulting matrix paramMat
-// will be (spot, vol, rate[i], carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike, timeTillMat). That 
-// is, this constructor is used when the user wishes to only vary the money market interest rate but wishes to keep all other 
-// parameters fixed.
-ParamMatrix::ParamMatrix(double spot, double vol, const vector<double>& rate, double carry, char optionType, double strike, double timeTillMat)
-{
-	for (vector<double>::const_iterator it = rate.begin(); it != rate.end(); ++it)
-	{
-		if (optionType == 'C')
-		{
-			vector<double> row{ spot, vol, *it, carry, 1, strike, timeTillMat };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new EuropeanOption(optionType, strike, timeTillMat)));
-		}
-		else if (optionType == 'P')
-		{
-			vector<double> row{ spot, vol, *it, carry, -1, strike, timeTillMat };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new EuropeanOption(optionType, strike, timeTillMat)));
-		}
-		//  else 
-		//		throw IllegalOptionTypeException(optionType)
-	}
-}
-
-// Constructs a matrix of Euro option parameters with carry.size() many rows. The i^th row of the resulting matrix paramMat
-// will be (spot, vol, rate, carry[i], +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike, timeTillMat). That 
-// is, this constructor is used when the user wishes to only vary the cost-of-carry of the underlying but wishes to keep all
-// other parameters fixed.
-ParamMatrix::ParamMatrix(double spot, double vol, double rate, const vector<double>& carry, char optionType, double strike, double timeTillMat)
-{
-	for (vector<double>::const_iterator it = carry.begin(); it != carry.end(); ++it)
-	{
-		if (optionType == 'C')
-		{
-			vector<double> row{ spot, vol, rate, *it, 1, strike, timeTillMat };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new EuropeanOption(optionType, strike, timeTillMat)));
-		}
-		else if (optionType == 'P')
-		{
-			vector<double> row{ spot, vol, rate, *it, -1, strike, timeTillMat };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new EuropeanOption(optionType, strike, timeTillMat)));
-		}
-		//  else 
-		//		throw IllegalOptionTypeException(optionType)
-	}
-}
-
-// Constructs a matrix of Euro option parameters with strike.size() many rows. The i^th row of the resulting matrix paramMat
-// will be (spot, vol, rate, carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike[i], timeTillMat). That 
-// is, this constructor is used when the user wishes to only vary the strike price of the option but wishes to keep all other 
-// parameters fixed.
-ParamMatrix::ParamMatrix(double spot, double vol, double rate, double carry, char optionType, const vector<double>& strike, double timeTillMat)
-{
-	for (vector<double>::const_iterator it = strike.begin(); it != strike.end(); ++it)
-	{
-		if (optionType == 'C')
-		{
-			vector<double> row{ spot, vol, rate, carry, 1, *it, timeTillMat };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new EuropeanOption(optionType, *it, timeTillMat)));
-		}
-		else if (optionType == 'P')
-		{
-			vector<double> row{ spot, vol, rate, carry, -1, *it, timeTillMat };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new EuropeanOption(optionType, *it, timeTillMat)));
-		}
-		//  else 
-		//		throw IllegalOptionTypeException(optionType)
-	}
-}
-
-// Constructs a matrix of Euro option parameters with timeTillMat.size() many rows. The i^th row of the resulting matrix 
-// paramMat will be (spot, vol, rate, carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike[i], timeTillMat).
-// That is, this constructor is used when the user wishes to only vary the expiry length of the option but wishes to keep all
-// other parameters fixed.
-ParamMatrix::ParamMatrix(double spot, double vol, double rate, double carry, char optionType, double strike, const vector<double>& timeTillMat)
-{
-	for (vector<double>::const_iterator it = timeTillMat.begin(); it != timeTillMat.end(); ++it)
-	{
-		if (optionType == 'C')
-		{
-			vector<double> row{ spot, vol, rate, carry, 1, strike, *it };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new EuropeanOption(optionType, strike, *it)));
-		}
-		else if (optionType == 'P')
-		{
-			vector<double> row{ spot, vol, rate, carry, -1, strike, *it };
-			paramMat.push_back(row);
-			optVect.push_back(OptionPtr(new EuropeanOption(optionType, strike, *it)));
-		}
-		//  else 
-		//		throw IllegalOptionTypeException(optionType)
-	}
-}
-
-// Copy constructor
-ParamMatrix::ParamMatrix(const ParamMatrix& copyParamMat) : paramMat(copyParamMat.paramMat), optVect(copyParamMat.optVect)
-{
-}
-
-// Destructor
-ParamMatrix::~ParamMatrix()
-{
-}
-
-
-
-// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-
-// Returns a vector of prices corresponding to the options whose addresses are stored in the vector optVect. Here we make use
-// of the polymorphicity of the function Price() defined within the Option class hierarchy
-vector<double> ParamMatrix::Price() const
-{
-	vector<double> resultVect;
-	for (int i = 0; i < optVect.size(); i++)
-		resultVect.push_back(optVect[i]->Price(paramMat[i][0], paramMat[i][1], paramMat[i][2], paramMat[i][3]));
-
-	return resultVect;
-}
-
-// Returns a vector of deltas corresponding to the options whose addresses are stored in the vector optVect. Here we make use
-// of the polymorphicity of the function Delta() defined within the Option class hierarchy
-vector<double> ParamMatrix::Delta() const
-{
-	vector<double> resultVect;
-	for (int i = 0; i < optVect.size(); i++)
-	{
-		resultVect.push_back((optVect[i])->Delta(paramMat[i][0], paramMat[i][1], paramMat[i][2], paramMat[i][3]));
-	}
-
-	return resultVect;
-}
-
-// Returns a vector of approximated deltas corresponding to the options whose addresses are stored in the vector optVect. Here 
-// we make use of the polymorphicity of the function DivDiffDelta() defined within the Option class hierarchy
-vector<double> ParamMatrix::DivDiffDelta(double h) const
-{
-	vector<double> resultVect;
-	for (int i = 0; i < optVect.size(); i++)
-	{
-		resultVect.push_back((optVect[i])->DivDiffDelta(paramMat[i][0], paramMat[i][1], paramMat[i][2], paramMat[i][3], h));
-	}
-
-	return resultVect;
-}
-
-// Returns a vector of gammas corresponding to the options whose addresses are stored in the vector optVect. Here we make use
-// of the polymorphicity of the function Gamma() defined within the Option class hierarchy
-vector<double> ParamMatrix::Gamma() const
-{
-	vector<double> resultVect;
-	for (int i = 0; i < optVect.size(); i++)
-		resultVect.push_back((optVect[i])->Gamma(paramMat[i][0], paramMat[i][1], paramMat[i][2], paramMat[i][3]));
-
-	return resultVect;
-}
-
-// Returns a vector of approximated gammas corresponding to the options whose addresses are stored in the vector optVect. Here 
-// we make use of the polymorphicity of the function DivDiffGamma() defined within the Option class hierarchy
-vector<double> ParamMatrix::DivDiffGamma(double h) const
-{
-	vector<double> resultVect;
-	for (int i = 0; i < optVect.size(); i++)
-	{
-		resultVect.push_back((optVect[i])->DivDiffGamma(paramMat[i][0], paramMat[i][1], paramMat[i][2], paramMat[i][3], h));
-	}
-
-	return resultVect;
-}
-
-
-// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
-// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-
-// Allows the user to add a new row to the parameter matrix; the row can correspond to any derived Option object,
-// which at the moment (9.15.20) means the row can correspond to either a Euro option object or a PAMO object
-void ParamMatrix::PushRow(vector<double>& newRow)
-{
-	if (newRow.size() == 6)
-	{
-		if (newRow[4] == 1)
-			optVect.push_back(OptionPtr(new PerpetualAmericanOption('C', newRow[5])));
-		else
-			optVect.push_back(OptionPtr(new PerpetualAmericanOption('P', newRow[5])));
-	}
-	
-	else if (newRow.size() == 7)
-	{
-		if (newRow[4] == 1)
-			optVect.push_back(OptionPtr(new EuropeanOption('C', newRow[5], newRow[6])));
-		else
-			optVect.push_back(OptionPtr(new EuropeanOption('P', newRow[5], newRow[6])));
-	}
-	/*
-	else
-		//throw IllegalRowException()
-	*/
-
-	paramMat.push_back(newRow);
-}
-
-// Assignment operator
-ParamMatrix& ParamMatrix::operator = (const ParamMatrix& newMat)
-{
-	if (this != &newMat)
-	{
-		paramMat = newMat.paramMat;
-		optVect = newMat.optVect;
-	}
-
-	return *this;
-}
\ No newline at end of file
+// ParamMatrix.cpp
+
+#include "ParamMatrix.hpp"
+#include "EuropeanOption.hpp"
+#include "PerpetualAmericanOption.hpp"
+#include "Instrumentation.hpp"
+#include "ThreadPool.hpp"
+
+#include <vector>
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor
+ParamMatrix::ParamMatrix()
+{
+}
+
+										// ------------------ Constructors for Perpetual American Option Matrices ------------------ \\
+			  // Each of the following constructors in this subsection are intended to initialize the matrix private member paramMat by holding all parameter's \\
+			  // constant except for one, which will vary according to the entries of the input vector. All matrices constructed in this subsection will have 6 \\
+              // columns, 1 for each of the input parameters to the constructor, and as such each of the rows represents a PAMO. In each constructor we	also    \\
+			  // populate the vector private member optVect, 1 entry for each row in the matrix paramMat, where the PAMO is constructed according to the last	\\
+			  // 2 entries in each row of the matrix paramMat.																								    \\ 
+
+// Constructs a matrix of PAMO parameters with spot.size() many rows. The i^th row of the resulting matrix paramMat will be 
+// (spot[i], vol, rate, carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike). That is, this constructor
+// is used when the user wishes to only vary the underlying spot price but wishes to keep all other parameters fixed.
+ParamMatrix::ParamMatrix(const vector<double>& spot, double vol, double rate, double carry, char optionType, double strike)
+{
+	Reserve(spot.size());
+	for (vector<double>::const_iterator it = spot.begin(); it != spot.end(); ++it)
+	{
+		if (optionType == 'C')
+		{
+			double row[6] = { *it, vol, rate, carry, 1, strike };
+			AppendRow(row, 6);
+		}
+		else if (optionType == 'P')
+		{
+			double row[6] = { *it, vol, rate, carry, -1, strike };
+			AppendRow(row, 6);
+		}
+	//  else 
+	//		throw illegalOptionTypeException(optionType)
+	}
+}
+
+// Constructs a matrix of PAMO parameters with vol.size() many rows. The i^th row of the resulting matrix paramMat will be 
+// (spot, vol[i], rate, carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike). That is, this constructor
+// is used when the user wishes to only vary the volatility parameter but wishes to keep all other parameters fixed.
+ParamMatrix::ParamMatrix(double spot, const vector<double>& vol, double rate, double carry, char optionType, double strike)
+{
+	Reserve(vol.size());
+	for (vector<double>::const_iterator it = vol.begin(); it != vol.end(); ++it)
+	{
+		if (optionType == 'C')
+		{
+			double row[6] = { spot, *it, rate, carry, 1, strike };
+			AppendRow(row, 6);
+		}
+		else if (optionType == 'P')
+		{
+			double row[6] = { spot, *it, rate, carry, -1, strike };
+			AppendRow(row, 6);
+		}
+	//  else 
+	//		throw illegalOtionTypeException(optionType)
+	}
+}
+
+// Constructs a matrix of PAMO parameters with rate.size() many rows. The i^th row of the resulting matrix paramMat will be 
+// (spot, vol, rate[i], carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike). That is, this constructor
+// is used when the user wishes to only vary the money market interest rate but wishes to keep all other parameters fixed.
+ParamMatrix::ParamMatrix(double spot, double vol, const vector<double>& rate, double carry, char optionType, double strike)
+{
+	Reserve(rate.size());
+	for (vector<double>::const_iterator it = rate.begin(); it != rate.end(); ++it)
+	{
+		if (optionType == 'C')
+		{
+			double row[6] = { spot, vol, *it, carry, 1, strike };
+			AppendRow(row, 6);
+		}
+		else if (optionType == 'P')
+		{
+			double row[6] = { spot, vol, *it, carry, -1, strike };
+			AppendRow(row, 6);
+		}
+	//  else 
+	//		throw illegalOtionTypeException(optionType)
+	}
+}
+
+// Constructs a matrix of PAMO parameters with carry.size() many rows. The i^th row of the resulting matrix paramMat will be 
+// (spot, vol, rate, carry[i], +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike). That is, this constructor
+// is used when the user wishes to only vary the cost-of-carry of the underlying but wishes to keep all other parameters fixed.
+ParamMatrix::ParamMatrix(double spot, double vol, double rate, const vector<double>& carry, char optionType, double strike)
+{
+	Reserve(carry.size());
+	for (vector<double>::const_iterator it = carry.begin(); it != carry.end(); ++it)
+	{
+		if (optionType == 'C')
+		{
+			double row[6] = { spot, vol, rate, *it, 1, strike };
+			AppendRow(row, 6);
+		}
+		else if (optionType == 'P')
+		{
+			double row[6] = { spot, vol, rate, *it, -1, strike };
+			AppendRow(row, 6);
+		}
+	//  else 
+	//		throw illegalOtionTypeException(optionType)
+	}
+}
+
+// Constructs a matrix of PAMO parameters with strike.size() many rows. The i^th row of the resulting matrix paramMat will be 
+// (spot, vol, rate, carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike[i]). That is, this constructor
+// is used when the user wishes to only vary the strike price of the option but wishes to keep all other parameters fixed.
+ParamMatrix::ParamMatrix(double spot, double vol, double rate, double carry, char optionType, const vector<double>& strike)
+{
+	Reserve(strike.size());
+	for (vector<double>::const_iterator it = strike.begin(); it != strike.end(); ++it)
+	{
+		if (optionType == 'C')
+		{
+			double row[6] = { spot, vol, rate, carry, 1, *it };
+			AppendRow(row, 6);
+		}
+		else if (optionType == 'P')
+		{
+			double row[6] = { spot, vol, rate, carry, -1, *it };
+			AppendRow(row, 6);
+		}
+	//  else 
+	//		throw IllegalOptionTypeException(optionType)
+	}
+}
+
+
+										// ------------------ Constructors for European Option Matrices ------------------ \\
+			  // Each of the following constructors in this subsection are intended to initialize the matrix private member paramMat by holding all parameter's \\
+			  // constant except for one, which varies according to the entries of the input vector. All matrices constructed in this subsection will have 7    \\
+              // columns, 1 for each of the input parameters to the constructor, and as such each of the rows represents a Euro option.	In each constructor we	\\
+			  // also populate the vector private member optVect, 1 entry for each row in the matrix paramMat, where the Euro option is constructed according   \\
+			  // to the last 3 entries in each row of the matrix paramMat.																						\\ 
+
+// Constructs a matrix of Euro option parameters with spot.size() many rows. The i^th row of the resulting matrix paramMat
+// will be (spot[i], vol, rate, carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike, timeTillMat). That 
+// is, this constructor is used when the user wishes to only vary the strike price of the option but wishes to keep all other 
+// parameters fixed.
+ParamMatrix::ParamMatrix(const vector<double>& spot, double vol, double rate, double carry, char optionType, double strike, double timeTillMat)
+{
+	Reserve(spot.size());
+	for (vector<double>::const_iterator it = spot.begin(); it != spot.end(); ++it)
+	{
+		if (optionType == 'C')
+		{
+			double row[7] = { *it, vol, rate, carry, 1, strike, timeTillMat };
+			AppendRow(row, 7);
+		}
+		else if (optionType == 'P')
+		{
+			double row[7] = { *it, vol, rate, carry, -1, strike, timeTillMat };
+			AppendRow(row, 7);
+		}
+		//  else 
+		//		throw IllegalOptionTypeException(optionType)
+	}
+}
+
+// Constructs a matrix of Euro option parameters with vol.size() many rows. The i^th row of the resulting matrix paramMat
+// will be (spot, vol[i], rate, carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike, timeTillMat). That 
+// is, this constructor is used when the user wishes to only vary the volatility parameter of the option but wishes to keep
+// all other parameters fixed.
+ParamMatrix::ParamMatrix(double spot, const vector<double>& vol, double rate, double carry, char optionType, double strike, double timeTillMat)
+{
+	Reserve(vol.size());
+	for (vector<double>::const_iterator it = vol.begin(); it != vol.end(); ++it)
+	{
+		if (optionType == 'C')
+		{
+			double row[7] = { spot, *it, rate, carry, 1, strike, timeTillMat };
+			AppendRow(row, 7);
+		}
+		else if (optionType == 'P')
+		{
+			double row[7] = { spot, *it, rate, carry, -1, strike, timeTillMat };
+			AppendRow(row, 7);
+		}
+		//  else 
+		//		throw IllegalOptionTypeException(optionType)
+	}
+}
+
+// Constructs a matrix of Euro option parameters with rate.size() many rows. The i^th row of the resulting matrix paramMat
+// will be (spot, vol, rate[i], carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike, timeTillMat). That 
+// is, this constructor is used when the user wishes to only vary the money market interest rate but wishes to keep all other 
+// parameters fixed.
+ParamMatrix::ParamMatrix(double spot, double vol, const vector<double>& rate, double carry, char optionType, double strike, double timeTillMat)
+{
+	Reserve(rate.size());
+	for (vector<double>::const_iterator it = rate.begin(); it != rate.end(); ++it)
+	{
+		if (optionType == 'C')
+		{
+			double row[7] = { spot, vol, *it, carry, 1, strike, timeTillMat };
+			AppendRow(row, 7);
+		}
+		else if (optionType == 'P')
+		{
+			double row[7] = { spot, vol, *it, carry, -1, strike, timeTillMat };
+			AppendRow(row, 7);
+		}
+		//  else 
+		//		throw IllegalOptionTypeException(optionType)
+	}
+}
+
+// Constructs a matrix of Euro option parameters with carry.size() many rows. The i^th row of the resulting matrix paramMat
+// will be (spot, vol, rate, carry[i], +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike, timeTillMat). That 
+// is, this constructor is used when the user wishes to only vary the cost-of-carry of the underlying but wishes to keep all
+// other parameters fixed.
+ParamMatrix::ParamMatrix(double spot, double vol, double rate, const vector<double>& carry, char optionType, double strike, double timeTillMat)
+{
+	Reserve(carry.size());
+	for (vector<double>::const_iterator it = carry.begin(); it != carry.end(); ++it)
+	{
+		if (optionType == 'C')
+		{
+			double row[7] = { spot, vol, rate, *it, 1, strike, timeTillMat };
+			AppendRow(row, 7);
+		}
+		else if (optionType == 'P')
+		{
+			double row[7] = { spot, vol, rate, *it, -1, strike, timeTillMat };
+			AppendRow(row, 7);
+		}
+		//  else 
+		//		throw IllegalOptionTypeException(optionType)
+	}
+}
+
+// Constructs a matrix of Euro option parameters with strike.size() many rows. The i^th row of the resulting matrix paramMat
+// will be (spot, vol, rate, carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike[i], timeTillMat). That 
+// is, this constructor is used when the user wishes to only vary the strike price of the option but wishes to keep all other 
+// parameters fixed.
+ParamMatrix::ParamMatrix(double spot, double vol, double rate, double carry, char optionType, const vector<double>& strike, double timeTillMat)
+{
+	Reserve(strike.size());
+	for (vector<double>::const_iterator it = strike.begin(); it != strike.end(); ++it)
+	{
+		if (optionType == 'C')
+		{
+			double row[7] = { spot, vol, rate, carry, 1, *it, timeTillMat };
+			AppendRow(row, 7);
+		}
+		else if (optionType == 'P')
+		{
+			double row[7] = { spot, vol, rate, carry, -1, *it, timeTillMat };
+			AppendRow(row, 7);
+		}
+		//  else 
+		//		throw IllegalOptionTypeException(optionType)
+	}
+}
+
+// Constructs a matrix of Euro option parameters with timeTillMat.size() many rows. The i^th row of the resulting matrix 
+// paramMat will be (spot, vol, rate, carry, +/- 1 (+1 if optionType == 'C', -1 if optionType == 'P'), strike[i], timeTillMat).
+// That is, this constructor is used when the user wishes to only vary the expiry length of the option but wishes to keep all
+// other parameters fixed.
+ParamMatrix::ParamMatrix(double spot, double vol, double rate, double carry, char optionType, double strike, const vector<double>& timeTillMat)
+{
+	Reserve(timeTillMat.size());
+	for (vector<double>::const_iterator it = timeTillMat.begin(); it != timeTillMat.end(); ++it)
+	{
+		if (optionType == 'C')
+		{
+			double row[7] = { spot, vol, rate, carry, 1, strike, *it };
+			AppendRow(row, 7);
+		}
+		else if (optionType == 'P')
+		{
+			double row[7] = { spot, vol, rate, carry, -1, strike, *it };
+			AppendRow(row, 7);
+		}
+		//  else 
+		//		throw IllegalOptionTypeException(optionType)
+	}
+}
+
+// Copy constructor; the copy constructs its own Option objects from the rows of copyParamMat
+ParamMatrix::ParamMatrix(const ParamMatrix& copyParamMat)
+{
+	Reserve(copyParamMat.Size());
+	for (size_t i = 0; i < copyParamMat.Size(); i++)
+		AppendRow(copyParamMat.RowData(i), copyParamMat.RowWidth(i));
+}
+
+// Destructor; the Option objects are destroyed here and their memory is returned with optionArena's
+ParamMatrix::~ParamMatrix()
+{
+	DestroyOptions();
+}
+
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the number of rows in the matrix paramMat, which equals the number of options pointed to by the entries of optVect
+size_t ParamMatrix::Size() const
+{
+	return rowWidths.size();
+}
+
+// Returns a copy of the i^th row of the matrix paramMat; the row holds 6 entries for PAMOs and 7 entries for Euro options. Loops
+// over every row should use RowData and RowWidth, which do not allocate.
+vector<double> ParamMatrix::GetRow(size_t i) const
+{
+	return vector<double>(RowData(i), RowData(i) + RowWidth(i));
+}
+
+// Returns the number of entries of the i^th row of the matrix paramMat
+size_t ParamMatrix::RowWidth(size_t i) const
+{
+	return rowWidths[i];
+}
+
+// Returns a vector of prices corresponding to the options whose addresses are stored in the vector optVect. Here we make use
+// of the polymorphicity of the function Price() defined within the Option class hierarchy
+vector<double> ParamMatrix::Price() const
+{
+	INSTRUMENT_SCOPE("ParamMatrix::Price");
+	vector<double> resultVect(optVect.size());
+	for (size_t i = 0; i < optVect.size(); i++)
+	{
+		const double* row = RowData(i);
+		resultVect[i] = optVect[i]->Price(row[0], row[1], row[2], row[3]);
+	}
+
+	return resultVect;
+}
+
+// Returns a vector of deltas corresponding to the options whose addresses are stored in the vector optVect. Here we make use
+// of the polymorphicity of the function Delta() defined within the Option class hierarchy
+vector<double> ParamMatrix::Delta() const
+{
+	INSTRUMENT_SCOPE("ParamMatrix::Delta");
+	vector<double> resultVect(optVect.size());
+	for (size_t i = 0; i < optVect.size(); i++)
+	{
+		const double* row = RowData(i);
+		resultVect[i] = optVect[i]->Delta(row[0], row[1], row[2], row[3]);
+	}
+
+	return resultVect;
+}
+
+// Returns a vector of approximated deltas corresponding to the options whose addresses are stored in the vector optVect. Here 
+// we make use of the polymorphicity of the function DivDiffDelta() defined within the Option class hierarchy
+vector<double> ParamMatrix::DivDiffDelta(double h) const
+{
+	INSTRUMENT_SCOPE("ParamMatrix::DivDiffDelta");
+	vector<double> resultVect(optVect.size());
+	for (size_t i = 0; i < optVect.size(); i++)
+	{
+		const double* row = RowData(i);
+		resultVect[i] = optVect[i]->DivDiffDelta(row[0], row[1], row[2], row[3], h);
+	}
+
+	return resultVect;
+}
+
+// Returns a vector of gammas corresponding to the options whose addresses are stored in the vector optVect. Here we make use
+// of the polymorphicity of the function Gamma() defined within the Option class hierarchy
+vector<double> ParamMatrix::Gamma() const
+{
+	INSTRUMENT_SCOPE("ParamMatrix::Gamma");
+	vector<double> resultVect(optVect.size());
+	for (size_t i = 0; i < optVect.size(); i++)
+	{
+		const double* row = RowData(i);
+		resultVect[i] = optVect[i]->Gamma(row[0], row[1], row[2], row[3]);
+	}
+
+	return resultVect;
+}
+
+// Returns a vector of approximated gammas corresponding to the options whose addresses are stored in the vector optVect. Here 
+// we make use of the polymorphicity of the function DivDiffGamma() defined within the Option class hierarchy
+vector<double> ParamMatrix::DivDiffGamma(double h) const
+{
+	INSTRUMENT_SCOPE("ParamMatrix::DivDiffGamma");
+	vector<double> resultVect(optVect.size());
+	for (size_t i = 0; i < optVect.size(); i++)
+	{
+		const double* row = RowData(i);
+		resultVect[i] = optVect[i]->DivDiffGamma(row[0], row[1], row[2], row[3], h);
+	}
+
+	return resultVect;
+}
+
+
+// Returns a vector of single-pass evaluations corresponding to the options whose addresses are stored in the vector optVect. Here we
+// make use of the polymorphicity of the function Evaluate() defined within the Option class hierarchy
+vector<OptionResults> ParamMatrix::Evaluate(int outputs) const
+{
+	INSTRUMENT_SCOPE("ParamMatrix::Evaluate");
+	vector<OptionResults> resultVect(optVect.size());
+	for (size_t i = 0; i < optVect.size(); i++)
+	{
+		const double* row = RowData(i);
+		resultVect[i] = optVect[i]->Evaluate(row[0], row[1], row[2], row[3], outputs);
+	}
+
+	return resultVect;
+}
+
+
+// Returns a vector of the higher-order Greeks selected by higherOutputs of the options whose addresses are stored in the vector
+// optVect. Here we make use of the polymorphicity of the function EvaluateHigherOrder() defined within the Option class hierarchy
+vector<HigherOrderResults> ParamMatrix::EvaluateHigherOrder(int higherOutputs) const
+{
+	INSTRUMENT_SCOPE("ParamMatrix::EvaluateHigherOrder");
+	vector<HigherOrderResults> resultVect(optVect.size());
+	for (size_t i = 0; i < optVect.size(); i++)
+	{
+		const double* row = RowData(i);
+		resultVect[i] = optVect[i]->EvaluateHigherOrder(row[0], row[1], row[2], row[3], higherOutputs);
+	}
+
+	return resultVect;
+}
+
+// Fills results and higherResults with the outputs selected by outputs and higherOutputs of the options whose addresses are stored
+// in the vector optVect, each option computing both in a single pass
+void ParamMatrix::Evaluate(int outputs, int higherOutputs, vector<OptionResults>& results, vector<HigherOrderResults>& higherResults) const
+{
+	INSTRUMENT_SCOPE("ParamMatrix::Evaluate(higher order)");
+	results.resize(optVect.size());
+	higherResults.resize(optVect.size());
+	for (size_t i = 0; i < optVect.size(); i++)
+	{
+		const double* row = RowData(i);
+		optVect[i]->Evaluate(row[0], row[1], row[2], row[3], outputs, higherOutputs, results[i], higherResults[i]);
+	}
+}
+
+// Returns a vector of the price gradients of the options whose addresses are stored in the vector optVect. Here we make use of the
+// polymorphicity of the function Gradient() defined within the Option class hierarchy
+vector<PriceGradient> ParamMatrix::Gradient() const
+{
+	INSTRUMENT_SCOPE("ParamMatrix::Gradient");
+	vector<PriceGradient> resultVect(optVect.size());
+	for (size_t i = 0; i < optVect.size(); i++)
+	{
+		const double* row = RowData(i);
+		resultVect[i] = optVect[i]->Gradient(row[0], row[1], row[2], row[3]);
+	}
+
+	return resultVect;
+}
+
+// Returns the sum over every option of its price gradient. Every derivative of the sum is the derivative of the value of the book
+// when the corresponding input of every row moves by the same amount, e.g. the book's delta to a common underlying or its exposure
+// to a parallel shift of rates; the rows are summed in order, so the result does not depend on anything but the matrix.
+PriceGradient ParamMatrix::BookGradient() const
+{
+	INSTRUMENT_SCOPE("ParamMatrix::BookGradient");
+	PriceGradient total = { 0, 0, 0, 0, 0, 0, 0 };
+	for (size_t i = 0; i < optVect.size(); i++)
+	{
+		const double* row = RowData(i);
+		PriceGradient gradient = optVect[i]->Gradient(row[0], row[1], row[2], row[3]);
+		total.price += gradient.price;
+		total.dS += gradient.dS;
+		total.dSig += gradient.dSig;
+		total.dr += gradient.dr;
+		total.db += gradient.db;
+		total.dK += gradient.dK;
+		total.dT += gradient.dT;
+	}
+
+	return total;
+}
+
+
+// Fills result with the price of every option pointed to by the entries of optVect, evaluating chunks of rows in parallel on pool
+void ParamMatrix::Price(vector<double>& result, ThreadPool& pool, size_t grain) const
+{
+	ParallelApply(&Option::Price, result, pool, grain);
+}
+
+// Fills result with the delta of every option pointed to by the entries of optVect, evaluating chunks of rows in parallel on pool
+void ParamMatrix::Delta(vector<double>& result, ThreadPool& pool, size_t grain) const
+{
+	ParallelApply(&Option::Delta, result, pool, grain);
+}
+
+// Fills result with the approximate delta of every option pointed to by the entries of optVect, evaluating chunks of rows in
+// parallel on pool
+void ParamMatrix::DivDiffDelta(double h, vector<double>& result, ThreadPool& pool, size_t grain) const
+{
+	ParallelApply(&Option::DivDiffDelta, h, result, pool, grain);
+}
+
+// Fills result with the gamma of every option pointed to by the entries of optVect, evaluating chunks of rows in parallel on pool
+void ParamMatrix::Gamma(vector<double>& result, ThreadPool& pool, size_t grain) const
+{
+	ParallelApply(&Option::Gamma, result, pool, grain);
+}
+
+// Fills result with the approximate gamma of every option pointed to by the entries of optVect, evaluating chunks of rows in
+// parallel on pool
+void ParamMatrix::DivDiffGamma(double h, vector<double>& result, ThreadPool& pool, size_t grain) const
+{
+	ParallelApply(&Option::DivDiffGamma, h, result, pool, grain);
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Allows the user to add a new row to the parameter matrix; the row can correspond to any derived Option object,
+// which at the moment (9.15.20) means the row can correspond to either a Euro option object or a PAMO object
+void ParamMatrix::PushRow(vector<double>& newRow)
+{
+	AppendRow(newRow.data(), newRow.size());
+}
+
+// Reserves room for rows many rows in the matrix paramMat and in optionArena, so that a book of known size is built with no
+// further allocation
+void ParamMatrix::Reserve(size_t rows)
+{
+	paramMat.reserve(rowStride * rows);
+	rowWidths.reserve(rows);
+	optVect.reserve(rows);
+
+	size_t largest = (sizeof(EuropeanOption) > sizeof(PerpetualAmericanOption)) ? sizeof(EuropeanOption) : sizeof(PerpetualAmericanOption);
+	if (rows > optVect.size())
+		optionArena.Reserve(largest * (rows - optVect.size()));
+}
+
+// Removes every row. The vectors keep their capacity and optionArena keeps its memory, so rebuilding a book of the same size
+// afterwards allocates nothing.
+void ParamMatrix::Clear()
+{
+	DestroyOptions();
+	optVect.clear();
+	rowWidths.clear();
+	paramMat.clear();
+	optionArena.Reset();
+}
+
+// Assignment operator; as with the copy constructor, the Option objects of newMat are not shared but constructed anew
+ParamMatrix& ParamMatrix::operator = (const ParamMatrix& newMat)
+{
+	if (this != &newMat)
+	{
+		Clear();
+		Reserve(newMat.Size());
+		for (size_t i = 0; i < newMat.Size(); i++)
+			AppendRow(newMat.RowData(i), newMat.RowWidth(i));
+	}
+
+	return *this;
+}
+
+
+// ------------------------------------------------------------------------ Private Functions -------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Writes (optVect[i]->*member)(S, sig, r, b) into result[i] for every row i; each chunk of rows is handled by a single thread
+void ParamMatrix::ParallelApply(OptionMember member, vector<double>& result, ThreadPool& pool, size_t grain) const
+{
+	INSTRUMENT_SCOPE("ParamMatrix::ParallelApply");
+	result.resize(optVect.size());
+	pool.ParallelFor(0, optVect.size(), grain, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; i++)
+		{
+			const double* row = RowData(i);
+			result[i] = ((*optVect[i]).*member)(row[0], row[1], row[2], row[3]);
+		}
+	});
+}
+
+// Writes (optVect[i]->*member)(S, sig, r, b, h) into result[i] for every row i; each chunk of rows is handled by a single thread
+void ParamMatrix::ParallelApply(OptionDivDiffMember member, double h, vector<double>& result, ThreadPool& pool, size_t grain) const
+{
+	INSTRUMENT_SCOPE("ParamMatrix::ParallelApply");
+	result.resize(optVect.size());
+	pool.ParallelFor(0, optVect.size(), grain, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; i++)
+		{
+			const double* row = RowData(i);
+			result[i] = ((*optVect[i]).*member)(row[0], row[1], row[2], row[3], h);
+		}
+	});
+}
+
+// Appends the width entries of row to the matrix paramMat and constructs the Option object the row represents in optionArena
+void ParamMatrix::AppendRow(const double* row, size_t width)
+{
+	if (width != 6 && width != 7)
+		return;
+	//	throw IllegalRowException()
+
+	char optionType = (row[4] == 1) ? 'C' : 'P';
+	if (width == 6)
+		optVect.push_back(optionArena.Create<PerpetualAmericanOption>(optionType, row[5]));
+	else
+		optVect.push_back(optionArena.Create<EuropeanOption>(optionType, row[5], row[6]));
+
+	paramMat.insert(paramMat.end(), row, row + width);
+	if (width < rowStride)
+		paramMat.insert(paramMat.end(), rowStride - width, 0.0);
+	rowWidths.push_back(static_cast<unsigned char>(width));
+}
+
+// Runs the destructor of every Option object constructed in optionArena; the memory itself is kept by optionArena
+void ParamMatrix::DestroyOptions()
+{
+	for (size_t i = 0; i < optVect.size(); i++)
+		optVect[i]->~Option();
+}
@@ -1,83 +1,144 @@
-// ParamMatrix.hpp
-//
-// The purpose of the ParamMatrix class is to extend the functionality of the Option class hierarchy so as to be able to
-// handle multiple options of potentially different types at the same time i.e. to be able to compute the price or Greeks
-// of a vector of Options objects. In order to allow the user to specify different parameters (S/sig/r/b) for each option, 
-// we use a matrix private data member in order to store a vector of Option parameter vectors. That is, each row in the
-// matrix represents a different Option object along with a different set of parameter values that will be used when working 
-// with the pricing and Greeks functions defined in the Option class hiearchy. In tandem with the matrix private member,
-// we use a Option shared pointer vector in order to store the address of each Option object represented in the matrix. We
-// do this in order to simplify the code in the Price(), Delta(), and Gamma() member functions defined in ParamMatrix.cpp. 
-
-#ifndef ParamMatrix_H
-#define ParamMatrix_H
-
-#include "Option.hpp"
-
-#include <boost/shared_ptr.hpp>
-typedef boost::shared_ptr<Option> OptionPtr;
-
-#include <vector>
-using namespace std;
-
-class ParamMatrix
-{
-private:
-	vector< vector<double> > paramMat;					// Stores a matrix of option parameters. Each row in the matrix can hold parameters for either
-														// Euro options or PAMOs, and in the future any other derived option object. The number of entries
-														// in a given row depends on whether that row represents a Euro option, in which case there will
-														// be 7 entries (S, sig, r, b, Put/Call, K, T), or a PAMO, in which case there will be 6 entries 
-														// (S, sig, r, b, Put/Call, K)
-
-	vector<OptionPtr> optVect;							// This vector stores pointers to Option objects that are represented by rows in the matrix
-														// paramMat. The j^th entry of optVect points to the Option object represented by the j^th
-														// row of the matrix paramMat. It is important to note that only the last 2 (for PAMOs) and
-														// last 3 (for Euro options) entries in each row are used to create an Option object, the 
-														// other entries are parameters for member functions defined in the Option classes.
-
-public:
-	// Constructors and Destructor
-	ParamMatrix();										// Default constructor
-	ParamMatrix(const ParamMatrix& copyParamMat);		// Copy constructor
-	virtual ~ParamMatrix();								// Destructor
-									
-								    // Constructors for Perpetual American matrices \\
-			     // The purpose of each of the below constructors is described in detail in ParamMatrix.cpp \\
-
-	ParamMatrix(const vector<double>& spot, double vol, double rate, double carry, char optionType, double strike);
-	ParamMatrix(double spot, const vector<double>& vol, double rate, double carry, char optionType, double strike);
-	ParamMatrix(double spot, double vol, const vector<double>& rate, double carry, char optionType, double strike);
-	ParamMatrix(double spot, double vol, double rate, const vector<double>& carry, char optionType, double strike);
-	ParamMatrix(double spot, double vol, double rate, double carry, char optionType, const vector<double>& strike);
-										
-										 // Constructors for European matrices \\
-				// The purpose of each of the below constructors is described in detail in ParamMatrix.cpp  \\
-
-	ParamMatrix(const vector<double>& spot, double vol, double rate, double carry, char optionType, double strike, double timeTillMat);
-	ParamMatrix(double spot, const vector<double>& vol, double rate, double carry, char optionType, double strike, double timeTillMat);
-	ParamMatrix(double spot, double vol, const vector<double>& rate, double carry, char optionType, double strike, double timeTillMat);
-	ParamMatrix(double spot, double vol, double rate, const vector<double>& carry, char optionType, double strike, double timeTillMat);
-	ParamMatrix(double spot, double vol, double rate, double carry, char optionType, const vector<double>& strike, double timeTillMat);
-	ParamMatrix(double spot, double vol, double rate, double carry, char optionType, double strike, const vector<double>& timeTillMat);
-
-
-	// Accessor Functions
-	vector<double> Price() const;								// Returns a vector of prices corresponding to the options pointed to by the entries of optVec
-	vector<double> Delta() const;								// Returns a vector of deltas corresponding to the options pointed to by the entries of optVec
-	vector<double> DivDiffDelta(double h) const;				// Returns an vector of approximate deltas corresponding to a step size of h using centered 
-																// divided differences		
-	vector<double> Gamma() const;								// Returns a vector of gammas corresponding to the options pointed to by the entries of optVec
-	vector<double> DivDiffGamma(double h) const;				// Returns an vector of approximate gammas corresponding to a step size of h using centered 
-																// divided differences
-
-
-	// Modifier Functions
-	virtual void PushRow(vector<double>& newRow);				// Adds a row to the private member paramMat and populates it with the vector newRow -- at the
-																// moment, newRow.size() can only equal 6 (for PAMOs) or 7 (for Euro options) 
-
-	ParamMatrix& operator = (const ParamMatrix& newMat);		// Assignment operator	
-
-};
-
-
-#endif
+// ParamMatrix.hpp
+//
+// The purpose of the ParamMatrix class is to extend the functionality of the Option class hierarchy so as to be able to
+// handle multiple options of potentially different types at the same time i.e. to be able to compute the price or Greeks
+// of a vector of Options objects. In order to allow the user to specify different parameters (S/sig/r/b) for each option, 
+// we use a matrix private data member in order to store a vector of Option parameter vectors. That is, each row in the
+// matrix represents a different Option object along with a different set of parameter values that will be used when working 
+// with the pricing and Greeks functions defined in the Option class hiearchy. In tandem with the matrix private member,
+// we use a vector of Option pointers in order to store the address of each Option object represented in the matrix. We
+// do this in order to simplify the code in the Price(), Delta(), and Gamma() member functions defined in ParamMatrix.cpp. 
+//
+// The matrix is stored row by row in a single array, and the Option objects are constructed in an Arena owned by the matrix, so a
+// book costs a handful of allocations however many rows it has rather than two or three per row, and no reference counts are
+// touched when it is copied or destroyed. Clear empties the matrix while keeping that memory, so that a book rebuilt between runs
+// does not allocate at all. A copy of a ParamMatrix constructs Option objects of its own.
+
+#ifndef ParamMatrix_H
+#define ParamMatrix_H
+
+#include "Option.hpp"
+#include "Arena.hpp"
+
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+class ThreadPool;
+
+class ParamMatrix
+{
+private:
+	static const size_t rowStride = 7;					// Entries reserved for each row of paramMat
+
+	vector<double> paramMat;							// Stores a matrix of option parameters, row i in entries [rowStride * i, rowStride * (i + 1)).
+														// Each row in the matrix can hold parameters for either Euro options or PAMOs, and in the future
+														// any other derived option object. The number of entries in a given row depends on whether that
+														// row represents a Euro option, in which case there will be 7 entries (S, sig, r, b, Put/Call,
+														// K, T), or a PAMO, in which case there will be 6 entries (S, sig, r, b, Put/Call, K) and the
+														// 7th is unused and 0
+	vector<unsigned char> rowWidths;					// The number of entries, 6 or 7, of each row of paramMat
+
+	vector<Option*> optVect;							// This vector stores pointers to Option objects that are represented by rows in the matrix
+														// paramMat. The j^th entry of optVect points to the Option object represented by the j^th
+														// row of the matrix paramMat. It is important to note that only the last 2 (for PAMOs) and
+														// last 3 (for Euro options) entries in each row are used to create an Option object, the 
+														// other entries are parameters for member functions defined in the Option classes.
+	Arena optionArena;									// Holds the Option objects pointed to by the entries of optVect
+
+	void AppendRow(const double* row, size_t width);	// Adds a row of width entries and constructs its Option object; rows of any width other
+														// than 6 or 7 are ignored
+	void DestroyOptions();								// Runs the destructor of every Option object in optionArena
+
+	typedef double (Option::*OptionMember)(double, double, double, double) const;
+	typedef double (Option::*OptionDivDiffMember)(double, double, double, double, double) const;
+
+	void ParallelApply(OptionMember member, vector<double>& result, ThreadPool& pool, size_t grain) const;
+	void ParallelApply(OptionDivDiffMember member, double h, vector<double>& result, ThreadPool& pool, size_t grain) const;
+														// Helpers for the parallel accessor functions; they apply member to every row
+
+public:
+	// Constructors and Destructor
+	ParamMatrix();										// Default constructor
+	ParamMatrix(const ParamMatrix& copyParamMat);		// Copy constructor
+	virtual ~ParamMatrix();								// Destructor
+									
+								    // Constructors for Perpetual American matrices \\
+			     // The purpose of each of the below constructors is described in detail in ParamMatrix.cpp \\
+
+	ParamMatrix(const vector<double>& spot, double vol, double rate, double carry, char optionType, double strike);
+	ParamMatrix(double spot, const vector<double>& vol, double rate, double carry, char optionType, double strike);
+	ParamMatrix(double spot, double vol, const vector<double>& rate, double carry, char optionType, double strike);
+	ParamMatrix(double spot, double vol, double rate, const vector<double>& carry, char optionType, double strike);
+	ParamMatrix(double spot, double vol, double rate, double carry, char optionType, const vector<double>& strike);
+										
+										 // Constructors for European matrices \\
+				// The purpose of each of the below constructors is described in detail in ParamMatrix.cpp  \\
+
+	ParamMatrix(const vector<double>& spot, double vol, double rate, double carry, char optionType, double strike, double timeTillMat);
+	ParamMatrix(double spot, const vector<double>& vol, double rate, double carry, char optionType, double strike, double timeTillMat);
+	ParamMatrix(double spot, double vol, const vector<double>& rate, double carry, char optionType, double strike, double timeTillMat);
+	ParamMatrix(double spot, double vol, double rate, const vector<double>& carry, char optionType, double strike, double timeTillMat);
+	ParamMatrix(double spot, double vol, double rate, double carry, char optionType, const vector<double>& strike, double timeTillMat);
+	ParamMatrix(double spot, double vol, double rate, double carry, char optionType, double strike, const vector<double>& timeTillMat);
+
+
+	// Accessor Functions
+	size_t Size() const;										// Returns the number of rows in the matrix paramMat
+	vector<double> GetRow(size_t i) const;						// Returns a copy of the i^th row of the matrix paramMat
+	const double* RowData(size_t i) const;						// Returns the entries of the i^th row of the matrix paramMat without copying them
+	size_t RowWidth(size_t i) const;							// Returns the number of entries of the i^th row, 6 for PAMOs and 7 for Euro options
+
+	vector<double> Price() const;								// Returns a vector of prices corresponding to the options pointed to by the entries of optVec
+	vector<double> Delta() const;								// Returns a vector of deltas corresponding to the options pointed to by the entries of optVec
+	vector<double> DivDiffDelta(double h) const;				// Returns an vector of approximate deltas corresponding to a step size of h using centered 
+																// divided differences		
+	vector<double> Gamma() const;								// Returns a vector of gammas corresponding to the options pointed to by the entries of optVec
+	vector<double> DivDiffGamma(double h) const;				// Returns an vector of approximate gammas corresponding to a step size of h using centered 
+																// divided differences
+	vector<OptionResults> Evaluate(int outputs = Option::AllOutputs) const;
+																// Returns a vector holding, for each option pointed to by the entries of optVect, the
+																// outputs selected by the Option::Outputs flags computed in a single pass
+	vector<HigherOrderResults> EvaluateHigherOrder(int higherOutputs = Option::AllHigherOrderOutputs) const;
+																// Returns, for each option, the higher-order Greeks selected by the
+																// Option::HigherOrderOutputs flags; they are 0 for PAMOs
+	void Evaluate(int outputs, int higherOutputs, vector<OptionResults>& results, vector<HigherOrderResults>& higherResults) const;
+																// Resizes results and higherResults to one entry per row and fills them in a
+																// single pass per option
+	vector<PriceGradient> Gradient() const;						// Returns, for each option, its price and the derivatives of the price with respect to
+																// S, sig, r, b, K and T, computed by reverse mode differentiation
+	PriceGradient BookGradient() const;							// Returns the sum of the gradients of every option: the value of the whole book and its
+																// derivatives with respect to a shift of each input applied to every row at once
+
+								// Parallel versions of the above; each resizes result to one entry per row (which does not allocate when
+								// result already has that size) and fills it in place using the given pool. Chunks of grain rows are
+								// scheduled with work stealing, grain = 0 lets the pool choose, and the results are identical to, and
+								// in the same order as, those of the serial functions //
+
+	void Price(vector<double>& result, ThreadPool& pool, size_t grain = 0) const;
+	void Delta(vector<double>& result, ThreadPool& pool, size_t grain = 0) const;
+	void DivDiffDelta(double h, vector<double>& result, ThreadPool& pool, size_t grain = 0) const;
+	void Gamma(vector<double>& result, ThreadPool& pool, size_t grain = 0) const;
+	void DivDiffGamma(double h, vector<double>& result, ThreadPool& pool, size_t grain = 0) const;
+
+
+	// Modifier Functions
+	virtual void PushRow(vector<double>& newRow);				// Adds a row to the private member paramMat and populates it with the vector newRow -- at the
+																// moment, newRow.size() can only equal 6 (for PAMOs) or 7 (for Euro options), and any
+																// other row is ignored
+	void Reserve(size_t rows);									// Reserves room for at least rows many rows, Option objects included
+	void Clear();												// Removes every row while keeping the memory for reuse
+
+	ParamMatrix& operator = (const ParamMatrix& newMat);		// Assignment operator	
+
+};
+
+
+// Returns a pointer to the first entry of the i^th row of the matrix paramMat
+inline const double* ParamMatrix::RowData(size_t i) const
+{
+	return &paramMat[rowStride * i];
+}
+
+
+#endif
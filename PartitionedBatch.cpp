@@ -0,0 +1,302 @@
+// PartitionedBatch.cpp
+
+#include "PartitionedBatch.hpp"
+#include "BsmKernel.hpp"
+#include "OptionKernels.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+
+namespace
+{
+	// Rows evaluated per block before their results are scattered
+	const size_t blockRows = 256;
+
+	// Returns the bucket of row i of view
+	int BucketOf(const OptionBatchView& view, size_t i)
+	{
+		int bucket = (view.type[i] == 1) ? 0 : 1;
+		return (view.kind[i] == 'E') ? bucket : bucket + 2;
+	}
+
+	// Price, Delta and Gamma of a homogeneous block. The Euro overloads are more specialized and therefore chosen for Euro kernels;
+	// they switch to BsmKernel when vectorized is set.
+	template <typename Kernel>
+	void PriceBlock(Kernel, const OptionBatchView& view, double* out, bool)
+	{
+		Kernel::PriceBatch(view, out);
+	}
+
+	template <typename Type>
+	void PriceBlock(EuropeanKernel<Type>, const OptionBatchView& view, double* out, bool vectorized)
+	{
+		if (vectorized)
+			BsmKernel::Price(view, out);
+		else
+			EuropeanKernel<Type>::PriceBatch(view, out);
+	}
+
+	template <typename Kernel>
+	void DeltaBlock(Kernel, const OptionBatchView& view, double* out, bool)
+	{
+		Kernel::DeltaBatch(view, out);
+	}
+
+	template <typename Type>
+	void DeltaBlock(EuropeanKernel<Type>, const OptionBatchView& view, double* out, bool vectorized)
+	{
+		if (vectorized)
+			BsmKernel::Delta(view, out);
+		else
+			EuropeanKernel<Type>::DeltaBatch(view, out);
+	}
+
+	template <typename Kernel>
+	void GammaBlock(Kernel, const OptionBatchView& view, double* out, bool)
+	{
+		Kernel::GammaBatch(view, out);
+	}
+
+	template <typename Type>
+	void GammaBlock(EuropeanKernel<Type>, const OptionBatchView& view, double* out, bool vectorized)
+	{
+		if (vectorized)
+			BsmKernel::Gamma(view, out);
+		else
+			EuropeanKernel<Type>::GammaBatch(view, out);
+	}
+}
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor
+PartitionedBatch::PartitionedBatch() : rows(), permutation(), vectorized(false)
+{
+	fill(bucketStart, bucketStart + BucketCount + 1, 0);
+}
+
+// Partitions the rows of view
+PartitionedBatch::PartitionedBatch(const OptionBatchView& view) : rows(), permutation(), vectorized(false)
+{
+	Assign(view);
+}
+
+// Partitions the rows of paramMat by way of its columnar form
+PartitionedBatch::PartitionedBatch(const ParamMatrix& paramMat) : rows(), permutation(), vectorized(false)
+{
+	OptionBatch batch(paramMat);
+	Assign(batch.View());
+}
+
+// Copy constructor
+PartitionedBatch::PartitionedBatch(const PartitionedBatch& batch) : rows(batch.rows), permutation(batch.permutation), vectorized(batch.vectorized)
+{
+	copy(batch.bucketStart, batch.bucketStart + BucketCount + 1, bucketStart);
+}
+
+// Destructor
+PartitionedBatch::~PartitionedBatch()
+{
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the number of rows in the book
+size_t PartitionedBatch::Size() const
+{
+	return rows.Size();
+}
+
+// Returns the number of rows in bucket
+size_t PartitionedBatch::BucketSize(Bucket bucket) const
+{
+	return bucketStart[bucket + 1] - bucketStart[bucket];
+}
+
+// Returns a view of the rows of bucket, which can be passed to the batch functions of the matching OptionKernel
+OptionBatchView PartitionedBatch::BucketView(Bucket bucket) const
+{
+	return OptionBatch::Slice(rows.View(), bucketStart[bucket], bucketStart[bucket + 1]);
+}
+
+// Returns the permutation index; row j of the bucketed storage is row GetPermutation()[j] of the original book
+const vector<size_t>& PartitionedBatch::GetPermutation() const
+{
+	return permutation;
+}
+
+// Returns whether Euro buckets are evaluated with BsmKernel
+bool PartitionedBatch::IsVectorized() const
+{
+	return vectorized;
+}
+
+// Writes the price of every row into result
+void PartitionedBatch::Price(double* result) const
+{
+	Apply(result, 0, 0, [this](auto kernel, const OptionBatchView& view, double* out) { PriceBlock(kernel, view, out, vectorized); });
+}
+
+// Writes the delta of every row into result
+void PartitionedBatch::Delta(double* result) const
+{
+	Apply(result, 0, 0, [this](auto kernel, const OptionBatchView& view, double* out) { DeltaBlock(kernel, view, out, vectorized); });
+}
+
+// Writes the centered divided differences approximation of the delta of every row into result
+void PartitionedBatch::DivDiffDelta(double h, double* result) const
+{
+	Apply(result, 0, 0, [h](auto kernel, const OptionBatchView& view, double* out) { decltype(kernel)::DivDiffDeltaBatch(view, h, out); });
+}
+
+// Writes the gamma of every row into result
+void PartitionedBatch::Gamma(double* result) const
+{
+	Apply(result, 0, 0, [this](auto kernel, const OptionBatchView& view, double* out) { GammaBlock(kernel, view, out, vectorized); });
+}
+
+// Writes the centered divided differences approximation of the gamma of every row into result
+void PartitionedBatch::DivDiffGamma(double h, double* result) const
+{
+	Apply(result, 0, 0, [h](auto kernel, const OptionBatchView& view, double* out) { decltype(kernel)::DivDiffGammaBatch(view, h, out); });
+}
+
+// Writes the single-pass evaluation of the outputs selected by outputs for every row into result
+void PartitionedBatch::Evaluate(int outputs, OptionResults* result) const
+{
+	Apply(result, 0, 0, [outputs](auto kernel, const OptionBatchView& view, OptionResults* out) { decltype(kernel)::EvaluateBatch(view, outputs, out); });
+}
+
+// Parallel versions of the above
+void PartitionedBatch::Price(double* result, ThreadPool& pool, size_t grain) const
+{
+	Apply(result, &pool, grain, [this](auto kernel, const OptionBatchView& view, double* out) { PriceBlock(kernel, view, out, vectorized); });
+}
+
+void PartitionedBatch::Delta(double* result, ThreadPool& pool, size_t grain) const
+{
+	Apply(result, &pool, grain, [this](auto kernel, const OptionBatchView& view, double* out) { DeltaBlock(kernel, view, out, vectorized); });
+}
+
+void PartitionedBatch::DivDiffDelta(double h, double* result, ThreadPool& pool, size_t grain) const
+{
+	Apply(result, &pool, grain, [h](auto kernel, const OptionBatchView& view, double* out) { decltype(kernel)::DivDiffDeltaBatch(view, h, out); });
+}
+
+void PartitionedBatch::Gamma(double* result, ThreadPool& pool, size_t grain) const
+{
+	Apply(result, &pool, grain, [this](auto kernel, const OptionBatchView& view, double* out) { GammaBlock(kernel, view, out, vectorized); });
+}
+
+void PartitionedBatch::DivDiffGamma(double h, double* result, ThreadPool& pool, size_t grain) const
+{
+	Apply(result, &pool, grain, [h](auto kernel, const OptionBatchView& view, double* out) { decltype(kernel)::DivDiffGammaBatch(view, h, out); });
+}
+
+void PartitionedBatch::Evaluate(int outputs, OptionResults* result, ThreadPool& pool, size_t grain) const
+{
+	Apply(result, &pool, grain, [outputs](auto kernel, const OptionBatchView& view, OptionResults* out) { decltype(kernel)::EvaluateBatch(view, outputs, out); });
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Sorts the rows of view into buckets with a counting sort, which keeps the original order of the rows within each bucket
+void PartitionedBatch::Assign(const OptionBatchView& view)
+{
+	size_t counts[BucketCount] = { 0, 0, 0, 0 };
+	for (size_t i = 0; i < view.rows; i++)
+		counts[BucketOf(view, i)]++;
+
+	bucketStart[0] = 0;
+	for (int k = 0; k < BucketCount; k++)
+		bucketStart[k + 1] = bucketStart[k] + counts[k];
+
+	permutation.resize(view.rows);
+	size_t next[BucketCount] = { bucketStart[0], bucketStart[1], bucketStart[2], bucketStart[3] };
+	for (size_t i = 0; i < view.rows; i++)
+		permutation[next[BucketOf(view, i)]++] = i;
+
+	rows.Clear();
+	rows.Reserve(view.rows);
+	for (size_t j = 0; j < view.rows; j++)
+	{
+		size_t i = permutation[j];
+		char optionType = (view.type[i] == 1) ? 'C' : 'P';
+		if (view.kind[i] == 'E')
+			rows.PushEuropean(view.S[i], view.sig[i], view.r[i], view.b[i], optionType, view.K[i], view.T[i]);
+		else
+			rows.PushPerpetual(view.S[i], view.sig[i], view.r[i], view.b[i], optionType, view.K[i]);
+	}
+}
+
+// Selects BsmKernel (true) or the scalar kernels (false) for Price, Delta and Gamma of the Euro buckets
+void PartitionedBatch::SetVectorized(bool useSimd)
+{
+	vectorized = useSimd;
+}
+
+// Assignment operator
+PartitionedBatch& PartitionedBatch::operator = (const PartitionedBatch& batch)
+{
+	if (this != &batch)
+	{
+		rows = batch.rows;
+		permutation = batch.permutation;
+		copy(batch.bucketStart, batch.bucketStart + BucketCount + 1, bucketStart);
+		vectorized = batch.vectorized;
+	}
+
+	return *this;
+}
+
+
+// -------------------------------------------------------------------------- Private Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Evaluates rows [first, last) of the bucketed storage. The range is cut at bucket boundaries and into blocks of blockRows rows;
+// function(kernel, blockView, out) evaluates each block with the bucket's kernel into a local buffer, whose entries are then
+// scattered to their original positions.
+template <typename Result, typename Function>
+void PartitionedBatch::Apply(size_t first, size_t last, Result* result, Function function) const
+{
+	OptionBatchView all = rows.View();
+	Result block[blockRows];
+
+	for (int k = 0; k < BucketCount; k++)
+	{
+		size_t begin = max(first, bucketStart[k]);
+		size_t end = min(last, bucketStart[k + 1]);
+		for (size_t blockFirst = begin; blockFirst < end; blockFirst += blockRows)
+		{
+			size_t blockLast = min(blockFirst + blockRows, end);
+			OptionBatchView view = OptionBatch::Slice(all, blockFirst, blockLast);
+			switch (k)
+			{
+			case EuropeanCall:	function(EuropeanKernel<CallOption>(), view, block);			break;
+			case EuropeanPut:	function(EuropeanKernel<PutOption>(), view, block);				break;
+			case PerpetualCall:	function(PerpetualAmericanKernel<CallOption>(), view, block);	break;
+			default:			function(PerpetualAmericanKernel<PutOption>(), view, block);
+			}
+
+			for (size_t j = blockFirst; j < blockLast; j++)
+				result[permutation[j]] = block[j - blockFirst];
+		}
+	}
+}
+
+// Evaluates every row, splitting the bucketed storage into chunks on pool when pool is not null
+template <typename Result, typename Function>
+void PartitionedBatch::Apply(Result* result, ThreadPool* pool, size_t grain, Function function) const
+{
+	if (pool == 0)
+		Apply(0, Size(), result, function);
+	else
+		pool->ParallelFor(0, Size(), grain, [&](size_t first, size_t last) { Apply(first, last, result, function); });
+}
@@ -0,0 +1,84 @@
+// PartitionedBatch.hpp
+//
+// The purpose of the PartitionedBatch class is to evaluate mixed books -- Euro and PAMO rows, calls and puts, interleaved in any
+// order -- at the speed of homogeneous ones. On construction the rows are sorted (stably) into four buckets, Euro calls, Euro puts,
+// PAMO calls and PAMO puts, and stored contiguously in that order together with a permutation index recording each row's position
+// in the caller's book. Each evaluator then runs the OptionKernel matching each bucket over that bucket's rows, so the inner loops
+// contain no virtual calls and no per-row branches on kind or type, and scatters the results back through the permutation so that
+// result[i] always belongs to row i of the original book. Rows are processed in blocks of a few hundred, which keeps the unscattered
+// results in cache.
+//
+// By default every bucket is evaluated with the scalar kernels, so the results are exactly those of the equivalent ParamMatrix and
+// OptionBatch evaluators. With SetVectorized(true), Price, Delta and Gamma of the two Euro buckets are evaluated with BsmKernel
+// instead, with the accuracy documented in BsmKernel.hpp.
+
+#ifndef PartitionedBatch_H
+#define PartitionedBatch_H
+
+#include "OptionBatch.hpp"
+
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+class ThreadPool;
+
+class PartitionedBatch
+{
+public:
+	enum Bucket { EuropeanCall = 0, EuropeanPut = 1, PerpetualCall = 2, PerpetualPut = 3, BucketCount = 4 };
+
+private:
+	OptionBatch rows;									// Rows of the book grouped by bucket, in bucket order
+	vector<size_t> permutation;							// permutation[j] is the position in the original book of row j of rows
+	size_t bucketStart[BucketCount + 1];				// Rows of bucket k are rows[bucketStart[k], bucketStart[k + 1])
+	bool vectorized;									// Whether Euro buckets use BsmKernel for Price, Delta and Gamma
+
+	template <typename Result, typename Function>
+	void Apply(size_t first, size_t last, Result* result, Function function) const;	// Evaluates rows [first, last) of rows bucket by
+																					// bucket and scatters the results into result
+	template <typename Result, typename Function>
+	void Apply(Result* result, ThreadPool* pool, size_t grain, Function function) const;	// Evaluates every row, on pool if not null
+
+public:
+	// Constructors and Destructor
+	PartitionedBatch();												// Default constructor; an empty book
+	explicit PartitionedBatch(const OptionBatchView& view);			// Partitions the rows of view
+	explicit PartitionedBatch(const ParamMatrix& paramMat);			// Partitions the rows of an existing ParamMatrix
+	PartitionedBatch(const PartitionedBatch& batch);				// Copy constructor
+	virtual ~PartitionedBatch();									// Destructor
+
+
+	// Accessor Functions
+	size_t Size() const;											// Returns the number of rows in the book
+	size_t BucketSize(Bucket bucket) const;							// Returns the number of rows in bucket
+	OptionBatchView BucketView(Bucket bucket) const;				// Returns a view of the rows of bucket, which all share its kind and type
+	const vector<size_t>& GetPermutation() const;					// Returns the original positions of the rows in bucket order
+	bool IsVectorized() const;										// Returns whether Euro buckets are evaluated with BsmKernel
+
+	// Each evaluator writes Size() results into result in the caller's original row order; the overloads taking a ThreadPool split
+	// the rows into chunks of grain rows (0 for automatic) and evaluate them on pool.
+	void Price(double* result) const;
+	void Delta(double* result) const;
+	void DivDiffDelta(double h, double* result) const;
+	void Gamma(double* result) const;
+	void DivDiffGamma(double h, double* result) const;
+	void Evaluate(int outputs, OptionResults* result) const;
+
+	void Price(double* result, ThreadPool& pool, size_t grain = 0) const;
+	void Delta(double* result, ThreadPool& pool, size_t grain = 0) const;
+	void DivDiffDelta(double h, double* result, ThreadPool& pool, size_t grain = 0) const;
+	void Gamma(double* result, ThreadPool& pool, size_t grain = 0) const;
+	void DivDiffGamma(double h, double* result, ThreadPool& pool, size_t grain = 0) const;
+	void Evaluate(int outputs, OptionResults* result, ThreadPool& pool, size_t grain = 0) const;
+
+
+	// Modifier Functions
+	void Assign(const OptionBatchView& view);						// Replaces the book with the rows of view
+	void SetVectorized(bool useSimd);								// Selects BsmKernel (true) or the scalar kernels (false) for Euro buckets
+	PartitionedBatch& operator = (const PartitionedBatch& batch);	// Assignment operator
+
+};
+
+
+#endif
@@ -0,0 +1,228 @@
+// PerpetualAmericanModel.cpp
+
+#include "PerpetualAmericanModel.hpp"
+
+#include <cmath>
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor; a call with K = 100, sig = 0.2, r = 0.05 and b = 0.05
+PerpetualAmericanModel::PerpetualAmericanModel() : type('C'), K(100), sig(0.2), r(0.05), b(0.05)
+{
+	Precompute();
+}
+
+// Value constructor
+PerpetualAmericanModel::PerpetualAmericanModel(char optionType, double strike, double vol, double rate, double carry)
+	: type(optionType), K(strike), sig(vol), r(rate), b(carry)
+{
+	Precompute();
+}
+
+// Builds the model of an existing PAMO under the market parameters sig = vol, r = rate and b = carry
+PerpetualAmericanModel::PerpetualAmericanModel(const PerpetualAmericanOption& option, double vol, double rate, double carry)
+	: type(option.GetType()), K(option.GetStrike()), sig(vol), r(rate), b(carry)
+{
+	Precompute();
+}
+
+// Copy constructor
+PerpetualAmericanModel::PerpetualAmericanModel(const PerpetualAmericanModel& model) : type(model.type), K(model.K), sig(model.sig), r(model.r),
+	b(model.b), y(model.y), scale(model.scale), boundary(model.boundary)
+{
+}
+
+// Destructor
+PerpetualAmericanModel::~PerpetualAmericanModel()
+{
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Getter for the option type
+char PerpetualAmericanModel::GetType() const
+{
+	return type;
+}
+
+// Getter for the strike price
+double PerpetualAmericanModel::GetStrike() const
+{
+	return K;
+}
+
+// Returns the exponent y; y_1 for calls and y_2 for puts
+double PerpetualAmericanModel::GetExponent() const
+{
+	return y;
+}
+
+// Returns F = K / |y - 1|, the price of the PAMO at its exercise boundary
+double PerpetualAmericanModel::GetScale() const
+{
+	return scale;
+}
+
+// Returns the optimal exercise boundary S* = K * y / (y - 1)
+double PerpetualAmericanModel::GetBoundary() const
+{
+	return boundary;
+}
+
+// Returns the price of the PAMO at spot S as F * (S / S*)^y
+double PerpetualAmericanModel::Price(double S) const
+{
+	return (scale * exp(y * log(S / boundary)));
+}
+
+// Returns the delta of the PAMO at spot S; differentiating the price once with respect to S gives y * price / S
+double PerpetualAmericanModel::Delta(double S) const
+{
+	return ((y * Price(S)) / S);
+}
+
+// Returns the gamma of the PAMO at spot S; differentiating the price twice with respect to S gives y * (y - 1) * price / S^2
+double PerpetualAmericanModel::Gamma(double S) const
+{
+	return (((y * (y - 1)) * Price(S)) / (S * S));
+}
+
+// Returns the price, delta and gamma selected by outputs, all derived from a single exponential; PAMOs have no theta and their
+// vega is not implemented, so both are left at 0 as in Option::Evaluate
+OptionResults PerpetualAmericanModel::Evaluate(double S, int outputs) const
+{
+	OptionResults result = { 0, 0, 0, 0, 0 };
+	if ((outputs & (Option::PriceOutput | Option::DeltaOutput | Option::GammaOutput)) == 0)
+		return result;
+
+	double price = Price(S);
+	if (outputs & Option::PriceOutput)
+		result.price = price;
+	if (outputs & Option::DeltaOutput)
+		result.delta = (y * price) / S;
+	if (outputs & Option::GammaOutput)
+		result.gamma = ((y * (y - 1)) * price) / (S * S);
+
+	return result;
+}
+
+// Writes the prices of the count spots S[0], ..., S[count - 1] into result
+void PerpetualAmericanModel::Price(const double* S, size_t count, double* result) const
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = scale * exp(y * log(S[i] / boundary));
+}
+
+// Writes the deltas of the count spots S[0], ..., S[count - 1] into result
+void PerpetualAmericanModel::Delta(const double* S, size_t count, double* result) const
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = (y * (scale * exp(y * log(S[i] / boundary)))) / S[i];
+}
+
+// Writes the gammas of the count spots S[0], ..., S[count - 1] into result
+void PerpetualAmericanModel::Gamma(const double* S, size_t count, double* result) const
+{
+	double curvature = y * (y - 1);
+	for (size_t i = 0; i < count; i++)
+		result[i] = (curvature * (scale * exp(y * log(S[i] / boundary)))) / (S[i] * S[i]);
+}
+
+// Writes the outputs selected by outputs for the count spots S[0], ..., S[count - 1] into result
+void PerpetualAmericanModel::Evaluate(const double* S, size_t count, int outputs, OptionResults* result) const
+{
+	for (size_t i = 0; i < count; i++)
+		result[i] = Evaluate(S[i], outputs);
+}
+
+// Returns the prices of the spot ladder S
+vector<double> PerpetualAmericanModel::Price(const vector<double>& S) const
+{
+	vector<double> result(S.size());
+	if (!S.empty())
+		Price(&S[0], S.size(), &result[0]);
+
+	return result;
+}
+
+// Returns the deltas of the spot ladder S
+vector<double> PerpetualAmericanModel::Delta(const vector<double>& S) const
+{
+	vector<double> result(S.size());
+	if (!S.empty())
+		Delta(&S[0], S.size(), &result[0]);
+
+	return result;
+}
+
+// Returns the gammas of the spot ladder S
+vector<double> PerpetualAmericanModel::Gamma(const vector<double>& S) const
+{
+	vector<double> result(S.size());
+	if (!S.empty())
+		Gamma(&S[0], S.size(), &result[0]);
+
+	return result;
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Changes the market parameters sig, r and b and recomputes the invariants
+void PerpetualAmericanModel::SetParameters(double vol, double rate, double carry)
+{
+	sig = vol;
+	r = rate;
+	b = carry;
+	Precompute();
+}
+
+// Changes the strike price and recomputes the invariants
+void PerpetualAmericanModel::SetStrike(double strike)
+{
+	K = strike;
+	Precompute();
+}
+
+// Changes the option type and recomputes the invariants
+void PerpetualAmericanModel::SetType(char optionType)
+{
+	type = optionType;
+	Precompute();
+}
+
+// Assignment operator
+PerpetualAmericanModel& PerpetualAmericanModel::operator = (const PerpetualAmericanModel& model)
+{
+	if (this != &model)
+	{
+		type = model.type;
+		K = model.K;
+		sig = model.sig;
+		r = model.r;
+		b = model.b;
+		y = model.y;
+		scale = model.scale;
+		boundary = model.boundary;
+	}
+
+	return *this;
+}
+
+
+// -------------------------------------------------------------------------- Private Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Computes the exponent, the price at the boundary and the boundary itself; y - 1 is positive for calls and negative for puts, so
+// F = K / |y - 1| is K / (y - 1) for calls and K / (1 - y) for puts, matching the factors of the PAMO kernels
+void PerpetualAmericanModel::Precompute()
+{
+	y = (type == 'C') ? PerpetualAmericanOption::y_1(sig, r, b) : PerpetualAmericanOption::y_2(sig, r, b);
+	scale = (type == 'C') ? (K / (y - 1)) : (K / (1 - y));
+	boundary = (K * y) / (y - 1);
+}
@@ -0,0 +1,82 @@
+// PerpetualAmericanModel.hpp
+//
+// The purpose of the PerpetualAmericanModel class is to price a PAMO repeatedly for many spots while the remaining parameters
+// (type, K, sig, r, b) stay fixed, as when revaluing a spot ladder. Written in terms of the exponent y (y_1 for calls, y_2 for
+// puts) and the optimal exercise boundary S* = K * y / (y - 1), the PAMO price is a power of S,
+//		price(S) = F * (S / S*)^y,		F = K / |y - 1| = |S* - K|,
+// i.e. the exercise value at the boundary scaled by (S / S*)^y, so that delta = y * price / S and gamma = y * (y - 1) * price / S^2.
+// The model computes y, F and S* once, when its parameters are set, after which every spot costs a single
+// exp(y * log(S / S*)) plus a few multiplications, against several pow calls and repeated y_1/y_2 evaluations per function in
+// PerpetualAmericanOption. The results agree with the PerpetualAmericanOption member functions to within a few units in the last
+// place times |y * log(S / S*)|.
+//
+// As in PerpetualAmericanOption, the formulas describe the continuation region (S below S* for calls, S above S* for puts); the
+// boundary is exposed so that callers can check on which side of it a spot lies.
+
+#ifndef PerpetualAmericanModel_H
+#define PerpetualAmericanModel_H
+
+#include "Option.hpp"
+#include "PerpetualAmericanOption.hpp"
+
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+class PerpetualAmericanModel
+{
+private:
+	char type;											// 'C' for calls and 'P' for puts
+	double K;											// Strike price
+	double sig;											// Volatility
+	double r;											// Interest rate
+	double b;											// Cost-of-carry
+	double y;											// Exponent; y_1(sig, r, b) for calls and y_2(sig, r, b) for puts
+	double scale;										// F = K / |y - 1|, the price at the exercise boundary
+	double boundary;									// Optimal exercise boundary S*
+
+	void Precompute();									// Recomputes y, scale and boundary from the parameters
+
+public:
+	// Constructors and Destructor
+	PerpetualAmericanModel();																	// Default constructor
+	PerpetualAmericanModel(char optionType, double strike, double vol, double rate, double carry);	// Value constructor
+	PerpetualAmericanModel(const PerpetualAmericanOption& option, double vol, double rate, double carry);
+																								// Builds the model of an existing PAMO
+	PerpetualAmericanModel(const PerpetualAmericanModel& model);								// Copy constructor
+	virtual ~PerpetualAmericanModel();															// Destructor
+
+
+	// Accessor Functions
+	char GetType() const;																		// Getter for the option type
+	double GetStrike() const;																	// Getter for the strike price
+	double GetExponent() const;																	// Returns y
+	double GetScale() const;																	// Returns F
+	double GetBoundary() const;																	// Returns the optimal exercise boundary S*
+
+	double Price(double S) const;																// Returns the PAMO price at spot S
+	double Delta(double S) const;																// Returns the PAMO delta at spot S
+	double Gamma(double S) const;																// Returns the PAMO gamma at spot S
+	OptionResults Evaluate(double S, int outputs = Option::AllOutputs) const;					// Returns the price, delta and gamma selected by
+																								// outputs from one exponential; theta and vega are 0
+
+	void Price(const double* S, size_t count, double* result) const;							// Batch versions of the above; each writes count
+	void Delta(const double* S, size_t count, double* result) const;							// results, one per entry of S
+	void Gamma(const double* S, size_t count, double* result) const;
+	void Evaluate(const double* S, size_t count, int outputs, OptionResults* result) const;
+
+	vector<double> Price(const vector<double>& S) const;										// Returns the prices of a spot ladder
+	vector<double> Delta(const vector<double>& S) const;										// Returns the deltas of a spot ladder
+	vector<double> Gamma(const vector<double>& S) const;										// Returns the gammas of a spot ladder
+
+
+	// Modifier Functions
+	void SetParameters(double vol, double rate, double carry);									// Changes sig, r and b and recomputes the invariants
+	void SetStrike(double strike);																// Changes K and recomputes the invariants
+	void SetType(char optionType);																// Changes the option type and recomputes the invariants
+	PerpetualAmericanModel& operator = (const PerpetualAmericanModel& model);					// Assignment operator
+
+};
+
+
+#endif
@@ -0,0 +1,468 @@
+// Portfolio.cpp
+
+#include "Portfolio.hpp"
+#include "Instrumentation.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+
+namespace
+{
+	const size_t blockRows = 4096;						// Positions of a reduction block
+	const size_t evaluateRows = 256;					// Rows evaluated at a time within a block
+	const size_t outputCount = 5;						// Fields of OptionResults, summed in the order price, delta, gamma, theta, vega
+}
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor
+Portfolio::Portfolio()
+{
+}
+
+// Copy constructor
+Portfolio::Portfolio(const Portfolio& portfolio) : positions(portfolio.positions), quantities(portfolio.quantities),
+												   underlyingIds(portfolio.underlyingIds), bookIds(portfolio.bookIds),
+												   underlyingNames(portfolio.underlyingNames), bookNames(portfolio.bookNames),
+												   underlyingIndex(portfolio.underlyingIndex), bookIndex(portfolio.bookIndex),
+												   expiryEdges(portfolio.expiryEdges), strikeEdges(portfolio.strikeEdges)
+{
+}
+
+// Destructor
+Portfolio::~Portfolio()
+{
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the number of positions
+size_t Portfolio::Size() const
+{
+	return quantities.size();
+}
+
+// Returns a view of the option rows of the positions
+OptionBatchView Portfolio::View() const
+{
+	return positions.View();
+}
+
+// Returns the quantity of position i
+double Portfolio::GetQuantity(size_t i) const
+{
+	return quantities[i];
+}
+
+// Returns the quantities of every position, in row order
+const vector<double>& Portfolio::GetQuantities() const
+{
+	return quantities;
+}
+
+// Returns the underlying name of position i
+const string& Portfolio::GetUnderlying(size_t i) const
+{
+	return underlyingNames[underlyingIds[i]];
+}
+
+// Returns the trading book name of position i
+const string& Portfolio::GetBook(size_t i) const
+{
+	return bookNames[bookIds[i]];
+}
+
+// Returns the number of distinct underlying names
+size_t Portfolio::UnderlyingCount() const
+{
+	return underlyingNames.size();
+}
+
+// Returns the underlying name with the given index
+const string& Portfolio::UnderlyingName(size_t index) const
+{
+	return underlyingNames[index];
+}
+
+// Returns the number of distinct trading book names
+size_t Portfolio::BookCount() const
+{
+	return bookNames.size();
+}
+
+// Returns the trading book name with the given index
+const string& Portfolio::BookName(size_t index) const
+{
+	return bookNames[index];
+}
+
+// Returns the edges of the expiry bands
+const vector<double>& Portfolio::GetExpiryEdges() const
+{
+	return expiryEdges;
+}
+
+// Returns the edges of the moneyness bands
+const vector<double>& Portfolio::GetStrikeEdges() const
+{
+	return strikeEdges;
+}
+
+// Returns the totals of the selected outputs for every non-empty bucket formed by groupBy
+vector<PortfolioBucket> Portfolio::Aggregate(int groupBy, int outputs) const
+{
+	INSTRUMENT_SCOPE("Portfolio::Aggregate");
+	return Aggregate(groupBy, outputs, 0);
+}
+
+// Parallel version of Aggregate; the reduction blocks are evaluated on pool, and combined exactly as in the serial version
+vector<PortfolioBucket> Portfolio::Aggregate(int groupBy, int outputs, ThreadPool& pool) const
+{
+	INSTRUMENT_SCOPE("Portfolio::Aggregate(pool)");
+	return Aggregate(groupBy, outputs, &pool);
+}
+
+// Returns the totals of the whole portfolio; every key is allKeys, and the totals are 0 for an empty portfolio
+PortfolioBucket Portfolio::Total(int outputs) const
+{
+	vector<PortfolioBucket> buckets = Aggregate(0, outputs);
+	if (!buckets.empty())
+		return buckets[0];
+
+	PortfolioBucket empty = { allKeys, allKeys, allKeys, allKeys, 0, { 0, 0, 0, 0, 0 } };
+	return empty;
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Reserves room for at least rows many positions
+void Portfolio::Reserve(size_t rows)
+{
+	positions.Reserve(rows);
+	quantities.reserve(rows);
+	underlyingIds.reserve(rows);
+	bookIds.reserve(rows);
+}
+
+// Removes every position and name while keeping the memory for reuse; the bands are kept
+void Portfolio::Clear()
+{
+	positions.Clear();
+	quantities.clear();
+	underlyingIds.clear();
+	bookIds.clear();
+	underlyingNames.clear();
+	bookNames.clear();
+	underlyingIndex.clear();
+	bookIndex.clear();
+}
+
+// Adds a position of quantity Euro options on underlying in book
+void Portfolio::PushEuropean(const string& underlying, const string& book, double quantity, double spot, double vol, double rate,
+							 double carry, char optionType, double strike, double timeTillMat)
+{
+	positions.PushEuropean(spot, vol, rate, carry, optionType, strike, timeTillMat);
+	quantities.push_back(quantity);
+	underlyingIds.push_back(Intern(underlying, underlyingNames, underlyingIndex));
+	bookIds.push_back(Intern(book, bookNames, bookIndex));
+}
+
+// Adds a position of quantity PAMOs on underlying in book
+void Portfolio::PushPerpetual(const string& underlying, const string& book, double quantity, double spot, double vol, double rate,
+							  double carry, char optionType, double strike)
+{
+	positions.PushPerpetual(spot, vol, rate, carry, optionType, strike);
+	quantities.push_back(quantity);
+	underlyingIds.push_back(Intern(underlying, underlyingNames, underlyingIndex));
+	bookIds.push_back(Intern(book, bookNames, bookIndex));
+}
+
+// Adds every row of view as a position on underlying in book, with quantity[i] for row i
+void Portfolio::PushRows(const OptionBatchView& view, const double* quantity, const string& underlying, const string& book)
+{
+	for (size_t i = 0; i < view.rows; i++)
+	{
+		char optionType = (view.type[i] == 1) ? 'C' : 'P';
+		if (view.kind[i] == 'E')
+			PushEuropean(underlying, book, quantity[i], view.S[i], view.sig[i], view.r[i], view.b[i], optionType, view.K[i], view.T[i]);
+		else
+			PushPerpetual(underlying, book, quantity[i], view.S[i], view.sig[i], view.r[i], view.b[i], optionType, view.K[i]);
+	}
+}
+
+// Changes the quantity of position i
+void Portfolio::SetQuantity(size_t i, double quantity)
+{
+	quantities[i] = quantity;
+}
+
+// Sets the edges of the expiry bands
+void Portfolio::SetExpiryEdges(const vector<double>& edges)
+{
+	expiryEdges = edges;
+	sort(expiryEdges.begin(), expiryEdges.end());
+}
+
+// Sets the edges of the moneyness bands
+void Portfolio::SetStrikeEdges(const vector<double>& edges)
+{
+	strikeEdges = edges;
+	sort(strikeEdges.begin(), strikeEdges.end());
+}
+
+// Assignment operator
+Portfolio& Portfolio::operator = (const Portfolio& portfolio)
+{
+	if (this != &portfolio)
+	{
+		positions = portfolio.positions;
+		quantities = portfolio.quantities;
+		underlyingIds = portfolio.underlyingIds;
+		bookIds = portfolio.bookIds;
+		underlyingNames = portfolio.underlyingNames;
+		bookNames = portfolio.bookNames;
+		underlyingIndex = portfolio.underlyingIndex;
+		bookIndex = portfolio.bookIndex;
+		expiryEdges = portfolio.expiryEdges;
+		strikeEdges = portfolio.strikeEdges;
+	}
+
+	return *this;
+}
+
+
+// -------------------------------------------------------------------------- Private Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the layout of the buckets formed by groupBy
+Portfolio::BucketLayout Portfolio::Layout(int groupBy) const
+{
+	BucketLayout layout;
+	layout.groupBy = groupBy;
+	layout.counts[0] = (groupBy & ByUnderlying) ? max(underlyingNames.size(), size_t(1)) : 1;
+	layout.counts[1] = (groupBy & ByExpiry) ? expiryEdges.size() + 2 : 1;
+	layout.counts[2] = (groupBy & ByStrikeBand) ? strikeEdges.size() + 1 : 1;
+	layout.counts[3] = (groupBy & ByBook) ? max(bookNames.size(), size_t(1)) : 1;
+	layout.buckets = layout.counts[0] * layout.counts[1] * layout.counts[2] * layout.counts[3];
+	return layout;
+}
+
+// Returns the bucket of position row, view being the view of positions
+size_t Portfolio::BucketOf(const BucketLayout& layout, const OptionBatchView& view, size_t row) const
+{
+	size_t underlying = 0, expiry = 0, strikeBand = 0, book = 0;
+	if (layout.groupBy & ByUnderlying)
+		underlying = underlyingIds[row];
+	if (layout.groupBy & ByExpiry)
+	{
+		if (view.kind[row] == 'E')
+			expiry = upper_bound(expiryEdges.begin(), expiryEdges.end(), view.T[row]) - expiryEdges.begin();
+		else
+			expiry = expiryEdges.size() + 1;
+	}
+	if (layout.groupBy & ByStrikeBand)
+		strikeBand = upper_bound(strikeEdges.begin(), strikeEdges.end(), view.K[row] / view.S[row]) - strikeEdges.begin();
+	if (layout.groupBy & ByBook)
+		book = bookIds[row];
+
+	return ((underlying * layout.counts[1] + expiry) * layout.counts[2] + strikeBand) * layout.counts[3] + book;
+}
+
+// Evaluates the positions of blocks [firstBlock, lastBlock) evaluateRows at a time and adds quantity times each output to the partial
+// sums of their block; block k holds positions order[blockStart[k], blockStart[k + 1]), or positions blockStart[k] to blockStart[k + 1]
+// if order is null, and sums holds outputCount entries per block
+void Portfolio::ReduceBlocks(int outputs, const size_t* order, const size_t* blockStart, size_t firstBlock, size_t lastBlock,
+							 CompensatedSum* sums) const
+{
+	OptionBatchView view = positions.View();
+	double S[evaluateRows], sig[evaluateRows], r[evaluateRows], b[evaluateRows], type[evaluateRows], K[evaluateRows], T[evaluateRows];
+	char kind[evaluateRows];
+	OptionBatchView gathered = { S, sig, r, b, type, K, T, kind, 0 };
+	OptionResults results[evaluateRows];
+
+	size_t block = firstBlock;
+	for (size_t start = blockStart[firstBlock]; start < blockStart[lastBlock]; start += evaluateRows)
+	{
+		size_t rows = min(evaluateRows, blockStart[lastBlock] - start);
+		if (order != 0)
+		{
+			for (size_t i = 0; i < rows; i++)
+			{
+				size_t row = order[start + i];
+				S[i] = view.S[row];
+				sig[i] = view.sig[row];
+				r[i] = view.r[row];
+				b[i] = view.b[row];
+				type[i] = view.type[row];
+				K[i] = view.K[row];
+				T[i] = view.T[row];
+				kind[i] = view.kind[row];
+			}
+			gathered.rows = rows;
+			OptionBatch::Evaluate(gathered, outputs, results);
+		}
+		else
+			OptionBatch::Evaluate(OptionBatch::Slice(view, start, start + rows), outputs, results);
+
+		for (size_t i = 0; i < rows; i++)
+		{
+			while (start + i >= blockStart[block + 1])
+				block++;
+
+			double quantity = quantities[(order != 0) ? order[start + i] : start + i];
+			CompensatedSum* blockSums = sums + block * outputCount;
+			blockSums[0].Add(quantity * results[i].price);
+			blockSums[1].Add(quantity * results[i].delta);
+			blockSums[2].Add(quantity * results[i].gamma);
+			blockSums[3].Add(quantity * results[i].theta);
+			blockSums[4].Add(quantity * results[i].vega);
+		}
+	}
+}
+
+// Aggregates the positions, evaluating the reduction blocks on pool if it is not null. The buckets holding positions are numbered in
+// bucket order, and the positions are sorted stably into them by counting. Each bucket is cut into blocks of blockRows positions,
+// each block fills partial sums of its own, and within each bucket the partial sums of blocks b and b + w are added into those of
+// block b for w = 1, 2, 4, ..., so that its first block ends up with the totals; this order is the same whoever evaluated the blocks.
+vector<PortfolioBucket> Portfolio::Aggregate(int groupBy, int outputs, ThreadPool* pool) const
+{
+	BucketLayout layout = Layout(groupBy);
+	OptionBatchView view = positions.View();
+	size_t rows = Size();
+
+	vector<size_t> codes;								// Layout bucket of every non-empty bucket, increasing
+	vector<size_t> bucketStart;							// Positions of non-empty bucket c are order[bucketStart[c], bucketStart[c + 1])
+	vector<size_t> order;								// Positions sorted by bucket; empty if there is at most one bucket
+	if (layout.buckets == 1 || rows == 0)
+	{
+		if (rows > 0)
+			codes.push_back(0);
+		bucketStart.push_back(0);
+		bucketStart.push_back(rows);
+	}
+	else
+	{
+		vector<size_t> ids(rows);
+		auto findBuckets = [&](size_t first, size_t last)
+		{
+			for (size_t i = first; i < last; i++)
+				ids[i] = BucketOf(layout, view, i);
+		};
+		if (pool != 0)
+			pool->ParallelFor(0, rows, 0, findBuckets);
+		else
+			findBuckets(0, rows);
+
+		// Number the non-empty buckets: through a table of every bucket when there are no more buckets than positions, and by
+		// sorting the buckets of the positions otherwise
+		if (layout.buckets <= rows)
+		{
+			const size_t empty = size_t(-1);
+			vector<size_t> number(layout.buckets, empty);
+			for (size_t i = 0; i < rows; i++)
+				number[ids[i]] = 0;
+			for (size_t c = 0; c < layout.buckets; c++)
+			{
+				if (number[c] != empty)
+				{
+					number[c] = codes.size();
+					codes.push_back(c);
+				}
+			}
+			for (size_t i = 0; i < rows; i++)
+				ids[i] = number[ids[i]];
+		}
+		else
+		{
+			codes = ids;
+			sort(codes.begin(), codes.end());
+			codes.erase(unique(codes.begin(), codes.end()), codes.end());
+			for (size_t i = 0; i < rows; i++)
+				ids[i] = lower_bound(codes.begin(), codes.end(), ids[i]) - codes.begin();
+		}
+
+		bucketStart.assign(codes.size() + 1, 0);
+		for (size_t i = 0; i < rows; i++)
+			bucketStart[ids[i] + 1]++;
+		for (size_t c = 0; c < codes.size(); c++)
+			bucketStart[c + 1] += bucketStart[c];
+
+		vector<size_t> next(bucketStart.begin(), bucketStart.end() - 1);
+		order.resize(rows);
+		for (size_t i = 0; i < rows; i++)
+			order[next[ids[i]]++] = i;
+	}
+
+	// Cut every bucket into blocks; blocks of bucket c are [firstBlock[c], firstBlock[c + 1])
+	vector<size_t> blockStart;
+	vector<size_t> firstBlock(codes.size() + 1);
+	for (size_t c = 0; c < codes.size(); c++)
+	{
+		firstBlock[c] = blockStart.size();
+		for (size_t start = bucketStart[c]; start < bucketStart[c + 1]; start += blockRows)
+			blockStart.push_back(start);
+	}
+	firstBlock[codes.size()] = blockStart.size();
+	blockStart.push_back(rows);
+	size_t blocks = blockStart.size() - 1;
+
+	CompensatedSum zero = { 0, 0 };
+	vector<CompensatedSum> sums(blocks * outputCount, zero);
+	const size_t* permutation = order.empty() ? 0 : order.data();
+	auto reduceBlocks = [&](size_t first, size_t last) { ReduceBlocks(outputs, permutation, blockStart.data(), first, last, sums.data()); };
+	if (pool != 0)
+		pool->ParallelFor(0, blocks, 0, reduceBlocks);
+	else
+		reduceBlocks(0, blocks);
+
+	vector<PortfolioBucket> result;
+	const int dimensions[4] = { ByUnderlying, ByExpiry, ByStrikeBand, ByBook };
+	for (size_t c = 0; c < codes.size(); c++)
+	{
+		CompensatedSum* bucketSums = &sums[firstBlock[c] * outputCount];
+		size_t bucketBlocks = firstBlock[c + 1] - firstBlock[c];
+		for (size_t width = 1; width < bucketBlocks; width *= 2)
+		{
+			for (size_t block = 0; block + width < bucketBlocks; block += 2 * width)
+			{
+				for (size_t k = 0; k < outputCount; k++)
+					bucketSums[block * outputCount + k].Add(bucketSums[(block + width) * outputCount + k]);
+			}
+		}
+
+		size_t keys[4];
+		for (size_t d = 4, rest = codes[c]; d-- > 0; rest /= layout.counts[d])
+			keys[d] = rest % layout.counts[d];
+		for (size_t d = 0; d < 4; d++)
+		{
+			if ((groupBy & dimensions[d]) == 0)
+				keys[d] = allKeys;
+		}
+
+		PortfolioBucket bucket = { keys[0], keys[1], keys[2], keys[3], bucketStart[c + 1] - bucketStart[c], { bucketSums[0].Value(),
+								   bucketSums[1].Value(), bucketSums[2].Value(), bucketSums[3].Value(), bucketSums[4].Value() } };
+		result.push_back(bucket);
+	}
+
+	return result;
+}
+
+// Returns the index of name in names, adding it at the end if it is not there yet
+unsigned Portfolio::Intern(const string& name, vector<string>& names, map<string, unsigned>& index)
+{
+	map<string, unsigned>::const_iterator found = index.find(name);
+	if (found != index.end())
+		return found->second;
+
+	unsigned id = unsigned(names.size());
+	names.push_back(name);
+	index[name] = id;
+	return id;
+}
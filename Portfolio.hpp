@@ -0,0 +1,141 @@
+// Portfolio.hpp
+//
+// The purpose of the Portfolio class is to turn a book of option rows into positions and report its risk in total and by bucket. Each
+// position is an OptionBatch row together with a signed quantity (positive for long, negative for short) and two names, its underlying
+// and the trading book it belongs to. Aggregate values every position and returns, for every bucket holding at least one position,
+// the sums of quantity times price, delta, gamma, theta and vega, i.e. the PV and Greeks of the bucket. Buckets are formed by any
+// combination of four keys chosen with the GroupBy flags:
+//
+//		ByUnderlying	The underlying's name
+//		ByExpiry		The expiry band: band k holds the Euro positions with expiryEdges[k - 1] <= T < expiryEdges[k], and band
+//						expiryEdges.size() + 1 holds every PAMO position
+//		ByStrikeBand	The moneyness band: band k holds the positions with strikeEdges[k - 1] <= K / S < strikeEdges[k]
+//		ByBook			The trading book's name
+//
+// With no flags every position falls in the one bucket of the portfolio's totals.
+//
+// Each call to Aggregate first finds the bucket of every position and numbers only the buckets that actually hold positions, in
+// bucket order, so that grouping by keys with many values costs nothing for the combinations that never occur. The positions are then
+// sorted (stably) by bucket with a permutation index, as in PartitionedBatch, and the positions of each bucket are cut into reduction
+// blocks of a fixed number of rows. Every block is evaluated a few hundred rows at a time, so that the Greeks of the rows are still in
+// L1 cache when they are added to the compensated partial sums (see CompensatedSum.hpp) of the block, and the partial sums of the
+// blocks of each bucket are combined pairwise in a fixed order. The totals are therefore accurate to about one rounding even over
+// 10^8 positions, and are bitwise identical whether the blocks are evaluated serially or on a ThreadPool, with any number of threads.
+// Aggregate needs memory for two indices per position and a partial sum per block, i.e. proportional to the number of positions and
+// of non-empty buckets, but not to the number of possible buckets.
+
+#ifndef Portfolio_H
+#define Portfolio_H
+
+#include "CompensatedSum.hpp"
+#include "OptionBatch.hpp"
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+using namespace std;
+
+class ThreadPool;
+
+// The totals of one bucket of a Portfolio; see Portfolio::Aggregate. Keys that are not grouped by are Portfolio::allKeys.
+struct PortfolioBucket
+{
+	size_t underlying;									// Index of the underlying; see Portfolio::UnderlyingName
+	size_t expiry;										// Expiry band
+	size_t strikeBand;									// Moneyness band
+	size_t book;										// Index of the trading book; see Portfolio::BookName
+	size_t positions;									// Number of positions in the bucket
+	OptionResults totals;								// Sum over the positions of quantity times each output; totals.price is the PV
+};
+
+class Portfolio
+{
+public:
+	// Bit flags used to select the keys that buckets are formed by; combine them with |
+	enum GroupBy { ByUnderlying = 1, ByExpiry = 2, ByStrikeBand = 4, ByBook = 8 };
+
+	static const size_t allKeys = size_t(-1);			// Key of a dimension that is not grouped by
+
+private:
+	OptionBatch positions;								// Option rows of the positions
+	vector<double> quantities;							// Signed quantity of every position
+	vector<unsigned> underlyingIds;						// Index into underlyingNames of every position
+	vector<unsigned> bookIds;							// Index into bookNames of every position
+
+	vector<string> underlyingNames;						// Distinct underlying names, in order of first appearance
+	vector<string> bookNames;							// Distinct trading book names, in order of first appearance
+	map<string, unsigned> underlyingIndex;				// Index of each name in underlyingNames
+	map<string, unsigned> bookIndex;					// Index of each name in bookNames
+
+	vector<double> expiryEdges;							// Ascending edges of the expiry bands, in years
+	vector<double> strikeEdges;							// Ascending edges of the moneyness bands, as K / S
+
+	// Layout of the buckets for one call to Aggregate: bucket c has keys (u, e, s, k) with c = ((u * E + e) * M + s) * B + k, where
+	// U, E, M and B count the keys of each dimension grouped by and are 1 for the others
+	struct BucketLayout
+	{
+		int groupBy;
+		size_t counts[4];								// U, E, M and B
+		size_t buckets;									// U * E * M * B
+	};
+
+	BucketLayout Layout(int groupBy) const;												// Returns the layout of the buckets for groupBy
+	size_t BucketOf(const BucketLayout& layout, const OptionBatchView& view, size_t row) const;	// Returns the bucket of position row
+	void ReduceBlocks(int outputs, const size_t* order, const size_t* blockStart, size_t firstBlock, size_t lastBlock,
+					  CompensatedSum* sums) const;										// Adds the outputs of the positions of blocks
+																						// [firstBlock, lastBlock) to their partial sums
+	vector<PortfolioBucket> Aggregate(int groupBy, int outputs, ThreadPool* pool) const;// Aggregates, on pool if not null
+	unsigned Intern(const string& name, vector<string>& names, map<string, unsigned>& index);
+																						// Returns the index of name, adding it if new
+
+public:
+	// Constructors and Destructor
+	Portfolio();										// Default constructor; an empty portfolio with no bands
+	Portfolio(const Portfolio& portfolio);				// Copy constructor
+	virtual ~Portfolio();								// Destructor
+
+
+	// Accessor Functions
+	size_t Size() const;										// Returns the number of positions
+	OptionBatchView View() const;								// Returns a view of the option rows of the positions
+	double GetQuantity(size_t i) const;							// Returns the quantity of position i
+	const vector<double>& GetQuantities() const;				// Returns the quantities of every position, in row order
+	const string& GetUnderlying(size_t i) const;				// Returns the underlying name of position i
+	const string& GetBook(size_t i) const;						// Returns the trading book name of position i
+	size_t UnderlyingCount() const;								// Returns the number of distinct underlying names
+	const string& UnderlyingName(size_t index) const;			// Returns the underlying name with the given index
+	size_t BookCount() const;									// Returns the number of distinct trading book names
+	const string& BookName(size_t index) const;					// Returns the trading book name with the given index
+	const vector<double>& GetExpiryEdges() const;				// Returns the edges of the expiry bands
+	const vector<double>& GetStrikeEdges() const;				// Returns the edges of the moneyness bands
+
+	vector<PortfolioBucket> Aggregate(int groupBy, int outputs = Option::AllOutputs) const;
+																// Returns the totals of the outputs selected by the Option::Outputs flags for every
+																// non-empty bucket formed by the GroupBy flags, ordered by underlying, expiry band,
+																// moneyness band and trading book
+	vector<PortfolioBucket> Aggregate(int groupBy, int outputs, ThreadPool& pool) const;
+																// Parallel version of the above, with bitwise identical results
+	PortfolioBucket Total(int outputs = Option::AllOutputs) const;
+																// Returns the totals of the whole portfolio
+
+
+	// Modifier Functions
+	void Reserve(size_t rows);									// Reserves room for at least rows many positions
+	void Clear();												// Removes every position and name while keeping the memory for reuse; the
+																// bands are kept
+	void PushEuropean(const string& underlying, const string& book, double quantity, double spot, double vol, double rate, double carry,
+					  char optionType, double strike, double timeTillMat);
+	void PushPerpetual(const string& underlying, const string& book, double quantity, double spot, double vol, double rate, double carry,
+					   char optionType, double strike);
+	void PushRows(const OptionBatchView& view, const double* quantity, const string& underlying, const string& book);
+																// Adds every row of view as a position, with quantity[i] for row i
+	void SetQuantity(size_t i, double quantity);				// Changes the quantity of position i
+	void SetExpiryEdges(const vector<double>& edges);			// Sets the edges of the expiry bands; they are sorted
+	void SetStrikeEdges(const vector<double>& edges);			// Sets the edges of the moneyness bands; they are sorted
+	Portfolio& operator = (const Portfolio& portfolio);			// Assignment operator
+
+};
+
+
+#endif
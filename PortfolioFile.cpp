@@ -0,0 +1,391 @@
+// PortfolioFile.cpp
+
+#include "PortfolioFile.hpp"
+#include "Instrumentation.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PORTFOLIO_FILE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(PortfolioFileHeader) == 128, "PortfolioFileHeader must occupy exactly 128 bytes");
+
+namespace
+{
+	const char portfolioMagic[8] = { 'B', 'S', 'M', 'P', 'O', 'R', 'T', 0 };
+	const char resultsMagic[8] = { 'B', 'S', 'M', 'R', 'S', 'L', 'T', 0 };
+	const unsigned int formatVersion = 1;
+	const unsigned int byteOrderMark = 0x01020304;
+	const size_t columnAlignment = 64;
+
+	// Rounds offset up to the next multiple of columnAlignment
+	unsigned long long AlignUp(unsigned long long offset)
+	{
+		return (offset + columnAlignment - 1) / columnAlignment * columnAlignment;
+	}
+
+	// Fills in a header for rows rows and columnCount columns of the given widths, laid out back to back after the header
+	PortfolioFileHeader MakeHeader(const char* magic, size_t rows, const size_t* widths, int columnCount, unsigned long long& fileSize)
+	{
+		PortfolioFileHeader header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, magic, sizeof(header.magic));
+		header.version = formatVersion;
+		header.byteOrder = byteOrderMark;
+		header.rows = rows;
+
+		unsigned long long offset = AlignUp(sizeof(header));
+		for (int c = 0; c < columnCount; c++)
+		{
+			header.offsets[c] = offset;
+			offset = AlignUp(offset + rows * widths[c]);
+		}
+		fileSize = offset;
+
+		return header;
+	}
+
+	// Checks that header, read from a file of size bytes, carries magic and the current version and byte order, and that its
+	// columnCount columns of the given widths lie inside the file
+	bool CheckHeader(const PortfolioFileHeader& header, unsigned long long size, const char* magic, const size_t* widths, int columnCount)
+	{
+		if (size < sizeof(header) || memcmp(header.magic, magic, sizeof(header.magic)) != 0)
+			return false;
+		if (header.version != formatVersion || header.byteOrder != byteOrderMark)
+			return false;
+
+		for (int c = 0; c < columnCount; c++)
+		{
+			unsigned long long offset = header.offsets[c];
+			if (offset % columnAlignment != 0 || offset < sizeof(header) || offset > size || header.rows > (size - offset) / widths[c])
+				return false;
+		}
+
+		return true;
+	}
+
+	const size_t portfolioWidths[8] = { sizeof(double), sizeof(double), sizeof(double), sizeof(double),
+										sizeof(double), sizeof(double), sizeof(double), sizeof(char) };
+	const size_t resultsWidths[5] = { sizeof(double), sizeof(double), sizeof(double), sizeof(double), sizeof(double) };
+}
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor
+PortfolioFile::PortfolioFile() : mapping(0), mappingSize(0), fallback()
+{
+	memset(&view, 0, sizeof(view));
+}
+
+// Opens the portfolio file at path
+PortfolioFile::PortfolioFile(const string& path) : mapping(0), mappingSize(0), fallback()
+{
+	memset(&view, 0, sizeof(view));
+	Open(path);
+}
+
+// Destructor
+PortfolioFile::~PortfolioFile()
+{
+	Close();
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns true when a portfolio file is open
+bool PortfolioFile::IsOpen() const
+{
+	return (mapping != 0) || !fallback.empty();
+}
+
+// Returns the number of rows in the open file
+size_t PortfolioFile::Size() const
+{
+	return view.rows;
+}
+
+// Returns a view whose columns point into the mapped file
+OptionBatchView PortfolioFile::View() const
+{
+	return view;
+}
+
+// Prices the open file chunkRows rows at a time (all rows at once if chunkRows is 0). After each chunk its results are written to
+// their place in the five result columns and the chunk's pages are released, so neither the book nor the results need to fit in
+// memory at once.
+bool PortfolioFile::Evaluate(int outputs, size_t chunkRows, const string& resultsPath) const
+{
+	return EvaluateChunks(outputs, chunkRows, resultsPath, 0);
+}
+
+// Parallel version of the above
+bool PortfolioFile::Evaluate(int outputs, size_t chunkRows, const string& resultsPath, ThreadPool& pool) const
+{
+	return EvaluateChunks(outputs, chunkRows, resultsPath, &pool);
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Maps the file at path and points the view at its columns. If the file cannot be mapped it is read into memory instead.
+bool PortfolioFile::Open(const string& path)
+{
+	INSTRUMENT_SCOPE("PortfolioFile::load");
+	Close();
+
+	const char* base = 0;
+	unsigned long long size = 0;
+
+#if defined(PORTFOLIO_FILE_MMAP)
+	int descriptor = open(path.c_str(), O_RDONLY);
+	if (descriptor >= 0)
+	{
+		struct stat status;
+		if (fstat(descriptor, &status) == 0 && status.st_size >= static_cast<off_t>(sizeof(PortfolioFileHeader)))
+		{
+			void* address = mmap(0, status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+			if (address != MAP_FAILED)
+			{
+				mapping = address;
+				mappingSize = status.st_size;
+				base = static_cast<const char*>(address);
+				size = status.st_size;
+				madvise(address, mappingSize, MADV_SEQUENTIAL);
+			}
+		}
+		close(descriptor);
+	}
+#endif
+
+	if (base == 0)
+	{
+		ifstream file(path.c_str(), ios::binary | ios::ate);
+		if (!file)
+			return false;
+
+		size = file.tellg();
+		if (size < sizeof(PortfolioFileHeader))
+			return false;
+		fallback.resize((size + sizeof(double) - 1) / sizeof(double));
+		file.seekg(0);
+		if (!file.read(reinterpret_cast<char*>(fallback.data()), size))
+		{
+			Close();
+			return false;
+		}
+		base = reinterpret_cast<const char*>(fallback.data());
+	}
+
+	PortfolioFileHeader header;
+	memcpy(&header, base, sizeof(header));
+	if (!CheckHeader(header, size, portfolioMagic, portfolioWidths, 8))
+	{
+		Close();
+		return false;
+	}
+
+	view.S = reinterpret_cast<const double*>(base + header.offsets[0]);
+	view.sig = reinterpret_cast<const double*>(base + header.offsets[1]);
+	view.r = reinterpret_cast<const double*>(base + header.offsets[2]);
+	view.b = reinterpret_cast<const double*>(base + header.offsets[3]);
+	view.type = reinterpret_cast<const double*>(base + header.offsets[4]);
+	view.K = reinterpret_cast<const double*>(base + header.offsets[5]);
+	view.T = reinterpret_cast<const double*>(base + header.offsets[6]);
+	view.kind = base + header.offsets[7];
+	view.rows = header.rows;
+
+	return true;
+}
+
+// Unmaps the open file, or frees its in-memory copy
+void PortfolioFile::Close()
+{
+#if defined(PORTFOLIO_FILE_MMAP)
+	if (mapping != 0)
+		munmap(mapping, mappingSize);
+#endif
+	mapping = 0;
+	mappingSize = 0;
+	AlignedColumn().swap(fallback);
+	memset(&view, 0, sizeof(view));
+}
+
+
+// -------------------------------------------------------------------------- Static Functions ------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Writes the rows of view to path in the layout described in PortfolioFile.hpp
+bool PortfolioFile::Write(const string& path, const OptionBatchView& view)
+{
+	unsigned long long fileSize = 0;
+	PortfolioFileHeader header = MakeHeader(portfolioMagic, view.rows, portfolioWidths, 8, fileSize);
+
+	ofstream file(path.c_str(), ios::binary | ios::trunc);
+	if (!file)
+		return false;
+
+	const char* columns[8] = { reinterpret_cast<const char*>(view.S), reinterpret_cast<const char*>(view.sig),
+							   reinterpret_cast<const char*>(view.r), reinterpret_cast<const char*>(view.b),
+							   reinterpret_cast<const char*>(view.type), reinterpret_cast<const char*>(view.K),
+							   reinterpret_cast<const char*>(view.T), view.kind };
+	const char padding[columnAlignment] = { 0 };
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	unsigned long long position = sizeof(header);
+	for (int c = 0; c < 8; c++)
+	{
+		file.write(padding, header.offsets[c] - position);
+		file.write(columns[c], view.rows * portfolioWidths[c]);
+		position = header.offsets[c] + view.rows * portfolioWidths[c];
+	}
+	file.write(padding, fileSize - position);
+
+	file.close();
+	return !file.fail();
+}
+
+// Reads every row of a results file written by Evaluate; outputs receives the Option::Outputs flags the file was written with
+bool PortfolioFile::ReadResults(const string& path, int& outputs, vector<OptionResults>& results)
+{
+	ifstream file(path.c_str(), ios::binary | ios::ate);
+	if (!file)
+		return false;
+
+	unsigned long long size = file.tellg();
+	PortfolioFileHeader header;
+	file.seekg(0);
+	if (size < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		return false;
+	if (!CheckHeader(header, size, resultsMagic, resultsWidths, 5))
+		return false;
+
+	outputs = static_cast<int>(header.outputs);
+	results.resize(header.rows);
+
+	vector<double> column(header.rows);
+	for (int c = 0; c < 5; c++)
+	{
+		file.seekg(header.offsets[c]);
+		if (!file.read(reinterpret_cast<char*>(column.data()), header.rows * sizeof(double)))
+			return false;
+		for (size_t i = 0; i < header.rows; i++)
+		{
+			OptionResults& result = results[i];
+			double& target = (c == 0) ? result.price : (c == 1) ? result.delta : (c == 2) ? result.gamma : (c == 3) ? result.theta : result.vega;
+			target = column[i];
+		}
+	}
+
+	return true;
+}
+
+
+// -------------------------------------------------------------------------- Private Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Evaluates the open file chunk by chunk into a results file; each chunk is split across pool when pool is not null
+bool PortfolioFile::EvaluateChunks(int outputs, size_t chunkRows, const string& resultsPath, ThreadPool* pool) const
+{
+	if (!IsOpen())
+		return false;
+
+	size_t rows = view.rows;
+	if (chunkRows == 0 || chunkRows > rows)
+		chunkRows = (rows > 0) ? rows : 1;
+
+	unsigned long long fileSize = 0;
+	PortfolioFileHeader header = MakeHeader(resultsMagic, rows, resultsWidths, 5, fileSize);
+	header.outputs = outputs;
+
+	ofstream file(resultsPath.c_str(), ios::binary | ios::trunc);
+	if (!file)
+		return false;
+
+	// Write the header and extend the file to its final size so that every column can be written in place
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	if (fileSize > sizeof(header))
+	{
+		file.seekp(fileSize - 1);
+		file.put(0);
+	}
+
+	vector<OptionResults> results(chunkRows);
+	vector<double> column(chunkRows);
+	for (size_t first = 0; first < rows && file; first += chunkRows)
+	{
+		size_t last = (rows - first < chunkRows) ? rows : first + chunkRows;
+		OptionBatchView chunk = OptionBatch::Slice(view, first, last);
+
+		{
+			INSTRUMENT_SCOPE("PortfolioFile::evaluate");
+			if (pool == 0)
+				OptionBatch::Evaluate(chunk, outputs, results.data());
+			else
+			{
+				OptionResults* out = results.data();
+				pool->ParallelFor(0, chunk.rows, 0, [&](size_t begin, size_t end)
+				{
+					OptionBatch::Evaluate(OptionBatch::Slice(chunk, begin, end), outputs, out + begin);
+				});
+			}
+		}
+
+		// Transpose into the five result columns
+		INSTRUMENT_SCOPE("PortfolioFile::write");
+		for (int c = 0; c < 5; c++)
+		{
+			for (size_t i = 0; i < chunk.rows; i++)
+			{
+				const OptionResults& result = results[i];
+				column[i] = (c == 0) ? result.price : (c == 1) ? result.delta : (c == 2) ? result.gamma : (c == 3) ? result.theta : result.vega;
+			}
+			file.seekp(header.offsets[c] + first * sizeof(double));
+			file.write(reinterpret_cast<const char*>(column.data()), chunk.rows * sizeof(double));
+		}
+
+		ReleaseRows(first, last);
+	}
+
+	file.close();
+	return !file.fail();
+}
+
+// Tells the operating system that the mapped pages lying entirely inside rows [first, last) of every column will not be needed
+// again; they are dropped from the page cache's view of this process and re-read from disk if touched later. Does nothing when the
+// file was read into memory.
+void PortfolioFile::ReleaseRows(size_t first, size_t last) const
+{
+#if defined(PORTFOLIO_FILE_MMAP)
+	if (mapping == 0 || last <= first)
+		return;
+
+	const char* base = static_cast<const char*>(mapping);
+	const char* columns[8] = { reinterpret_cast<const char*>(view.S), reinterpret_cast<const char*>(view.sig),
+							   reinterpret_cast<const char*>(view.r), reinterpret_cast<const char*>(view.b),
+							   reinterpret_cast<const char*>(view.type), reinterpret_cast<const char*>(view.K),
+							   reinterpret_cast<const char*>(view.T), view.kind };
+	size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+	for (int c = 0; c < 8; c++)
+	{
+		size_t begin = (columns[c] - base) + first * portfolioWidths[c];
+		size_t end = (columns[c] - base) + last * portfolioWidths[c];
+		begin = (begin + page - 1) / page * page;
+		end = end / page * page;
+		if (end > begin)
+			madvise(const_cast<char*>(base) + begin, end - begin, MADV_DONTNEED);
+	}
+#endif
+}
@@ -0,0 +1,100 @@
+// PortfolioFile.hpp
+//
+// The purpose of the PortfolioFile class is to store a book of options on disk in a form that can be priced directly, without
+// parsing or copying, and to write the matching results. A portfolio file is laid out exactly like the columns of an OptionBatch:
+//
+//		offset 0	PortfolioFileHeader (128 bytes)
+//					magic		8 bytes, "BSMPORT" followed by a 0 byte
+//					version		uint32, currently 1
+//					byteOrder	uint32, 0x01020304 written in the byte order of the machine that wrote the file
+//					rows		uint64, number of options n
+//					offsets		8 x uint64, byte offset of the S, sig, r, b, type, K, T and kind columns
+//					outputs		uint64, the Option::Outputs flags held by a results file; 0 for portfolio files
+//					reserved	32 bytes of zeros
+//		offsets[0..6]	n doubles each; type is +1 for calls and -1 for puts, T is 0 for PAMO rows
+//		offsets[7]		n chars; 'E' for Euro option rows and 'A' for PAMO rows
+//
+// Every column begins on a 64-byte boundary so that, once the file is memory-mapped (the mapping itself is page aligned), the
+// columns satisfy the same alignment as an OptionBatch and an OptionBatchView can point straight into the mapping. Opening a file
+// therefore costs one mmap call and a header check, independent of the number of rows; pages are only read from disk when the
+// evaluators touch them. Files are written and read in host byte order, and a file written on a machine of the other byte order is
+// rejected through the byteOrder field. On platforms without mmap the file is read into aligned memory with the same layout.
+//
+// Evaluate prices the book in chunks of rows and streams each chunk of results to a results file, releasing the mapped pages of
+// the chunk once it is done, so a book larger than the available memory is priced with a resident set of about one chunk. A
+// results file has the same structure: a 128-byte header with the magic "BSMRSLT", the version, the byte order mark, the row
+// count, the Option::Outputs flags it holds and the offsets of five double columns (price, delta, gamma, theta, vega). Columns
+// for outputs that were not requested are filled with zeros.
+
+#ifndef PortfolioFile_H
+#define PortfolioFile_H
+
+#include "OptionBatch.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+using namespace std;
+
+class ThreadPool;
+
+struct PortfolioFileHeader
+{
+	char magic[8];										// "BSMPORT" for portfolio files, "BSMRSLT" for results files
+	unsigned int version;								// Format version
+	unsigned int byteOrder;								// 0x01020304 in the writer's byte order
+	unsigned long long rows;							// Number of rows
+	unsigned long long offsets[8];						// Byte offsets of the columns, each a multiple of 64
+	unsigned long long outputs;							// Option::Outputs flags held by a results file; 0 for portfolio files
+	unsigned long long reserved[4];						// Zero; pads the header to 128 bytes
+};
+
+class PortfolioFile
+{
+private:
+	void* mapping;										// Start of the mapped file, or 0 when nothing is mapped
+	size_t mappingSize;									// Length of the mapping in bytes
+	AlignedColumn fallback;								// Copy of the file used when it could not be mapped
+	OptionBatchView view;								// Columns of the open file
+
+	void ReleaseRows(size_t first, size_t last) const;	// Lets the operating system drop the mapped pages of rows [first, last)
+	bool EvaluateChunks(int outputs, size_t chunkRows, const string& resultsPath, ThreadPool* pool) const;
+														// Implements both Evaluate overloads; pool may be null
+
+	PortfolioFile(const PortfolioFile&);				// Not copyable
+	PortfolioFile& operator = (const PortfolioFile&);	// Not assignable
+
+public:
+	// Constructors and Destructor
+	PortfolioFile();																// Default constructor; no file is open
+	explicit PortfolioFile(const string& path);										// Opens path; check IsOpen() for success
+	~PortfolioFile();																// Unmaps the open file, if any
+
+
+	// Accessor Functions
+	bool IsOpen() const;															// Returns true when a file is open
+	size_t Size() const;															// Returns the number of rows of the open file
+	OptionBatchView View() const;													// Returns a view of the open file's columns; valid until Close()
+
+	bool Evaluate(int outputs, size_t chunkRows, const string& resultsPath) const;	// Evaluates the outputs selected by the Option::Outputs flags
+																					// for every row, chunkRows rows at a time, and writes them to
+																					// a results file at resultsPath; returns false on an I/O error
+	bool Evaluate(int outputs, size_t chunkRows, const string& resultsPath, ThreadPool& pool) const;
+																					// Parallel version of the above; each chunk is split across pool
+
+
+	// Modifier Functions
+	bool Open(const string& path);													// Closes any open file and opens path; returns false if path is
+																					// missing, truncated or not a version 1 portfolio file
+	void Close();																	// Closes the open file
+
+
+	// Static Functions
+	static bool Write(const string& path, const OptionBatchView& view);				// Writes the rows of view to a portfolio file at path
+	static bool ReadResults(const string& path, int& outputs, vector<OptionResults>& results);
+																					// Reads a results file written by Evaluate
+
+};
+
+
+#endif
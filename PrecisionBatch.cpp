@@ -0,0 +1,389 @@
+// PrecisionBatch.cpp
+
+#include "PrecisionBatch.hpp"
+#include "BsmKernel.hpp"
+#include "Instrumentation.hpp"
+#include "OptionKernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace
+{
+	const size_t blockRows = 256;						// Rows gathered at a time for the vectorized kernels
+
+	// The view type over columns of scalar type Real
+	template <typename Real>
+	struct ViewOf;
+
+	template <>
+	struct ViewOf<float>
+	{
+		typedef FloatBatchView Type;
+	};
+
+	template <>
+	struct ViewOf<double>
+	{
+		typedef OptionBatchView Type;
+	};
+
+	// Passes rows [first, last) of a single precision view to vectorized as they are, without gathering; the overload for double,
+	// where the rows must first be widened, does nothing and returns false
+	template <typename Vectorized, typename Result>
+	bool EvaluateSlice(Vectorized& vectorized, const FloatBatchView& view, size_t first, size_t last, Result* result, float)
+	{
+		FloatBatchView slice = { view.S + first, view.sig + first, view.r + first, view.b + first, view.type + first, view.K + first,
+								 view.T + first, view.kind + first, last - first };
+		vectorized(slice, result + first);
+		return true;
+	}
+
+	template <typename Vectorized, typename Result>
+	bool EvaluateSlice(Vectorized&, const FloatBatchView&, size_t, size_t, Result*, double)
+	{
+		return false;
+	}
+
+	// Evaluates view in mode into result; the double reference of Compare comes from OptionBatch directly
+	void EvaluateIn(const OptionBatchView& view, PrecisionBatch::Precision mode, int outputs, OptionResults* result)
+	{
+		PrecisionBatch batch(view, mode);
+		batch.Evaluate(outputs, result);
+	}
+
+	// Folds the difference between value and reference at row into maxAbs/maxRel of output
+	void Accumulate(PrecisionErrors& errors, int output, double value, double reference, size_t row, double relativeFloor)
+	{
+		double absolute = fabs(value - reference);
+		if (!(absolute <= errors.maxAbs[output]))					// Also records NaNs
+		{
+			errors.maxAbs[output] = absolute;
+			errors.worstAbsRow[output] = row;
+		}
+
+		if (fabs(reference) >= relativeFloor)
+		{
+			double relative = absolute / fabs(reference);
+			if (!(relative <= errors.maxRel[output]))
+			{
+				errors.maxRel[output] = relative;
+				errors.worstRelRow[output] = row;
+			}
+		}
+	}
+}
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor
+PrecisionBatch::PrecisionBatch() : precision(DoublePrecision)
+{
+}
+
+// Copies the rows of view, rounded to float unless mode is DoublePrecision
+PrecisionBatch::PrecisionBatch(const OptionBatchView& view, Precision mode) : precision(mode)
+{
+	Assign(view);
+}
+
+// Copy constructor
+PrecisionBatch::PrecisionBatch(const PrecisionBatch& batch) : precision(batch.precision), doubleRows(batch.doubleRows), S(batch.S),
+															  sig(batch.sig), r(batch.r), b(batch.b), type(batch.type), K(batch.K),
+															  T(batch.T), kind(batch.kind)
+{
+}
+
+// Destructor
+PrecisionBatch::~PrecisionBatch()
+{
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the number of rows in the book
+size_t PrecisionBatch::Size() const
+{
+	return (precision == DoublePrecision) ? doubleRows.Size() : kind.size();
+}
+
+// Returns the precision mode of the book
+PrecisionBatch::Precision PrecisionBatch::GetPrecision() const
+{
+	return precision;
+}
+
+// Returns a view of the float columns; the view has no rows when the book is held in double precision
+FloatBatchView PrecisionBatch::FloatView() const
+{
+	FloatBatchView view = { S.data(), sig.data(), r.data(), b.data(), type.data(), K.data(), T.data(), kind.data(), kind.size() };
+	return view;
+}
+
+// Writes the price of every row into result
+void PrecisionBatch::Price(double* result) const
+{
+	INSTRUMENT_SCOPE("PrecisionBatch::Price");
+	Apply(result, [](const auto& view, double* out) { BsmKernel::Price(view, out); }, [](auto kernel, const auto& view, size_t i)
+	{
+		return decltype(kernel)::Price(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i]);
+	});
+}
+
+// Writes the delta of every row into result
+void PrecisionBatch::Delta(double* result) const
+{
+	INSTRUMENT_SCOPE("PrecisionBatch::Delta");
+	Apply(result, [](const auto& view, double* out) { BsmKernel::Delta(view, out); }, [](auto kernel, const auto& view, size_t i)
+	{
+		return decltype(kernel)::Delta(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i]);
+	});
+}
+
+// Writes the gamma of every row into result
+void PrecisionBatch::Gamma(double* result) const
+{
+	INSTRUMENT_SCOPE("PrecisionBatch::Gamma");
+	Apply(result, [](const auto& view, double* out) { BsmKernel::Gamma(view, out); }, [](auto kernel, const auto& view, size_t i)
+	{
+		return decltype(kernel)::Gamma(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i]);
+	});
+}
+
+// Writes the single-pass evaluation of the outputs selected by outputs for every row into result
+void PrecisionBatch::Evaluate(int outputs, OptionResults* result) const
+{
+	INSTRUMENT_SCOPE("PrecisionBatch::Evaluate");
+	Apply(result, [outputs](const auto& view, OptionResults* out) { BsmKernel::Evaluate(view, outputs, out); },
+		  [outputs](auto kernel, const auto& view, size_t i)
+	{
+		return decltype(kernel)::Evaluate(view.S[i], view.sig[i], view.r[i], view.b[i], view.K[i], view.T[i], outputs);
+	});
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Replaces the book with the rows of view, stored in the current precision mode
+void PrecisionBatch::Assign(const OptionBatchView& view)
+{
+	doubleRows.Clear();
+	Narrow(OptionBatch().View());								// Empties the float columns
+	if (precision == DoublePrecision)
+	{
+		doubleRows.Reserve(view.rows);
+		for (size_t i = 0; i < view.rows; i++)
+		{
+			if (view.kind[i] == 'E')
+				doubleRows.PushEuropean(view.S[i], view.sig[i], view.r[i], view.b[i], (view.type[i] == 1) ? 'C' : 'P', view.K[i], view.T[i]);
+			else
+				doubleRows.PushPerpetual(view.S[i], view.sig[i], view.r[i], view.b[i], (view.type[i] == 1) ? 'C' : 'P', view.K[i]);
+		}
+	}
+	else
+		Narrow(view);
+}
+
+// Converts the book to mode. Single and mixed precision share the float columns, so switching between them converts nothing.
+void PrecisionBatch::SetPrecision(Precision mode)
+{
+	if (mode == precision)
+		return;
+
+	if (precision == DoublePrecision)
+	{
+		OptionBatch rows(doubleRows);
+		doubleRows.Clear();
+		precision = mode;
+		Narrow(rows.View());
+	}
+	else if (mode == DoublePrecision)
+	{
+		FloatBatchView view = FloatView();
+		OptionBatch rows;
+		rows.Reserve(view.rows);
+		for (size_t i = 0; i < view.rows; i++)
+		{
+			if (view.kind[i] == 'E')
+				rows.PushEuropean(view.S[i], view.sig[i], view.r[i], view.b[i], (view.type[i] == 1) ? 'C' : 'P', view.K[i], view.T[i]);
+			else
+				rows.PushPerpetual(view.S[i], view.sig[i], view.r[i], view.b[i], (view.type[i] == 1) ? 'C' : 'P', view.K[i]);
+		}
+		precision = mode;
+		Narrow(OptionBatch().View());							// Empties the float columns
+		doubleRows = rows;
+	}
+	else
+		precision = mode;
+}
+
+// Assignment operator
+PrecisionBatch& PrecisionBatch::operator = (const PrecisionBatch& batch)
+{
+	if (this == &batch)
+		return *this;
+
+	precision = batch.precision;
+	doubleRows = batch.doubleRows;
+	S = batch.S;
+	sig = batch.sig;
+	r = batch.r;
+	b = batch.b;
+	type = batch.type;
+	K = batch.K;
+	T = batch.T;
+	kind = batch.kind;
+	return *this;
+}
+
+
+// -------------------------------------------------------------------------- Static Functions ------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the name of mode as used in reports
+const char* PrecisionBatch::Name(Precision mode)
+{
+	switch (mode)
+	{
+	case DoublePrecision:	return "double";
+	case SinglePrecision:	return "single";
+	default:				return "mixed";
+	}
+}
+
+// Evaluates view in mode and in double precision and returns, for each output selected by outputs, the largest absolute and relative
+// differences between the two. Relative differences are taken only over rows whose double value is at least relativeFloor in size,
+// since a tiny reference value (the price of a far out of the money option, say) makes any relative difference meaningless.
+PrecisionErrors PrecisionBatch::Compare(const OptionBatchView& view, Precision mode, int outputs, double relativeFloor)
+{
+	PrecisionErrors errors = { view.rows, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 } };
+
+	vector<OptionResults> reference(view.rows);
+	vector<OptionResults> values(view.rows);
+	OptionBatch::Evaluate(view, outputs, reference.data());
+	EvaluateIn(view, mode, outputs, values.data());
+
+	for (size_t i = 0; i < view.rows; i++)
+	{
+		if (outputs & Option::PriceOutput)
+			Accumulate(errors, 0, values[i].price, reference[i].price, i, relativeFloor);
+		if (outputs & Option::DeltaOutput)
+			Accumulate(errors, 1, values[i].delta, reference[i].delta, i, relativeFloor);
+		if (outputs & Option::GammaOutput)
+			Accumulate(errors, 2, values[i].gamma, reference[i].gamma, i, relativeFloor);
+		if (outputs & Option::ThetaOutput)
+			Accumulate(errors, 3, values[i].theta, reference[i].theta, i, relativeFloor);
+		if (outputs & Option::VegaOutput)
+			Accumulate(errors, 4, values[i].vega, reference[i].vega, i, relativeFloor);
+	}
+
+	return errors;
+}
+
+
+// -------------------------------------------------------------------------- Private Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Replaces the float columns with the rows of view rounded to float
+void PrecisionBatch::Narrow(const OptionBatchView& view)
+{
+	AlignedFloatColumn* columns[7] = { &S, &sig, &r, &b, &type, &K, &T };
+	const double* sources[7] = { view.S, view.sig, view.r, view.b, view.type, view.K, view.T };
+	for (int j = 0; j < 7; j++)
+	{
+		columns[j]->resize(view.rows);
+		for (size_t i = 0; i < view.rows; i++)
+			(*columns[j])[i] = static_cast<float>(sources[j][i]);
+	}
+	kind.assign(view.kind, view.kind + view.rows);
+}
+
+// In double precision, dispatches each row to the double kernel matching its kind and type, exactly as OptionBatch does. In the float
+// modes the rows are taken blockRows at a time: the Euro rows of a block are gathered into local columns -- float for SinglePrecision,
+// widened to double for MixedPrecision -- and evaluated together by vectorized(view, out), a BsmKernel function, while each PAMO row is
+// passed to function(kernel, view, i) with the scalar kernel of its type and of the scalar type of the mode. A block made only of
+// Euro rows is passed to the single precision kernel as it is, without gathering.
+template <typename Result, typename Vectorized, typename Function>
+void PrecisionBatch::Apply(Result* result, Vectorized vectorized, Function function) const
+{
+	auto forEachRow = [&](auto real, const auto& view, size_t first, size_t last)
+	{
+		typedef decltype(real) Real;
+		for (size_t i = first; i < last; i++)
+		{
+			bool call = (view.type[i] == 1);
+			if (view.kind[i] == 'E')
+				result[i] = call ? function(EuropeanKernel<CallOption, Real>(), view, i) : function(EuropeanKernel<PutOption, Real>(), view, i);
+			else
+				result[i] = call ? function(PerpetualAmericanKernel<CallOption, Real>(), view, i) : function(PerpetualAmericanKernel<PutOption, Real>(), view, i);
+		}
+	};
+
+	auto forEachBlock = [&](auto real)
+	{
+		typedef decltype(real) Real;
+		typedef typename ViewOf<Real>::Type View;
+		FloatBatchView view = FloatView();
+		Real columns[7][blockRows];
+		char kinds[blockRows];
+		size_t rows[blockRows];
+		Result out[blockRows];
+
+		for (size_t first = 0; first < view.rows; first += blockRows)
+		{
+			size_t last = min(view.rows, first + blockRows);
+			size_t euroRows = 0;
+			for (size_t i = first; i < last; i++)
+			{
+				if (view.kind[i] == 'E')
+					rows[euroRows++] = i;
+			}
+
+			if (euroRows == last - first && EvaluateSlice(vectorized, view, first, last, result, real))
+				continue;
+
+			for (size_t j = 0; j < euroRows; j++)
+			{
+				size_t i = rows[j];
+				columns[0][j] = view.S[i];
+				columns[1][j] = view.sig[i];
+				columns[2][j] = view.r[i];
+				columns[3][j] = view.b[i];
+				columns[4][j] = view.type[i];
+				columns[5][j] = view.K[i];
+				columns[6][j] = view.T[i];
+				kinds[j] = 'E';
+			}
+			View euro = { columns[0], columns[1], columns[2], columns[3], columns[4], columns[5], columns[6], kinds, euroRows };
+			vectorized(euro, out);
+			for (size_t j = 0; j < euroRows; j++)
+				result[rows[j]] = out[j];
+
+			if (euroRows < last - first)
+			{
+				for (size_t i = first; i < last; i++)
+				{
+					if (view.kind[i] != 'E')
+						forEachRow(real, view, i, i + 1);
+				}
+			}
+		}
+	};
+
+	if (precision == DoublePrecision)
+	{
+		OptionBatchView view = doubleRows.View();
+		forEachRow(double(), view, 0, view.rows);
+	}
+	else if (precision == SinglePrecision)
+		forEachBlock(float());
+	else
+		forEachBlock(double());
+}
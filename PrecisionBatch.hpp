@@ -0,0 +1,106 @@
+// PrecisionBatch.hpp
+//
+// The purpose of the PrecisionBatch class is to let the precision of a batch be chosen at run time, per batch, for work such as
+// scenario runs and surface generation where single precision is accurate enough. A PrecisionBatch holds a book in one of three modes:
+//
+//		DoublePrecision		double columns priced by the double kernels; exactly the results of OptionBatch
+//		SinglePrecision		float columns priced by the float kernels, every operation in single precision
+//		MixedPrecision		float columns priced by the double kernels, i.e. float inputs with double arithmetic
+//
+// In the two float modes the parameter columns take half the memory, and half the memory bandwidth to stream, of an OptionBatch; in
+// mixed mode the only error is the rounding of the inputs to float. Results are always written as doubles so that callers need not
+// care which mode a batch uses. The Euro rows of the float modes are gathered in blocks and evaluated by BsmKernel -- by its single
+// precision overloads, with twice the lanes of the double ones, in SinglePrecision and by its double functions in MixedPrecision --
+// and the PAMO rows by the scalar kernels of OptionKernels.hpp. The double kernel differs from OptionBatch by < 1e-13 relative, far
+// below the rounding of the inputs, so mixed mode still reflects that rounding alone.
+//
+// Compare measures the cost in accuracy of a mode: it evaluates a view in that mode and in double precision and reports, for each
+// output, the largest absolute and relative differences and the rows where they occur.
+
+#ifndef PrecisionBatch_H
+#define PrecisionBatch_H
+
+#include "AlignedAllocator.hpp"
+#include "OptionBatch.hpp"
+
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+typedef vector<float, AlignedAllocator<float> > AlignedFloatColumn;
+
+// Differences between a reduced precision evaluation and the double one; every array is indexed by output in the order price,
+// delta, gamma, theta, vega, and outputs which were not compared are left at 0
+struct PrecisionErrors
+{
+	size_t rows;										// Number of rows compared
+	double maxAbs[5];									// Largest |value - reference|
+	double maxRel[5];									// Largest |value - reference| / |reference| over rows whose |reference| is at
+														// least the relative floor passed to Compare
+	size_t worstAbsRow[5];								// Row at which maxAbs occurs
+	size_t worstRelRow[5];								// Row at which maxRel occurs
+};
+
+class PrecisionBatch
+{
+public:
+	enum Precision { DoublePrecision = 0, SinglePrecision = 1, MixedPrecision = 2 };
+
+private:
+	Precision precision;
+	OptionBatch doubleRows;								// The book when precision is DoublePrecision; empty otherwise
+	AlignedFloatColumn S;								// The columns of the book when precision is SinglePrecision or MixedPrecision;
+	AlignedFloatColumn sig;								// empty otherwise
+	AlignedFloatColumn r;
+	AlignedFloatColumn b;
+	AlignedFloatColumn type;
+	AlignedFloatColumn K;
+	AlignedFloatColumn T;
+	AlignedTagColumn kind;
+
+	void Narrow(const OptionBatchView& view);			// Fills the float columns with the rows of view rounded to float
+
+	template <typename Result, typename Vectorized, typename Function>
+	void Apply(Result* result, Vectorized vectorized, Function function) const;	// Evaluates the Euro rows of a float mode in
+																				// blocks with vectorized(view, out), and every
+																				// other row i with function(kernel, view, i),
+																				// storing the values in result
+
+public:
+	// Constructors and Destructor
+	PrecisionBatch();													// Default constructor; an empty double precision book
+	PrecisionBatch(const OptionBatchView& view, Precision mode);		// Copies the rows of view in the precision mode
+	PrecisionBatch(const PrecisionBatch& batch);						// Copy constructor
+	virtual ~PrecisionBatch();											// Destructor
+
+
+	// Accessor Functions
+	size_t Size() const;												// Returns the number of rows in the book
+	Precision GetPrecision() const;										// Returns the precision mode of the book
+	FloatBatchView FloatView() const;									// Returns a view of the float columns; has no rows in DoublePrecision
+
+	// Each evaluator writes Size() results into result, in row order, computed in the precision mode of the book
+	void Price(double* result) const;
+	void Delta(double* result) const;
+	void Gamma(double* result) const;
+	void Evaluate(int outputs, OptionResults* result) const;
+
+
+	// Modifier Functions
+	void Assign(const OptionBatchView& view);							// Replaces the book with the rows of view, keeping the mode
+	void SetPrecision(Precision mode);									// Converts the book to mode; going from a float mode back to
+																		// DoublePrecision widens the float values, it does not restore
+																		// the digits lost when they were narrowed
+	PrecisionBatch& operator = (const PrecisionBatch& batch);			// Assignment operator
+
+
+	// Static Functions
+	static const char* Name(Precision mode);							// Returns "double", "single" or "mixed"
+	static PrecisionErrors Compare(const OptionBatchView& view, Precision mode, int outputs = Option::AllOutputs,
+								   double relativeFloor = 1e-6);		// Evaluates view in mode and in DoublePrecision and returns the
+																		// differences of the outputs selected by outputs
+
+};
+
+
+#endif
@@ -0,0 +1,151 @@
+// PriceCsvFile.cpp
+//
+// The purpose of this program is to price a CSV file of option parameters with the CsvPricingPipeline and to report how fast each of
+// its stages ran. The input and output formats are described in CsvPricingPipeline.hpp. The per-stage report is written to standard
+// error: a stage whose busy time is close to the total run time is the one limiting the throughput.
+//
+// Usage: PriceCsvFile input.csv output.csv [--outputs=price,delta,gamma,theta,vega] [--batch-rows=n] [--queue-depth=n] [--digits=n]
+//		  [--threads=n] [--metrics=file]
+// An input or output of "-" means standard input or standard output. --threads=0 (the default) prices each batch on the price stage's
+// own thread; a positive value splits each batch across a pool with that many additional threads. --metrics dumps the latency
+// histograms of the Instrumentation probes to a file after the run, as JSON if its name ends in .json and as Prometheus text
+// otherwise; the probes only record when the program is built with EXACT_PRICING_INSTRUMENT defined.
+
+#include "CsvPricingPipeline.hpp"
+#include "Instrumentation.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace std;
+
+// Converts a comma separated list of output names into Option::Outputs flags
+int ParseOutputs(const string& list)
+{
+	int flags = 0;
+	size_t first = 0;
+	while (first <= list.size())
+	{
+		size_t comma = list.find(',', first);
+		string name = list.substr(first, (comma == string::npos) ? string::npos : comma - first);
+		if (name == "price")
+			flags |= Option::PriceOutput;
+		else if (name == "delta")
+			flags |= Option::DeltaOutput;
+		else if (name == "gamma")
+			flags |= Option::GammaOutput;
+		else if (name == "theta")
+			flags |= Option::ThetaOutput;
+		else if (name == "vega")
+			flags |= Option::VegaOutput;
+		else
+			cerr << "Ignoring unknown output " << name << endl;
+
+		if (comma == string::npos)
+			break;
+		first = comma + 1;
+	}
+	return flags;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		cerr << "Usage: PriceCsvFile input.csv output.csv [--outputs=price,delta,gamma,theta,vega] [--batch-rows=n] [--queue-depth=n]"
+			 << " [--digits=n] [--threads=n] [--metrics=file]" << endl;
+		return 1;
+	}
+
+	string inputPath = argv[1];
+	string outputPath = argv[2];
+	int outputs = Option::AllOutputs;
+	size_t batchRows = 65536;
+	size_t queueDepth = 4;
+	int digits = 15;
+	size_t threads = 0;
+	string metricsPath;
+	for (int i = 3; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg.compare(0, 10, "--outputs=") == 0)
+			outputs = ParseOutputs(arg.substr(10));
+		else if (arg.compare(0, 13, "--batch-rows=") == 0)
+			batchRows = strtoul(arg.c_str() + 13, 0, 10);
+		else if (arg.compare(0, 14, "--queue-depth=") == 0)
+			queueDepth = strtoul(arg.c_str() + 14, 0, 10);
+		else if (arg.compare(0, 9, "--digits=") == 0)
+			digits = atoi(arg.c_str() + 9);
+		else if (arg.compare(0, 10, "--threads=") == 0)
+			threads = strtoul(arg.c_str() + 10, 0, 10);
+		else if (arg.compare(0, 10, "--metrics=") == 0)
+			metricsPath = arg.substr(10);
+		else
+			cerr << "Ignoring unrecognized argument " << arg << endl;
+	}
+
+	ios::sync_with_stdio(false);
+	ifstream inputFile;
+	ofstream outputFile;
+	if (inputPath != "-")
+	{
+		inputFile.open(inputPath.c_str(), ios::binary);
+		if (!inputFile)
+		{
+			cerr << "Cannot open " << inputPath << endl;
+			return 1;
+		}
+	}
+	if (outputPath != "-")
+	{
+		outputFile.open(outputPath.c_str(), ios::binary | ios::trunc);
+		if (!outputFile)
+		{
+			cerr << "Cannot create " << outputPath << endl;
+			return 1;
+		}
+	}
+	istream& input = (inputPath != "-") ? static_cast<istream&>(inputFile) : cin;
+	ostream& output = (outputPath != "-") ? static_cast<ostream&>(outputFile) : cout;
+
+	CsvPricingPipeline pipeline(outputs, batchRows, queueDepth, digits);
+	unique_ptr<ThreadPool> pool;
+	if (threads > 0)
+	{
+		pool.reset(new ThreadPool(threads));
+		pipeline.SetThreadPool(pool.get());
+	}
+
+	bool written = pipeline.Run(input, output);
+	if (!written)
+		cerr << "Writing " << outputPath << " failed" << endl;
+	if (pipeline.GetMalformedRows() > 0)
+		cerr << pipeline.GetMalformedRows() << " malformed lines, the first on line " << pipeline.GetFirstMalformedLine() << endl;
+
+	const vector<PipelineStageStats>& stats = pipeline.GetStats();
+	cerr << left << setw(8) << "stage" << right << setw(14) << "rows" << setw(12) << "MB" << setw(10) << "busy s" << setw(10) << "wall s"
+		 << setw(14) << "rows/busy s" << setw(12) << "MB/busy s" << endl;
+	for (size_t i = 0; i < stats.size(); i++)
+	{
+		const PipelineStageStats& s = stats[i];
+		double busy = (s.busySeconds > 0) ? s.busySeconds : 1e-9;
+		cerr << left << setw(8) << s.name << right << setw(14) << s.rows << setw(12) << fixed << setprecision(1) << s.bytes / 1e6
+			 << setw(10) << setprecision(3) << s.busySeconds << setw(10) << s.wallSeconds << setw(14) << setprecision(0) << s.rows / busy
+			 << setw(12) << setprecision(1) << s.bytes / 1e6 / busy << endl;
+	}
+
+	if (!metricsPath.empty())
+	{
+		if (!Instrumentation::IsEnabled())
+			cerr << "Built without EXACT_PRICING_INSTRUMENT; " << metricsPath << " will hold no probes" << endl;
+		if (!Instrumentation::Dump(metricsPath))
+			cerr << "Writing " << metricsPath << " failed" << endl;
+	}
+
+	return written ? 0 : 1;
+}
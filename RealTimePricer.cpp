@@ -0,0 +1,333 @@
+// RealTimePricer.cpp
+
+#include "RealTimePricer.hpp"
+#include "SpscRing.hpp"
+#include "Seqlock.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__)
+#define REAL_TIME_PRICER_AFFINITY
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+
+// State of one worker thread; everything but ring is touched by the worker alone while it runs
+struct RealTimePricer::Worker
+{
+	SpscRing<MarketTick> ring;								// Ticks submitted for the underlyings this worker owns
+	thread handle;
+	vector<long long> latencies;							// Submit-to-publish latency of every tick handled, in nanoseconds
+	size_t conflated;										// Ticks superseded by a later tick in the same batch
+	size_t reprices;										// Contract evaluations performed
+
+	explicit Worker(size_t capacity) : ring(capacity), handle(), latencies(), conflated(0), reprices(0) {}
+};
+
+
+namespace
+{
+	// Ticks taken from a ring before any of them is repriced; a larger batch conflates more under load
+	const size_t maxBatch = 64;
+
+	// Empty polls of the ring after which an idle worker starts yielding its CPU between polls
+	const size_t spinLimit = 1000;
+
+	// Returns the steady clock time in nanoseconds
+	long long Now()
+	{
+		return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Returns the q-quantile of values by the nearest-rank method; reorders values
+	double Percentile(vector<long long>& values, double q)
+	{
+		size_t rank = static_cast<size_t>(q * values.size() + 0.999999999);
+		rank = (rank == 0) ? 0 : min(rank, values.size()) - 1;
+		nth_element(values.begin(), values.begin() + rank, values.end());
+		return static_cast<double>(values[rank]);
+	}
+}
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor; one unpinned worker with a ring of 4096 ticks, computing every output
+RealTimePricer::RealTimePricer() : outputs(Option::AllOutputs), workerCount(1), ringCapacity(4096), pinThreads(false), initialSpots(), members(),
+	contracts(), snapshots(), workers(), running(false), fullRingSpins(0)
+{
+}
+
+// Value constructor; threads workers (at least one), each with a ring of at least ticksPerRing ticks, pinned to a CPU if pin is set
+RealTimePricer::RealTimePricer(size_t threads, size_t ticksPerRing, bool pin, int outputFlags) : outputs(outputFlags), workerCount((threads > 0) ? threads : 1),
+	ringCapacity(ticksPerRing), pinThreads(pin), initialSpots(), members(), contracts(), snapshots(), workers(), running(false), fullRingSpins(0)
+{
+}
+
+// Destructor
+RealTimePricer::~RealTimePricer()
+{
+	Stop();
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the number of contracts
+size_t RealTimePricer::Size() const
+{
+	return contracts.size();
+}
+
+// Returns the number of underlyings
+size_t RealTimePricer::UnderlyingCount() const
+{
+	return initialSpots.size();
+}
+
+// Returns whether the workers are running
+bool RealTimePricer::IsRunning() const
+{
+	return running.load(memory_order_acquire);
+}
+
+// Copies the latest published state of contract id into snapshot without waiting; returns false before Start or if a write overlapped
+// the copy
+bool RealTimePricer::Read(size_t id, PricedSnapshot& snapshot) const
+{
+	if (!snapshots)
+		return false;
+
+	return snapshots[id].TryRead(snapshot);
+}
+
+// Returns the latest published state of contract id, retrying until a copy is not overlapped by a write; call after Start
+PricedSnapshot RealTimePricer::Read(size_t id) const
+{
+	return snapshots[id].Read();
+}
+
+// Summarizes the latencies recorded by the workers during the last run
+LatencyReport RealTimePricer::GetLatencyReport() const
+{
+	LatencyReport report = { 0, 0, 0, fullRingSpins, 0, 0, 0, 0, 0 };
+
+	vector<long long> latencies;
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		const Worker& worker = *workers[i];
+		latencies.insert(latencies.end(), worker.latencies.begin(), worker.latencies.end());
+		report.conflated += worker.conflated;
+		report.reprices += worker.reprices;
+	}
+
+	report.ticks = latencies.size();
+	if (latencies.empty())
+		return report;
+
+	double total = 0;
+	for (size_t i = 0; i < latencies.size(); i++)
+		total += latencies[i];
+	report.mean = total / latencies.size();
+	report.max = static_cast<double>(*max_element(latencies.begin(), latencies.end()));
+	report.p50 = Percentile(latencies, 0.5);
+	report.p99 = Percentile(latencies, 0.99);
+	report.p999 = Percentile(latencies, 0.999);
+
+	return report;
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Adds an underlying with spot S and returns its index
+size_t RealTimePricer::AddUnderlying(double S)
+{
+	initialSpots.push_back(S);
+	members.push_back(vector<size_t>());
+	return initialSpots.size() - 1;
+}
+
+// Adds a copy of option on the given underlying, priced with sig, r and b, and returns its id
+size_t RealTimePricer::AddEuropean(const EuropeanOption& option, size_t underlying, double sig, double r, double b)
+{
+	return AddContract(new EuropeanOption(option), underlying, sig, r, b);
+}
+
+// Adds a copy of option on the given underlying, priced with sig, r and b, and returns its id
+size_t RealTimePricer::AddPerpetual(const PerpetualAmericanOption& option, size_t underlying, double sig, double r, double b)
+{
+	return AddContract(new PerpetualAmericanOption(option), underlying, sig, r, b);
+}
+
+// Prices every contract at the initial spot of its underlying and publishes the results, so that readers see a complete book from the
+// start, then starts the workers. The latencies and counters of any previous run are discarded.
+void RealTimePricer::Start()
+{
+	if (running.load(memory_order_acquire))
+		return;
+
+	snapshots.reset(new Seqlock<PricedSnapshot>[contracts.size()]);
+	MarketTick initial = { ~0ULL, 0, 0, 0 };
+	for (size_t u = 0; u < initialSpots.size(); u++)
+	{
+		initial.underlying = u;
+		initial.spot = initialSpots[u];
+		Reprice(u, initial);
+	}
+
+	fullRingSpins = 0;
+	workers.clear();
+	for (size_t i = 0; i < workerCount; i++)
+	{
+		workers.push_back(unique_ptr<Worker>(new Worker(ringCapacity)));
+		workers.back()->latencies.reserve(1 << 16);
+	}
+
+	running.store(true, memory_order_release);
+	for (size_t i = 0; i < workerCount; i++)
+	{
+		Worker& worker = *workers[i];
+		worker.handle = thread([this, &worker] { WorkerLoop(worker); });
+
+#if defined(REAL_TIME_PRICER_AFFINITY)
+		if (pinThreads)
+		{
+			unsigned cpus = thread::hardware_concurrency();
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			CPU_SET((cpus > 0) ? i % cpus : 0, &set);
+			pthread_setaffinity_np(worker.handle.native_handle(), sizeof(set), &set);			// Failure leaves the thread unpinned
+		}
+#endif
+	}
+}
+
+// Stamps tick with the current time and pushes it onto the ring of the worker owning its underlying, yielding while that ring is full.
+// Throws if the workers are not running, since there would be no ring to push onto before Start and no consumer after Stop.
+void RealTimePricer::Submit(const MarketTick& tick)
+{
+	if (!running.load(memory_order_acquire))
+		throw logic_error("RealTimePricer::Submit: the workers are not running");
+	if (tick.underlying >= initialSpots.size())
+		throw out_of_range("RealTimePricer::Submit: unknown underlying");
+
+	MarketTick stamped = tick;
+	stamped.stamp = Now();
+
+	Worker& worker = *workers[tick.underlying % workerCount];
+	while (!worker.ring.TryPush(stamped))
+	{
+		fullRingSpins++;
+		this_thread::yield();
+	}
+}
+
+// Tells the workers to stop once their rings are empty and waits for them; ticks submitted before Stop are all repriced
+void RealTimePricer::Stop()
+{
+	if (!running.load(memory_order_acquire))
+		return;
+
+	running.store(false, memory_order_release);
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i]->handle.join();
+}
+
+
+// -------------------------------------------------------------------------- Private Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Takes ownership of option and registers it under underlying; throws, freeing option, if underlying was not added
+size_t RealTimePricer::AddContract(Option* option, size_t underlying, double sig, double r, double b)
+{
+	Contract contract;
+	contract.option.reset(option);
+	contract.sig = sig;
+	contract.r = r;
+	contract.b = b;
+	if (underlying >= members.size())
+		throw out_of_range("RealTimePricer::AddContract: unknown underlying");
+
+	contracts.push_back(move(contract));
+	members[underlying].push_back(contracts.size() - 1);
+	return contracts.size() - 1;
+}
+
+// Drains the worker's ring in batches of up to maxBatch ticks. Within a batch only the last tick of each underlying is repriced, so a
+// worker which falls behind catches up instead of repricing spots that are already stale; every tick of the batch is then recorded as
+// delivered at the time the batch was published. An idle worker spins on its ring for a while and then yields between polls.
+void RealTimePricer::WorkerLoop(Worker& worker)
+{
+	MarketTick batch[maxBatch];
+	vector<unsigned long long> lastBatch(initialSpots.size(), 0);		// Batch in which each underlying was last repriced
+	unsigned long long batchNumber = 0;
+	size_t idlePolls = 0;
+
+	while (true)
+	{
+		size_t count = 0;
+		while (count < maxBatch && worker.ring.TryPop(batch[count]))
+			count++;
+
+		if (count == 0)
+		{
+			// Every tick submitted before Stop is visible once running reads false, so an empty ring then means the run is over
+			if (!running.load(memory_order_acquire) && !worker.ring.TryPop(batch[0]))
+				break;
+			if (running.load(memory_order_relaxed))
+			{
+				if (++idlePolls > spinLimit)
+					this_thread::yield();
+				continue;
+			}
+			count = 1;
+		}
+
+		idlePolls = 0;
+		batchNumber++;
+		for (size_t i = count; i-- > 0;)
+		{
+			size_t underlying = static_cast<size_t>(batch[i].underlying);
+			if (lastBatch[underlying] == batchNumber)
+			{
+				worker.conflated++;
+				continue;
+			}
+
+			lastBatch[underlying] = batchNumber;
+			worker.reprices += Reprice(underlying, batch[i]);
+		}
+
+		long long published = Now();
+		for (size_t i = 0; i < count; i++)
+			worker.latencies.push_back(published - batch[i].stamp);
+	}
+}
+
+// Evaluates every contract of underlying at the spot of tick and publishes each result to the contract's Seqlock
+size_t RealTimePricer::Reprice(size_t underlying, const MarketTick& tick)
+{
+	const vector<size_t>& ids = members[underlying];
+	for (size_t i = 0; i < ids.size(); i++)
+	{
+		const Contract& contract = contracts[ids[i]];
+
+		PricedSnapshot snapshot;
+		snapshot.results = contract.option->Evaluate(tick.spot, contract.sig, contract.r, contract.b, outputs);
+		snapshot.spot = tick.spot;
+		snapshot.tickSequence = tick.sequence;
+		snapshot.stamp = tick.stamp;
+		snapshot.publishTime = Now();
+		snapshots[ids[i]].Write(snapshot);
+	}
+
+	return ids.size();
+}
@@ -0,0 +1,139 @@
+// RealTimePricer.hpp
+//
+// The purpose of the RealTimePricer class is to run the pricing classes as a real-time component: market-data ticks go in on one
+// side, and up-to-date prices and Greeks come out on the other, readable at any moment by any thread. It has three parts:
+//		1. intake	the feed thread calls Submit for each tick, which stamps it and pushes it onto the lock-free SpscRing of the
+//					worker owning the tick's underlying (underlying % workers), spinning only if that ring is full,
+//		2. reprice	each worker thread, pinned to its own CPU where the platform allows, drains its ring, conflates ticks for the same
+//					underlying to the latest spot, and reprices every contract of each updated underlying through Option::Evaluate,
+//					so EuropeanOption and PerpetualAmericanOption contracts can be mixed freely, and
+//		3. publish	each contract's results, together with the spot and the tick they were computed from, are written to the
+//					contract's Seqlock, from which readers take consistent snapshots without ever blocking a worker.
+// The end-to-end latency of each tick, from Submit to the publication of the last contract repriced for it, is recorded by the worker
+// that handled it, and GetLatencyReport summarizes the latencies of the last run as percentiles.
+//
+// Only one thread may call Submit. The contracts must be added before Start, and AddUnderlying, AddEuropean and AddPerpetual may not
+// be called while the workers are running.
+
+#ifndef RealTimePricer_H
+#define RealTimePricer_H
+
+#include "Option.hpp"
+#include "EuropeanOption.hpp"
+#include "PerpetualAmericanOption.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+using namespace std;
+
+template <typename T>
+class SpscRing;
+
+template <typename T>
+class Seqlock;
+
+// A spot update for one underlying
+struct MarketTick
+{
+	unsigned long long sequence;						// Position of the tick in its feed
+	unsigned long long underlying;						// Index of the underlying
+	double spot;										// New spot price
+	long long stamp;									// Steady clock time in nanoseconds at which Submit accepted the tick
+};
+
+// The published state of one contract; see RealTimePricer::Read
+struct PricedSnapshot
+{
+	OptionResults results;								// Outputs computed from spot
+	double spot;										// Spot of the tick the results were computed from
+	unsigned long long tickSequence;					// Sequence number of that tick; ~0 before the first reprice
+	long long stamp;									// Its Submit stamp
+	long long publishTime;								// Steady clock time in nanoseconds at which the results were published
+};
+
+// End-to-end latencies, in nanoseconds, of the ticks of a run
+struct LatencyReport
+{
+	size_t ticks;										// Ticks submitted
+	size_t conflated;									// Ticks superseded by a later tick for the same underlying before repricing
+	size_t reprices;									// Contract evaluations performed
+	size_t fullRingSpins;								// Polls of a full ring made by Submit while waiting for room
+	double mean;
+	double p50;
+	double p99;
+	double p999;
+	double max;
+};
+
+class RealTimePricer
+{
+private:
+	struct Contract
+	{
+		unique_ptr<Option> option;						// The contract, copied from the caller's EuropeanOption or PerpetualAmericanOption
+		double sig;										// Volatility
+		double r;										// Interest rate
+		double b;										// Cost-of-carry
+	};
+
+	struct Worker;
+
+	int outputs;										// Option::Outputs flags computed for each contract
+	size_t workerCount;									// Number of worker threads
+	size_t ringCapacity;								// Minimum capacity of each worker's ring
+	bool pinThreads;									// Whether to pin worker i to CPU i modulo the number of CPUs
+
+	vector<double> initialSpots;						// Spot of each underlying before the first tick
+	vector<vector<size_t> > members;					// members[u] lists the contracts of underlying u
+	vector<Contract> contracts;
+	unique_ptr<Seqlock<PricedSnapshot>[]> snapshots;	// One per contract, created by Start
+	vector<unique_ptr<Worker> > workers;				// Created by Start
+	atomic<bool> running;
+	size_t fullRingSpins;								// Counted by the feed thread in Submit
+
+	RealTimePricer(const RealTimePricer&);				// Not copyable; the workers hold pointers into the pricer
+	RealTimePricer& operator = (const RealTimePricer&);	// Not assignable
+
+	size_t AddContract(Option* option, size_t underlying, double sig, double r, double b);	// Takes ownership of option
+	void WorkerLoop(Worker& worker);																// Body of each worker thread
+	size_t Reprice(size_t underlying, const MarketTick& tick);									// Reprices and publishes the contracts of
+																									// underlying and returns how many there are
+
+public:
+	// Constructors and Destructor
+	RealTimePricer();																		// Default constructor; one unpinned worker, rings of
+																							// 4096 ticks, every output
+	RealTimePricer(size_t threads, size_t ticksPerRing, bool pin, int outputFlags);			// Value constructor
+	virtual ~RealTimePricer();																// Stops the workers if they are running
+
+
+	// Accessor Functions
+	size_t Size() const;																	// Returns the number of contracts
+	size_t UnderlyingCount() const;															// Returns the number of underlyings
+	bool IsRunning() const;																	// Returns whether the workers are running
+	bool Read(size_t id, PricedSnapshot& snapshot) const;									// Copies the latest published state of contract id into
+																							// snapshot; returns false if a write overlapped the copy,
+																							// in which case the caller may simply try again
+	PricedSnapshot Read(size_t id) const;													// Retries until a consistent snapshot is obtained
+	LatencyReport GetLatencyReport() const;													// Summarizes the last run; call after Stop
+
+
+	// Modifier Functions
+	size_t AddUnderlying(double S);															// Adds an underlying with spot S and returns its index
+	size_t AddEuropean(const EuropeanOption& option, size_t underlying, double sig, double r, double b);
+																							// Adds a Euro contract and returns its id
+	size_t AddPerpetual(const PerpetualAmericanOption& option, size_t underlying, double sig, double r, double b);
+																							// Adds a PAMO contract and returns its id
+
+	void Start();																			// Prices every contract at its initial spot, publishes the
+																							// results and starts the workers
+	void Submit(const MarketTick& tick);													// Feed thread only; stamps tick and hands it to its worker;
+																							// throws unless running or if its underlying is unknown
+	void Stop();																			// Lets the workers drain their rings, then joins them
+
+};
+
+
+#endif
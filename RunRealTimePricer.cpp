@@ -0,0 +1,175 @@
+// RunRealTimePricer.cpp
+//
+// The purpose of this program is to run the RealTimePricer against the TickGenerator feed stand-in and report the end-to-end latency
+// of the ticks, from the moment the feed hands a tick to the pricer until every contract on its underlying has been republished.
+// The book holds --contracts contracts on each of --underlyings underlyings, Euro calls and puts with one PAMO in every eight. The
+// ticks are submitted at --rate ticks per second (0 for as fast as possible) while a reader thread continuously takes snapshots of
+// the whole book, so that the latencies include the effect of concurrent readers. Latencies are reported in microseconds.
+//
+// Usage: RunRealTimePricer [--underlyings=n] [--contracts=n] [--ticks=n] [--rate=ticks per second] [--workers=n] [--ring=n]
+//		  [--seed=n] [--no-pin] [--record=file] [--replay=file]
+// --record saves the generated ticks to a file; --replay prices the ticks of a file written by --record instead of generating them.
+
+#include "RealTimePricer.hpp"
+#include "TickGenerator.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+struct RunSettings
+{
+	size_t underlyings;
+	size_t contracts;
+	size_t ticks;
+	double rate;
+	size_t workers;
+	size_t ring;
+	unsigned long long seed;
+	bool pin;
+	string record;
+	string replay;
+};
+
+// Parses the command line; unrecognized arguments are reported and ignored
+RunSettings ParseArguments(int argc, char* argv[])
+{
+	RunSettings settings = { 16, 64, 200000, 100000, 1, 4096, 1, true, "", "" };
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg.compare(0, 14, "--underlyings=") == 0)
+			settings.underlyings = strtoul(arg.c_str() + 14, 0, 10);
+		else if (arg.compare(0, 12, "--contracts=") == 0)
+			settings.contracts = strtoul(arg.c_str() + 12, 0, 10);
+		else if (arg.compare(0, 8, "--ticks=") == 0)
+			settings.ticks = strtoul(arg.c_str() + 8, 0, 10);
+		else if (arg.compare(0, 7, "--rate=") == 0)
+			settings.rate = strtod(arg.c_str() + 7, 0);
+		else if (arg.compare(0, 10, "--workers=") == 0)
+			settings.workers = strtoul(arg.c_str() + 10, 0, 10);
+		else if (arg.compare(0, 7, "--ring=") == 0)
+			settings.ring = strtoul(arg.c_str() + 7, 0, 10);
+		else if (arg.compare(0, 7, "--seed=") == 0)
+			settings.seed = strtoull(arg.c_str() + 7, 0, 10);
+		else if (arg == "--no-pin")
+			settings.pin = false;
+		else if (arg.compare(0, 9, "--record=") == 0)
+			settings.record = arg.substr(9);
+		else if (arg.compare(0, 9, "--replay=") == 0)
+			settings.replay = arg.substr(9);
+		else
+			cerr << "Ignoring unrecognized argument " << arg << endl;
+	}
+	return settings;
+}
+
+int main(int argc, char* argv[])
+{
+	RunSettings settings = ParseArguments(argc, argv);
+	if (settings.underlyings == 0)
+		settings.underlyings = 1;
+
+	// The book
+	mt19937_64 generator(settings.seed);
+	uniform_real_distribution<double> vol(0.1, 0.5), rate(0.0, 0.08), moneyness(0.7, 1.3), maturity(0.05, 3);
+	vector<double> spots(settings.underlyings, 100);
+	RealTimePricer pricer(settings.workers, settings.ring, settings.pin, Option::AllOutputs);
+	for (size_t u = 0; u < settings.underlyings; u++)
+	{
+		size_t underlying = pricer.AddUnderlying(spots[u]);
+		for (size_t i = 0; i < settings.contracts; i++)
+		{
+			double r = rate(generator);
+			char type = (i % 2 == 0) ? 'C' : 'P';
+			if (i % 8 != 7)
+				pricer.AddEuropean(EuropeanOption(type, 100 * moneyness(generator), maturity(generator)), underlying, vol(generator), r, r - 0.02);
+			else
+				pricer.AddPerpetual(PerpetualAmericanOption('P', 60 * moneyness(generator)), underlying, vol(generator), r, r - 0.02);
+		}
+	}
+
+	// The feed
+	vector<MarketTick> ticks;
+	if (!settings.replay.empty())
+	{
+		if (!TickGenerator::Load(settings.replay, ticks))
+		{
+			cerr << "Cannot read ticks from " << settings.replay << endl;
+			return 1;
+		}
+		for (size_t i = 0; i < ticks.size(); i++)
+		{
+			if (ticks[i].underlying >= settings.underlyings)
+			{
+				cerr << "Tick " << ticks[i].sequence << " refers to underlying " << ticks[i].underlying << ", but the book has only "
+					 << settings.underlyings << endl;
+				return 1;
+			}
+		}
+	}
+	else
+	{
+		double tickInterval = (settings.rate > 0) ? settings.underlyings / (settings.rate * 252 * 6.5 * 3600) : 1.0 / (252 * 6.5 * 3600);
+		ticks = TickGenerator(spots, 0.25, tickInterval, settings.seed).Generate(settings.ticks);
+	}
+	if (!settings.record.empty() && !TickGenerator::Save(settings.record, ticks))
+		cerr << "Cannot write ticks to " << settings.record << endl;
+
+	// A reader which keeps taking snapshots of the whole book while the ticks are priced
+	atomic<bool> reading(true);
+	size_t snapshots = 0, retries = 0;
+	pricer.Start();
+	thread reader([&]
+	{
+		PricedSnapshot snapshot;
+		while (reading.load(memory_order_relaxed))
+		{
+			for (size_t id = 0; id < pricer.Size(); id++)
+			{
+				if (pricer.Read(id, snapshot))
+					snapshots++;
+				else
+					retries++;
+			}
+			this_thread::yield();
+		}
+	});
+
+	typedef chrono::steady_clock Clock;
+	Clock::time_point start = Clock::now();
+	for (size_t i = 0; i < ticks.size(); i++)
+	{
+		if (settings.rate > 0)
+		{
+			Clock::time_point due = start + chrono::duration_cast<Clock::duration>(chrono::duration<double>(i / settings.rate));
+			while (Clock::now() < due)
+				this_thread::yield();
+		}
+		pricer.Submit(ticks[i]);
+	}
+	pricer.Stop();
+	double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+	reading.store(false, memory_order_relaxed);
+	reader.join();
+
+	LatencyReport report = pricer.GetLatencyReport();
+	cout << "contracts        " << pricer.Size() << " on " << pricer.UnderlyingCount() << " underlyings, " << settings.workers << " worker(s)" << endl;
+	cout << "ticks            " << report.ticks << " in " << seconds << " s (" << report.ticks / seconds << " per second)" << endl;
+	cout << "conflated        " << report.conflated << endl;
+	cout << "reprices         " << report.reprices << endl;
+	cout << "full ring polls  " << report.fullRingSpins << endl;
+	cout << "snapshots read   " << snapshots << " (" << retries << " retried)" << endl;
+	cout << "latency (us)     mean " << report.mean / 1000 << "  p50 " << report.p50 / 1000 << "  p99 " << report.p99 / 1000
+		 << "  p99.9 " << report.p999 / 1000 << "  max " << report.max / 1000 << endl;
+
+	return 0;
+}
@@ -0,0 +1,313 @@
+// ScenarioEngine.cpp
+
+#include "ScenarioEngine.hpp"
+#include "CompensatedSum.hpp"
+#include "Instrumentation.hpp"
+#include "Portfolio.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+namespace
+{
+	const size_t minBlockRows = 1024;					// Smallest block of rows
+	const size_t maxRowBlocks = 256;					// Largest number of blocks of rows
+	const size_t blockScenarios = 32;					// Scenarios per block
+	const size_t tileRows = 256;						// Rows priced at a time
+
+	// OptionBatch::Price is overloaded, so the static version has to be named by its type
+	void DefaultPricer(const OptionBatchView& view, double* result)
+	{
+		OptionBatch::Price(view, result);
+	}
+}
+
+const double ScenarioEngine::volFloor = 1e-6;
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Value constructor; the engine keeps baseBook and quantity, not copies of them
+ScenarioEngine::ScenarioEngine(const OptionBatchView& baseBook, const double* quantity) : book(baseBook), quantities(quantity),
+																						  pricer(DefaultPricer)
+{
+}
+
+// Value constructor; the engine keeps views of the rows and quantities of portfolio
+ScenarioEngine::ScenarioEngine(const Portfolio& portfolio) : book(portfolio.View()), quantities(portfolio.GetQuantities().data()),
+															 pricer(DefaultPricer)
+{
+}
+
+// Copy constructor; the copy shares the base book
+ScenarioEngine::ScenarioEngine(const ScenarioEngine& engine) : book(engine.book), quantities(engine.quantities),
+															   scenarios(engine.scenarios), pricer(engine.pricer)
+{
+}
+
+// Destructor
+ScenarioEngine::~ScenarioEngine()
+{
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the number of rows of the book
+size_t ScenarioEngine::Size() const
+{
+	return book.rows;
+}
+
+// Returns the number of scenarios
+size_t ScenarioEngine::ScenarioCount() const
+{
+	return scenarios.size();
+}
+
+// Returns scenario index
+const MarketScenario& ScenarioEngine::GetScenario(size_t index) const
+{
+	return scenarios[index];
+}
+
+// Returns the P&L of the book under every scenario
+vector<double> ScenarioEngine::ProfitAndLoss() const
+{
+	INSTRUMENT_SCOPE("ScenarioEngine::ProfitAndLoss");
+	return ProfitAndLoss(0);
+}
+
+// Parallel version of ProfitAndLoss; the blocks are evaluated on pool, and their P&L combined exactly as in the serial version
+vector<double> ScenarioEngine::ProfitAndLoss(ThreadPool& pool) const
+{
+	INSTRUMENT_SCOPE("ScenarioEngine::ProfitAndLoss(pool)");
+	return ProfitAndLoss(&pool);
+}
+
+// Passes the P&L of every row under every scenario to sink
+void ScenarioEngine::Stream(const ScenarioTileSink& sink) const
+{
+	INSTRUMENT_SCOPE("ScenarioEngine::Stream");
+	Run(sink, 0);
+}
+
+// Parallel version of Stream
+void ScenarioEngine::Stream(const ScenarioTileSink& sink, ThreadPool& pool) const
+{
+	INSTRUMENT_SCOPE("ScenarioEngine::Stream(pool)");
+	Run(sink, &pool);
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Adds a scenario and returns its index
+size_t ScenarioEngine::AddScenario(const MarketScenario& scenario)
+{
+	scenarios.push_back(scenario);
+	return scenarios.size() - 1;
+}
+
+// Adds every scenario of newScenarios, in order
+void ScenarioEngine::AddScenarios(const vector<MarketScenario>& newScenarios)
+{
+	scenarios.insert(scenarios.end(), newScenarios.begin(), newScenarios.end());
+}
+
+// Removes every scenario
+void ScenarioEngine::ClearScenarios()
+{
+	scenarios.clear();
+}
+
+// Prices the shifted rows with batchPricer
+void ScenarioEngine::SetPricer(const BatchPricer& batchPricer)
+{
+	pricer = batchPricer;
+}
+
+// Assignment operator; the engine then shares the base book of engine
+ScenarioEngine& ScenarioEngine::operator = (const ScenarioEngine& engine)
+{
+	if (this != &engine)
+	{
+		book = engine.book;
+		quantities = engine.quantities;
+		scenarios = engine.scenarios;
+		pricer = engine.pricer;
+	}
+
+	return *this;
+}
+
+
+// -------------------------------------------------------------------------- Static Functions ------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns every combination of the given shifts, ordered with the spot shift varying fastest, followed by the vol, rate and carry
+// shifts and finally the time roll
+vector<MarketScenario> ScenarioEngine::Product(const vector<double>& spotShifts, const vector<double>& volShifts,
+											   const vector<double>& rateShifts, const vector<double>& carryShifts,
+											   const vector<double>& timeRolls)
+{
+	const vector<double> none(1, 0.0);
+	const vector<double>& spot = spotShifts.empty() ? none : spotShifts;
+	const vector<double>& vol = volShifts.empty() ? none : volShifts;
+	const vector<double>& rate = rateShifts.empty() ? none : rateShifts;
+	const vector<double>& carry = carryShifts.empty() ? none : carryShifts;
+	const vector<double>& roll = timeRolls.empty() ? none : timeRolls;
+
+	vector<MarketScenario> result;
+	result.reserve(spot.size() * vol.size() * rate.size() * carry.size() * roll.size());
+	for (double t : roll)
+		for (double b : carry)
+			for (double r : rate)
+				for (double sig : vol)
+					for (double S : spot)
+					{
+						MarketScenario scenario = { S, sig, r, b, t };
+						result.push_back(scenario);
+					}
+	return result;
+}
+
+// Returns the p-quantile of values: with the values sorted into v_0 <= ... <= v_(n-1) and h = (n - 1)p, the value v_floor(h)
+// + (h - floor(h)) (v_(floor(h)+1) - v_floor(h)). p is limited to [0, 1].
+double ScenarioEngine::Quantile(vector<double> values, double p)
+{
+	if (values.empty())
+		return numeric_limits<double>::quiet_NaN();
+
+	sort(values.begin(), values.end());
+	double h = (values.size() - 1) * min(max(p, 0.0), 1.0);
+	size_t lower = size_t(h);
+	if (lower + 1 >= values.size())
+		return values.back();
+
+	return values[lower] + (h - lower) * (values[lower + 1] - values[lower]);
+}
+
+// Returns the VaR of the P&L vector pnl at the given confidence, as a positive number for a loss
+double ScenarioEngine::ValueAtRisk(const vector<double>& pnl, double confidence)
+{
+	return -Quantile(pnl, 1 - confidence);
+}
+
+
+// -------------------------------------------------------------------------- Private Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the number of rows of a block: at least minBlockRows, and enough for the book to have at most maxRowBlocks blocks
+size_t ScenarioEngine::RowBlockRows() const
+{
+	return max(minBlockRows, (book.rows + maxRowBlocks - 1) / maxRowBlocks);
+}
+
+// Revalues rows [firstRow, lastRow) under scenarios [firstScenario, lastScenario), tileRows rows at a time. The type, strike and
+// kind columns of a tile are those of the book itself; only S, sig, r, b and T are written to the buffers.
+void ScenarioEngine::EvaluateBlock(size_t firstRow, size_t lastRow, size_t firstScenario, size_t lastScenario,
+								   const ScenarioTileSink& sink) const
+{
+	size_t tile = min(tileRows, lastRow - firstRow);
+	AlignedColumn S(tile), sig(tile), r(tile), b(tile), T(tile);
+	vector<double> basePrices(tile), prices(tile), pnl(tile);
+	vector<char> expired(tile);
+
+	for (size_t start = firstRow; start < lastRow; start += tile)
+	{
+		size_t count = min(tile, lastRow - start);
+		pricer(OptionBatch::Slice(book, start, start + count), basePrices.data());
+
+		for (size_t s = firstScenario; s < lastScenario; s++)
+		{
+			const MarketScenario& scenario = scenarios[s];
+			for (size_t i = 0; i < count; i++)
+			{
+				size_t row = start + i;
+				S[i] = book.S[row] * (1 + scenario.spotShift);
+				sig[i] = max(book.sig[row] + scenario.volShift, volFloor);
+				r[i] = book.r[row] + scenario.rateShift;
+				b[i] = book.b[row] + scenario.carryShift;
+				T[i] = (book.kind[row] == 'E') ? book.T[row] - scenario.timeRoll : book.T[row];
+				expired[i] = (book.kind[row] == 'E') && !(T[i] > 0);
+				if (expired[i])
+					T[i] = book.T[row];										// Priced as is, then replaced by the intrinsic value
+			}
+
+			OptionBatchView shifted = { S.data(), sig.data(), r.data(), b.data(), book.type + start, book.K + start, T.data(),
+										book.kind + start, count };
+			pricer(shifted, prices.data());
+
+			for (size_t i = 0; i < count; i++)
+			{
+				size_t row = start + i;
+				double price = expired[i] ? max(book.type[row] * (S[i] - book.K[row]), 0.0) : prices[i];
+				pnl[i] = ((quantities != 0) ? quantities[row] : 1.0) * (price - basePrices[i]);
+			}
+			sink(s, start, count, pnl.data());
+		}
+	}
+}
+
+// Evaluates every block of rows and scenarios, on pool if it is not null
+void ScenarioEngine::Run(const ScenarioTileSink& sink, ThreadPool* pool) const
+{
+	size_t rowBlockRows = RowBlockRows();
+	size_t rowBlocks = (book.rows + rowBlockRows - 1) / rowBlockRows;
+	size_t scenarioBlocks = (scenarios.size() + blockScenarios - 1) / blockScenarios;
+
+	auto evaluateBlocks = [&](size_t firstBlock, size_t lastBlock)
+	{
+		for (size_t block = firstBlock; block < lastBlock; block++)
+		{
+			size_t rowBlock = block / scenarioBlocks;
+			size_t scenarioBlock = block % scenarioBlocks;
+			EvaluateBlock(rowBlock * rowBlockRows, min(book.rows, (rowBlock + 1) * rowBlockRows), scenarioBlock * blockScenarios,
+						  min(scenarios.size(), (scenarioBlock + 1) * blockScenarios), sink);
+		}
+	};
+	if (pool != 0)
+		pool->ParallelFor(0, rowBlocks * scenarioBlocks, 1, evaluateBlocks);
+	else
+		evaluateBlocks(0, rowBlocks * scenarioBlocks);
+}
+
+// Reduces the P&L of every row under every scenario. Each (row block, scenario) pair has a compensated partial sum of its own, to
+// which only one block adds, tile by tile in row order; the partial sums of row blocks k and k + w are then added into those of row
+// block k for w = 1, 2, 4, ..., so that the order of every addition is fixed whoever evaluated the blocks.
+vector<double> ScenarioEngine::ProfitAndLoss(ThreadPool* pool) const
+{
+	size_t n = scenarios.size();
+	size_t rowBlockRows = RowBlockRows();
+	size_t rowBlocks = (book.rows + rowBlockRows - 1) / rowBlockRows;
+
+	CompensatedSum zero = { 0, 0 };
+	vector<CompensatedSum> sums(max(rowBlocks, size_t(1)) * n, zero);
+	Run([&](size_t scenario, size_t first, size_t count, const double* pnl)
+		{
+			CompensatedSum& sum = sums[(first / rowBlockRows) * n + scenario];
+			for (size_t i = 0; i < count; i++)
+				sum.Add(pnl[i]);
+		}, pool);
+
+	for (size_t width = 1; width < rowBlocks; width *= 2)
+	{
+		for (size_t block = 0; block + width < rowBlocks; block += 2 * width)
+		{
+			for (size_t s = 0; s < n; s++)
+				sums[block * n + s].Add(sums[(block + width) * n + s]);
+		}
+	}
+
+	vector<double> result(n);
+	for (size_t s = 0; s < n; s++)
+		result[s] = sums[s].Value();
+	return result;
+}
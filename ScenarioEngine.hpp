@@ -0,0 +1,110 @@
+// ScenarioEngine.hpp
+//
+// The purpose of the ScenarioEngine class is to revalue a whole book under a list of market scenarios, for stress tests, VaR and limit
+// checks. A scenario shifts the market parameters of every row at once: the spot by a relative amount, the volatility, rate and cost of
+// carry by absolute amounts, and the time till maturity of Euro rows down by a time roll. Rather than a shifted copy of the book per
+// scenario, the engine keeps a view of the base book (OptionBatchView, plus the signed quantity of each row) that it never modifies,
+// and writes the shifted parameters of one tile of rows at a time to small buffers of its own before pricing them with a batch
+// pricer, OptionBatch::Price by default, i.e. the kernels behind EuropeanOption::Price and PerpetualAmericanOption::Price.
+//
+// The (row, scenario) pairs are cut into blocks of rows times blocks of scenarios, which are evaluated independently, serially or on
+// a ThreadPool. Within a block every tile of rows is priced unshifted once and then under each scenario of the block, so the base
+// columns of the tile stay in cache while they are reused, and the P&L of each row, quantity * (shifted price - base price), is
+// handed on a tile at a time. ProfitAndLoss reduces them to the P&L of the whole book under each scenario with compensated partial
+// sums per row block that are combined in a fixed order (see Portfolio.hpp), so the P&L vector is the same whether it is computed
+// serially or in parallel; Stream hands the row P&L tiles to a caller-supplied sink instead, for reductions of the caller's own such
+// as P&L by desk. ValueAtRisk and Quantile read VaR figures off a P&L vector.
+//
+// Shifted volatilities are floored at volFloor. A Euro row whose time till maturity is rolled to 0 or below has expired and is
+// valued at its intrinsic value. As with the rest of the library, a PAMO row shifted to parameters where its formula does not hold
+// (r <= b for calls, r <= 0 for puts) prices to NaN, which then shows in the P&L of that scenario.
+
+#ifndef ScenarioEngine_H
+#define ScenarioEngine_H
+
+#include "OptionBatch.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+using namespace std;
+
+class Portfolio;
+class ThreadPool;
+
+// The shifts applied to every row of a book by one scenario
+struct MarketScenario
+{
+	double spotShift;									// Relative; S becomes S * (1 + spotShift)
+	double volShift;									// Absolute; sig becomes sig + volShift
+	double rateShift;									// Absolute; r becomes r + rateShift
+	double carryShift;									// Absolute; b becomes b + carryShift
+	double timeRoll;									// Years; T becomes T - timeRoll for Euro rows
+};
+
+// Receives the P&L of rows [first, first + count) of the book under scenario; pnl points to count entries valid only during the call
+typedef function<void(size_t scenario, size_t first, size_t count, const double* pnl)> ScenarioTileSink;
+
+class ScenarioEngine
+{
+private:
+	OptionBatchView book;								// Base book; not owned, and never modified
+	const double* quantities;							// Signed quantity of each row of book, or 0 for a quantity of 1 per row; not owned
+	vector<MarketScenario> scenarios;					// Scenarios to revalue the book under
+	BatchPricer pricer;									// Prices the tiles of shifted rows
+
+	size_t RowBlockRows() const;						// Returns the number of rows of a block, which depends only on book.rows
+	void EvaluateBlock(size_t firstRow, size_t lastRow, size_t firstScenario, size_t lastScenario, const ScenarioTileSink& sink) const;
+														// Revalues rows [firstRow, lastRow) under scenarios [firstScenario, lastScenario),
+														// passing the P&L of each tile of rows and each scenario to sink
+	void Run(const ScenarioTileSink& sink, ThreadPool* pool) const;	// Evaluates every block, on pool if not null
+	vector<double> ProfitAndLoss(ThreadPool* pool) const;				// Reduces the P&L of every block, evaluated on pool if not null
+
+public:
+	static const double volFloor;						// Smallest shifted volatility
+
+	// Constructors and Destructor
+	ScenarioEngine(const OptionBatchView& baseBook, const double* quantity = 0);	// Revalues the rows of baseBook, row i held in quantity[i]
+																					// (or 1 if quantity is 0); both must outlive the engine
+	explicit ScenarioEngine(const Portfolio& portfolio);							// Revalues the positions of portfolio, which must outlive the
+																					// engine and must not be modified while it is in use
+	ScenarioEngine(const ScenarioEngine& engine);									// Copy constructor
+	virtual ~ScenarioEngine();														// Destructor
+
+
+	// Accessor Functions
+	size_t Size() const;														// Returns the number of rows of the book
+	size_t ScenarioCount() const;												// Returns the number of scenarios
+	const MarketScenario& GetScenario(size_t index) const;						// Returns scenario index
+
+	vector<double> ProfitAndLoss() const;										// Returns the P&L of the book under every scenario, in scenario order
+	vector<double> ProfitAndLoss(ThreadPool& pool) const;						// Parallel version of the above, with bitwise identical results
+	void Stream(const ScenarioTileSink& sink) const;							// Passes the P&L of every row under every scenario to sink, a tile
+																				// of rows and one scenario at a time
+	void Stream(const ScenarioTileSink& sink, ThreadPool& pool) const;			// Parallel version of the above; tiles are passed to sink
+																				// concurrently and in no particular order, so sink must be thread safe
+
+
+	// Modifier Functions
+	size_t AddScenario(const MarketScenario& scenario);							// Adds a scenario and returns its index
+	void AddScenarios(const vector<MarketScenario>& newScenarios);				// Adds every scenario of newScenarios, in order
+	void ClearScenarios();														// Removes every scenario
+	void SetPricer(const BatchPricer& batchPricer);								// Prices the shifted rows with batchPricer
+	ScenarioEngine& operator = (const ScenarioEngine& engine);					// Assignment operator
+
+
+	// Static Functions
+	static vector<MarketScenario> Product(const vector<double>& spotShifts, const vector<double>& volShifts,
+										  const vector<double>& rateShifts, const vector<double>& carryShifts,
+										  const vector<double>& timeRolls);
+																				// Returns every combination of the given shifts, the spot shift
+																				// varying fastest; an empty list stands for a shift of 0
+	static double Quantile(vector<double> values, double p);					// Returns the p-quantile of values, interpolating linearly between
+																				// order statistics; NaN if values is empty
+	static double ValueAtRisk(const vector<double>& pnl, double confidence);	// Returns the VaR of the P&L vector pnl at the given confidence,
+																				// e.g. 0.99: the loss -Quantile(pnl, 1 - confidence)
+
+};
+
+
+#endif
@@ -0,0 +1,232 @@
+// ScenarioGrid.cpp
+
+#include "ScenarioGrid.hpp"
+#include "OptionKernels.hpp"
+#include "ThreadPool.hpp"
+
+#include <cmath>
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor
+ScenarioGrid::ScenarioGrid() : spots(), vols(), rates(), carries(), strikes(), maturities(), type('C'), logSpots(), logStrikes()
+{
+}
+
+// Value constructor; a single value for a parameter is given as a one element axis
+ScenarioGrid::ScenarioGrid(const vector<double>& spot, const vector<double>& vol, const vector<double>& rate, const vector<double>& carry,
+						   char optionType, const vector<double>& strike, const vector<double>& timeTillMat) : spots(spot), vols(vol), rates(rate),
+						   carries(carry), strikes(strike), maturities(timeTillMat), type(optionType)
+{
+	ComputeLogs();
+}
+
+// Copy constructor
+ScenarioGrid::ScenarioGrid(const ScenarioGrid& grid) : spots(grid.spots), vols(grid.vols), rates(grid.rates), carries(grid.carries),
+													   strikes(grid.strikes), maturities(grid.maturities), type(grid.type),
+													   logSpots(grid.logSpots), logStrikes(grid.logStrikes)
+{
+}
+
+// Destructor
+ScenarioGrid::~ScenarioGrid()
+{
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the number of points in the grid, i.e. the product of the axis lengths
+size_t ScenarioGrid::Size() const
+{
+	return spots.size() * strikes.size() * vols.size() * carries.size() * rates.size() * maturities.size();
+}
+
+// Returns the option type shared by every point of the grid
+char ScenarioGrid::GetType() const
+{
+	return type;
+}
+
+// Decomposes index into its axis coordinates, spot fastest and maturity slowest
+void ScenarioGrid::GetPoint(size_t index, double& S, double& sig, double& r, double& b, double& K, double& T) const
+{
+	S = spots[index % spots.size()];
+	index /= spots.size();
+	K = strikes[index % strikes.size()];
+	index /= strikes.size();
+	sig = vols[index % vols.size()];
+	index /= vols.size();
+	b = carries[index % carries.size()];
+	index /= carries.size();
+	r = rates[index % rates.size()];
+	index /= rates.size();
+	T = maturities[index];
+}
+
+// Evaluates the grid tile by tile on the calling thread, passing the tiles to sink in index order. Only one tile of results is held
+// at a time; a tileSize of 0 is treated as 4096 points.
+void ScenarioGrid::Evaluate(int outputs, size_t tileSize, const GridTileSink& sink) const
+{
+	size_t total = Size();
+	if (tileSize == 0)
+		tileSize = 4096;
+
+	vector<OptionResults> tile((tileSize < total) ? tileSize : total);
+	for (size_t first = 0; first < total; first += tileSize)
+	{
+		size_t count = (total - first < tileSize) ? total - first : tileSize;
+		EvaluateRange(first, count, outputs, tile.data());
+		sink(first, count, tile.data());
+	}
+}
+
+// Parallel version of the above; each chunk of the loop is one tile with its own buffer, so at most one tile per thread is alive
+void ScenarioGrid::Evaluate(int outputs, size_t tileSize, const GridTileSink& sink, ThreadPool& pool) const
+{
+	size_t total = Size();
+	if (tileSize == 0)
+		tileSize = 4096;
+
+	size_t tileCount = (total + tileSize - 1) / tileSize;
+	pool.ParallelFor(0, tileCount, 1, [&](size_t firstTile, size_t lastTile)
+	{
+		vector<OptionResults> tile(tileSize);
+		for (size_t t = firstTile; t < lastTile; t++)
+		{
+			size_t first = t * tileSize;
+			size_t count = (total - first < tileSize) ? total - first : tileSize;
+			EvaluateRange(first, count, outputs, tile.data());
+			sink(first, count, tile.data());
+		}
+	});
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Assignment operator
+ScenarioGrid& ScenarioGrid::operator = (const ScenarioGrid& grid)
+{
+	if (this != &grid)
+	{
+		spots = grid.spots;
+		vols = grid.vols;
+		rates = grid.rates;
+		carries = grid.carries;
+		strikes = grid.strikes;
+		maturities = grid.maturities;
+		type = grid.type;
+		logSpots = grid.logSpots;
+		logStrikes = grid.logStrikes;
+	}
+
+	return *this;
+}
+
+
+// -------------------------------------------------------------------------- Private Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Computes the logs of the spot and strike axes once, at construction, rather than once per tile
+void ScenarioGrid::ComputeLogs()
+{
+	logSpots.resize(spots.size());
+	for (size_t i = 0; i < spots.size(); i++)
+		logSpots[i] = log(spots[i]);
+
+	logStrikes.resize(strikes.size());
+	for (size_t i = 0; i < strikes.size(); i++)
+		logStrikes[i] = log(strikes[i]);
+}
+
+// Evaluates points [first, first + count) into results with EuropeanFormulas, the formulas of EuropeanOption::Evaluate. The
+// coordinates of first are found once and then advanced like an odometer; whenever an axis rolls over, only the invariants of that
+// axis and the axes inside it are recomputed, so the outer level quantities are computed once per change rather than once per point.
+void ScenarioGrid::EvaluateRange(size_t first, size_t count, int outputs, OptionResults* results) const
+{
+	size_t nS = spots.size(), nK = strikes.size(), nSig = vols.size(), nB = carries.size(), nR = rates.size();
+
+	// Odometer position of first
+	size_t index = first;
+	size_t iS = index % nS;		index /= nS;
+	size_t iK = index % nK;		index /= nK;
+	size_t iSig = index % nSig;	index /= nSig;
+	size_t iB = index % nB;		index /= nB;
+	size_t iR = index % nR;		index /= nR;
+	size_t iT = index;
+
+	double phi = (type == 'C') ? 1 : -1;
+
+	// Hoisted invariants, from the outermost level inwards: T and terms.sqrtT per maturity, terms.r and discount per (rate, maturity),
+	// terms.b and terms.carryFactor per (carry, rate, maturity), terms.sig, terms.sigSqrtT and drift per (vol, carry, maturity), and
+	// terms.discountedStrike and shift per (strike, vol, carry, rate, maturity)
+	EuropeanTerms<double> terms = EuropeanTerms<double>();
+	double T = 0, discount = 0, drift = 0, shift = 0;
+
+	int level = 0;											// Outermost axis whose invariants are stale; 0 = maturity ... 5 = spot
+	for (size_t p = 0; p < count; p++)
+	{
+		if (level <= 0)
+		{
+			T = maturities[iT];
+			terms.sqrtT = sqrt(T);
+		}
+		if (level <= 1)
+		{
+			terms.r = rates[iR];
+			discount = exp((-terms.r) * T);
+		}
+		if (level <= 2)
+		{
+			terms.b = carries[iB];
+			terms.carryFactor = exp((terms.b - terms.r) * T);
+		}
+		if (level <= 3)
+		{
+			terms.sig = vols[iSig];
+			terms.sigSqrtT = terms.sig * terms.sqrtT;
+			drift = (terms.b + (terms.sig * terms.sig) / 2) * T;
+		}
+		if (level <= 4)
+		{
+			terms.discountedStrike = strikes[iK] * discount;
+			shift = drift - logStrikes[iK];
+		}
+
+		results[p] = EuropeanFormulas<double>::Evaluate(phi, spots[iS], logSpots[iS] + shift, terms, outputs);
+
+		// Advance the odometer, remembering the outermost axis that moved
+		level = 5;
+		if (++iS == nS)
+		{
+			iS = 0;
+			level = 4;
+			if (++iK == nK)
+			{
+				iK = 0;
+				level = 3;
+				if (++iSig == nSig)
+				{
+					iSig = 0;
+					level = 2;
+					if (++iB == nB)
+					{
+						iB = 0;
+						level = 1;
+						if (++iR == nR)
+						{
+							iR = 0;
+							level = 0;
+							iT++;
+						}
+					}
+				}
+			}
+		}
+	}
+}
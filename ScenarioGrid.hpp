@@ -0,0 +1,80 @@
+// ScenarioGrid.hpp
+//
+// The purpose of the ScenarioGrid class is to describe, without materializing it, the full Cartesian product of ranges of Euro option
+// parameters, e.g. spot x vol x maturity x strike, and to evaluate the price and Greeks over it in a streaming fashion. Where each
+// ParamMatrix constructor varies a single parameter and stores one row plus one Option object per point, a ScenarioGrid only stores
+// its axes (typically produced by mesher()), so the grid itself costs memory proportional to the sum of the axis lengths rather than
+// their product.
+//
+// Points are numbered with the spot axis varying fastest, followed by strike, vol, carry, rate and finally maturity, i.e.
+//		index = ((((iT * nr + ir) * nb + ib) * nsig + isig) * nK + iK) * nS + iS.
+// Evaluate walks the points in this order in tiles of a caller-chosen size and hands each tile of results to a sink, so memory use
+// is proportional to the tile. Because the outer axes change slowly, everything that does not depend on the inner axes is hoisted:
+// sqrt(T) is computed once per maturity, exp(-rT) once per (rate, maturity), exp((b - r)T) once per (carry, rate, maturity),
+// sig * sqrt(T) and the drift (b + sig^2/2)T once per (vol, carry, maturity), and log(K) and log(S) once per axis entry. Each grid
+// point then costs a subtraction, a multiplication and the normal CDF/PDF evaluations its outputs need.
+
+#ifndef ScenarioGrid_H
+#define ScenarioGrid_H
+
+#include "Option.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+using namespace std;
+
+class ThreadPool;
+
+// Receives the results of points [first, first + count) of a grid; results points to count entries valid only during the call
+typedef function<void(size_t first, size_t count, const OptionResults* results)> GridTileSink;
+
+class ScenarioGrid
+{
+private:
+	vector<double> spots;								// Spot axis
+	vector<double> vols;								// Volatility axis
+	vector<double> rates;								// Interest rate axis
+	vector<double> carries;								// Cost-of-carry axis
+	vector<double> strikes;								// Strike axis
+	vector<double> maturities;							// Time till maturity axis
+	char type;											// 'C' for calls and 'P' for puts; shared by every point
+	vector<double> logSpots;							// log of each entry of the spot axis
+	vector<double> logStrikes;							// log of each entry of the strike axis
+
+	void ComputeLogs();															// Fills logSpots and logStrikes from the axes
+
+	void EvaluateRange(size_t first, size_t count, int outputs, OptionResults* results) const;	// Evaluates points [first, first + count)
+
+public:
+	// Constructors and Destructor
+	ScenarioGrid();																				// Default constructor; an empty grid
+	ScenarioGrid(const vector<double>& spot, const vector<double>& vol, const vector<double>& rate, const vector<double>& carry,
+				 char optionType, const vector<double>& strike, const vector<double>& timeTillMat);	// Value constructor; parameters ordered as
+																							// in the ParamMatrix constructors
+	ScenarioGrid(const ScenarioGrid& grid);														// Copy constructor
+	virtual ~ScenarioGrid();																	// Destructor
+
+
+	// Accessor Functions
+	size_t Size() const;																		// Returns the number of points in the grid
+	char GetType() const;																		// Returns the option type of the grid
+	void GetPoint(size_t index, double& S, double& sig, double& r, double& b, double& K, double& T) const;
+																								// Returns the parameters of point index
+
+	void Evaluate(int outputs, size_t tileSize, const GridTileSink& sink) const;				// Evaluates the outputs selected by the
+																								// Option::Outputs flags for every point, passing
+																								// tiles of at most tileSize points to sink in order
+	void Evaluate(int outputs, size_t tileSize, const GridTileSink& sink, ThreadPool& pool) const;
+																								// Parallel version of the above; tiles are
+																								// evaluated and passed to sink concurrently and
+																								// in no particular order, so sink must be
+																								// thread safe
+
+	// Modifier Functions
+	ScenarioGrid& operator = (const ScenarioGrid& grid);										// Assignment operator
+
+};
+
+
+#endif
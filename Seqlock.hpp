@@ -0,0 +1,90 @@
+// Seqlock.hpp
+//
+// The purpose of the Seqlock class template is to publish a small value from one writer thread to any number of reader threads so
+// that readers never block the writer and the writer never waits for readers. The writer makes a sequence counter odd, stores the
+// value and makes the counter even again; a reader copies the value between two loads of the counter and keeps the copy only if both
+// loads returned the same even number, retrying otherwise. A reader may therefore have to retry while a write is in progress, but a
+// write always completes in a bounded number of steps.
+//
+// The value is held as an array of 64-bit atomic words accessed with relaxed loads and stores, so concurrent reads and writes are
+// well defined; T must be trivially copyable and its size a multiple of 8 bytes.
+
+#ifndef Seqlock_H
+#define Seqlock_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+
+template <typename T>
+class Seqlock
+{
+private:
+	static_assert(sizeof(T) % sizeof(unsigned long long) == 0, "Seqlock requires a value whose size is a multiple of 8 bytes");
+	static const std::size_t words = sizeof(T) / sizeof(unsigned long long);
+
+	std::atomic<unsigned long long> sequence;									// Even when the value is stable, odd during a write
+	std::atomic<unsigned long long> data[words];
+
+	Seqlock(const Seqlock&);													// Not copyable
+	Seqlock& operator = (const Seqlock&);										// Not assignable
+
+public:
+	// Constructors and Destructor
+	Seqlock() : sequence(0)
+	{
+		for (std::size_t i = 0; i < words; i++)
+			data[i].store(0, std::memory_order_relaxed);
+	}
+
+	// Single writer only; publishes value
+	void Write(const T& value)
+	{
+		unsigned long long buffer[words];
+		std::memcpy(buffer, &value, sizeof(T));
+
+		unsigned long long start = sequence.load(std::memory_order_relaxed);
+		sequence.store(start + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (std::size_t i = 0; i < words; i++)
+			data[i].store(buffer[i], std::memory_order_relaxed);
+		sequence.store(start + 2, std::memory_order_release);
+	}
+
+	// Copies the published value into value and returns true, or returns false if a write overlapped the copy
+	bool TryRead(T& value) const
+	{
+		unsigned long long before = sequence.load(std::memory_order_acquire);
+		if (before & 1)
+			return false;
+
+		unsigned long long buffer[words];
+		for (std::size_t i = 0; i < words; i++)
+			buffer[i] = data[i].load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (sequence.load(std::memory_order_relaxed) != before)
+			return false;
+
+		std::memcpy(&value, buffer, sizeof(T));
+		return true;
+	}
+
+	// Returns the published value, retrying until a copy is not overlapped by a write
+	T Read() const
+	{
+		T value;
+		while (!TryRead(value))
+			std::this_thread::yield();
+		return value;
+	}
+
+	// Returns the number of completed writes
+	unsigned long long Version() const
+	{
+		return sequence.load(std::memory_order_acquire) / 2;
+	}
+};
+
+
+#endif
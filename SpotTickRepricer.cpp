@@ -0,0 +1,252 @@
+// SpotTickRepricer.cpp
+
+#include "SpotTickRepricer.hpp"
+#include "ThreadPool.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Creates an empty book whose Reprice computes the outputs selected by outputFlags
+SpotTickRepricer::SpotTickRepricer(int outputFlags) : contracts(), spots(), logSpots(), members(), results(), dirty(), dirtyList(), outputs(outputFlags)
+{
+}
+
+// Copy constructor
+SpotTickRepricer::SpotTickRepricer(const SpotTickRepricer& repricer) : contracts(repricer.contracts), spots(repricer.spots), logSpots(repricer.logSpots),
+	members(repricer.members), results(repricer.results), dirty(repricer.dirty), dirtyList(repricer.dirtyList), outputs(repricer.outputs)
+{
+}
+
+// Destructor
+SpotTickRepricer::~SpotTickRepricer()
+{
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the number of contracts in the book
+size_t SpotTickRepricer::Size() const
+{
+	return contracts.size();
+}
+
+// Returns the number of underlyings
+size_t SpotTickRepricer::UnderlyingCount() const
+{
+	return spots.size();
+}
+
+// Returns the number of contracts awaiting repricing
+size_t SpotTickRepricer::DirtyCount() const
+{
+	return dirtyList.size();
+}
+
+// Returns whether contract id awaits repricing
+bool SpotTickRepricer::IsDirty(size_t id) const
+{
+	return dirty[id] != 0;
+}
+
+// Returns the Option::Outputs flags computed by Reprice
+int SpotTickRepricer::GetOutputs() const
+{
+	return outputs;
+}
+
+// Returns the current spot of an underlying
+double SpotTickRepricer::GetSpot(size_t underlying) const
+{
+	return spots[underlying];
+}
+
+// Returns the outputs of contract id as of the last Reprice; the fields not selected by GetOutputs() are 0
+const OptionResults& SpotTickRepricer::GetResults(size_t id) const
+{
+	return results[id];
+}
+
+// Returns the outputs of every contract as of the last Reprice, indexed by contract id
+const vector<OptionResults>& SpotTickRepricer::GetResults() const
+{
+	return results;
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Adds an underlying with spot S and returns its index
+size_t SpotTickRepricer::AddUnderlying(double S)
+{
+	spots.push_back(S);
+	logSpots.push_back(log(S));
+	members.push_back(vector<size_t>());
+	return spots.size() - 1;
+}
+
+// Adds a copy of the terms of option, following the given underlying under the market data sig, r and b, and returns its id; throws
+// if underlying was not added
+size_t SpotTickRepricer::AddContract(const EuropeanOption& option, size_t underlying, double sig, double r, double b)
+{
+	if (underlying >= spots.size())
+		throw out_of_range("SpotTickRepricer::AddContract: unknown underlying");
+
+	Contract contract = Contract();
+	contract.phi = (option.GetType() == 'C') ? 1 : -1;
+	contract.K = option.GetStrike();
+	contract.T = option.GetTTM();
+	contract.terms.sig = sig;
+	contract.terms.r = r;
+	contract.terms.b = b;
+	contract.underlying = underlying;
+	contract.stale = true;
+
+	size_t id = contracts.size();
+	contracts.push_back(contract);
+	OptionResults empty = { 0, 0, 0, 0, 0 };
+	results.push_back(empty);
+	dirty.push_back(0);
+	members[underlying].push_back(id);
+	MarkDirty(id);
+
+	return id;
+}
+
+// Moves the spot of an underlying; the log is taken here, once for all of the underlying's contracts, and their cached terms are kept
+void SpotTickRepricer::SetSpot(size_t underlying, double S)
+{
+	if (S == spots[underlying])
+		return;
+
+	spots[underlying] = S;
+	logSpots[underlying] = log(S);
+
+	const vector<size_t>& ids = members[underlying];
+	for (size_t i = 0; i < ids.size(); i++)
+		MarkDirty(ids[i]);
+}
+
+// Changes the market data of contract id; every cached term depends on at least one of sig, r and b
+void SpotTickRepricer::SetMarketData(size_t id, double sig, double r, double b)
+{
+	Contract& contract = contracts[id];
+	contract.terms.sig = sig;
+	contract.terms.r = r;
+	contract.terms.b = b;
+	contract.stale = true;
+	MarkDirty(id);
+}
+
+// Changes the strike of contract id, which invalidates log(K) and K * exp(-r * T)
+void SpotTickRepricer::SetStrike(size_t id, double strike)
+{
+	contracts[id].K = strike;
+	contracts[id].stale = true;
+	MarkDirty(id);
+}
+
+// Changes the maturity of contract id, which invalidates every cached term but log(K)
+void SpotTickRepricer::SetTTM(size_t id, double timeTillMat)
+{
+	contracts[id].T = timeTillMat;
+	contracts[id].stale = true;
+	MarkDirty(id);
+}
+
+// Changes the outputs computed by Reprice; the cached terms are unaffected but every contract must be repriced
+void SpotTickRepricer::SetOutputs(int outputFlags)
+{
+	outputs = outputFlags;
+	for (size_t id = 0; id < contracts.size(); id++)
+		MarkDirty(id);
+}
+
+// Reprices the dirty contracts and returns how many were repriced
+size_t SpotTickRepricer::Reprice()
+{
+	size_t count = dirtyList.size();
+	RepriceRange(0, count);
+	dirtyList.clear();
+	return count;
+}
+
+// Reprices the dirty contracts on pool in chunks of grain contracts (0 for automatic); each contract appears once in dirtyList,
+// so the chunks write disjoint entries of contracts and results
+size_t SpotTickRepricer::Reprice(ThreadPool& pool, size_t grain)
+{
+	size_t count = dirtyList.size();
+	pool.ParallelFor(0, count, grain, [this](size_t first, size_t last) { RepriceRange(first, last); });
+	dirtyList.clear();
+	return count;
+}
+
+// Assignment operator
+SpotTickRepricer& SpotTickRepricer::operator = (const SpotTickRepricer& repricer)
+{
+	if (this != &repricer)
+	{
+		contracts = repricer.contracts;
+		spots = repricer.spots;
+		logSpots = repricer.logSpots;
+		members = repricer.members;
+		results = repricer.results;
+		dirty = repricer.dirty;
+		dirtyList = repricer.dirtyList;
+		outputs = repricer.outputs;
+	}
+
+	return *this;
+}
+
+
+// -------------------------------------------------------------------------- Private Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Queues contract id for repricing unless it is already queued
+void SpotTickRepricer::MarkDirty(size_t id)
+{
+	if (!dirty[id])
+	{
+		dirty[id] = 1;
+		dirtyList.push_back(id);
+	}
+}
+
+// Recomputes the S-independent terms of the Black-Scholes-Merton formulas for contract
+void SpotTickRepricer::Refresh(Contract& contract)
+{
+	EuropeanTerms<double>& terms = contract.terms;
+	terms.sqrtT = sqrt(contract.T);
+	terms.sigSqrtT = terms.sig * terms.sqrtT;
+	terms.carryFactor = exp((terms.b - terms.r) * contract.T);
+	terms.discountedStrike = contract.K * exp((-terms.r) * contract.T);
+	contract.logK = log(contract.K);
+	contract.drift = (terms.b + (pow(terms.sig, 2) / 2)) * contract.T;
+	contract.stale = false;
+}
+
+// Recomputes the outputs of contract id from the current spot of its underlying with EuropeanFormulas
+void SpotTickRepricer::RepriceContract(size_t id)
+{
+	Contract& contract = contracts[id];
+	if (contract.stale)
+		Refresh(contract);
+
+	size_t u = contract.underlying;
+	results[id] = EuropeanFormulas<double>::Evaluate(contract.phi, spots[u], (logSpots[u] - contract.logK) + contract.drift, contract.terms, outputs);
+	dirty[id] = 0;
+}
+
+// Reprices the contracts dirtyList[first, last)
+void SpotTickRepricer::RepriceRange(size_t first, size_t last)
+{
+	for (size_t i = first; i < last; i++)
+		RepriceContract(dirtyList[i]);
+}
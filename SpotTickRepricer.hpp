@@ -0,0 +1,100 @@
+// SpotTickRepricer.hpp
+//
+// The purpose of the SpotTickRepricer class is to keep the prices and Greeks of a book of Euro options current as market data
+// ticks in, when most ticks move only the spot of one underlying. Each contract references an underlying by index and carries its own
+// sig, r and b. Everything in the Black-Scholes-Merton formulas which does not depend on S -- log(K), sig * sqrt(T),
+// (b + sig^2 / 2) * T, exp((b - r) * T) and K * exp(-r * T), the EuropeanTerms of OptionKernels.hpp -- is cached per contract and
+// recomputed only after SetStrike, SetTTM or SetMarketData has changed one of its inputs. SetSpot takes the log of the new spot once
+// for the underlying and marks the underlying's contracts dirty; Reprice then revalues only the dirty contracts with
+// EuropeanFormulas::Evaluate, each at the cost of two normal CDFs (plus the PDF when gamma, theta or vega is requested) and a few
+// multiplications.
+//
+// d_1 is formed as (log(S) - log(K) + (b + sig^2 / 2) * T) / (sig * sqrt(T)), which differs from log(S / K) in EuropeanOption::d_1
+// by a rounding error or two. The tails of the normal CDF amplify that difference, so the results agree with EuropeanOption::Evaluate to
+// within about 1e-13 relative error rather than exactly.
+
+#ifndef SpotTickRepricer_H
+#define SpotTickRepricer_H
+
+#include "Option.hpp"
+#include "EuropeanOption.hpp"
+#include "OptionKernels.hpp"
+
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+class ThreadPool;
+
+class SpotTickRepricer
+{
+private:
+	// Parameters of a contract together with its cached S-independent terms
+	struct Contract
+	{
+		double phi;											// 1 for calls and -1 for puts
+		double K;											// Strike price
+		double T;											// Time till maturity
+		size_t underlying;									// Index of the underlying whose spot the contract follows
+		bool stale;											// Whether the cached terms below must be recomputed
+
+		EuropeanTerms<double> terms;						// sig, r and b, always current, and the cached S-independent terms
+		double logK;										// log(K)
+		double drift;										// (b + sig^2 / 2) * T
+	};
+
+	vector<Contract> contracts;								// The book
+	vector<double> spots;									// Current spot of each underlying
+	vector<double> logSpots;								// log of the current spot of each underlying
+	vector<vector<size_t> > members;						// members[u] lists the contracts following underlying u
+	vector<OptionResults> results;							// Last computed outputs of each contract
+	vector<char> dirty;										// Whether each contract awaits repricing
+	vector<size_t> dirtyList;								// The contracts awaiting repricing, each listed once
+	int outputs;											// Option::Outputs flags computed by Reprice
+
+	void MarkDirty(size_t id);								// Queues contract id for repricing
+	static void Refresh(Contract& contract);				// Recomputes the cached terms of contract
+	void RepriceContract(size_t id);						// Refreshes contract id if stale and recomputes its outputs
+	void RepriceRange(size_t first, size_t last);			// Reprices dirtyList[first, last)
+
+public:
+	// Constructors and Destructor
+	explicit SpotTickRepricer(int outputFlags = Option::AllOutputs);						// Creates an empty book computing outputFlags
+	SpotTickRepricer(const SpotTickRepricer& repricer);										// Copy constructor
+	virtual ~SpotTickRepricer();															// Destructor
+
+
+	// Accessor Functions
+	size_t Size() const;																	// Returns the number of contracts
+	size_t UnderlyingCount() const;															// Returns the number of underlyings
+	size_t DirtyCount() const;																// Returns the number of contracts awaiting repricing
+	bool IsDirty(size_t id) const;															// Returns whether contract id awaits repricing
+	int GetOutputs() const;																	// Returns the Option::Outputs flags computed by Reprice
+	double GetSpot(size_t underlying) const;												// Returns the current spot of an underlying
+	const OptionResults& GetResults(size_t id) const;										// Returns the outputs of contract id as of the last Reprice
+	const vector<OptionResults>& GetResults() const;										// Returns the outputs of every contract, indexed by contract id
+
+
+	// Modifier Functions
+	size_t AddUnderlying(double S);															// Adds an underlying with spot S and returns its index
+	size_t AddContract(const EuropeanOption& option, size_t underlying, double sig, double r, double b);
+																							// Adds option on the given underlying with its market data and
+																							// returns the contract id; the new contract starts dirty;
+																							// throws out_of_range if underlying was not added
+
+	void SetSpot(size_t underlying, double S);												// Moves the spot of an underlying and marks its contracts dirty;
+																							// the cached terms stay valid
+	void SetMarketData(size_t id, double sig, double r, double b);							// Changes the market data of contract id and invalidates its cache
+	void SetStrike(size_t id, double strike);												// Changes the strike of contract id and invalidates its cache
+	void SetTTM(size_t id, double timeTillMat);												// Changes the maturity of contract id and invalidates its cache
+	void SetOutputs(int outputFlags);														// Changes the outputs computed and marks every contract dirty
+
+	size_t Reprice();																		// Reprices the dirty contracts and returns how many there were
+	size_t Reprice(ThreadPool& pool, size_t grain = 0);										// As above, spreading the dirty contracts over pool
+
+	SpotTickRepricer& operator = (const SpotTickRepricer& repricer);						// Assignment operator
+
+};
+
+
+#endif
@@ -0,0 +1,99 @@
+// SpscRing.hpp
+//
+// The purpose of the SpscRing class template is to pass items from exactly one producer thread to exactly one consumer thread without
+// locks. The items live in a ring whose capacity is rounded up to a power of two; the producer owns the tail index and the consumer the
+// head index, and each publishes its index with a release store that the other reads with an acquire load. Each side also keeps a
+// private copy of the other's index and rereads the shared one only when that copy says the ring is full (producer) or empty
+// (consumer), so in steady state a push or a pop touches no cache line written by the other thread. The two indices are padded onto
+// separate cache lines for the same reason.
+//
+// Unlike BoundedQueue, TryPush and TryPop never wait: they return false when the ring is full or empty, and the caller decides whether
+// to spin, yield or drop. T must be default constructible and copy assignable.
+
+#ifndef SpscRing_H
+#define SpscRing_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+template <typename T>
+class SpscRing
+{
+private:
+	static const std::size_t cacheLine = 64;
+
+	std::atomic<std::size_t> head;												// Next slot to pop; written by the consumer only
+	char headPadding[cacheLine - sizeof(std::atomic<std::size_t>)];
+	std::size_t cachedTail;														// Consumer's copy of tail
+	char cachedTailPadding[cacheLine - sizeof(std::size_t)];
+	std::atomic<std::size_t> tail;												// Next slot to push; written by the producer only
+	char tailPadding[cacheLine - sizeof(std::atomic<std::size_t>)];
+	std::size_t cachedHead;														// Producer's copy of head
+	char cachedHeadPadding[cacheLine - sizeof(std::size_t)];
+	std::vector<T> slots;
+	std::size_t mask;															// slots.size() - 1
+
+	SpscRing(const SpscRing&);													// Not copyable
+	SpscRing& operator = (const SpscRing&);										// Not assignable
+
+	static std::size_t RoundUp(std::size_t n)									// Smallest power of two not below n, and at least 2
+	{
+		std::size_t capacity = 2;
+		while (capacity < n)
+			capacity <<= 1;
+		return capacity;
+	}
+
+public:
+	// Constructors and Destructor
+	explicit SpscRing(std::size_t minCapacity) : head(0), cachedTail(0), tail(0), cachedHead(0), slots(RoundUp(minCapacity)),
+		mask(RoundUp(minCapacity) - 1) {}
+
+	// Returns the number of items the ring can hold
+	std::size_t Capacity() const
+	{
+		return slots.size();
+	}
+
+	// Returns the number of items in the ring; exact only when neither thread is running
+	std::size_t SizeApprox() const
+	{
+		return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+	}
+
+	// Producer only; copies item into the ring, or returns false if the ring is full
+	bool TryPush(const T& item)
+	{
+		std::size_t position = tail.load(std::memory_order_relaxed);
+		if (position - cachedHead == slots.size())
+		{
+			cachedHead = head.load(std::memory_order_acquire);
+			if (position - cachedHead == slots.size())
+				return false;
+		}
+
+		slots[position & mask] = item;
+		tail.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer only; moves the oldest item into item, or returns false if the ring is empty
+	bool TryPop(T& item)
+	{
+		std::size_t position = head.load(std::memory_order_relaxed);
+		if (position == cachedTail)
+		{
+			cachedTail = tail.load(std::memory_order_acquire);
+			if (position == cachedTail)
+				return false;
+		}
+
+		item = slots[position & mask];
+		head.store(position + 1, std::memory_order_release);
+		return true;
+	}
+};
+
+
+#endif
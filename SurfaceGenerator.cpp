@@ -0,0 +1,405 @@
+// SurfaceGenerator.cpp
+
+#include "SurfaceGenerator.hpp"
+#include "ExactPricingMethodsGlobalFunctions.hpp"
+#include "Instrumentation.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+
+namespace
+{
+	const char surfaceMagic[8] = { 'B', 'S', 'M', 'S', 'U', 'R', 'F', 0 };
+	const unsigned int formatVersion = 1;
+	const unsigned int byteOrderMark = 0x01020304;
+	const size_t defaultTileSize = 64;
+
+	const int outputFlags[5] = { Option::PriceOutput, Option::DeltaOutput, Option::GammaOutput, Option::ThetaOutput, Option::VegaOutput };
+	const char* const outputNames[5] = { "price", "delta", "gamma", "theta", "vega" };
+
+	// Returns the position of the single flag output in outputFlags, or 5 if it is not one of them
+	size_t SurfaceIndex(int output)
+	{
+		return find(outputFlags, outputFlags + 5, output) - outputFlags;
+	}
+
+	// Writes count values to file as doubles, or as floats if singlePrecision
+	void WriteValues(ofstream& file, const double* values, size_t count, bool singlePrecision)
+	{
+		if (!singlePrecision)
+		{
+			file.write(reinterpret_cast<const char*>(values), count * sizeof(double));
+			return;
+		}
+
+		vector<float> narrowed(min(count, size_t(1) << 16));
+		for (size_t first = 0; first < count; first += narrowed.size())
+		{
+			size_t n = min(narrowed.size(), count - first);
+			for (size_t i = 0; i < n; i++)
+				narrowed[i] = static_cast<float>(values[first + i]);
+			file.write(reinterpret_cast<const char*>(narrowed.data()), n * sizeof(float));
+		}
+	}
+
+	// Reads count values stored as doubles, or as floats if valueBytes is 4, from file into values
+	bool ReadValues(ifstream& file, double* values, size_t count, unsigned long long valueBytes)
+	{
+		if (valueBytes == sizeof(double))
+			return !!file.read(reinterpret_cast<char*>(values), count * sizeof(double));
+
+		vector<float> narrowed(count);
+		if (!file.read(reinterpret_cast<char*>(narrowed.data()), count * sizeof(float)))
+			return false;
+		copy(narrowed.begin(), narrowed.end(), values);
+		return true;
+	}
+}
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor
+SurfaceGenerator::SurfaceGenerator() : type('C'), K(0), sig(0), r(0), b(0), tileRows(defaultTileSize), tileColumns(defaultTileSize),
+									   outputs(0)
+{
+}
+
+// Value constructor; a call (optionType 'C') or put (any other value) struck at strike, over the grid spot x timeTillMat
+SurfaceGenerator::SurfaceGenerator(const vector<double>& spot, const vector<double>& timeTillMat, char optionType, double strike,
+								   double vol, double rate, double carry) : spots(spot), maturities(timeTillMat),
+								   type((optionType == 'C') ? 'C' : 'P'), K(strike), sig(vol), r(rate), b(carry),
+								   tileRows(defaultTileSize), tileColumns(defaultTileSize), outputs(0)
+{
+}
+
+// Copy constructor
+SurfaceGenerator::SurfaceGenerator(const SurfaceGenerator& generator) : spots(generator.spots), maturities(generator.maturities),
+																		type(generator.type), K(generator.K), sig(generator.sig),
+																		r(generator.r), b(generator.b), tileRows(generator.tileRows),
+																		tileColumns(generator.tileColumns), outputs(generator.outputs)
+{
+	for (int c = 0; c < 5; c++)
+		surfaces[c] = generator.surfaces[c];
+}
+
+// Destructor
+SurfaceGenerator::~SurfaceGenerator()
+{
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the number of spots
+size_t SurfaceGenerator::Rows() const
+{
+	return spots.size();
+}
+
+// Returns the number of maturities
+size_t SurfaceGenerator::Columns() const
+{
+	return maturities.size();
+}
+
+// Returns the spot axis
+const vector<double>& SurfaceGenerator::GetSpots() const
+{
+	return spots;
+}
+
+// Returns the time till maturity axis
+const vector<double>& SurfaceGenerator::GetMaturities() const
+{
+	return maturities;
+}
+
+// Returns the Option::Outputs flags of the surfaces held
+int SurfaceGenerator::GetOutputs() const
+{
+	return outputs;
+}
+
+// Returns the surface of output; an empty vector if output is not a single Option::Outputs flag or was not generated
+const vector<double>& SurfaceGenerator::Surface(Option::Outputs output) const
+{
+	static const vector<double> none;
+	size_t c = SurfaceIndex(output);
+	return (c < 5) ? surfaces[c] : none;
+}
+
+// Returns the value of output at spots[row] and maturities[column]
+double SurfaceGenerator::Value(Option::Outputs output, size_t row, size_t column) const
+{
+	return Surface(output)[row * maturities.size() + column];
+}
+
+// Writes the surfaces held to path in the layout described in SurfaceGenerator.hpp
+bool SurfaceGenerator::WriteBinary(const string& path, bool singlePrecision) const
+{
+	SurfaceFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, surfaceMagic, sizeof(header.magic));
+	header.version = formatVersion;
+	header.byteOrder = byteOrderMark;
+	header.rows = spots.size();
+	header.columns = maturities.size();
+	header.outputs = outputs;
+	header.valueBytes = singlePrecision ? sizeof(float) : sizeof(double);
+	header.contract[0] = (type == 'C') ? 1 : -1;
+	header.contract[1] = K;
+	header.contract[2] = sig;
+	header.contract[3] = r;
+	header.contract[4] = b;
+
+	ofstream file(path.c_str(), ios::binary | ios::trunc);
+	if (!file)
+		return false;
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(spots.data()), spots.size() * sizeof(double));
+	file.write(reinterpret_cast<const char*>(maturities.data()), maturities.size() * sizeof(double));
+	for (int c = 0; c < 5; c++)
+	{
+		if (outputs & outputFlags[c])
+			WriteValues(file, surfaces[c].data(), surfaces[c].size(), singlePrecision);
+	}
+
+	file.close();
+	return !file.fail();
+}
+
+// Writes a header line and then one line per point, row by row: S, T and the selected outputs
+bool SurfaceGenerator::WriteCsv(const string& path, int digits) const
+{
+	ofstream file(path.c_str(), ios::binary | ios::trunc);
+	if (!file)
+		return false;
+
+	string header = "S,T";
+	for (int c = 0; c < 5; c++)
+	{
+		if (outputs & outputFlags[c])
+			header += string(",") + outputNames[c];
+	}
+	header += "\n";
+	file.write(header.data(), header.size());
+
+	size_t columns = maturities.size();
+	vector<char> text(columns * (7 * (digits + 9) + 1));
+	for (size_t i = 0; i < spots.size(); i++)
+	{
+		char* out = text.data();
+		for (size_t j = 0; j < columns; j++)
+		{
+			out = FormatDouble(spots[i], out, digits);
+			*out++ = ',';
+			out = FormatDouble(maturities[j], out, digits);
+			for (int c = 0; c < 5; c++)
+			{
+				if (outputs & outputFlags[c])
+				{
+					*out++ = ',';
+					out = FormatDouble(surfaces[c][i * columns + j], out, digits);
+				}
+			}
+			*out++ = '\n';
+		}
+		file.write(text.data(), out - text.data());
+	}
+
+	file.close();
+	return !file.fail();
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Evaluates the selected outputs at every point, tile by tile
+void SurfaceGenerator::Generate(int selectedOutputs)
+{
+	INSTRUMENT_SCOPE("SurfaceGenerator::Generate");
+	Prepare(selectedOutputs);
+	for (size_t tile = 0; tile < TileCount(); tile++)
+		GenerateTile(tile);
+}
+
+// Parallel version of Generate; the tiles are evaluated on pool. Every point is computed exactly as in the serial version.
+void SurfaceGenerator::Generate(int selectedOutputs, ThreadPool& pool)
+{
+	INSTRUMENT_SCOPE("SurfaceGenerator::Generate(pool)");
+	Prepare(selectedOutputs);
+	pool.ParallelFor(0, TileCount(), 1, [this](size_t first, size_t last)
+	{
+		for (size_t tile = first; tile < last; tile++)
+			GenerateTile(tile);
+	});
+}
+
+// Sets the size of the tiles; a size of 0 is taken as 1
+void SurfaceGenerator::SetTileSize(size_t rows, size_t columns)
+{
+	tileRows = max(rows, size_t(1));
+	tileColumns = max(columns, size_t(1));
+}
+
+// Reads a surface file written by WriteBinary
+bool SurfaceGenerator::ReadBinary(const string& path)
+{
+	ifstream file(path.c_str(), ios::binary | ios::ate);
+	if (!file)
+		return false;
+
+	unsigned long long size = file.tellg();
+	SurfaceFileHeader header;
+	file.seekg(0);
+	if (size < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		return false;
+	if (memcmp(header.magic, surfaceMagic, sizeof(header.magic)) != 0 || header.version != formatVersion || header.byteOrder != byteOrderMark)
+		return false;
+	if ((header.valueBytes != sizeof(double) && header.valueBytes != sizeof(float)) || (header.outputs & ~Option::AllOutputs) != 0)
+		return false;
+
+	unsigned long long points = header.rows * header.columns;
+	unsigned long long surfaceCount = 0;
+	for (int c = 0; c < 5; c++)
+		surfaceCount += (header.outputs & outputFlags[c]) ? 1 : 0;
+	if (size != sizeof(header) + (header.rows + header.columns) * sizeof(double) + surfaceCount * points * header.valueBytes)
+		return false;
+
+	vector<double> newSpots(header.rows), newMaturities(header.columns);
+	vector<double> newSurfaces[5];
+	if (!ReadValues(file, newSpots.data(), newSpots.size(), sizeof(double)) || !ReadValues(file, newMaturities.data(), newMaturities.size(), sizeof(double)))
+		return false;
+	for (int c = 0; c < 5; c++)
+	{
+		if (header.outputs & outputFlags[c])
+		{
+			newSurfaces[c].resize(points);
+			if (!ReadValues(file, newSurfaces[c].data(), points, header.valueBytes))
+				return false;
+		}
+	}
+
+	spots.swap(newSpots);
+	maturities.swap(newMaturities);
+	for (int c = 0; c < 5; c++)
+		surfaces[c].swap(newSurfaces[c]);
+	outputs = static_cast<int>(header.outputs);
+	type = (header.contract[0] == 1) ? 'C' : 'P';
+	K = header.contract[1];
+	sig = header.contract[2];
+	r = header.contract[3];
+	b = header.contract[4];
+	return true;
+}
+
+// Assignment operator
+SurfaceGenerator& SurfaceGenerator::operator = (const SurfaceGenerator& generator)
+{
+	if (this != &generator)
+	{
+		spots = generator.spots;
+		maturities = generator.maturities;
+		type = generator.type;
+		K = generator.K;
+		sig = generator.sig;
+		r = generator.r;
+		b = generator.b;
+		tileRows = generator.tileRows;
+		tileColumns = generator.tileColumns;
+		outputs = generator.outputs;
+		for (int c = 0; c < 5; c++)
+			surfaces[c] = generator.surfaces[c];
+	}
+
+	return *this;
+}
+
+
+// -------------------------------------------------------------------------- Private Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Sizes the surfaces of the selected outputs, releases the others, and computes the invariants of every row and column
+void SurfaceGenerator::Prepare(int selectedOutputs)
+{
+	outputs = selectedOutputs & Option::AllOutputs;
+	for (int c = 0; c < 5; c++)
+	{
+		if (outputs & outputFlags[c])
+			surfaces[c].resize(spots.size() * maturities.size());
+		else
+			vector<double>().swap(surfaces[c]);
+	}
+
+	logSpots.resize(spots.size());
+	for (size_t i = 0; i < spots.size(); i++)
+		logSpots[i] = log(spots[i]);
+
+	size_t columns = maturities.size();
+	columnTerms.resize(columns);
+	shifts.resize(columns);
+	double logK = log(K);
+	for (size_t j = 0; j < columns; j++)
+	{
+		double T = maturities[j];
+		EuropeanTerms<double>& terms = columnTerms[j];
+		terms.sig = sig;
+		terms.r = r;
+		terms.b = b;
+		terms.sqrtT = sqrt(T);
+		terms.sigSqrtT = sig * terms.sqrtT;
+		terms.carryFactor = exp((b - r) * T);
+		terms.discountedStrike = K * exp((-r) * T);
+		shifts[j] = (b + (sig * sig) / 2) * T - logK;
+	}
+}
+
+// Returns the number of tiles covering the grid
+size_t SurfaceGenerator::TileCount() const
+{
+	size_t rowTiles = (spots.size() + tileRows - 1) / tileRows;
+	size_t columnTiles = (maturities.size() + tileColumns - 1) / tileColumns;
+	return rowTiles * columnTiles;
+}
+
+// Evaluates the points of tile number tile with EuropeanFormulas, using the invariants of Prepare
+void SurfaceGenerator::GenerateTile(size_t tile)
+{
+	size_t columns = maturities.size();
+	size_t columnTiles = (columns + tileColumns - 1) / tileColumns;
+	size_t firstRow = (tile / columnTiles) * tileRows;
+	size_t lastRow = min(firstRow + tileRows, spots.size());
+	size_t firstColumn = (tile % columnTiles) * tileColumns;
+	size_t lastColumn = min(firstColumn + tileColumns, columns);
+
+	double phi = (type == 'C') ? 1 : -1;
+	for (size_t i = firstRow; i < lastRow; i++)
+	{
+		double S = spots[i];
+		double logS = logSpots[i];
+		for (size_t j = firstColumn; j < lastColumn; j++)
+		{
+			OptionResults result = EuropeanFormulas<double>::Evaluate(phi, S, logS + shifts[j], columnTerms[j], outputs);
+			size_t point = i * columns + j;
+			if (outputs & Option::PriceOutput)
+				surfaces[0][point] = result.price;
+			if (outputs & Option::DeltaOutput)
+				surfaces[1][point] = result.delta;
+			if (outputs & Option::GammaOutput)
+				surfaces[2][point] = result.gamma;
+			if (outputs & Option::ThetaOutput)
+				surfaces[3][point] = result.theta;
+			if (outputs & Option::VegaOutput)
+				surfaces[4][point] = result.vega;
+		}
+	}
+}
@@ -0,0 +1,123 @@
+// SurfaceGenerator.hpp
+//
+// The purpose of the SurfaceGenerator class is to evaluate the price and Greeks of one Euro option contract over a dense spot x time
+// till maturity grid, e.g. 2000 x 2000 points for a dashboard, and to write the resulting surfaces to a file. Evaluating such a grid
+// as separate EuropeanOption::Price calls recomputes log(S / K), sqrt(T), exp(-rT) and exp((b - r)T) at every point. Instead,
+// Generate computes everything that depends on the spot alone (S and log S) once per row, and everything that depends on the
+// maturity alone (sqrt T, sig sqrt T, the drift (b + sig^2/2)T - log K, exp(-rT) K and exp((b - r)T)) once per column, so each point
+// costs a few arithmetic operations plus the normal CDF/PDF evaluations its outputs need, with the formulas of EuropeanOption.
+//
+// The grid is walked in tiles of tileRows x tileColumns points, which keeps the column invariants of the tile and the rows of
+// every output surface being written in L1 cache, and the tiles are independent, so Generate can run them in parallel on a
+// ThreadPool. Each selected output is stored as a surface of its own, row by row: the value at spot i and maturity j is entry
+// i * Columns() + j.
+//
+// WriteBinary writes a surface file:
+//
+//		offset 0	SurfaceFileHeader (128 bytes)
+//					magic		8 bytes, "BSMSURF" followed by a 0 byte
+//					version		uint32, currently 1
+//					byteOrder	uint32, 0x01020304 written in the byte order of the machine that wrote the file
+//					rows		uint64, number of spots
+//					columns		uint64, number of maturities
+//					outputs		uint64, the Option::Outputs flags of the surfaces held
+//					valueBytes	uint64, 8 for double or 4 for float surface values
+//					contract	5 doubles: type (+1 call, -1 put), K, sig, r, b
+//					reserved	40 bytes of zeros
+//		128			rows doubles, the spot axis
+//					columns doubles, the maturity axis
+//					one surface per selected output, in the order price, delta, gamma, theta, vega, each rows * columns values
+//
+// Float values halve the size of the file at a relative precision of about 6 * 10^-8, ample for display. WriteCsv writes one line
+// per point, "S,T," followed by the selected outputs.
+
+#ifndef SurfaceGenerator_H
+#define SurfaceGenerator_H
+
+#include "Option.hpp"
+#include "OptionKernels.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+using namespace std;
+
+class ThreadPool;
+
+struct SurfaceFileHeader
+{
+	char magic[8];										// "BSMSURF"
+	unsigned int version;								// Format version
+	unsigned int byteOrder;								// 0x01020304 in the writer's byte order
+	unsigned long long rows;							// Number of spots
+	unsigned long long columns;							// Number of maturities
+	unsigned long long outputs;							// Option::Outputs flags of the surfaces held
+	unsigned long long valueBytes;						// 8 for double or 4 for float values
+	double contract[5];									// type, K, sig, r, b
+	unsigned long long reserved[5];						// Zero; pads the header to 128 bytes
+};
+
+class SurfaceGenerator
+{
+private:
+	vector<double> spots;								// Spot axis; one surface row per entry
+	vector<double> maturities;							// Time till maturity axis; one surface column per entry
+	char type;											// 'C' for calls and 'P' for puts
+	double K;											// Strike price
+	double sig;											// Volatility
+	double r;											// Interest rate
+	double b;											// Cost-of-carry
+	size_t tileRows;									// Rows of a tile
+	size_t tileColumns;									// Columns of a tile
+
+	int outputs;										// Option::Outputs flags of the surfaces last generated
+	vector<double> surfaces[5];							// Surfaces of price, delta, gamma, theta and vega; empty unless selected
+
+	// Invariants of the rows and columns, computed by Generate
+	vector<double> logSpots;							// log S per row
+	vector<EuropeanTerms<double> > columnTerms;			// The S-independent Black-Scholes-Merton terms per column
+	vector<double> shifts;								// (b + sig^2/2)T - log K per column
+
+	void Prepare(int selectedOutputs);					// Allocates the selected surfaces and computes the invariants
+	void GenerateTile(size_t tile);						// Evaluates tile number tile, tiles being numbered row by row
+	size_t TileCount() const;							// Returns the number of tiles
+
+public:
+	// Constructors and Destructor
+	SurfaceGenerator();																		// Default constructor; an empty grid
+	SurfaceGenerator(const vector<double>& spot, const vector<double>& timeTillMat, char optionType, double strike, double vol,
+					 double rate, double carry);											// Value constructor
+	SurfaceGenerator(const SurfaceGenerator& generator);									// Copy constructor
+	virtual ~SurfaceGenerator();															// Destructor
+
+
+	// Accessor Functions
+	size_t Rows() const;																	// Returns the number of spots
+	size_t Columns() const;																	// Returns the number of maturities
+	const vector<double>& GetSpots() const;													// Returns the spot axis
+	const vector<double>& GetMaturities() const;											// Returns the time till maturity axis
+	int GetOutputs() const;																	// Returns the Option::Outputs flags of the surfaces held
+	const vector<double>& Surface(Option::Outputs output) const;							// Returns the surface of output, which must be a single
+																							// flag; empty unless output was generated
+	double Value(Option::Outputs output, size_t row, size_t column) const;					// Returns the value of output at spots[row] and
+																							// maturities[column]
+
+	bool WriteBinary(const string& path, bool singlePrecision = false) const;				// Writes the surfaces held to a surface file at path,
+																							// as floats if singlePrecision; false on an I/O error
+	bool WriteCsv(const string& path, int digits = 10) const;								// Writes the surfaces held to a CSV file at path with the
+																							// given number of significant digits
+
+
+	// Modifier Functions
+	void Generate(int selectedOutputs);														// Evaluates the outputs selected by the Option::Outputs
+																							// flags at every point of the grid
+	void Generate(int selectedOutputs, ThreadPool& pool);									// Parallel version of the above, with identical results
+	void SetTileSize(size_t rows, size_t columns);											// Sets the size of the tiles, 64 x 64 by default
+	bool ReadBinary(const string& path);													// Replaces the grid, contract and surfaces with those of
+																							// a surface file; false if it is missing or malformed
+	SurfaceGenerator& operator = (const SurfaceGenerator& generator);						// Assignment operator
+
+};
+
+
+#endif
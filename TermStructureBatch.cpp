@@ -0,0 +1,240 @@
+// TermStructureBatch.cpp
+
+#include "TermStructureBatch.hpp"
+#include "Instrumentation.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Value constructor; indexes the nodes of contracts and starts from its own r, b and sig columns
+TermStructureBatch::TermStructureBatch(const OptionBatchView& contracts) : book(contracts), r(contracts.r, contracts.r + contracts.rows),
+																		   b(contracts.b, contracts.b + contracts.rows),
+																		   sig(contracts.sig, contracts.sig + contracts.rows)
+{
+	BuildNodes();
+}
+
+// Destructor
+TermStructureBatch::~TermStructureBatch()
+{
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the number of rows
+size_t TermStructureBatch::Size() const
+{
+	return book.rows;
+}
+
+// Returns the number of distinct Euro maturities
+size_t TermStructureBatch::MaturityCount() const
+{
+	return maturities.size();
+}
+
+// Returns the number of distinct (maturity, strike) nodes
+size_t TermStructureBatch::VolNodeCount() const
+{
+	return volNodeStrike.size();
+}
+
+// Returns the curves last set
+const MarketCurves& TermStructureBatch::GetMarket() const
+{
+	return market;
+}
+
+// Returns the book with the resolved r, b and sig columns
+OptionBatchView TermStructureBatch::View() const
+{
+	OptionBatchView view = { book.S, sig.data(), r.data(), b.data(), book.type, book.K, book.T, book.kind, book.rows };
+	return view;
+}
+
+// Returns the discount factor of the maturity of row, cached per maturity when a rate curve is set
+double TermStructureBatch::Discount(size_t row) const
+{
+	if (book.kind[row] != 'E')
+		return 0;
+
+	return market.rates ? nodeDiscounts[maturityOf[row]] : exp((-r[row]) * book.T[row]);
+}
+
+// Returns the carry factor of the maturity of row, cached per maturity when both a rate and a carry curve are set
+double TermStructureBatch::CarryFactor(size_t row) const
+{
+	if (book.kind[row] != 'E')
+		return 0;
+
+	return (market.rates && market.carries) ? nodeCarryFactors[maturityOf[row]] : exp((b[row] - r[row]) * book.T[row]);
+}
+
+// Writes the price of every row into result
+void TermStructureBatch::Price(double* result) const
+{
+	INSTRUMENT_SCOPE("TermStructureBatch::Price");
+	for (size_t i = 0; i < book.rows; i++)
+		result[i] = PriceRow(i);
+}
+
+// Writes the outputs selected by the Option::Outputs flags of every row into result
+void TermStructureBatch::Evaluate(int outputs, OptionResults* result) const
+{
+	INSTRUMENT_SCOPE("TermStructureBatch::Evaluate");
+	for (size_t i = 0; i < book.rows; i++)
+		result[i] = EvaluateRow(i, outputs);
+}
+
+// Parallel version of Price
+void TermStructureBatch::Price(double* result, ThreadPool& pool, size_t grain) const
+{
+	INSTRUMENT_SCOPE("TermStructureBatch::Price(pool)");
+	pool.ParallelFor(0, book.rows, grain, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; i++)
+			result[i] = PriceRow(i);
+	});
+}
+
+// Parallel version of Evaluate
+void TermStructureBatch::Evaluate(int outputs, OptionResults* result, ThreadPool& pool, size_t grain) const
+{
+	INSTRUMENT_SCOPE("TermStructureBatch::Evaluate(pool)");
+	pool.ParallelFor(0, book.rows, grain, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; i++)
+			result[i] = EvaluateRow(i, outputs);
+	});
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Looks every curve up once per node and gathers the cached values into the r, b and sig columns; the columns of curves that are
+// null are restored from the book
+void TermStructureBatch::SetMarket(const MarketCurves& curves)
+{
+	INSTRUMENT_SCOPE("TermStructureBatch::SetMarket");
+	market = curves;
+	size_t nodes = maturities.size() + 1;
+	nodeRates.assign(nodes, 0);
+	nodeCarries.assign(nodes, 0);
+	nodeDiscounts.assign(nodes, 0);
+	nodeCarryFactors.assign(nodes, 0);
+	nodeVols.assign(volNodeStrike.size(), 0);
+
+	for (size_t k = 0; k < maturities.size(); k++)
+	{
+		double T = maturities[k];
+		nodeRates[k] = market.rates ? market.rates->Rate(T) : 0;
+		nodeCarries[k] = market.carries ? market.carries->Rate(T) : 0;
+		nodeDiscounts[k] = exp((-nodeRates[k]) * T);
+		nodeCarryFactors[k] = exp((nodeCarries[k] - nodeRates[k]) * T);
+	}
+	nodeRates[nodes - 1] = market.rates ? market.rates->LongRate() : 0;
+	nodeCarries[nodes - 1] = market.carries ? market.carries->LongRate() : 0;
+
+	if (market.vols)
+	{
+		for (size_t v = 0; v < volNodeStrike.size(); v++)
+		{
+			size_t k = volNodeMaturity[v];
+			nodeVols[v] = (k < maturities.size()) ? market.vols->Vol(volNodeStrike[v], maturities[k]) : market.vols->LongVol(volNodeStrike[v]);
+		}
+	}
+
+	for (size_t i = 0; i < book.rows; i++)
+	{
+		r[i] = market.rates ? nodeRates[maturityOf[i]] : book.r[i];
+		b[i] = market.carries ? nodeCarries[maturityOf[i]] : book.b[i];
+		sig[i] = market.vols ? nodeVols[volNodeOf[i]] : book.sig[i];
+	}
+}
+
+
+// -------------------------------------------------------------------------- Private Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Finds the distinct maturities of the Euro rows and the distinct (maturity node, strike) pairs of all rows, and the nodes of every
+// row, by sorting and binary search
+void TermStructureBatch::BuildNodes()
+{
+	for (size_t i = 0; i < book.rows; i++)
+	{
+		if (book.kind[i] == 'E')
+			maturities.push_back(book.T[i]);
+	}
+	sort(maturities.begin(), maturities.end());
+	maturities.erase(unique(maturities.begin(), maturities.end()), maturities.end());
+	sqrtMaturities.resize(maturities.size());
+	for (size_t k = 0; k < maturities.size(); k++)
+		sqrtMaturities[k] = sqrt(maturities[k]);
+
+	maturityOf.resize(book.rows);
+	vector<pair<unsigned, double> > keys(book.rows);
+	for (size_t i = 0; i < book.rows; i++)
+	{
+		size_t k = (book.kind[i] == 'E') ? lower_bound(maturities.begin(), maturities.end(), book.T[i]) - maturities.begin() : maturities.size();
+		maturityOf[i] = unsigned(k);
+		keys[i] = make_pair(unsigned(k), book.K[i]);
+	}
+
+	vector<pair<unsigned, double> > nodes(keys);
+	sort(nodes.begin(), nodes.end());
+	nodes.erase(unique(nodes.begin(), nodes.end()), nodes.end());
+	for (size_t v = 0; v < nodes.size(); v++)
+	{
+		volNodeMaturity.push_back(nodes[v].first);
+		volNodeStrike.push_back(nodes[v].second);
+	}
+
+	volNodeOf.resize(book.rows);
+	for (size_t i = 0; i < book.rows; i++)
+		volNodeOf[i] = unsigned(lower_bound(nodes.begin(), nodes.end(), keys[i]) - nodes.begin());
+}
+
+// Gathers sig, r and b of Euro row row with the sqrt(T) of its maturity and its discount and carry factors, cached or not
+EuropeanTerms<double> TermStructureBatch::TermsOf(size_t row) const
+{
+	EuropeanTerms<double> terms;
+	terms.sig = sig[row];
+	terms.r = r[row];
+	terms.b = b[row];
+	terms.sqrtT = sqrtMaturities[maturityOf[row]];
+	terms.sigSqrtT = terms.sig * terms.sqrtT;
+	terms.carryFactor = CarryFactor(row);
+	terms.discountedStrike = book.K[row] * Discount(row);
+	return terms;
+}
+
+// Prices a Euro row from its terms and a PAMO row with its kernel, as OptionBatch::Price does
+double TermStructureBatch::PriceRow(size_t row) const
+{
+	return EvaluateRow(row, Option::PriceOutput).price;
+}
+
+// Evaluates a Euro row from its terms and a PAMO row with its kernel, as OptionBatch::Evaluate does
+OptionResults TermStructureBatch::EvaluateRow(size_t row, int outputs) const
+{
+	double S = book.S[row], K = book.K[row], T = book.T[row];
+	double phi = (book.type[row] == 1) ? 1 : -1;
+	if (book.kind[row] == 'E')
+	{
+		double x = log(S / K) + ((b[row] + (pow(sig[row], 2) / 2)) * T);
+		return EuropeanFormulas<double>::Evaluate(phi, S, x, TermsOf(row), outputs);
+	}
+
+	if (phi > 0)
+		return PerpetualAmericanKernel<CallOption>::Evaluate(S, sig[row], r[row], b[row], K, T, outputs);
+	return PerpetualAmericanKernel<PutOption>::Evaluate(S, sig[row], r[row], b[row], K, T, outputs);
+}
@@ -0,0 +1,113 @@
+// TermStructureBatch.hpp
+//
+// The purpose of the TermStructureBatch class is to price a book against term structures -- an interest rate curve, a cost-of-carry
+// curve and a volatility surface -- instead of the flat r, b and sig of each row. Looking the curves up row by row would repeat the
+// same interpolation for every contract sharing an expiry (and, for the volatility, a strike), so on construction the batch finds the
+// distinct maturities of its Euro rows and the distinct (maturity, strike) pairs of all its rows, and records for every row which of
+// these nodes it uses. SetMarket then looks each curve up once per node, caching the zero rate, zero carry, discount factor exp(-rT)
+// and carry factor exp((b - r)T) of every maturity and the volatility of every (maturity, strike) pair, and gathers them into r, b and
+// sig columns of its own. View() combines those columns with the S, type, K, T and kind columns of the book into an ordinary
+// OptionBatchView, so the book can be handed to any batch engine -- OptionBatch, PartitionedBatch, BumpEngine, ScenarioEngine --
+// with the effective flat parameters of each row: R(T), B(T) and the surface volatility at (K, T). With these, the Black-Scholes-Merton
+// formulas discount and carry each Euro row exactly along the curves.
+//
+// The batch's own Price and Evaluate go further and price the Euro rows with EuropeanFormulas (see OptionKernels.hpp) from the
+// cached sqrt(T), discount factor and carry factor of their maturity, so that each row costs one logarithm and the normal CDF/PDF
+// values rather than also a square root and two exponentials. The cached factors are exactly those the kernels would compute from
+// the resolved columns, so the results are those of the OptionBatch evaluators on View(). A discount factor is only shared by a
+// maturity when a rate curve is set, and a carry factor when both a rate and a carry curve are; otherwise they are computed per row.
+//
+// PAMO rows have no maturity; they take the long end of each curve (YieldCurve::LongRate and VolSurface::LongVol) and share one
+// node. A curve left null in MarketCurves is not used, and the corresponding column of the book is taken as is.
+//
+// The curves are immutable snapshots (see YieldCurve.hpp) held by shared_ptr, so many batches, on any number of threads, can price
+// against the same market without copying it, and a new market is installed with another call to SetMarket. The batch keeps a view
+// of the book, not a copy, so the book must outlive it; SetMarket must not run concurrently with the evaluators of the same batch.
+
+#ifndef TermStructureBatch_H
+#define TermStructureBatch_H
+
+#include "OptionBatch.hpp"
+#include "OptionKernels.hpp"
+#include "VolSurface.hpp"
+#include "YieldCurve.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+using namespace std;
+
+class ThreadPool;
+
+// The market a TermStructureBatch prices against; any member may be null, in which case the book's own column is used
+struct MarketCurves
+{
+	shared_ptr<const YieldCurve> rates;					// Interest rate curve
+	shared_ptr<const YieldCurve> carries;				// Cost-of-carry curve
+	shared_ptr<const VolSurface> vols;					// Volatility surface
+};
+
+class TermStructureBatch
+{
+private:
+	OptionBatchView book;								// Contracts; not owned
+	MarketCurves market;								// Curves the columns below were resolved from
+
+	vector<double> maturities;							// Distinct maturities of the Euro rows, increasing; node maturities.size() is the
+														// perpetual node shared by PAMO rows
+	vector<double> sqrtMaturities;						// sqrt(T) of every Euro maturity
+	vector<unsigned> maturityOf;						// Maturity node of every row
+	vector<unsigned> volNodeMaturity;					// Maturity node of every (maturity, strike) node, in increasing order of
+	vector<double> volNodeStrike;						// maturity node and then strike
+	vector<unsigned> volNodeOf;							// (maturity, strike) node of every row
+
+	vector<double> nodeRates;							// Cached per maturity node: R(T)
+	vector<double> nodeCarries;							// B(T)
+	vector<double> nodeDiscounts;						// exp(-R(T) T); 0 for the perpetual node
+	vector<double> nodeCarryFactors;					// exp((B(T) - R(T)) T); 0 for the perpetual node
+	vector<double> nodeVols;							// Cached per (maturity, strike) node: the surface volatility
+
+	AlignedColumn r;									// Resolved interest rate of every row
+	AlignedColumn b;									// Resolved cost-of-carry of every row
+	AlignedColumn sig;									// Resolved volatility of every row
+
+	void BuildNodes();									// Finds the maturity and (maturity, strike) nodes of the book
+	EuropeanTerms<double> TermsOf(size_t row) const;	// Returns the S-independent terms of Euro row row from the node caches
+	double PriceRow(size_t row) const;					// Returns the price of row row
+	OptionResults EvaluateRow(size_t row, int outputs) const;	// Returns the outputs of row row selected by outputs
+
+	TermStructureBatch(const TermStructureBatch&);				// Not copyable
+	TermStructureBatch& operator = (const TermStructureBatch&);	// Not assignable
+
+public:
+	// Constructors and Destructor
+	explicit TermStructureBatch(const OptionBatchView& contracts);	// Indexes the rows of contracts, which must outlive the batch; until
+																	// SetMarket is called, every row keeps its own r, b and sig
+	virtual ~TermStructureBatch();									// Destructor
+
+
+	// Accessor Functions
+	size_t Size() const;											// Returns the number of rows
+	size_t MaturityCount() const;									// Returns the number of distinct Euro maturities
+	size_t VolNodeCount() const;									// Returns the number of distinct (maturity, strike) nodes, the
+																	// perpetual ones included
+	const MarketCurves& GetMarket() const;							// Returns the curves last set
+	OptionBatchView View() const;									// Returns the book with the resolved r, b and sig columns
+	double Discount(size_t row) const;								// Returns the cached discount factor of the maturity of row; 0 for PAMOs
+	double CarryFactor(size_t row) const;							// Returns the cached carry factor of the maturity of row; 0 for PAMOs
+
+	// Each evaluator writes Size() results into result in row order, with exactly the values the OptionBatch evaluator of the same
+	// name gives for View(); the overloads taking a ThreadPool split the rows into chunks of grain rows (0 for automatic).
+	void Price(double* result) const;
+	void Evaluate(int outputs, OptionResults* result) const;
+	void Price(double* result, ThreadPool& pool, size_t grain = 0) const;
+	void Evaluate(int outputs, OptionResults* result, ThreadPool& pool, size_t grain = 0) const;
+
+
+	// Modifier Functions
+	void SetMarket(const MarketCurves& curves);						// Looks up every curve of curves once per node and resolves the r, b
+																	// and sig columns
+};
+
+
+#endif
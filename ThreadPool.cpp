@@ -0,0 +1,210 @@
+// ThreadPool.cpp
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+
+// State shared by the chunks of one ParallelFor call; it lives on the caller's stack for the duration of the call
+struct ThreadPool::Job
+{
+	const function<void(size_t, size_t)>* body;								// Loop body
+	size_t remaining;														// Chunks not yet completed; guarded by lock
+	exception_ptr error;													// First exception thrown by body; guarded by lock
+	mutex lock;
+	condition_variable finished;											// Signalled when remaining reaches 0
+};
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Starts threadCount persistent workers. The last entry of queues is shared by threads outside the pool which call ParallelFor.
+ThreadPool::ThreadPool(size_t threadCount) : pendingChunks(0), stopping(false)
+{
+	if (threadCount == 0)
+	{
+		size_t hardware = thread::hardware_concurrency();
+		threadCount = (hardware > 1) ? hardware - 1 : 0;
+	}
+
+	for (size_t i = 0; i <= threadCount; i++)
+		queues.push_back(unique_ptr<WorkQueue>(new WorkQueue));
+
+	for (size_t i = 0; i < threadCount; i++)
+		threads.push_back(thread(&ThreadPool::WorkerLoop, this, i));
+}
+
+// Destructor; the workers drain any queued chunks before exiting
+ThreadPool::~ThreadPool()
+{
+	{
+		lock_guard<mutex> guard(sleepLock);
+		stopping = true;
+	}
+	wakeUp.notify_all();
+
+	for (size_t i = 0; i < threads.size(); i++)
+		threads[i].join();
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the number of worker threads, not counting callers of ParallelFor
+size_t ThreadPool::Size() const
+{
+	return threads.size();
+}
+
+// Splits [begin, end) into chunks of at most grain indices and runs body over every chunk. The chunks are dealt out to the
+// worker deques in contiguous runs, one run per deque, and the calling thread then works through its own share and steals
+// from the others until none remain, after which it waits for the chunks still running on other threads to complete.
+void ThreadPool::ParallelFor(size_t begin, size_t end, size_t grain, const function<void(size_t, size_t)>& body)
+{
+	if (begin >= end)
+		return;
+
+	size_t count = end - begin;
+	if (grain == 0)
+		grain = max<size_t>(1, count / (8 * queues.size()));
+	size_t chunkCount = (count + grain - 1) / grain;
+
+	// Nothing to share: run the chunks in order on the calling thread
+	if (threads.empty() || chunkCount == 1)
+	{
+		for (size_t first = begin; first < end; first += grain)
+			body(first, min(first + grain, end));
+		return;
+	}
+
+	Job job;
+	job.body = &body;
+	job.remaining = chunkCount;
+
+	size_t queueCount = queues.size();
+	for (size_t q = 0; q < queueCount; q++)
+	{
+		size_t firstChunk = (q * chunkCount) / queueCount;
+		size_t lastChunk = ((q + 1) * chunkCount) / queueCount;
+		lock_guard<mutex> guard(queues[q]->lock);
+		for (size_t c = firstChunk; c < lastChunk; c++)
+		{
+			Chunk chunk = { begin + c * grain, min(begin + (c + 1) * grain, end), &job };
+			queues[q]->chunks.push_back(chunk);
+		}
+	}
+
+	pendingChunks += chunkCount;
+	{
+		lock_guard<mutex> guard(sleepLock);
+	}
+	wakeUp.notify_all();
+
+	Chunk chunk;
+	while (TakeChunk(queueCount - 1, chunk))
+		RunChunk(chunk);
+
+	unique_lock<mutex> guard(job.lock);
+	while (job.remaining > 0)
+	{
+		// Chunks of this loop are still running elsewhere; help with any other queued work before sleeping
+		guard.unlock();
+		if (TakeChunk(queueCount - 1, chunk))
+		{
+			RunChunk(chunk);
+			guard.lock();
+			continue;
+		}
+		guard.lock();
+		if (job.remaining > 0)
+			job.finished.wait(guard);
+	}
+
+	if (job.error)
+		rethrow_exception(job.error);
+}
+
+// Returns a process-wide pool; it is created on first use and joined at program exit
+ThreadPool& ThreadPool::Default()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+
+// ------------------------------------------------------------------------ Private Functions -------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Takes the chunk at the front of queue home if there is one, and otherwise steals the chunk at the back of the first other
+// non-empty queue. Returns false if every queue is empty.
+bool ThreadPool::TakeChunk(size_t home, Chunk& chunk)
+{
+	size_t queueCount = queues.size();
+	for (size_t k = 0; k < queueCount; k++)
+	{
+		WorkQueue& queue = *queues[(home + k) % queueCount];
+		lock_guard<mutex> guard(queue.lock);
+		if (queue.chunks.empty())
+			continue;
+
+		if (k == 0)
+		{
+			chunk = queue.chunks.front();
+			queue.chunks.pop_front();
+		}
+		else
+		{
+			chunk = queue.chunks.back();
+			queue.chunks.pop_back();
+		}
+		pendingChunks--;
+		return true;
+	}
+
+	return false;
+}
+
+// Runs one chunk and records its completion. The count is decremented under the job's lock so that the caller of ParallelFor,
+// which only returns after observing remaining == 0 under the same lock, cannot destroy the job while it is still being touched.
+void ThreadPool::RunChunk(const Chunk& chunk)
+{
+	Job* job = chunk.job;
+	exception_ptr error;
+	try
+	{
+		(*job->body)(chunk.begin, chunk.end);
+	}
+	catch (...)
+	{
+		error = current_exception();
+	}
+
+	lock_guard<mutex> guard(job->lock);
+	if (error && !job->error)
+		job->error = error;
+	if (--job->remaining == 0)
+		job->finished.notify_all();
+}
+
+// Body of worker thread index: run chunks while there are any, sleep while there are none, and exit once the pool is stopping
+// and no queued chunks remain
+void ThreadPool::WorkerLoop(size_t index)
+{
+	Chunk chunk;
+	for (;;)
+	{
+		if (TakeChunk(index, chunk))
+		{
+			RunChunk(chunk);
+			continue;
+		}
+
+		unique_lock<mutex> guard(sleepLock);
+		while (!stopping && pendingChunks.load() == 0)
+			wakeUp.wait(guard);
+		if (stopping && pendingChunks.load() == 0)
+			return;
+	}
+}
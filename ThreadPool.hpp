@@ -0,0 +1,77 @@
+// ThreadPool.hpp
+//
+// The purpose of the ThreadPool class is to run data-parallel loops, such as the ParamMatrix and OptionBatch evaluators, on a fixed
+// set of persistent worker threads. A loop over [begin, end) is cut into chunks of at most grain indices; the chunks are dealt out
+// in contiguous runs to one deque per worker, each worker takes chunks from the front of its own deque, and a worker whose deque is
+// empty steals from the back of another worker's deque. This keeps neighbouring chunks on the same thread when the work is even and
+// rebalances automatically when it is not (for example when Euro rows, PAMO rows and divided-difference rows are interleaved). The
+// thread that calls ParallelFor works on the loop as well rather than blocking, so nested and concurrent loops cannot deadlock.
+
+#ifndef ThreadPool_H
+#define ThreadPool_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+class ThreadPool
+{
+private:
+	struct Job;
+
+	struct Chunk
+	{
+		size_t begin;														// First index of the chunk
+		size_t end;															// One past the last index of the chunk
+		Job* job;															// Loop the chunk belongs to
+	};
+
+	struct WorkQueue
+	{
+		mutex lock;
+		deque<Chunk> chunks;
+	};
+
+	vector<thread> threads;													// Persistent worker threads
+	vector<unique_ptr<WorkQueue> > queues;									// One work-stealing deque per worker, plus one for outside callers
+	atomic<size_t> pendingChunks;											// Number of chunks queued but not yet taken by any thread
+	mutex sleepLock;														// Guards the sleeping of idle workers
+	condition_variable wakeUp;												// Signalled when chunks are queued or the pool shuts down
+	bool stopping;															// Set by the destructor to make the workers exit
+
+	bool TakeChunk(size_t home, Chunk& chunk);								// Takes a chunk from queue home or, failing that, steals one
+	void RunChunk(const Chunk& chunk);										// Runs a chunk and marks it complete
+	void WorkerLoop(size_t index);											// Body of each worker thread
+
+	ThreadPool(const ThreadPool&);											// Not copyable
+	ThreadPool& operator = (const ThreadPool&);								// Not assignable
+
+public:
+	// Constructors and Destructor
+	explicit ThreadPool(size_t threadCount = 0);							// Starts threadCount workers; 0 means one fewer than the number of
+																			// hardware threads, since callers of ParallelFor also do work
+	~ThreadPool();															// Finishes queued work and joins the workers
+
+
+	// Accessor Functions
+	size_t Size() const;													// Returns the number of worker threads
+
+	void ParallelFor(size_t begin, size_t end, size_t grain,
+					 const function<void(size_t, size_t)>& body);			// Calls body(chunkBegin, chunkEnd) for chunks of at most grain indices
+																			// covering [begin, end) and returns once all have completed. A grain
+																			// of 0 picks about eight chunks per thread. The first exception thrown
+																			// by body is rethrown in the caller after the loop has finished
+
+	static ThreadPool& Default();											// Returns a process-wide pool created with threadCount = 0
+};
+
+
+#endif
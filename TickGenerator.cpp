@@ -0,0 +1,151 @@
+// TickGenerator.cpp
+
+#include "TickGenerator.hpp"
+#include "ExactPricingMethodsGlobalFunctions.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <random>
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor; one underlying at 100 with 20% volatility ticking about once a second, seed 1
+TickGenerator::TickGenerator() : initialSpots(1, 100), sig(0.2), dt(1.0 / (252 * 6.5 * 3600)), seed(1)
+{
+}
+
+// Value constructor; spots holds the initial spot of each underlying
+TickGenerator::TickGenerator(const vector<double>& spots, double vol, double tickInterval, unsigned long long randomSeed)
+	: initialSpots(spots), sig(vol), dt(tickInterval), seed(randomSeed)
+{
+}
+
+// Copy constructor
+TickGenerator::TickGenerator(const TickGenerator& generator) : initialSpots(generator.initialSpots), sig(generator.sig), dt(generator.dt),
+	seed(generator.seed)
+{
+}
+
+// Destructor
+TickGenerator::~TickGenerator()
+{
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the spots before the first tick
+const vector<double>& TickGenerator::GetInitialSpots() const
+{
+	return initialSpots;
+}
+
+// Returns the first count ticks of the sequence; the result depends only on the generator's settings, never on earlier calls
+vector<MarketTick> TickGenerator::Generate(size_t count) const
+{
+	vector<MarketTick> ticks;
+	if (initialSpots.empty())
+		return ticks;
+
+	mt19937_64 generator(seed);
+	uniform_int_distribution<size_t> pick(0, initialSpots.size() - 1);
+	normal_distribution<double> shock(0, 1);
+
+	vector<double> spots(initialSpots);
+	double drift = -0.5 * sig * sig * dt;
+	double diffusion = sig * sqrt(dt);
+
+	ticks.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		size_t underlying = pick(generator);
+		spots[underlying] *= exp(drift + diffusion * shock(generator));
+
+		ticks[i].sequence = i;
+		ticks[i].underlying = underlying;
+		ticks[i].spot = spots[underlying];
+		ticks[i].stamp = 0;
+	}
+
+	return ticks;
+}
+
+
+// ------------------------------------------------------------------------- Modifier Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Assignment operator
+TickGenerator& TickGenerator::operator = (const TickGenerator& generator)
+{
+	if (this != &generator)
+	{
+		initialSpots = generator.initialSpots;
+		sig = generator.sig;
+		dt = generator.dt;
+		seed = generator.seed;
+	}
+
+	return *this;
+}
+
+
+// -------------------------------------------------------------------------- Static Functions ------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Writes one "sequence,underlying,spot" line per tick, with spots to 17 significant digits so that they are read back exactly
+bool TickGenerator::Save(const string& path, const vector<MarketTick>& ticks)
+{
+	ofstream file(path.c_str(), ios::binary);
+	if (!file)
+		return false;
+
+	char number[32];
+	for (size_t i = 0; i < ticks.size(); i++)
+	{
+		char* end = FormatDouble(ticks[i].spot, number, 17);
+		file << ticks[i].sequence << ',' << ticks[i].underlying << ',';
+		file.write(number, end - number);
+		file << '\n';
+	}
+
+	return static_cast<bool>(file);
+}
+
+// Reads the ticks written by Save into ticks, replacing its contents
+bool TickGenerator::Load(const string& path, vector<MarketTick>& ticks)
+{
+	ifstream file(path.c_str(), ios::binary);
+	if (!file)
+		return false;
+
+	ticks.clear();
+	string line;
+	while (getline(file, line))
+	{
+		if (line.empty())
+			continue;
+
+		const char* first = line.c_str();
+		const char* last = first + line.size();
+		double fields[3];
+		for (int k = 0; k < 3; k++)
+		{
+			if (!ParseDouble(first, last, fields[k]))
+				return false;
+			if (k < 2)
+			{
+				if (first == last || *first != ',')
+					return false;
+				first++;
+			}
+		}
+
+		MarketTick tick = { static_cast<unsigned long long>(fields[0]), static_cast<unsigned long long>(fields[1]), fields[2], 0 };
+		ticks.push_back(tick);
+	}
+
+	return true;
+}
@@ -0,0 +1,55 @@
+// TickGenerator.hpp
+//
+// The purpose of the TickGenerator class is to stand in for a market-data feed when running the RealTimePricer locally. Each tick
+// picks an underlying uniformly at random and moves its spot by one step of a driftless geometric Brownian motion,
+//		S <- S * exp(-sig^2 * dt / 2 + sig * sqrt(dt) * Z),		Z ~ N(0, 1),
+// where dt is the time between two ticks of the same underlying on average. All randomness comes from a 64-bit Mersenne Twister seeded
+// with the seed given to the constructor, so the same generator settings always produce the same tick sequence and a run can be
+// replayed exactly. Sequences can also be saved to and loaded from a text file, one "sequence,underlying,spot" line per tick, so that a
+// recorded or externally produced feed can be replayed as well.
+
+#ifndef TickGenerator_H
+#define TickGenerator_H
+
+#include "RealTimePricer.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+using namespace std;
+
+class TickGenerator
+{
+private:
+	vector<double> initialSpots;						// Spot of each underlying before the first tick
+	double sig;											// Volatility of every underlying
+	double dt;											// Average time, in years, between two ticks of the same underlying
+	unsigned long long seed;							// Seed of the random number generator
+
+public:
+	// Constructors and Destructor
+	TickGenerator();																		// Default constructor; one underlying at 100
+	TickGenerator(const vector<double>& spots, double vol, double tickInterval, unsigned long long randomSeed);
+																							// Value constructor
+	TickGenerator(const TickGenerator& generator);											// Copy constructor
+	virtual ~TickGenerator();																// Destructor
+
+
+	// Accessor Functions
+	const vector<double>& GetInitialSpots() const;											// Returns the spots before the first tick
+	vector<MarketTick> Generate(size_t count) const;										// Returns the first count ticks of the sequence
+
+
+	// Modifier Functions
+	TickGenerator& operator = (const TickGenerator& generator);								// Assignment operator
+
+
+	// Static Functions
+	static bool Save(const string& path, const vector<MarketTick>& ticks);					// Writes ticks to path; returns false on failure
+	static bool Load(const string& path, vector<MarketTick>& ticks);						// Reads ticks written by Save; returns false if the
+																							// file cannot be opened or holds a malformed line
+
+};
+
+
+#endif
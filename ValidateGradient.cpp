@@ -0,0 +1,221 @@
+// ValidateGradient.cpp
+//
+// The purpose of this program is to check the reverse mode price gradients of EuropeanOption and PerpetualAmericanOption (see
+// Option::Gradient) against the closed-form Greeks, and against finite differences where there is no closed form, over a sweep of
+// Euro and PAMO calls and puts. For Euro rows dS, dSig and -dT are compared with Delta, Vega and Theta and dr and db with Rho and
+// CarryRho; gamma is compared with an extrapolated centered difference of dS, since a gradient holds no second derivatives. For
+// PAMO rows dS is compared with Delta and gamma as above, and dSig, dr and db with Richardson-extrapolated differences from a
+// BumpEngine. dK is compared with an extrapolated difference of the price in K for both. The program prints the largest absolute
+// and relative error of each comparison and the time per row of OptionBatch::Gradient against OptionBatch::Price.
+//
+// Usage: ValidateGradient [--floor=x] [--repeats=n]
+
+#include "BumpEngine.hpp"
+#include "EuropeanOption.hpp"
+#include "OptionBatch.hpp"
+#include "PerpetualAmericanOption.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Largest absolute and relative differences of one comparison
+struct Comparison
+{
+	string name;
+	size_t rows;
+	double maxAbs;
+	double maxRel;
+};
+
+// Folds the difference between value and reference into comparison; relative differences only count where |reference| >= floor
+void Accumulate(Comparison& comparison, double value, double reference, double relativeFloor)
+{
+	double absolute = fabs(value - reference);
+	comparison.rows++;
+	if (!(absolute <= comparison.maxAbs))
+		comparison.maxAbs = absolute;
+	if (fabs(reference) >= relativeFloor && !(absolute / fabs(reference) <= comparison.maxRel))
+		comparison.maxRel = absolute / fabs(reference);
+}
+
+// Builds the parameter sweep; PAMO rows are kept only where their formulas hold, as in ValidatePrecision
+OptionBatch SweepBook()
+{
+	const double spots[] = { 50, 70, 85, 95, 100, 105, 115, 130, 150 };
+	const double vols[] = { 0.05, 0.1, 0.2, 0.3, 0.5, 0.8 };
+	const double rates[] = { 0.0, 0.01, 0.05, 0.1 };
+	const double carries[] = { -0.03, 0.0, 0.03 };				// Added to the rate; b = r + carry
+	const double maturities[] = { 0.02, 0.1, 0.25, 0.5, 1, 2, 5 };
+	const char types[] = { 'C', 'P' };
+
+	OptionBatch book;
+	for (double S : spots)
+		for (double sig : vols)
+			for (double r : rates)
+				for (double carry : carries)
+					for (char type : types)
+					{
+						double b = r + carry;
+						for (double T : maturities)
+							book.PushEuropean(S, sig, r, b, type, 100, T);
+						if ((type == 'C') ? (r <= b) : (r <= 0))
+							continue;
+
+						double y = (type == 'C') ? PerpetualAmericanOption::y_1(sig, r, b) : PerpetualAmericanOption::y_2(sig, r, b);
+						double boundary = 100 * y / (y - 1);
+						if ((type == 'C') ? (S < boundary) : (S > boundary))
+							book.PushPerpetual(S, sig, r, b, type, 100);
+					}
+	return book;
+}
+
+// Returns a copy of the rows of view with every spot price multiplied by 1 + shift
+OptionBatch ShiftSpot(const OptionBatchView& view, double shift)
+{
+	OptionBatch shifted;
+	for (size_t i = 0; i < view.rows; i++)
+	{
+		char type = (view.type[i] == 1) ? 'C' : 'P';
+		double S = view.S[i] * (1 + shift);
+		if (view.kind[i] == 'E')
+			shifted.PushEuropean(S, view.sig[i], view.r[i], view.b[i], type, view.K[i], view.T[i]);
+		else
+			shifted.PushPerpetual(S, view.sig[i], view.r[i], view.b[i], type, view.K[i]);
+	}
+	return shifted;
+}
+
+// Returns the derivative of the price of row i of view with respect to K, by a centered difference extrapolated from the steps h
+// and h/2
+double StrikeDifference(const OptionBatchView& view, size_t i)
+{
+	char type = (view.type[i] == 1) ? 'C' : 'P';
+	double K = view.K[i];
+	double h = 1e-3 * K;
+	double price[4];
+	const double strikes[4] = { K + h, K - h, K + h / 2, K - h / 2 };
+	for (int j = 0; j < 4; j++)
+	{
+		if (view.kind[i] == 'E')
+			price[j] = EuropeanOption(type, strikes[j], view.T[i]).Price(view.S[i], view.sig[i], view.r[i], view.b[i]);
+		else
+			price[j] = PerpetualAmericanOption(type, strikes[j]).Price(view.S[i], view.sig[i], view.r[i], view.b[i]);
+	}
+
+	double coarse = (price[0] - price[1]) / (2 * h);
+	double fine = (price[2] - price[3]) / h;
+	return (4 * fine - coarse) / 3;
+}
+
+// Returns the mean time in nanoseconds per row of calling evaluate(view, result) repeats times
+template <typename Result, typename Function>
+double TimePerRow(const OptionBatchView& view, size_t repeats, Function evaluate)
+{
+	vector<Result> result(view.rows);
+	typedef chrono::steady_clock Clock;
+	Clock::time_point start = Clock::now();
+	for (size_t i = 0; i < repeats; i++)
+		evaluate(view, result.data());
+	return chrono::duration<double, nano>(Clock::now() - start).count() / (repeats * view.rows);
+}
+
+int main(int argc, char* argv[])
+{
+	double relativeFloor = 1e-6;
+	size_t repeats = 20;
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg.compare(0, 8, "--floor=") == 0)
+			relativeFloor = strtod(arg.c_str() + 8, 0);
+		else if (arg.compare(0, 10, "--repeats=") == 0)
+			repeats = strtoul(arg.c_str() + 10, 0, 10);
+		else
+			cerr << "Ignoring unrecognized argument " << arg << endl;
+	}
+	if (repeats == 0)
+		repeats = 1;
+
+	OptionBatch book = SweepBook();
+	OptionBatchView view = book.View();
+	vector<PriceGradient> gradients = book.Gradient();
+	vector<OptionResults> results = book.Evaluate();
+	vector<HigherOrderResults> higherResults = book.EvaluateHigherOrder(Option::RhoOutput | Option::CarryRhoOutput);
+
+	// Finite difference references: gamma from dS at S +/- h and S +/- h/2, and the PAMO sensitivities to sig, r and b from a bump
+	// engine
+	vector<PriceGradient> shifted[4];
+	const double shifts[4] = { 1e-3, -1e-3, 5e-4, -5e-4 };
+	for (int j = 0; j < 4; j++)
+		shifted[j] = ShiftSpot(view, shifts[j]).Gradient();
+
+	BumpEngine engine;
+	engine.AddFirst(BumpEngine::Vol);
+	engine.AddFirst(BumpEngine::Rate);
+	engine.AddFirst(BumpEngine::Carry);
+	vector<double> bumped = engine.Compute(view);
+
+	enum { Price, Delta, Gamma, Vega, Theta, Rho, CarryRho, Strike, PamoPrice, PamoDelta, PamoGamma, PamoVol, PamoRate, PamoCarry,
+		   PamoStrike, ComparisonCount };
+	const char* names[ComparisonCount] = { "Euro price vs Price", "Euro dS vs Delta", "Euro gamma (dS) vs Gamma", "Euro dSig vs Vega",
+										   "Euro -dT vs Theta", "Euro dr vs Rho", "Euro db vs CarryRho", "Euro dK vs differences",
+										   "PAMO price vs Price", "PAMO dS vs Delta", "PAMO gamma (dS) vs Gamma", "PAMO dSig vs differences",
+										   "PAMO dr vs differences", "PAMO db vs differences", "PAMO dK vs differences" };
+	vector<Comparison> comparisons(ComparisonCount);
+	for (int c = 0; c < ComparisonCount; c++)
+		comparisons[c] = Comparison{ names[c], 0, 0, 0 };
+
+	for (size_t i = 0; i < view.rows; i++)
+	{
+		const PriceGradient& g = gradients[i];
+		double h = 1e-3 * view.S[i];
+		double coarse = (shifted[0][i].dS - shifted[1][i].dS) / (2 * h);
+		double fine = (shifted[2][i].dS - shifted[3][i].dS) / h;
+		double gammaDifference = (4 * fine - coarse) / 3;
+		if (view.kind[i] == 'E')
+		{
+			Accumulate(comparisons[Price], g.price, results[i].price, relativeFloor);
+			Accumulate(comparisons[Delta], g.dS, results[i].delta, relativeFloor);
+			Accumulate(comparisons[Gamma], gammaDifference, results[i].gamma, relativeFloor);
+			Accumulate(comparisons[Vega], g.dSig, results[i].vega, relativeFloor);
+			Accumulate(comparisons[Theta], -g.dT, results[i].theta, relativeFloor);
+			Accumulate(comparisons[Rho], g.dr, higherResults[i].rho, relativeFloor);
+			Accumulate(comparisons[CarryRho], g.db, higherResults[i].carryRho, relativeFloor);
+			Accumulate(comparisons[Strike], g.dK, StrikeDifference(view, i), relativeFloor);
+		}
+		else
+		{
+			Accumulate(comparisons[PamoPrice], g.price, results[i].price, relativeFloor);
+			Accumulate(comparisons[PamoDelta], g.dS, results[i].delta, relativeFloor);
+			Accumulate(comparisons[PamoGamma], gammaDifference, results[i].gamma, relativeFloor);
+			Accumulate(comparisons[PamoVol], g.dSig, bumped[i * 3 + 0], relativeFloor);
+			Accumulate(comparisons[PamoRate], g.dr, bumped[i * 3 + 1], relativeFloor);
+			Accumulate(comparisons[PamoCarry], g.db, bumped[i * 3 + 2], relativeFloor);
+			Accumulate(comparisons[PamoStrike], g.dK, StrikeDifference(view, i), relativeFloor);
+		}
+	}
+
+	cout << "rows " << view.rows << ", relative floor " << relativeFloor << endl << endl;
+	cout << setw(28) << "comparison" << setw(8) << "rows" << setw(16) << "max abs" << setw(16) << "max rel" << endl;
+	for (int c = 0; c < ComparisonCount; c++)
+	{
+		cout << setw(28) << comparisons[c].name << setw(8) << comparisons[c].rows << setw(16) << setprecision(4) << comparisons[c].maxAbs
+			 << setw(16) << comparisons[c].maxRel << endl;
+	}
+
+	void (*price)(const OptionBatchView&, double*) = &OptionBatch::Price;
+	void (*gradient)(const OptionBatchView&, PriceGradient*) = &OptionBatch::Gradient;
+	double priceTime = TimePerRow<double>(view, repeats, price);
+	double gradientTime = TimePerRow<PriceGradient>(view, repeats, gradient);
+	cout << endl << "ns per row: Price " << setprecision(4) << priceTime << ", Gradient " << gradientTime << " ("
+		 << gradientTime / priceTime << " prices)" << endl;
+
+	return 0;
+}
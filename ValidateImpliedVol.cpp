@@ -0,0 +1,162 @@
+// ValidateImpliedVol.cpp
+//
+// The purpose of this program is to check the status and the round trip of ImpliedVolSolver over a sweep of Euro calls and puts.
+// Every row is priced at a known volatility and the quote is solved for again, from the Corrado-Miller guess (cold) and from a start
+// 10% off the known volatility (warm), by the default solver and by one whose search limit --cap lies inside the sweep. For each solver
+// the program checks that
+//		1. every ImpliedVolConverged result lies in (0, cap] and reprices the quote to within the price tolerance,
+//		2. every quote whose volatility is below the cap and that lies strictly between the no-arbitrage bounds converges, and
+//		3. every quote whose volatility is above the cap is reported as ImpliedVolAboveMaximum with vol equal to the cap,
+// and prints the count of each status, the largest repricing error and volatility error of the converged rows and the mean number of
+// evaluations per solve. The program returns 1 when any check fails.
+//
+// Usage: ValidateImpliedVol [--cap=x]
+
+#include "EuropeanOption.hpp"
+#include "ImpliedVolatility.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const double volTolerance = 1e-10;
+const double priceTolerance = 1e-12;
+const int maxIterations = 50;
+
+// One priced row of the sweep
+struct Quote
+{
+	EuropeanOption option;
+	double S, r, b;
+	double sig;													// Volatility the quote was priced at
+	double quote;
+	bool invertible;											// Whether the quote lies strictly between the no-arbitrage bounds
+};
+
+// Results of one solver over the sweep
+struct Summary
+{
+	size_t statusCounts[5];
+	size_t failures;
+	double maxPriceError;
+	double maxVolError;
+	size_t evaluations;
+	size_t solves;
+};
+
+// Builds the parameter sweep; the volatilities run past the cap of the second solver
+vector<Quote> SweepQuotes()
+{
+	const double spots[] = { 50, 70, 85, 95, 100, 105, 115, 130, 150 };
+	const double vols[] = { 0.05, 0.1, 0.2, 0.3, 0.5, 0.8, 1.2, 1.8, 2.5, 3, 4 };
+	const double rates[] = { 0.0, 0.01, 0.05, 0.1 };
+	const double carries[] = { -0.03, 0.0, 0.03 };				// Added to the rate; b = r + carry
+	const double maturities[] = { 0.02, 0.1, 0.25, 0.5, 1, 2, 5 };
+	const char types[] = { 'C', 'P' };
+
+	vector<Quote> quotes;
+	for (double S : spots)
+		for (double sig : vols)
+			for (double r : rates)
+				for (double carry : carries)
+					for (char type : types)
+						for (double T : maturities)
+						{
+							double b = r + carry;
+							EuropeanOption option(type, 100, T);
+							double price = option.Price(S, sig, r, b);
+							double discountedSpot = S * exp((b - r) * T);
+							double discountedStrike = 100 * exp(-r * T);
+							double lower = (type == 'C') ? (discountedSpot - discountedStrike) : (discountedStrike - discountedSpot);
+							double upper = (type == 'C') ? discountedSpot : discountedStrike;
+							bool invertible = (price > ((lower > 0) ? lower : 0)) && (price < upper);
+							quotes.push_back(Quote{ option, S, r, b, sig, price, invertible });
+						}
+	return quotes;
+}
+
+// Solves every quote with solver, cold or warm, checks the outcome against the known volatility and returns the summary
+Summary Check(const ImpliedVolSolver& solver, double cap, const vector<Quote>& quotes, bool warm)
+{
+	Summary summary = { { 0, 0, 0, 0, 0 }, 0, 0, 0, 0, 0 };
+	for (const Quote& q : quotes)
+	{
+		ImpliedVolResult result = solver.Solve(q.option, q.quote, q.S, q.r, q.b, warm ? 1.1 * q.sig : 0);
+		summary.statusCounts[result.status]++;
+		summary.evaluations += result.iterations;
+		summary.solves++;
+
+		bool passed = true;
+		if (result.status == ImpliedVolConverged)
+		{
+			double priceError = fabs(q.option.Price(q.S, result.vol, q.r, q.b) - q.quote);
+			passed = (result.vol > 0) && (result.vol <= cap) && (priceError <= priceTolerance * ((q.quote > 1) ? q.quote : 1));
+			if (!(priceError <= summary.maxPriceError))
+				summary.maxPriceError = priceError;
+			if (!(fabs(result.vol - q.sig) <= summary.maxVolError))
+				summary.maxVolError = fabs(result.vol - q.sig);
+		}
+		else if (q.invertible && q.sig < cap)
+			passed = false;
+		if (q.sig > cap && q.invertible)
+			passed = passed && (result.status == ImpliedVolAboveMaximum) && (result.vol == cap);
+
+		if (!passed)
+		{
+			summary.failures++;
+			if (summary.failures <= 5)
+			{
+				cout << "  FAIL " << q.option.GetType() << " S " << q.S << " K 100 T " << q.option.GetTTM() << " r " << q.r << " b " << q.b
+					 << " sig " << q.sig << ": status " << result.status << ", vol " << setprecision(10) << result.vol << " after "
+					 << result.iterations << " evaluations" << setprecision(6) << endl;
+			}
+		}
+	}
+	return summary;
+}
+
+int main(int argc, char* argv[])
+{
+	double cap = 2;
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg.compare(0, 6, "--cap=") == 0)
+			cap = strtod(arg.c_str() + 6, 0);
+		else
+			cerr << "Ignoring unrecognized argument " << arg << endl;
+	}
+
+	vector<Quote> quotes = SweepQuotes();
+	ImpliedVolSolver solvers[2] = { ImpliedVolSolver(), ImpliedVolSolver(volTolerance, priceTolerance, maxIterations, cap) };
+	const double caps[2] = { 10, cap };
+
+	cout << "rows " << quotes.size() << endl << endl;
+	cout << setw(18) << "solver" << setw(11) << "converged" << setw(10) << "below" << setw(10) << "above" << setw(10) << "max iter"
+		 << setw(10) << "failures" << setw(14) << "max price err" << setw(14) << "max vol err" << setw(12) << "evals/solve" << endl;
+
+	size_t failures = 0;
+	for (int s = 0; s < 2; s++)
+	{
+		for (int warm = 0; warm < 2; warm++)
+		{
+			Summary summary = Check(solvers[s], caps[s], quotes, warm != 0);
+			failures += summary.failures;
+
+			string name = string("cap ") + to_string(caps[s]).substr(0, 4) + (warm ? " warm" : " cold");
+			cout << setw(18) << name << setw(11) << summary.statusCounts[ImpliedVolConverged] << setw(10)
+				 << summary.statusCounts[ImpliedVolBelowIntrinsic] << setw(10) << summary.statusCounts[ImpliedVolAboveMaximum] << setw(10)
+				 << summary.statusCounts[ImpliedVolMaxIterations] << setw(10) << summary.failures << setw(14) << setprecision(3)
+				 << summary.maxPriceError << setw(14) << summary.maxVolError << setw(12) << double(summary.evaluations) / summary.solves
+				 << setprecision(6) << endl;
+		}
+	}
+
+	cout << endl << (failures == 0 ? "PASS" : "FAIL") << endl;
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+// ValidatePrecision.cpp
+//
+// The purpose of this program is to report the accuracy and speed of the single and mixed precision modes of PrecisionBatch against
+// double precision. The book is a sweep over spot, volatility, rate, cost-of-carry and maturity of Euro calls and puts, plus PAMO calls
+// and puts over spot, volatility, rate and cost-of-carry wherever their formulas hold: r > b for calls and r > 0 for puts, with the
+// spot short of the optimal exercise boundary. For each mode the program prints the largest absolute and relative error of every
+// output together with the row where it occurs, and the time per row of a full Evaluate in each mode. Relative errors are taken over
+// rows whose double value is at least --floor in size.
+//
+// Usage: ValidatePrecision [--floor=x] [--repeats=n]
+
+#include "PrecisionBatch.hpp"
+#include "PerpetualAmericanOption.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Builds the parameter sweep
+OptionBatch SweepBook()
+{
+	const double spots[] = { 50, 70, 85, 95, 100, 105, 115, 130, 150 };
+	const double vols[] = { 0.05, 0.1, 0.2, 0.3, 0.5, 0.8 };
+	const double rates[] = { 0.0, 0.01, 0.05, 0.1 };
+	const double carries[] = { -0.03, 0.0, 0.03 };				// Added to the rate; b = r + carry
+	const double maturities[] = { 0.02, 0.1, 0.25, 0.5, 1, 2, 5 };
+	const char types[] = { 'C', 'P' };
+
+	OptionBatch book;
+	for (double S : spots)
+		for (double sig : vols)
+			for (double r : rates)
+				for (double carry : carries)
+					for (char type : types)
+					{
+						double b = r + carry;
+						for (double T : maturities)
+							book.PushEuropean(S, sig, r, b, type, 100, T);
+						if ((type == 'C') ? (r <= b) : (r <= 0))
+							continue;
+
+						double y = (type == 'C') ? PerpetualAmericanOption::y_1(sig, r, b) : PerpetualAmericanOption::y_2(sig, r, b);
+						double boundary = 100 * y / (y - 1);
+						if ((type == 'C') ? (S < boundary) : (S > boundary))
+							book.PushPerpetual(S, sig, r, b, type, 100);
+					}
+	return book;
+}
+
+// Returns the mean time in nanoseconds per row of evaluating every output of batch
+double TimePerRow(const PrecisionBatch& batch, size_t repeats)
+{
+	vector<OptionResults> results(batch.Size());
+	typedef chrono::steady_clock Clock;
+	Clock::time_point start = Clock::now();
+	for (size_t i = 0; i < repeats; i++)
+		batch.Evaluate(Option::AllOutputs, results.data());
+	return chrono::duration<double, nano>(Clock::now() - start).count() / (repeats * batch.Size());
+}
+
+int main(int argc, char* argv[])
+{
+	double relativeFloor = 1e-6;
+	size_t repeats = 20;
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg.compare(0, 8, "--floor=") == 0)
+			relativeFloor = strtod(arg.c_str() + 8, 0);
+		else if (arg.compare(0, 10, "--repeats=") == 0)
+			repeats = strtoul(arg.c_str() + 10, 0, 10);
+		else
+			cerr << "Ignoring unrecognized argument " << arg << endl;
+	}
+	if (repeats == 0)
+		repeats = 1;
+
+	OptionBatch book = SweepBook();
+	OptionBatchView view = book.View();
+	const char* outputNames[5] = { "price", "delta", "gamma", "theta", "vega" };
+	const PrecisionBatch::Precision modes[3] = { PrecisionBatch::DoublePrecision, PrecisionBatch::SinglePrecision, PrecisionBatch::MixedPrecision };
+
+	cout << "rows " << view.rows << ", relative floor " << relativeFloor << endl;
+	for (int m = 1; m < 3; m++)
+	{
+		PrecisionErrors errors = PrecisionBatch::Compare(view, modes[m], Option::AllOutputs, relativeFloor);
+		cout << endl << PrecisionBatch::Name(modes[m]) << " vs double" << endl;
+		cout << setw(8) << "output" << setw(16) << "max abs" << setw(8) << "row" << setw(16) << "max rel" << setw(8) << "row" << endl;
+		for (int j = 0; j < 5; j++)
+		{
+			cout << setw(8) << outputNames[j] << setw(16) << setprecision(4) << errors.maxAbs[j] << setw(8) << errors.worstAbsRow[j]
+				 << setw(16) << errors.maxRel[j] << setw(8) << errors.worstRelRow[j] << endl;
+		}
+	}
+
+	cout << endl << "Evaluate, ns per row" << endl;
+	for (int m = 0; m < 3; m++)
+		cout << setw(8) << PrecisionBatch::Name(modes[m]) << setw(16) << setprecision(4) << TimePerRow(PrecisionBatch(view, modes[m]), repeats) << endl;
+
+	return 0;
+}
@@ -0,0 +1,144 @@
+// VolSurface.cpp
+
+#include "VolSurface.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+
+namespace
+{
+	// Returns the indices of nodes in the order that sorts them increasingly, keeping equal nodes in their given order
+	vector<size_t> SortedOrder(const vector<double>& nodes)
+	{
+		vector<size_t> order(nodes.size());
+		for (size_t i = 0; i < order.size(); i++)
+			order[i] = i;
+		stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return nodes[a] < nodes[b]; });
+		return order;
+	}
+}
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor
+VolSurface::VolSurface() : strikes(1, 0.0), maturities(1, 1.0), vols(1, 0.2)
+{
+}
+
+// Value constructor; a single node holding flatVol
+VolSurface::VolSurface(double flatVol) : strikes(1, 0.0), maturities(1, 1.0), vols(1, flatVol)
+{
+}
+
+// Value constructor; termVols[j] at timeNodes[j] for every strike, with the nodes sorted by maturity
+VolSurface::VolSurface(const vector<double>& timeNodes, const vector<double>& termVols) : strikes(1, 0.0)
+{
+	vector<pair<double, double> > nodes;
+	for (size_t j = 0; j < timeNodes.size(); j++)
+		nodes.push_back(make_pair(timeNodes[j], (j < termVols.size()) ? termVols[j] : 0.0));
+	sort(nodes.begin(), nodes.end());
+	if (nodes.empty())														// No nodes; the default surface
+		nodes.push_back(make_pair(1.0, 0.2));
+
+	for (size_t j = 0; j < nodes.size(); j++)
+	{
+		maturities.push_back(nodes[j].first);
+		vols.push_back(nodes[j].second);
+	}
+}
+
+// Value constructor; gridVols is resized to strikeNodes.size() * timeNodes.size() entries, and an empty grid is the default surface.
+// The strike and maturity nodes are sorted, and the grid permuted with them
+VolSurface::VolSurface(const vector<double>& strikeNodes, const vector<double>& timeNodes, const vector<double>& gridVols)
+{
+	vector<double> grid(gridVols);
+	grid.resize(strikeNodes.size() * timeNodes.size());
+	if (grid.empty())
+	{
+		strikes.assign(1, 0.0);
+		maturities.assign(1, 1.0);
+		vols.assign(1, 0.2);
+		return;
+	}
+
+	vector<size_t> strikeOrder = SortedOrder(strikeNodes);
+	vector<size_t> timeOrder = SortedOrder(timeNodes);
+	for (size_t i = 0; i < strikeOrder.size(); i++)
+		strikes.push_back(strikeNodes[strikeOrder[i]]);
+	for (size_t j = 0; j < timeOrder.size(); j++)
+	{
+		maturities.push_back(timeNodes[timeOrder[j]]);
+		for (size_t i = 0; i < strikeOrder.size(); i++)
+			vols.push_back(grid[timeOrder[j] * strikeNodes.size() + strikeOrder[i]]);
+	}
+}
+
+// Copy constructor
+VolSurface::VolSurface(const VolSurface& surface) : strikes(surface.strikes), maturities(surface.maturities), vols(surface.vols)
+{
+}
+
+// Destructor
+VolSurface::~VolSurface()
+{
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the strike nodes
+const vector<double>& VolSurface::GetStrikes() const
+{
+	return strikes;
+}
+
+// Returns the maturity nodes
+const vector<double>& VolSurface::GetMaturities() const
+{
+	return maturities;
+}
+
+// Returns the volatility at strike K and maturity T; total variance is interpolated linearly between the maturity nodes around T
+double VolSurface::Vol(double K, double T) const
+{
+	if (!(T > maturities.front()))
+		return StrikeSlice(0, K);
+	if (T >= maturities.back())
+		return StrikeSlice(maturities.size() - 1, K);
+
+	size_t j = upper_bound(maturities.begin(), maturities.end(), T) - maturities.begin();
+	double before = StrikeSlice(j - 1, K);
+	double after = StrikeSlice(j, K);
+	double weight = (T - maturities[j - 1]) / (maturities[j] - maturities[j - 1]);
+	double variance = (before * before) * maturities[j - 1] + weight * ((after * after) * maturities[j] - (before * before) * maturities[j - 1]);
+	return sqrt(max(variance, 0.0) / T);
+}
+
+// Returns the volatility at strike K beyond the last maturity node
+double VolSurface::LongVol(double K) const
+{
+	return StrikeSlice(maturities.size() - 1, K);
+}
+
+
+// -------------------------------------------------------------------------- Private Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the volatility at maturity node j interpolated linearly in K, and held flat beyond the first and last strike nodes
+double VolSurface::StrikeSlice(size_t j, double K) const
+{
+	const double* slice = &vols[j * strikes.size()];
+	if (!(K > strikes.front()))
+		return slice[0];
+	if (K >= strikes.back())
+		return slice[strikes.size() - 1];
+
+	size_t i = upper_bound(strikes.begin(), strikes.end(), K) - strikes.begin();
+	double weight = (K - strikes[i - 1]) / (strikes[i] - strikes[i - 1]);
+	return slice[i - 1] + weight * (slice[i] - slice[i - 1]);
+}
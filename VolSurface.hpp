@@ -0,0 +1,55 @@
+// VolSurface.hpp
+//
+// The purpose of the VolSurface class is to replace the flat volatility sig of a book by implied volatilities that depend on the
+// strike and the maturity. A surface is given by its volatilities on a grid of strikes K_0 < ... < K_m and maturities T_0 < ... <
+// T_n. Vol(K, T) is found in two steps: at each of the two maturity nodes around T the volatility is interpolated linearly in K, and
+// the total variances sig^2 T of those two nodes are then interpolated linearly in T, which keeps forward variances non-negative
+// whenever the node variances increase with maturity. Outside the grid the volatility is held flat: at the nearest strike node in K,
+// and at the first or last maturity node in T. A volatility term structure with no skew is a surface with a single strike.
+//
+// Like YieldCurve, a VolSurface is an immutable snapshot that any number of pricing threads can share without locking.
+
+#ifndef VolSurface_H
+#define VolSurface_H
+
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+class VolSurface
+{
+private:
+	vector<double> strikes;								// Strike nodes, increasing
+	vector<double> maturities;							// Maturity nodes, increasing
+	vector<double> vols;								// Volatility at maturity j and strike i in entry j * strikes.size() + i
+
+	double StrikeSlice(size_t j, double K) const;		// Returns the volatility at maturity node j interpolated in K
+
+	VolSurface& operator = (const VolSurface&);			// Not assignable; a snapshot never changes
+
+public:
+	// Constructors and Destructor
+	VolSurface();																			// Default constructor; a flat 0.2 surface
+	explicit VolSurface(double flatVol);													// A flat surface
+	VolSurface(const vector<double>& timeNodes, const vector<double>& termVols);			// A term structure with no skew; the
+																							// nodes are sorted by maturity
+	VolSurface(const vector<double>& strikeNodes, const vector<double>& timeNodes, const vector<double>& gridVols);
+																							// A surface with gridVols[j * strikeNodes.size() + i]
+																							// at strikeNodes[i] and timeNodes[j]; the nodes are
+																							// sorted, permuting gridVols with them, and missing
+																							// entries of gridVols are 0
+	VolSurface(const VolSurface& surface);													// Copy constructor
+	virtual ~VolSurface();																	// Destructor
+
+
+	// Accessor Functions
+	const vector<double>& GetStrikes() const;												// Returns the strike nodes
+	const vector<double>& GetMaturities() const;											// Returns the maturity nodes
+	double Vol(double K, double T) const;													// Returns the volatility at strike K and maturity T
+	double LongVol(double K) const;															// Returns the volatility at strike K beyond the last
+																							// maturity node, used for perpetual options
+
+};
+
+
+#endif
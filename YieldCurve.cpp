@@ -0,0 +1,97 @@
+// YieldCurve.cpp
+
+#include "YieldCurve.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+
+// --------------------------------------------------------------------- Constructors and Destructor ------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Default constructor
+YieldCurve::YieldCurve() : times(1, 1.0), rates(1, 0.0), logDiscounts(1, 0.0)
+{
+}
+
+// Value constructor; a single node holding flatRate
+YieldCurve::YieldCurve(double flatRate) : times(1, 1.0), rates(1, flatRate), logDiscounts(1, flatRate)
+{
+}
+
+// Value constructor; the nodes (nodeTimes[i], zeroRates[i]) are sorted by time, and a curve with no nodes is a zero curve
+YieldCurve::YieldCurve(const vector<double>& nodeTimes, const vector<double>& zeroRates)
+{
+	vector<pair<double, double> > nodes;
+	for (size_t i = 0; i < min(nodeTimes.size(), zeroRates.size()); i++)
+		nodes.push_back(make_pair(nodeTimes[i], zeroRates[i]));
+	sort(nodes.begin(), nodes.end());
+	if (nodes.empty())
+		nodes.push_back(make_pair(1.0, 0.0));
+
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		times.push_back(nodes[i].first);
+		rates.push_back(nodes[i].second);
+		logDiscounts.push_back(nodes[i].first * nodes[i].second);
+	}
+}
+
+// Copy constructor
+YieldCurve::YieldCurve(const YieldCurve& curve) : times(curve.times), rates(curve.rates), logDiscounts(curve.logDiscounts)
+{
+}
+
+// Destructor
+YieldCurve::~YieldCurve()
+{
+}
+
+
+// ------------------------------------------------------------------------- Accessor Functions -----------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// Returns the number of nodes
+size_t YieldCurve::Size() const
+{
+	return times.size();
+}
+
+// Returns the node times
+const vector<double>& YieldCurve::GetTimes() const
+{
+	return times;
+}
+
+// Returns the zero rates at the nodes
+const vector<double>& YieldCurve::GetRates() const
+{
+	return rates;
+}
+
+// Returns the zero rate R(T): that of the first node for T up to the first node time, that of the last node for T beyond the last
+// node time, and R(T) T interpolated linearly between the nodes in between
+double YieldCurve::Rate(double T) const
+{
+	if (!(T > times.front()))
+		return rates.front();
+	if (T >= times.back())
+		return rates.back();
+
+	size_t i = upper_bound(times.begin(), times.end(), T) - times.begin();
+	double weight = (T - times[i - 1]) / (times[i] - times[i - 1]);
+	return (logDiscounts[i - 1] + weight * (logDiscounts[i] - logDiscounts[i - 1])) / T;
+}
+
+// Returns the discount factor D(T) = exp(-R(T) T)
+double YieldCurve::Discount(double T) const
+{
+	return exp(-Rate(T) * T);
+}
+
+// Returns the zero rate beyond the last node, used for perpetual options
+double YieldCurve::LongRate() const
+{
+	return rates.back();
+}
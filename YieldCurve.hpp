@@ -0,0 +1,53 @@
+// YieldCurve.hpp
+//
+// The purpose of the YieldCurve class is to replace the flat interest rate r, or the flat cost-of-carry b, of a book by a term
+// structure. A curve is given by its zero rates R_i, continuously compounded, at increasing times T_i, and interpolates linearly in
+// R(T) T = -log D(T) between nodes, i.e. with a constant forward rate between consecutive nodes. Before the first node and after the
+// last the zero rate is held flat. Pricing a Euro option of maturity T with the flat rate R(T) discounts its payoff exactly by D(T),
+// so Rate(T) is the r (or b) to hand to the Black-Scholes-Merton formulas for that maturity.
+//
+// A cost-of-carry curve is a YieldCurve of zero carries B(T); the carry factor of a maturity is then exp((B(T) - R(T)) T).
+//
+// A YieldCurve is an immutable snapshot: every member is set by the constructor and every member function is const and keeps no
+// cache, so a curve can be shared, typically through a shared_ptr<const YieldCurve>, by any number of pricing threads without
+// locking. A new market is represented by a new curve.
+
+#ifndef YieldCurve_H
+#define YieldCurve_H
+
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+class YieldCurve
+{
+private:
+	vector<double> times;								// Node times, increasing
+	vector<double> rates;								// Zero rate at each node
+	vector<double> logDiscounts;						// R_i T_i at each node
+
+	YieldCurve& operator = (const YieldCurve&);			// Not assignable; a snapshot never changes
+
+public:
+	// Constructors and Destructor
+	YieldCurve();														// Default constructor; a zero curve
+	explicit YieldCurve(double flatRate);								// A flat curve
+	YieldCurve(const vector<double>& nodeTimes, const vector<double>& zeroRates);
+																		// A curve through the given nodes, which are sorted by time; extra
+																		// entries of the longer vector are ignored
+	YieldCurve(const YieldCurve& curve);								// Copy constructor
+	virtual ~YieldCurve();												// Destructor
+
+
+	// Accessor Functions
+	size_t Size() const;												// Returns the number of nodes
+	const vector<double>& GetTimes() const;								// Returns the node times
+	const vector<double>& GetRates() const;								// Returns the zero rates at the nodes
+	double Rate(double T) const;										// Returns the zero rate R(T)
+	double Discount(double T) const;									// Returns the discount factor D(T) = exp(-R(T) T)
+	double LongRate() const;											// Returns the zero rate beyond the last node
+
+};
+
+
+#endif